@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2019-2020 Ashar Khan <ashar786khan@gmail.com>
+ *
+ * This file is part of CPEditor.
+ *
+ * CPEditor is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * I will not be responsible if CPEditor behaves in unexpected way and
+ * causes your ratings to go down and or loose any important contest.
+ *
+ * Believe Software is "Software" and it isn't immune to bugs.
+ *
+ */
+
+#ifndef BENCHMARK_HPP
+#define BENCHMARK_HPP
+
+#include "Core/Runner.hpp"
+#include <QStringList>
+#include <QVector>
+
+namespace Core
+{
+
+// Benchmark runs a solution on each test several times after a few warm-up runs. The runs are sequential, pinned to
+// a single CPU core, and all the other runners are paused meanwhile, so that the measured CPU times are as stable as
+// possible.
+
+class Benchmark : public QObject
+{
+    Q_OBJECT
+
+  public:
+    struct Summary
+    {
+        int runs = 0;
+        double min = 0, median = 0, p95 = 0, mean = 0;
+        double cv = 0; // the coefficient of variation, i.e. the standard deviation divided by the mean
+    };
+
+    struct Result
+    {
+        int index = 0;
+        QVector<double> times;       // milliseconds of CPU time
+        QVector<ProcessStats> stats; // the hardware counters of the measured runs
+        QString error;
+
+        Summary summary() const;
+        // the median of a hardware counter of the measured runs, -1 if it's unknown
+        double medianCounter(qint64 ProcessStats::*counter) const;
+    };
+
+    Benchmark(const QString &filePath, const QString &lang, const QString &runCommand, const QString &args,
+              int timeLimit, QObject *parent = nullptr);
+    ~Benchmark();
+
+    // the file I/O of the problem, see Runner::setFileIO()
+    void setFileIO(const QString &inputFileName, const QString &outputFileName);
+    // the tests with an empty input are skipped, core is the CPU core the runs are pinned to, -1 for any core
+    void start(const QStringList &inputs, int runs, int warmUpRuns, int core);
+    void stop();
+    bool isRunning() const;
+    QVector<Result> results() const;
+
+    static Summary summarize(QVector<double> values);
+    // the last core the editor is allowed to run on, which is usually the least busy one
+    static int defaultCore();
+
+  signals:
+    void progress(int finished, int total);
+    void resultChanged(int index);
+    void benchmarkFinished();
+
+  private slots:
+    void onRunFinished(int index, const QByteArray &out, const QByteArray &err, int exitCode, int timeUsed);
+    void onRunErrorOccured(int index, const QString &error);
+    void onRunTimeout(int index);
+
+  private:
+    QString filePath, lang, runCommand, args;
+    QString inputFileName, outputFileName;
+    int timeLimit;
+    QStringList inputs;
+    int runs = 1, warmUpRuns = 0, core = -1;
+    int currentTest = 0, currentRun = 0, finished = 0;
+    bool running = false, timedOut = false;
+    QVector<Result> testResults;
+    Runner *runner = nullptr;
+
+    void runNext();
+    void nextTest();
+    void finish();
+    int runTimeLimit() const;
+};
+
+} // namespace Core
+
+#endif // BENCHMARK_HPP
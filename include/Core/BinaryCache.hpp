@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2019-2020 Ashar Khan <ashar786khan@gmail.com>
+ *
+ * This file is part of CPEditor.
+ *
+ * CPEditor is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * I will not be responsible if CPEditor behaves in unexpected way and
+ * causes your ratings to go down and or loose any important contest.
+ *
+ * Believe Software is "Software" and it isn't immune to bugs.
+ *
+ */
+
+#ifndef BINARYCACHE_HPP
+#define BINARYCACHE_HPP
+
+#include "Core/Scheduler.hpp"
+#include <QMap>
+#include <QProcess>
+#include <QSet>
+#include <QStringList>
+
+class QCryptographicHash;
+
+namespace Core
+{
+
+// BinaryCache compiles the C++ helper programs, such as checkers and interactors, in the background. The binaries
+// are cached on the disk by the hash of the source, the local headers it includes, e.g. testlib.h, and the compile
+// command, so each version of a helper is compiled only once, and is shared by all the tabs. A path which is not a C++
+// source is treated as a ready executable. The compilations wait for the Scheduler like those of the solutions.
+
+class BinaryCache : public QObject
+{
+    Q_OBJECT
+
+  public:
+    static BinaryCache *instance();
+
+    // buildFinished() or buildFailed() is emitted with the same source path, possibly before build() returns
+    void build(const QString &sourcePath, const QString &compileCommand);
+    static bool isSource(const QString &path);
+    static QString cacheDirectory();
+
+  signals:
+    void buildFinished(const QString &sourcePath, const QString &binaryPath);
+    void buildFailed(const QString &sourcePath, const QString &error);
+
+  private slots:
+    void onProcessFinished(int exitCode, QProcess::ExitStatus exitStatus);
+    void onProcessErrorOccurred(QProcess::ProcessError error);
+    void onTicketGranted();
+
+  private:
+    struct Build
+    {
+        QString binaryPath, command;
+        QStringList sourcePaths;
+    };
+
+    explicit BinaryCache(QObject *parent = nullptr);
+    void finishBuild(QProcess *process, bool success, const QString &error);
+    static void addLocalIncludes(const QString &sourcePath, const QByteArray &content, QCryptographicHash &hash,
+                                 QSet<QString> &visited);
+
+    QMap<QProcess *, Build> builds;
+};
+
+} // namespace Core
+
+#endif // BINARYCACHE_HPP
@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2019-2020 Ashar Khan <ashar786khan@gmail.com>
+ *
+ * This file is part of CPEditor.
+ *
+ * CPEditor is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * I will not be responsible if CPEditor behaves in unexpected way and
+ * causes your ratings to go down and or loose any important contest.
+ *
+ * Believe Software is "Software" and it isn't immune to bugs.
+ *
+ */
+
+
+#ifndef CALIBRATION_HPP
+#define CALIBRATION_HPP
+
+#include "Core/Benchmark.hpp"
+#include "Core/Compiler.hpp"
+#include <QMap>
+#include <QTemporaryDir>
+
+namespace Core
+{
+
+// Calibration measures how fast this machine runs a fixed suite of CPU, memory and I/O bound programs. The same
+// programs can be run on an online judge, and the ratios of the timings give the speed of the judge relative to this
+// machine, which is used to scale the time limits.
+
+class Calibration : public QObject
+{
+    Q_OBJECT
+
+  public:
+    explicit Calibration(QObject *parent = nullptr);
+    ~Calibration();
+    // compileCommand should match the one of the judge, e.g. g++ -O2
+    void start(const QString &compileCommand);
+    void stop();
+    bool isRunning() const;
+    // the median CPU time in milliseconds of each program measured so far
+    QMap<QString, double> timings() const;
+
+    static QStringList programs();
+    static QString description(const QString &program);
+    static QString source(const QString &program);
+    // how many times slower the judge is than this machine, the geometric mean of the ratios of the programs measured
+    // on both of them, 0 if there isn't any
+    static double speedFactor(const QMap<QString, double> &local, const QMap<QString, double> &judge);
+
+  signals:
+    void programStarted(const QString &program);
+    void programMeasured(const QString &program, double time);
+    void calibrationFinished();
+    void errorOccured(const QString &error);
+
+  private slots:
+    void onCompilationFinished(const QString &warning);
+    void onCompilationErrorOccured(const QString &error);
+    void onBenchmarkFinished();
+
+  private:
+    static const int RUNS = 5;
+    static const int WARM_UP_RUNS = 1;
+    static const int TIME_LIMIT = 20000;
+
+    QString compileCommand;
+    QTemporaryDir *tmpDir = nullptr;
+    Compiler *compiler = nullptr;
+    Benchmark *benchmark = nullptr;
+    int current = 0;
+    bool running = false;
+    QMap<QString, double> measured;
+
+    QString sourcePath() const;
+    void compileNext();
+    void fail(const QString &error);
+};
+
+} // namespace Core
+
+#endif // CALIBRATION_HPP
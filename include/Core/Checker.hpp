@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) 2019-2020 Ashar Khan <ashar786khan@gmail.com>
+ *
+ * This file is part of CPEditor.
+ *
+ * CPEditor is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * I will not be responsible if CPEditor behaves in unexpected way and
+ * causes your ratings to go down and or loose any important contest.
+ *
+ * Believe Software is "Software" and it isn't immune to bugs.
+ *
+ */
+
+#ifndef CHECKER_HPP
+#define CHECKER_HPP
+
+#include "Core/ExecutorMessage.hpp"
+#include "Core/Scheduler.hpp"
+#include <QMap>
+#include <QProcess>
+#include <QPointer>
+#include <QTemporaryDir>
+#include <QVector>
+
+namespace Core
+{
+
+// Checker judges the outputs with a testlib-style checker, which is run as "checker input output answer" and reports
+// the verdict by its exit code. A C++ source is compiled once by the BinaryCache. The checks run asynchronously and
+// in parallel as the Scheduler allows, checkFinished() is emitted for each of them. Like the compilations and the runs,
+// the checks are run by the executor daemon when it's enabled.
+
+class Checker : public QObject
+{
+    Q_OBJECT
+
+  public:
+    enum Verdict
+    {
+        Accepted,
+        WrongAnswer,
+        Failed // the checker itself failed, e.g. it crashed or it couldn't be compiled
+    };
+
+    explicit Checker(QObject *parent = nullptr);
+    ~Checker();
+    void setChecker(const QString &path, const QString &compileCommand);
+    QString checkerPath() const;
+    // the owner is the tab which started the checks, the jobs of the focused tab are scheduled first
+    void setScheduling(QObject *owner, Scheduler::Priority priority);
+    // the output is passed to the checker byte by byte as the program wrote it
+    void check(int index, const QString &input, const QByteArray &output, const QString &expected);
+    // kill the running checks, their results are no longer needed
+    void cancel();
+
+    static Verdict verdictOfExitCode(int exitCode, QString &message);
+    // compares the bytes directly, without decoding them, so an invalid UTF-8 output isn't changed by the comparison
+    static bool isSameOutput(const QByteArray &output, const QByteArray &expected);
+
+    static const int CHECKER_TIME_LIMIT = 10000;
+
+  signals:
+    void checkFinished(int index, Core::Checker::Verdict verdict, const QString &message);
+
+  private slots:
+    void onBuildFinished(const QString &sourcePath, const QString &binaryPath);
+    void onBuildFailed(const QString &sourcePath, const QString &error);
+    void onProcessFinished(int exitCode, QProcess::ExitStatus exitStatus);
+    void onProcessErrorOccurred(QProcess::ProcessError error);
+    void onTicketGranted();
+    void onRemoteJobOutput(quint64 job, int channel, const QByteArray &data);
+    void onRemoteJobFinished(quint64 job, const Core::ExecutorMessage &result);
+    void onRemoteJobFailed(quint64 job, const QString &error);
+
+  private:
+    struct Check
+    {
+        int index = 0;
+        QString input, expected;
+        QByteArray output;
+    };
+
+    QString path, binaryPath, buildError;
+    bool building = false;
+    QVector<Check> pending;
+    QMap<QProcess *, int> running;
+    QMap<quint64, QProcess *> remoteJobs; // the checks in the executor daemon, the processes hold their files
+    QMap<quint64, QByteArray> remoteErrors;
+    QTemporaryDir *tmpDir = nullptr;
+    int serial = 0;
+    QPointer<QObject> owner;
+    Scheduler::Priority priority = Scheduler::Background;
+
+    void startCheck(const Check &check);
+    void startProcess(QProcess *process);
+    static bool isBlank(const char *begin, const char *end);
+    static bool isSameText(const char *a, const char *aEnd, const char *b, const char *bEnd, char separator);
+    void finishCheck(QProcess *process, Verdict verdict, const QString &message);
+};
+
+} // namespace Core
+
+#endif // CHECKER_HPP
@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2019-2020 Ashar Khan <ashar786khan@gmail.com>
+ *
+ * This file is part of CPEditor.
+ *
+ * CPEditor is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * I will not be responsible if CPEditor behaves in unexpected way and
+ * causes your ratings to go down and or loose any important contest.
+ *
+ * Believe Software is "Software" and it isn't immune to bugs.
+ *
+ */
+
+#ifndef CHILDPROCESS_HPP
+#define CHILDPROCESS_HPP
+
+#include <QProcess>
+#include <QStringList>
+
+namespace Core
+{
+
+// ChildProcess is a QProcess which sets up the child between fork and exec. Only async-signal-safe calls are allowed
+// there, so the settings are stored as plain values before the process is started. On Unix the child leads a process
+// group of its own, so that the processes it starts can be killed together with it.
+
+class ChildProcess : public QProcess
+{
+    Q_OBJECT
+
+  public:
+    explicit ChildProcess(QObject *parent = nullptr);
+
+    // pin the child to a single CPU core, -1 to let it run on any core, only supported on Linux
+    void setCpuAffinity(int core);
+    int cpuAffinity() const;
+
+    // limit the address space of the child, 0 for no limit, only supported on Unix
+    void setMemoryLimit(qint64 bytes);
+    qint64 memoryLimit() const;
+
+    // limit the CPU time of the child, after which it gets SIGKILL, 0 for no limit, only supported on Unix
+    void setCpuTimeLimit(int seconds);
+
+    // the processes left in a process group after its leader has exited, as "name (pid)", only supported on Linux, on
+    // the other Unix systems it only tells whether there is any
+    static QStringList groupMembers(qint64 groupId);
+    // send a signal to all the processes of a process group, returns false if there isn't any, only supported on Unix
+    static bool signalGroup(qint64 groupId, int signal);
+
+  public slots:
+    // kill the child and all the processes it started which are still in its process group
+    void killTree();
+
+  protected:
+    void setupChildProcess() override;
+
+  private:
+    int affinity = -1;
+    qint64 memory = 0;
+    int cpuSeconds = 0;
+};
+
+} // namespace Core
+
+#endif // CHILDPROCESS_HPP
@@ -18,6 +18,9 @@
 #ifndef COMPILER_HPP
 #define COMPILER_HPP
 
+#include "Core/ChildProcess.hpp"
+#include "Core/ExecutorMessage.hpp"
+#include "Core/Scheduler.hpp"
 #include <QProcess>
 
 namespace Core
@@ -34,7 +37,9 @@ class Compiler : public QObject
     Compiler();
     ~Compiler();
     void start(const QString &filePath, const QString &compileCommand, const QString &lang);
-    static bool check(const QString &compileCommand);
+
+    // the owner is the tab which started the compilation, the jobs of the focused tab are scheduled first
+    void setScheduling(QObject *owner, Scheduler::Priority priority);
 
   signals:
     void compilationStarted();
@@ -43,9 +48,23 @@ class Compiler : public QObject
 
   private slots:
     void onProcessFinished(int exitCode, QProcess::ExitStatus exitStatus);
+    void onTicketGranted();
+    void onRemoteJobStarted(quint64 job);
+    void onRemoteJobOutput(quint64 job, int channel, const QByteArray &data);
+    void onRemoteJobFinished(quint64 job, const Core::ExecutorMessage &result);
+    void onRemoteJobFailed(quint64 job, const QString &error);
 
   private:
-    QProcess *compileProcess = nullptr;
+    ChildProcess *compileProcess = nullptr;
+    SchedulerTicket *ticket = nullptr;
+    QPointer<QObject> owner;
+    Scheduler::Priority priority = Scheduler::Background;
+    QString pendingCommand; // the compilation waiting for the scheduler
+    quint64 remoteJob = 0; // the compilation in the executor daemon
+    QByteArray remoteError;
+
+    void startCommand(const QString &command);
+    void releaseTicket();
 };
 
 } // namespace Core
@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2019-2020 Ashar Khan <ashar786khan@gmail.com>
+ *
+ * This file is part of CPEditor.
+ *
+ * CPEditor is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * I will not be responsible if CPEditor behaves in unexpected way and
+ * causes your ratings to go down and or loose any important contest.
+ *
+ * Believe Software is "Software" and it isn't immune to bugs.
+ *
+ */
+
+#ifndef COMPLEXITYPROFILER_HPP
+#define COMPLEXITYPROFILER_HPP
+
+#include "Core/Generator.hpp"
+#include "Core/Runner.hpp"
+#include <QVector>
+
+namespace Core
+{
+
+// ComplexityProfiler runs a solution on generated inputs of geometrically increasing sizes, measures the CPU time of
+// each size a few times, and fits the measurements against the common complexity classes. The runs are sequential so
+// that they don't disturb each other's timing.
+
+class ComplexityProfiler : public QObject
+{
+    Q_OBJECT
+
+  public:
+    enum Model
+    {
+        Linear,
+        LinearLogarithmic,
+        Quadratic,
+        Cubic
+    };
+
+    struct Sample
+    {
+        qint64 n = 0;
+        int cpuTime = 0;
+        bool timedOut = false;
+    };
+
+    struct Fit
+    {
+        Model model = Linear;
+        double constant = 0;    // the time not depending on n, e.g. the start up time, in ms
+        double coefficient = 0; // the time of one unit of the model, in ms
+        double error = 0;       // the root mean square of the relative errors
+        bool valid = false;
+
+        double predict(qint64 n) const;
+        QString name() const;
+    };
+
+    ComplexityProfiler(const QString &filePath, const QString &lang, const QString &runCommand, const QString &args,
+                       int timeLimit, QObject *parent = nullptr);
+    ~ComplexityProfiler();
+
+    // the file I/O of the problem, see Runner::setFileIO()
+    void setFileIO(const QString &inputFileName, const QString &outputFileName);
+    void start(const QString &generatorCommand, qint64 minN, qint64 maxN, int steps, int repetitions);
+    void stop();
+    bool isRunning() const;
+    QVector<Sample> samples() const;
+
+    // the fits sorted from the best to the worst, the samples that are too fast to be measured are ignored
+    static QVector<Fit> fit(const QVector<Sample> &samples);
+    static double modelValue(Model model, qint64 n);
+
+    static const int MIN_MEASURABLE_TIME = 20;
+    static const int MIN_NUMBER_OF_SAMPLES = 3;
+
+  signals:
+    void sampleMeasured(qint64 n, int cpuTime, bool timedOut);
+    void profilingFinished();
+    void errorOccured(const QString &error);
+
+  private slots:
+    void onGenerated(int index, const QString &input);
+    void onGenerationFailed(int index, const QString &error);
+    void onRunFinished(int index, const QByteArray &out, const QByteArray &err, int exitCode, int timeUsed);
+    void onRunErrorOccured(int index, const QString &error);
+    void onRunTimeout(int index);
+
+  private:
+    QString filePath, lang, runCommand, args;
+    QString inputFileName, outputFileName;
+    int timeLimit;
+    QString generatorCommand;
+    QVector<qint64> sizes;
+    int repetitions = 1, currentSize = 0;
+    bool running = false, currentTimedOut = false;
+    QString currentInput;
+    QVector<int> currentTimes;
+    QVector<Sample> measured;
+    Generator *generator = nullptr;
+    Runner *runner = nullptr;
+
+    void generateNext();
+    void runNext();
+    void finishSize();
+    void finish();
+    int runTimeLimit() const;
+};
+
+} // namespace Core
+
+#endif // COMPLEXITYPROFILER_HPP
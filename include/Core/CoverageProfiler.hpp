@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2019-2020 Ashar Khan <ashar786khan@gmail.com>
+ *
+ * This file is part of CPEditor.
+ *
+ * CPEditor is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * I will not be responsible if CPEditor behaves in unexpected way and
+ * causes your ratings to go down and or loose any important contest.
+ *
+ * Believe Software is "Software" and it isn't immune to bugs.
+ *
+ */
+
+#ifndef COVERAGEPROFILER_HPP
+#define COVERAGEPROFILER_HPP
+
+#include "Core/Scheduler.hpp"
+#include <QMap>
+#include <QPointer>
+#include <QProcess>
+#include <QTemporaryDir>
+#include <QTimer>
+#include <QVector>
+
+namespace Core
+{
+
+// CoverageProfiler runs a program compiled with --coverage on several tests in parallel and reads the merged line
+// execution counts with gcov. The counters of the concurrent runs are merged by libgcov itself when each run exits,
+// so a run killed at the time limit doesn't contribute any counts. Each run waits for a CPU slot of the Scheduler.
+
+class CoverageProfiler : public QObject
+{
+    Q_OBJECT
+
+  public:
+    struct Result
+    {
+        QVector<qint64> lines; // the execution count of each line of the source file, 0-based, -1 if not executable
+        int runs = 0;          // the runs whose counters are merged
+        QVector<int> killed;   // the indices of the tests stopped at the time limit
+    };
+
+    explicit CoverageProfiler(QObject *parent = nullptr);
+    ~CoverageProfiler();
+    // the file I/O of the problem, see Runner::setFileIO(), each run has its own directory, the output file is not read
+    void setFileIO(const QString &inputFileName, const QString &outputFileName);
+    // the directory contains the instrumented binary, its source file and the .gcno file of the compilation
+    void start(const QString &binaryPath, const QString &sourcePath, const QStringList &inputs, int timeLimit,
+               int parallel);
+    void stop();
+    // the owner is the tab which started the profile, the jobs of the focused tab are scheduled first
+    void setScheduling(QObject *owner, Scheduler::Priority priority);
+    bool isRunning() const;
+    Result result() const;
+
+  signals:
+    void testFinished(int index, int finished, int total);
+    void profilingFinished();
+    void errorOccured(const QString &error);
+
+  private slots:
+    void onRunFinished(int exitCode, QProcess::ExitStatus exitStatus);
+    void onGcovFinished(int exitCode, QProcess::ExitStatus exitStatus);
+    void onTimeout();
+    void onTicketGranted();
+
+  private:
+    QString binaryPath, sourcePath;
+    QString inputFileName, outputFileName;
+    QStringList inputs;
+    int timeLimit = 0, parallel = 1;
+    int next = 0, finished = 0;
+    bool running = false;
+    QVector<QProcess *> runs; // the running tests
+    QMap<QProcess *, QTemporaryDir *> scratchDirs; // the working directories of the runs with file I/O
+    QProcess *gcov = nullptr;
+    Result counts;
+    QPointer<QObject> owner;
+    Scheduler::Priority priority = Scheduler::Background;
+
+    void startNext();
+    void launch(QProcess *process);
+    void readCounts();
+    void fail(const QString &error);
+};
+
+} // namespace Core
+
+#endif // COVERAGEPROFILER_HPP
@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2019-2020 Ashar Khan <ashar786khan@gmail.com>
+ *
+ * This file is part of CPEditor.
+ *
+ * CPEditor is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * I will not be responsible if CPEditor behaves in unexpected way and
+ * causes your ratings to go down and or loose any important contest.
+ *
+ * Believe Software is "Software" and it isn't immune to bugs.
+ *
+ */
+
+#ifndef EXECUTORCLIENT_HPP
+#define EXECUTORCLIENT_HPP
+
+#include "Core/ExecutorMessage.hpp"
+#include <QList>
+#include <QLocalSocket>
+#include <QTimer>
+
+namespace Core
+{
+
+// ExecutorClient is the connection of the editor to the executor daemon. It starts the daemon if it's not running,
+// queues the messages until the connection is ready, and reports the messages of the jobs by signals. The job IDs are
+// unique across the restarts of the editor, so the results of the jobs submitted before a restart can't be mistaken
+// for the new ones. The pending jobs are attached again when the connection is lost and restored, and the results
+// of the jobs which nobody waits for, e.g. the ones finished while the editor was closed, are reported by
+// jobFinishedWhileAway(). It's shared by all the tabs.
+
+class ExecutorClient : public QObject
+{
+    Q_OBJECT
+
+  public:
+    static ExecutorClient *instance();
+
+    // whether the compile and run jobs should be executed by the daemon
+    static bool isEnabled();
+    static void setEnabled(bool value);
+
+    // the session identifies the editor to the daemon, it should be kept across the restarts
+    void setSession(const QString &session);
+
+    // connect to a running daemon to receive the results of the jobs submitted before a restart, the daemon is not
+    // started if it's not running
+    void attach();
+
+    quint64 submit(const QString &command, const QString &workingDirectory, const QByteArray &input, int timeLimit,
+                   qint64 memoryLimit);
+    void cancel(quint64 job);
+
+    // while it's set, cancel() leaves the job running in the daemon, it's set when the editor quits, so the long runs
+    // continue and their results are reported by jobFinishedWhileAway() after the next start
+    void setDetaching(bool value);
+
+  signals:
+    void jobStarted(quint64 job);
+    void jobOutput(quint64 job, int channel, const QByteArray &data);
+    void jobFinished(quint64 job, const Core::ExecutorMessage &result);
+    void jobFailed(quint64 job, const QString &error);
+
+    // a Finished or Failed message of a job which is not pending
+    void jobFinishedWhileAway(const Core::ExecutorMessage &result);
+
+  private slots:
+    void onConnected();
+    void onDisconnected();
+    void onErrorOccurred(QLocalSocket::LocalSocketError error);
+    void onReadyRead();
+    void onRetryTimeout();
+
+  private:
+    explicit ExecutorClient(QObject *parent = nullptr);
+    void send(const ExecutorMessage &message);
+    void connectToDaemon();
+    void failPendingJobs(const QString &error);
+
+    QLocalSocket *socket = nullptr;
+    QTimer *retryTimer = nullptr;
+    QString session;
+    QByteArray buffer;
+    QList<QByteArray> queue;  // the messages waiting for the connection
+    QList<quint64> pending;   // the jobs which are not finished
+    quint64 lastJob = 0;
+    int retries = 0;
+    bool daemonStarted = false;
+    bool detaching = false;
+
+    static bool enabled;
+
+    static const int RETRY_INTERVAL = 100;
+    static const int MAX_RETRIES = 50;
+};
+
+} // namespace Core
+
+#endif // EXECUTORCLIENT_HPP
@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2019-2020 Ashar Khan <ashar786khan@gmail.com>
+ *
+ * This file is part of CPEditor.
+ *
+ * CPEditor is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * I will not be responsible if CPEditor behaves in unexpected way and
+ * causes your ratings to go down and or loose any important contest.
+ *
+ * Believe Software is "Software" and it isn't immune to bugs.
+ *
+ */
+
+#ifndef EXECUTORDAEMON_HPP
+#define EXECUTORDAEMON_HPP
+
+#include "Core/ChildProcess.hpp"
+#include "Core/ExecutorMessage.hpp"
+#include "Core/ProcessMonitor.hpp"
+#include <QElapsedTimer>
+#include <QList>
+#include <QMap>
+#include <QTimer>
+
+class QLocalServer;
+class QLocalSocket;
+
+namespace Core
+{
+
+// ExecutorDaemon runs the compile and run jobs of the editors in a separate process (cpeditor --executor), so the
+// process I/O doesn't block the GUI thread. The editors connect to it by a local socket and identify themselves by a
+// session. The jobs keep running when an editor disconnects, and their results are sent to the next connection of the
+// same session, so a long run survives a restart of the editor. Only the output kept for a disconnected session is
+// limited, the results are never dropped. The daemon quits when it has been idle for a while.
+
+class ExecutorDaemon : public QObject
+{
+    Q_OBJECT
+
+  public:
+    explicit ExecutorDaemon(QObject *parent = nullptr);
+    ~ExecutorDaemon();
+
+    // returns false if another daemon is already running or the socket can't be created
+    bool listen();
+
+  private slots:
+    void onNewConnection();
+    void onSocketReadyRead();
+    void onSocketDisconnected();
+    void onJobStarted();
+    void onJobReadyRead();
+    void onJobFinished(int exitCode, QProcess::ExitStatus exitStatus);
+    void onJobErrorOccurred(QProcess::ProcessError error);
+    void onJobTimeout();
+    void onIdleTimeout();
+
+  private:
+    struct Job
+    {
+        QString session;
+        quint64 id = 0;
+        QString command;
+        ChildProcess *process = nullptr;
+        ProcessMonitor *monitor = nullptr;
+        QTimer *killTimer = nullptr;
+        QElapsedTimer timer;
+        bool timedOut = false;
+        QByteArray input;
+    };
+
+    struct Client
+    {
+        QString session;
+        QByteArray buffer;
+    };
+
+    struct Backlog
+    {
+        QList<QByteArray> messages;
+        qint64 outputSize = 0;
+    };
+
+    void handle(QLocalSocket *socket, const ExecutorMessage &message);
+    void submit(const QString &session, const ExecutorMessage &message);
+    void send(const QString &session, const ExecutorMessage &message);
+    void finishJob(Job *job);
+    Job *jobOf(QObject *object) const;
+    void updateIdleTimer();
+
+    QLocalServer *server = nullptr;
+    QMap<QLocalSocket *, Client> clients;
+    QList<Job *> jobs;
+    QMap<QString, Backlog> backlogs;         // the messages to the disconnected sessions
+    QMap<QString, QList<quint64>> finished; // the latest finished jobs of each session
+    QTimer *idleTimer = nullptr;
+
+    static const int IDLE_TIMEOUT = 10 * 60 * 1000;
+    static const qint64 MAX_BACKLOG_OUTPUT = 64 * 1024 * 1024;
+    static const int MAX_FINISHED = 1000;
+};
+
+} // namespace Core
+
+#endif // EXECUTORDAEMON_HPP
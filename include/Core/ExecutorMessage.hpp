@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2019-2020 Ashar Khan <ashar786khan@gmail.com>
+ *
+ * This file is part of CPEditor.
+ *
+ * CPEditor is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * I will not be responsible if CPEditor behaves in unexpected way and
+ * causes your ratings to go down and or loose any important contest.
+ *
+ * Believe Software is "Software" and it isn't immune to bugs.
+ *
+ */
+
+#ifndef EXECUTORMESSAGE_HPP
+#define EXECUTORMESSAGE_HPP
+
+#include <QByteArray>
+#include <QString>
+
+namespace Core
+{
+
+// ExecutorMessage is a message between the editor and the executor daemon. A message is framed by its length in four
+// big-endian bytes, followed by the type, the job ID and the fields used by the type, written with QDataStream.
+
+struct ExecutorMessage
+{
+    enum Type
+    {
+        Hello = 1, // editor -> daemon: text is the session, timeLimit is the protocol version
+        Submit,    // editor -> daemon: text is the command, data is the input
+        Cancel,    // editor -> daemon
+        Started,   // daemon -> editor
+        Output,    // daemon -> editor: data is a chunk of the channel
+        Finished,  // daemon -> editor: the result fields are set, text is the command
+        Failed,    // daemon -> editor: text is the error, the job is not started or is lost
+        Attach     // editor -> daemon: the job is still waited for after a reconnection
+    };
+
+    enum Channel
+    {
+        StandardOutput,
+        StandardError
+    };
+
+    Type type = Hello;
+    quint64 job = 0;
+    QString text;
+    QString workingDirectory;
+    QByteArray data;
+    int timeLimit = 0;      // milliseconds, 0 for no limit
+    qint64 memoryLimit = 0; // bytes, 0 for no limit
+    int channel = StandardOutput;
+
+    int exitCode = 0;
+    bool crashed = false;
+    bool timedOut = false;
+    int timeUsed = 0;
+    int cpuTime = 0;
+    qint64 peakMemory = -1;
+
+    QByteArray encode() const;
+
+    // take a message from the front of the buffer, returns false if the buffer doesn't contain a whole message yet, or
+    // if the buffer is corrupted, which is reported by *corrupted
+    static bool decode(QByteArray &buffer, ExecutorMessage &message, bool *corrupted = nullptr);
+
+    // the name of the local socket, it's unique for each user
+    static QString serverName();
+
+    static const int PROTOCOL_VERSION = 2;
+    static const int MAX_MESSAGE_SIZE = 256 * 1024 * 1024;
+};
+
+} // namespace Core
+
+#endif // EXECUTORMESSAGE_HPP
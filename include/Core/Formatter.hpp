@@ -29,7 +29,6 @@ class Formatter
   public:
     Formatter(const QString &clangFormatBinary, const QString &clangFormatStyle, MessageLogger *log);
     void format(QCodeEditor *editor, const QString &filePath, const QString &lang, bool selectionOnly);
-    static bool check(const QString &checkBinary, const QString &checkStyle);
     void updateBinary(const QString &newBinary);
     void updateStyle(const QString &newStyle);
 
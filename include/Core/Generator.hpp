@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2019-2020 Ashar Khan <ashar786khan@gmail.com>
+ *
+ * This file is part of CPEditor.
+ *
+ * CPEditor is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * I will not be responsible if CPEditor behaves in unexpected way and
+ * causes your ratings to go down and or loose any important contest.
+ *
+ * Believe Software is "Software" and it isn't immune to bugs.
+ *
+ */
+
+#ifndef GENERATOR_HPP
+#define GENERATOR_HPP
+
+#include "Core/Scheduler.hpp"
+#include <QMap>
+#include <QProcess>
+#include <QTimer>
+
+namespace Core
+{
+
+// Generator runs a user-provided test generator command and emits the generated input. Placeholders like {n} and
+// {seed} in the command are replaced by the given parameters. The generator waits for a CPU slot of the Scheduler like
+// the runs. Destructing it kills the generator process.
+
+class Generator : public QObject
+{
+    Q_OBJECT
+
+  public:
+    Generator(int index, QObject *parent = nullptr);
+    ~Generator();
+    void generate(const QString &command, const QMap<QString, QString> &parameters, int timeLimit);
+    static QString expandCommand(const QString &command, const QMap<QString, QString> &parameters);
+
+  signals:
+    void generated(int index, const QString &input);
+    void generationFailed(int index, const QString &error);
+
+  private slots:
+    void onFinished(int exitCode, QProcess::ExitStatus exitStatus);
+    void onErrorOccurred(QProcess::ProcessError error);
+    void onTimeout();
+    void onTicketGranted();
+
+  private:
+    const int generatorIndex;
+    QProcess *process = nullptr;
+    QTimer *killTimer = nullptr;
+    QString expandedCommand;
+    SchedulerTicket *ticket = nullptr;
+
+    void start();
+    void releaseTicket();
+};
+
+} // namespace Core
+
+#endif // GENERATOR_HPP
@@ -0,0 +1,114 @@
+/*
+ * Copyright (C) 2019-2020 Ashar Khan <ashar786khan@gmail.com>
+ *
+ * This file is part of CPEditor.
+ *
+ * CPEditor is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * I will not be responsible if CPEditor behaves in unexpected way and
+ * causes your ratings to go down and or loose any important contest.
+ *
+ * Believe Software is "Software" and it isn't immune to bugs.
+ *
+ */
+
+#ifndef HEADLESSJUDGE_HPP
+#define HEADLESSJUDGE_HPP
+
+#include "Core/Checker.hpp"
+#include "Core/Compiler.hpp"
+#include "Core/Runner.hpp"
+#include "Core/Scheduler.hpp"
+#include "Core/SettingsManager.hpp"
+#include <QJsonObject>
+#include <QMap>
+#include <QTemporaryDir>
+
+namespace Core
+{
+
+// HeadlessJudge compiles and judges solutions on their saved tests without a GUI, it's the --judge mode of the
+// command line. The tests of "dir/name.cpp" are "dir/name_N.in" and "dir/name_N.ans", as they are saved by the editor.
+// The solutions are compiled with the saved settings, and all the compilations and runs are queued by a Scheduler.
+// The Java solutions are copied to their own directories, so the ones in the same directory don't share classes.
+
+class HeadlessJudge : public QObject
+{
+    Q_OBJECT
+
+  public:
+    struct Options
+    {
+        QStringList sources;
+        QString testsFrom;   // judge all the solutions on the tests of this file instead of their own tests
+        QString checkerPath; // a testlib-style checker, the outputs are compared by Checker::isSameOutput() if empty
+        int timeLimit = 0;   // the time limit on the judge, 0 for the time limit in the settings
+        int jobs = 0;        // the CPU budget of the scheduler, 0 for automatic
+        QString inputFileName, outputFileName; // the file I/O of the problem, see Runner::setFileIO()
+    };
+
+    HeadlessJudge(const Options &options, const Settings::SettingsData &data, QObject *parent = nullptr);
+    ~HeadlessJudge();
+    void start();
+
+    // a solution passes if it's compiled, has tests, and none of its tests has a verdict other than AC, OK or SKIP
+    bool isSuccessful() const;
+    // a solution without any test is usually a wrong path, so it fails instead of passing nothing
+    bool hasSolutionWithoutTests() const;
+    QJsonObject report() const;
+
+    static QString languageOf(const QString &filePath);
+
+  signals:
+    void finished();
+
+  private slots:
+    void onCompilationFinished(const QString &warning);
+    void onCompilationErrorOccured(const QString &error);
+    void onRunFinished(int index, const QByteArray &out, const QByteArray &err, int exitCode, int timeUsed);
+    void onRunErrorOccured(int index, const QString &error);
+    void onRunTimeout(int index);
+    void onCheckFinished(int index, Core::Checker::Verdict verdict, const QString &message);
+
+  private:
+    struct Test
+    {
+        int solution = 0, number = 0;
+        QString input, expected;
+        QString verdict, message; // verdict is empty while the test is pending
+        int exitCode = 0, timeUsed = -1, cpuTime = -1;
+        qint64 peakMemory = -1;
+        bool timedOut = false;
+        Runner *runner = nullptr;
+    };
+
+    struct Solution
+    {
+        QString source, language, compileError, testsError;
+        QString buildPath;                 // the file compiled and run, a copy in buildDir for Java
+        QTemporaryDir *buildDir = nullptr; // Java is compiled to a.class next to the source, so each one has its own
+        bool compiled = false;
+        QVector<int> tests;
+    };
+
+    Options options;
+    Settings::SettingsData data;
+    Scheduler *scheduler = nullptr;
+    Checker *checker = nullptr;
+    QVector<Solution> solutions;
+    QVector<Test> tests;
+    QMap<Compiler *, int> compilers;
+    int pending = 0;
+
+    void loadTests(int solution);
+    void runTests(int solution);
+    void finishTest(int index, const QString &verdict, const QString &message = QString());
+    static QString readFile(const QString &path);
+};
+
+} // namespace Core
+
+#endif // HEADLESSJUDGE_HPP
@@ -0,0 +1,128 @@
+/*
+ * Copyright (C) 2019-2020 Ashar Khan <ashar786khan@gmail.com>
+ *
+ * This file is part of CPEditor.
+ *
+ * CPEditor is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * I will not be responsible if CPEditor behaves in unexpected way and
+ * causes your ratings to go down and or loose any important contest.
+ *
+ * Believe Software is "Software" and it isn't immune to bugs.
+ *
+ */
+
+#ifndef INTERACTIVERUNNER_HPP
+#define INTERACTIVERUNNER_HPP
+
+#include "Core/ChildProcess.hpp"
+#include "Core/ProcessMonitor.hpp"
+#include "Core/Scheduler.hpp"
+#include <QPointer>
+#include <QTemporaryDir>
+#include <QTimer>
+
+namespace Core
+{
+
+// InteractiveRunner runs a solution together with a testlib-style interactor, which is run as "interactor input
+// output answer". The standard output of each process is relayed to the standard input of the other one through the
+// event loop, and the writes are buffered by QProcess, so neither of them blocks on a full pipe and any number of
+// interactive runs can go on at the same time. The buffers are capped, a process which writes much more than the other
+// one reads ends the run. Both processes have time and memory limits. The verdict comes from the interactor's exit
+// code, unless the solution exceeded the limits or crashed. A run takes two CPU slots of the Scheduler, one for each
+// process.
+
+class InteractiveRunner : public QObject
+{
+    Q_OBJECT
+
+  public:
+    enum Verdict
+    {
+        Accepted,
+        WrongAnswer,
+        TimeLimitExceeded,
+        MemoryLimitExceeded,
+        RuntimeError,
+        Failed // the interactor itself failed
+    };
+
+    struct Result
+    {
+        Verdict verdict = Failed;
+        QString message;
+        QString transcript; // the lines of the solution start with "< ", the ones of the interactor with "> "
+        ProcessStats stats;
+        int exitCode = 0;
+    };
+
+    explicit InteractiveRunner(int index, QObject *parent = nullptr);
+    ~InteractiveRunner();
+    // the interactor is a C++ source or an executable, memoryLimit is in MB and 0 for no limit
+    void run(const QString &filePath, const QString &lang, const QString &runCommand, const QString &args,
+             const QString &interactorPath, const QString &compileCommand, const QString &input,
+             const QString &expected, int timeLimit, int memoryLimit);
+
+    // the owner is the tab which started the run, the runs of the focused tab are scheduled first
+    void setScheduling(QObject *owner, Scheduler::Priority priority);
+
+    static QString verdictName(Verdict verdict);
+
+    static const int MAX_TRANSCRIPT_LENGTH = 1 << 16;
+    static const int INTERACTOR_TIME_LIMIT = 10000;
+    static const qint64 INTERACTOR_MEMORY_LIMIT = 512 * 1024 * 1024;
+    // the bytes relayed to a process which hasn't read them yet
+    static const qint64 MAX_PENDING_RELAY = 16 * 1024 * 1024;
+
+  signals:
+    void interactionFinished(int index, const Core::InteractiveRunner::Result &result);
+
+  private slots:
+    void onBuildFinished(const QString &sourcePath, const QString &binaryPath);
+    void onBuildFailed(const QString &sourcePath, const QString &error);
+    void onSolutionOutput();
+    void onInteractorOutput();
+    void onSolutionFinished(int exitCode, QProcess::ExitStatus exitStatus);
+    void onInteractorFinished(int exitCode, QProcess::ExitStatus exitStatus);
+    void onSolutionErrorOccurred(QProcess::ProcessError error);
+    void onInteractorErrorOccurred(QProcess::ProcessError error);
+    void onTimeout();
+    void onTicketGranted();
+
+  private:
+    const int runnerIndex;
+    QString solutionCommand, interactorPath, input, expected;
+    int timeLimit = 0;
+    qint64 memoryLimit = 0;
+    ChildProcess *solution = nullptr, *interactor = nullptr;
+    ProcessMonitor *monitor = nullptr;
+    QTimer *killTimer = nullptr;
+    QTemporaryDir *tmpDir = nullptr;
+    bool waitingForBuild = false, solutionFinished = false, interactorFinished = false, timedOut = false,
+         killedByInteractor = false, finished = false, atLineStart = true, truncated = false, relayStopped = false;
+    char lastDirection = 0;
+    int solutionExitCode = 0, interactorExitCode = 0;
+    QProcess::ExitStatus solutionExitStatus = QProcess::NormalExit, interactorExitStatus = QProcess::NormalExit;
+    QByteArray transcript;
+    QString lang, interactorError, relayError;
+    QString interactorBinary; // the interactor waiting for the scheduler
+    SchedulerTicket *ticket = nullptr;
+    QPointer<QObject> owner;
+    Scheduler::Priority priority = Scheduler::Background;
+
+    void start(const QString &interactorBinary);
+    void launch();
+    void releaseTicket();
+    void appendTranscript(char direction, const QByteArray &data);
+    void fail(const QString &message);
+    void stopRelay(const QString &message);
+    void tryFinish();
+};
+
+} // namespace Core
+
+#endif // INTERACTIVERUNNER_HPP
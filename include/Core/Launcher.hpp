@@ -0,0 +1,129 @@
+/*
+ * Copyright (C) 2019-2020 Ashar Khan <ashar786khan@gmail.com>
+ *
+ * This file is part of CPEditor.
+ *
+ * CPEditor is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * I will not be responsible if CPEditor behaves in unexpected way and
+ * causes your ratings to go down and or loose any important contest.
+ *
+ * Believe Software is "Software" and it isn't immune to bugs.
+ *
+ */
+
+#ifndef LAUNCHER_HPP
+#define LAUNCHER_HPP
+
+#include "Core/ProcessMonitor.hpp"
+#include <QElapsedTimer>
+#include <QMap>
+#include <QStringList>
+
+class QSocketNotifier;
+
+namespace Core
+{
+
+// LaunchedProcess is a process started by the Launcher. It has the part of the QProcess interface used by Runner, and
+// its CPU time and peak memory are reported exactly by the launcher when it exits.
+
+class LaunchedProcess : public QObject
+{
+    Q_OBJECT
+
+  public:
+    ~LaunchedProcess();
+    qint64 processId() const;
+    bool isRunning() const;
+    void write(const QByteArray &data);
+    void closeWriteChannel();
+    QByteArray readAllStandardOutput();
+    QByteArray readAllStandardError();
+    void kill();
+    void sendSignal(int signal);
+    ProcessStats stats() const;
+
+  signals:
+    void started();
+    void readyReadStandardOutput();
+    void finished(int exitCode, bool crashed);
+    void errorOccurred(const QString &error);
+
+  private slots:
+    void onStdinActivated();
+    void onStdoutActivated();
+    void onStderrActivated();
+
+  private:
+    friend class Launcher;
+
+    explicit LaunchedProcess(quint64 id, QObject *parent = nullptr);
+    void setStarted(qint64 pid, int stdinFd, int stdoutFd, int stderrFd, int startLatency);
+    void setFinished(int status, const ProcessStats &stats);
+    void setFailed(const QString &error);
+    void flushInput();
+    bool readPipe(int &fd, QSocketNotifier *&notifier, QByteArray &buffer);
+    void closePipes();
+
+    quint64 id;
+    qint64 pid = 0;
+    bool running = false, closeRequested = false;
+    int stdinFd = -1, stdoutFd = -1, stderrFd = -1;
+    QSocketNotifier *stdinNotifier = nullptr, *stdoutNotifier = nullptr, *stderrNotifier = nullptr;
+    QByteArray input, output, error;
+    ProcessStats processStats;
+};
+
+// Launcher starts the processes from a small helper (the zygote), which is forked from the editor at startup before
+// it grows large and starts any thread. The zygote starts each process with posix_spawn, which uses vfork on Linux,
+// and passes the ends of the pre-opened pipes back by the control socket, so a start takes much less than a
+// millisecond instead of the fork of the whole editor by QProcess. The zygote waits for the processes, so the CPU time
+// and the peak memory come from wait4(). Each process leads its own process group, so the
+// processes it forks can be signalled and killed together. It's only supported on Unix.
+
+class Launcher : public QObject
+{
+    Q_OBJECT
+
+  public:
+    // fork the zygote, it must be called at the beginning of main(), before any thread is started
+    static void startZygote();
+    static bool isAvailable();
+    static Launcher *instance();
+
+    // returns nullptr if the zygote is not available, the memory limit is in bytes, 0 for no limit, the core is the
+    // CPU core the process is pinned to, -1 for any core, an empty working directory is the one of the editor
+    LaunchedProcess *spawn(const QString &command, qint64 memoryLimit, int core, const QString &workingDirectory,
+                           QObject *parent = nullptr);
+
+    // split a command line in the same way as QProcess::start()
+    static QStringList splitCommand(const QString &command);
+
+  private slots:
+    void onControlActivated();
+
+  private:
+    friend class LaunchedProcess;
+
+    explicit Launcher(QObject *parent = nullptr);
+    // returns false if the signal can't be delivered to the zygote in SIGNAL_TIMEOUT milliseconds
+    bool sendSignal(quint64 id, int signal);
+    void setUnavailable();
+
+    QSocketNotifier *notifier = nullptr;
+    QMap<quint64, LaunchedProcess *> processes;
+    QMap<quint64, QElapsedTimer> startTimers;
+    quint64 lastId = 0;
+
+    static int controlFd;
+
+    static const int SIGNAL_TIMEOUT = 100;
+};
+
+} // namespace Core
+
+#endif // LAUNCHER_HPP
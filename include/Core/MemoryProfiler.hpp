@@ -0,0 +1,129 @@
+/*
+ * Copyright (C) 2019-2020 Ashar Khan <ashar786khan@gmail.com>
+ *
+ * This file is part of CPEditor.
+ *
+ * CPEditor is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * I will not be responsible if CPEditor behaves in unexpected way and
+ * causes your ratings to go down and or loose any important contest.
+ *
+ * Believe Software is "Software" and it isn't immune to bugs.
+ *
+ */
+
+#ifndef MEMORYPROFILER_HPP
+#define MEMORYPROFILER_HPP
+
+#include "Core/Scheduler.hpp"
+#include "Core/Symbolizer.hpp"
+#include <QElapsedTimer>
+#include <QProcess>
+#include <QTemporaryDir>
+#include <QTimer>
+#include <QVector>
+
+namespace Core
+{
+
+// MemoryProfiler runs a program on an input and samples its resident set size from /proc at a fixed interval. For
+// C++, the allocations can be tracked as well by preloading the memory shim built with the editor, which reports the
+// allocation counts and the peak live bytes of each call site when the program exits. The run waits for a CPU slot of
+// the Scheduler. Only supported on Linux.
+
+class MemoryProfiler : public QObject
+{
+    Q_OBJECT
+
+  public:
+    struct Sample
+    {
+        int time = 0;   // milliseconds since the start
+        qint64 rss = 0; // bytes
+    };
+
+    struct Allocator
+    {
+        QString function, location;
+        qint64 count = 0, totalBytes = 0;
+        qint64 peakLive = 0; // the largest peak of the call sites of the function and the location
+    };
+
+    struct Profile
+    {
+        QVector<Sample> samples;
+        qint64 peakMemory = 0;  // VmHWM, bytes
+        qint64 shimMemory = -1; // the resident tables of the memory shim, excluded from the samples, -1 if not loaded
+        qint64 peakHeap = -1;  // the peak of the live allocated bytes, -1 if the allocations are not tracked
+        int timeUsed = 0;
+        bool timedOut = false;
+        int exitCode = 0; // -1 if the program crashed
+        QVector<Allocator> allocators; // the largest peak live bytes first
+        QString allocationError;       // why the allocations are not tracked although requested
+    };
+
+    static const int MAX_ALLOCATORS = 100;
+
+    explicit MemoryProfiler(QObject *parent = nullptr);
+    ~MemoryProfiler();
+    // the file I/O of the problem, see Runner::setFileIO(), the output file is not read
+    void setFileIO(const QString &inputFileName, const QString &outputFileName);
+    void start(const QString &filePath, const QString &lang, const QString &runCommand, const QString &args,
+               const QString &input, int timeLimit, int sampleInterval, bool trackAllocations);
+    void stop();
+    bool isRunning() const;
+    Profile profile() const;
+
+    static bool isSupported();
+    // the path of the memory shim, empty if it's not built
+    static QString shimPath();
+
+  signals:
+    void sampleTaken(int time, qint64 rss);
+    void profilingFinished();
+    void errorOccured(const QString &error);
+
+  private slots:
+    void onTicketGranted();
+    void onStarted();
+    void onFinished(int exitCode, QProcess::ExitStatus exitStatus);
+    void onErrorOccurred(QProcess::ProcessError error);
+    void onTimeout();
+    void takeSample();
+    void onSymbolized();
+    void onSymbolizerErrorOccured(const QString &error);
+
+  private:
+    struct Site
+    {
+        qint64 count, totalBytes, peakLive;
+        quint64 address; // the return address in the executable, 0 if it's in a library
+        QString name;    // the symbol or the library of a call site in a library
+    };
+
+    QString binaryPath, sourcePath, command;
+    QString inputFileName, outputFileName;
+    QByteArray input;
+    int timeLimit = 0;
+    bool running = false;
+    QProcess *process = nullptr;
+    Symbolizer *symbolizer = nullptr;
+    QTemporaryDir *reportDir = nullptr;
+    QTemporaryDir *scratchDir = nullptr; // the working directory of a run with file I/O
+    QTimer *sampleTimer = nullptr, *killTimer = nullptr;
+    QElapsedTimer runTimer;
+    QVector<Site> sites;
+    Profile result;
+
+    void readReport();
+    void aggregate();
+    void finish();
+    void fail(const QString &error);
+};
+
+} // namespace Core
+
+#endif // MEMORYPROFILER_HPP
@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2019-2020 Ashar Khan <ashar786khan@gmail.com>
+ *
+ * This file is part of CPEditor.
+ *
+ * CPEditor is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * I will not be responsible if CPEditor behaves in unexpected way and
+ * causes your ratings to go down and or loose any important contest.
+ *
+ * Believe Software is "Software" and it isn't immune to bugs.
+ *
+ */
+
+#ifndef PERFCOUNTERS_HPP
+#define PERFCOUNTERS_HPP
+
+#include "Core/ProcessMonitor.hpp"
+
+namespace Core
+{
+
+// PerfCounters counts the instructions, cycles, cache misses and branch mispredictions of a process and its children
+// with perf_event_open(2). The counters are attached right after the process is started, so the first microseconds of
+// a run are not counted. They are unavailable on the platforms other than Linux, in most containers and virtual
+// machines, and when kernel.perf_event_paranoid forbids them, then the counts are left unknown.
+
+class PerfCounters
+{
+  public:
+    PerfCounters();
+    ~PerfCounters();
+
+    // returns false if the counters are disabled or unavailable
+    bool attach(qint64 pid);
+    // fills the hardware counters of the stats, they keep their final values after the process exits
+    void read(ProcessStats &stats) const;
+
+    static void setEnabled(bool value);
+    static bool isEnabled();
+    // probes the counters on the editor itself, the result is cached
+    static bool isAvailable();
+    static QString unavailableReason();
+
+  private:
+    enum Event
+    {
+        Instructions,
+        Cycles,
+        CacheMisses,
+        BranchMisses,
+        NumberOfEvents
+    };
+
+    int fds[NumberOfEvents];
+
+    static bool enabled;
+    static int probeResult; // 0 if not probed yet, 1 if available, otherwise -errno
+};
+
+} // namespace Core
+
+#endif // PERFCOUNTERS_HPP
@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2019-2020 Ashar Khan <ashar786khan@gmail.com>
+ *
+ * This file is part of CPEditor.
+ *
+ * CPEditor is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * I will not be responsible if CPEditor behaves in unexpected way and
+ * causes your ratings to go down and or loose any important contest.
+ *
+ * Believe Software is "Software" and it isn't immune to bugs.
+ *
+ */
+
+#ifndef PERFORMANCECOMPARISON_HPP
+#define PERFORMANCECOMPARISON_HPP
+
+#include "Core/Benchmark.hpp"
+#include "Core/Runner.hpp"
+#include <QStringList>
+#include <QVector>
+
+namespace Core
+{
+
+// PerformanceComparison runs two versions of a solution, the baseline and the current one, on each test. The runs of
+// the two versions are interleaved in the order ABBA ABBA..., pinned to a single CPU core, with all the other runners
+// paused, like the Benchmark, so that a drift of the machine speed affects both of them equally. The speed-up is
+// estimated from the ratios of the paired runs.
+
+class PerformanceComparison : public QObject
+{
+    Q_OBJECT
+
+  public:
+    enum Side
+    {
+        Baseline,
+        Current
+    };
+
+    struct Target
+    {
+        QString filePath, lang, runCommand, args;
+        QString inputFileName, outputFileName; // the file I/O of the problem, see Runner::setFileIO()
+    };
+
+    // the speed-up, the CPU time of the baseline divided by the CPU time of the current version, with its 95%
+    // confidence interval
+    struct Estimate
+    {
+        bool valid = false;
+        double value = 1, low = 1, high = 1;
+    };
+
+    struct Result
+    {
+        int index = 0;
+        QVector<double> times[2]; // milliseconds of CPU time of the measured runs of each side, paired by the round
+        QByteArray output[2];
+        bool sameOutput = true;
+        int correct[2] = {-1, -1}; // whether the output matches the expected output, -1 if there's no expected output
+        QString error;
+
+        Benchmark::Summary summary(Side side) const;
+        Estimate speedUp() const;
+    };
+
+    PerformanceComparison(const Target &baseline, const Target &current, int timeLimit, QObject *parent = nullptr);
+    ~PerformanceComparison();
+    // the tests with an empty input are skipped, the first round of each test is a warm-up which is not measured
+    void start(const QStringList &inputs, const QStringList &expected, int rounds, int core);
+    void stop();
+    bool isRunning() const;
+    QVector<Result> results() const;
+    // the geometric mean of the speed-ups of all the measured runs
+    Estimate overallSpeedUp() const;
+
+    // the estimate of exp(mean) from a sample of logarithms of ratios
+    static Estimate estimate(const QVector<double> &logRatios);
+
+  signals:
+    void progress(int finished, int total);
+    void resultChanged(int index);
+    void comparisonFinished();
+
+  private slots:
+    void onRunFinished(int index, const QByteArray &out, const QByteArray &err, int exitCode, int timeUsed);
+    void onRunErrorOccured(int index, const QString &error);
+    void onRunTimeout(int index);
+
+  private:
+    Target targets[2];
+    int timeLimit;
+    QStringList inputs, expected;
+    int rounds = 1, core = -1;
+    int currentTest = 0, currentRound = 0, currentStep = 0, finished = 0;
+    bool running = false, timedOut = false;
+    QVector<Result> testResults;
+    Runner *runner = nullptr;
+
+    Side currentSide() const;
+    int totalRuns() const;
+    void runNext();
+    void nextTest();
+    void finish();
+    int runTimeLimit() const;
+    static QVector<double> logRatios(const Result &result);
+};
+
+} // namespace Core
+
+#endif // PERFORMANCECOMPARISON_HPP
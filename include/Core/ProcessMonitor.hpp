@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2019-2020 Ashar Khan <ashar786khan@gmail.com>
+ *
+ * This file is part of CPEditor.
+ *
+ * CPEditor is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * I will not be responsible if CPEditor behaves in unexpected way and
+ * causes your ratings to go down and or loose any important contest.
+ *
+ * Believe Software is "Software" and it isn't immune to bugs.
+ *
+ */
+
+#ifndef PROCESSMONITOR_HPP
+#define PROCESSMONITOR_HPP
+
+#include <QElapsedTimer>
+#include <QProcess>
+#include <QTimer>
+
+namespace Core
+{
+
+struct ProcessStats
+{
+    int cpuTime = 0;                 // milliseconds of user + system time
+    qint64 cpuTimeMicroseconds = -1; // the same from the resource usage of the exited process, -1 if unknown
+    qint64 peakMemory = -1;          // bytes of peak resident memory, -1 if unknown
+    int startLatency = -1;           // microseconds from the start request to the running process, -1 if unknown
+
+    // the I/O of /proc/<pid>/io, including the pipes of stdin and stdout, and the context switches, -1 if unknown
+    qint64 bytesRead = -1, bytesWritten = -1;
+    qint64 readCalls = -1, writeCalls = -1;
+    qint64 voluntarySwitches = -1, involuntarySwitches = -1;
+
+    // the hardware counters of PerfCounters, -1 if unknown
+    qint64 instructions = -1, cycles = -1, cacheMisses = -1, branchMisses = -1;
+
+    // milliseconds of CPU time, with the precision of microseconds when it's known
+    double preciseCpuTime() const;
+    // many read and write syscalls for few bytes, e.g. unsynchronised iostreams or flushing after each character
+    bool isIOBound() const;
+    // a human-readable description of the I/O and the context switches, empty if they are unknown
+    QString ioSummary() const;
+    // instructions per cycle, 0 if unknown
+    double ipc() const;
+    // a human-readable description of the hardware counters, empty if they are unknown
+    QString countersSummary() const;
+};
+
+// ProcessMonitor samples the CPU time, the peak memory, the I/O and the context switches of a running QProcess from
+// /proc until it exits. It's only supported on Linux. QProcess reaps the process before it reports the exit, so the
+// last interval is not sampled, the runs which need the exact totals are started by the Launcher, which has them from
+// wait4(). On the other platforms, and when nothing could be read, the CPU time falls back to the wall time and the
+// rest is unknown.
+
+class ProcessMonitor : public QObject
+{
+    Q_OBJECT
+
+  public:
+    explicit ProcessMonitor(QProcess *process, QObject *parent = nullptr);
+    void start();
+    // stop sampling, it may be called more than once, e.g. on a timeout and when the killed process exits
+    void stop();
+    ProcessStats stats() const;
+    static bool isSupported();
+
+  private slots:
+    void sample();
+
+  private:
+    // the samples run on the GUI thread for every run, so they are not frequent, the precise CPU time of the judged
+    // runs comes from the Launcher
+    static const int SAMPLE_INTERVAL = 50;
+
+    QProcess *process;
+    QTimer *timer = nullptr;
+    QElapsedTimer wallTimer;
+    qint64 pid = 0;
+    bool sampled = false;
+    ProcessStats current;
+};
+
+} // namespace Core
+
+#endif // PROCESSMONITOR_HPP
@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2019-2020 Ashar Khan <ashar786khan@gmail.com>
+ *
+ * This file is part of CPEditor.
+ *
+ * CPEditor is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * I will not be responsible if CPEditor behaves in unexpected way and
+ * causes your ratings to go down and or loose any important contest.
+ *
+ * Believe Software is "Software" and it isn't immune to bugs.
+ *
+ */
+
+#ifndef RUNHISTORY_HPP
+#define RUNHISTORY_HPP
+
+#include <QFile>
+#include <QHash>
+#include <QObject>
+#include <QVector>
+
+namespace Core
+{
+
+// RunHistory keeps the results of all the runs in the config directory, so that the running time of a test can be
+// followed across the revisions of a solution. The runs are appended to a binary log, and an index maps the hash of
+// each test to the offsets of its runs in the log. The index is rebuilt from the log if it's missing or behind, e.g.
+// after a crash between the two writes. It's shared by all the tabs.
+
+class RunHistory : public QObject
+{
+    Q_OBJECT
+
+  public:
+    struct Record
+    {
+        qint64 timestamp = 0;   // milliseconds since the epoch
+        QByteArray sourceHash;  // the SHA-1 of the source and its compile command
+        QByteArray testHash;    // the SHA-1 of the input
+        QString profile;        // the build profile, empty for the languages without one
+        QString verdict;        // AC, WA, TLE, RE or OK if there's no expected output
+        int cpuTime = 0;        // milliseconds
+        qint64 peakMemory = -1; // bytes, -1 if unknown
+    };
+
+    static const int MAX_RECORDS_PER_QUERY = 1000;
+
+    static RunHistory *instance();
+    static QByteArray hash(const QString &text);
+
+    void append(const Record &record);
+    // the runs of a test, the oldest first, at most MAX_RECORDS_PER_QUERY of the latest ones
+    QVector<Record> records(const QByteArray &testHash);
+    // the CPU time of the last run of each revision, the oldest first, for the runs of a test with a build profile
+    static QVector<int> timesPerRevision(const QVector<Record> &records, const QString &profile, int limit);
+    static QString directory();
+
+  private:
+    explicit RunHistory(QObject *parent = nullptr);
+    bool open();
+    bool readRecord(QFile &file, Record &record);
+    void indexRecord(const QByteArray &testHash, qint64 offset);
+
+    QFile log, index;
+    bool opened = false, failed = false;
+    QHash<quint64, QVector<qint64>> offsets; // the first 8 bytes of the test hash -> the offsets of its runs
+};
+
+} // namespace Core
+
+#endif // RUNHISTORY_HPP
@@ -18,8 +18,17 @@
 #ifndef RUNNER_HPP
 #define RUNNER_HPP
 
+#include "Core/ChildProcess.hpp"
+#include "Core/ExecutorMessage.hpp"
+#include "Core/Launcher.hpp"
+#include "Core/PerfCounters.hpp"
+#include "Core/ProcessMonitor.hpp"
+#include "Core/Scheduler.hpp"
+#include "Core/StreamingComparator.hpp"
 #include <QElapsedTimer>
+#include <QList>
 #include <QProcess>
+#include <QTemporaryDir>
 #include <QTimer>
 
 namespace Core
@@ -30,32 +39,130 @@ class Runner : public QObject
     Q_OBJECT
 
   public:
+    // the streamed output is emitted at most once in STREAM_INTERVAL milliseconds, and at most its last STREAM_TAIL
+    // bytes, so that a chatty program doesn't flood the GUI
+    static const int STREAM_INTERVAL = 100;
+    static const int STREAM_TAIL = 64 * 1024;
+
     Runner(int index);
     ~Runner();
     void run(const QString &filePath, const QString &lang, const QString &runCommand, const QString &args,
              const QString &input, int timeLimit);
     void runDetached(const QString &filePath, const QString &lang, const QString &runCommand, const QString &args);
+    ProcessStats stats() const;
+    void setCpuAffinity(int core);
+
+    // the memory limit of the problem in bytes, 0 for none, it's reserved from the memory budget of the scheduler,
+    // and it limits the address space of a C++ program, the JVM and the interpreters reserve much more than they use
+    void setMemoryLimit(qint64 bytes);
+
+    // compare the output with the expected output while running, and kill the process at the first wrong token
+    void setExpectedOutput(const QString &expected);
+
+    // emit runOutputStreamed() with the new output while running
+    void setOutputStreaming(bool value);
+
+    // for the problems with file I/O, the program runs in a scratch directory of its own, where the input is written
+    // to the input file instead of stdin, and the output file is reported instead of stdout, an empty name keeps the
+    // standard stream
+    void setFileIO(const QString &inputFileName, const QString &outputFileName);
+
+    // a file name of setFileIO() must be a plain name without directories, an empty one is valid
+    static bool isValidFileIOName(const QString &name);
+    // the working directory of a run with file I/O, with the input written to the input file unless its name is empty,
+    // nullptr if it can't be created, it's removed when it's deleted
+    static QTemporaryDir *createScratchDirectory(const QString &inputFileName, const QString &input);
+
+    // the owner is the tab which started the run, the runs of the focused tab are scheduled first
+    void setScheduling(QObject *owner, Scheduler::Priority priority);
+
+    // an exclusive runner is not paused by pauseAll() and is not queued by the scheduler,
+    // it's used for the runs which need a quiet machine
+    void setExclusive(bool value);
+
+    // pause all the running non-exclusive runners, and the ones started later, until resumeAll() is called as many
+    // times as pauseAll(), only supported on Unix, the runs in the executor daemon are not paused
+    static void pauseAll();
+    static void resumeAll();
+
+    static QString getCommand(const QString &filePath, const QString &lang, const QString &runCommand,
+                              const QString &args);
 
   signals:
     void runStarted(int index);
-    void runFinished(int index, const QString &out, const QString &err, int exitCode, int timeUsed);
+    void runFinished(int index, const QByteArray &out, const QByteArray &err, int exitCode, int timeUsed);
     void runErrorOccured(int index, const QString &error);
     void runTimeout(int index);
     void runKilled(int index);
+    void runWrongAnswer(int index, const QString &message);
+    // chunk is the output since the previous signal, or its tail, total is the size of the whole output so far
+    void runOutputStreamed(int index, const QByteArray &chunk, qint64 total);
+    // the processes which were still running after the program exited, they have been killed
+    void runLeakedProcesses(int index, const QStringList &processes);
 
   private slots:
     void onFinished(int exitCode, QProcess::ExitStatus exitStatus);
     void onStarted();
     void onTimeout();
+    void onReadyReadStandardOutput();
+    void onStreamTimeout();
+    void onDetachedErrorOccurred(QProcess::ProcessError error);
+    void onTicketGranted();
+    void onLaunchedStarted();
+    void onLaunchedFinished(int exitCode, bool crashed);
+    void onLaunchedErrorOccurred(const QString &error);
+    void onRemoteJobStarted(quint64 job);
+    void onRemoteJobOutput(quint64 job, int channel, const QByteArray &data);
+    void onRemoteJobFinished(quint64 job, const Core::ExecutorMessage &result);
+    void onRemoteJobFailed(quint64 job, const QString &error);
 
   private:
     const int runnerIndex;
     QString runCommand;
-    QProcess *runProcess = nullptr;
+    ChildProcess *runProcess = nullptr;
     QTimer *killTimer = nullptr;
     QElapsedTimer *runTimer = nullptr;
+    ProcessMonitor *monitor = nullptr;
+    PerfCounters *counters = nullptr;
+    StreamingComparator *comparator = nullptr;
+    QByteArray output;
+    QTimer *streamTimer = nullptr;
+    int streamed = 0; // the size of the output which has been streamed
+    bool exclusive = false, paused = false;
+    int remainingTime = 0;
+    LaunchedProcess *launched = nullptr; // the process started by the launcher instead of runProcess
+    int startLatency = -1;
+    qint64 groupId = 0; // the process group of the run, 0 if it's not started or it's already torn down
+    SchedulerTicket *ticket = nullptr;
+    QPointer<QObject> owner;
+    Scheduler::Priority priority = Scheduler::Background;
+    QString pendingCommand, pendingInput; // the run waiting for the scheduler
+    int pendingTimeLimit = 0;
+    bool remote = false;
+    quint64 remoteJob = 0; // the running job of the executor daemon
+    QByteArray remoteError;
+    ProcessStats remoteStats;
+    QString inputFileName, outputFileName;
+    qint64 memoryLimit = 0;
+    QTemporaryDir *scratchDir = nullptr; // the working directory of a run with file I/O
+
+    static QList<Runner *> runners;
+    static int pauseDepth;
+
+    void pause();
+    void resume();
+    void start(const QString &command, const QString &input, int timeLimit);
+    void releaseTicket();
+    void stopStreaming();
+    bool isRunning() const;
+    void killProcess();
+    void reapProcessGroup();
+    void attachCounters(qint64 pid);
+    void runRemotely(const QString &command, const QString &input, const QString &workingDirectory, int timeLimit);
+    bool prepareScratchDirectory(const QString &input);
+    void collectOutputFile(QByteArray &error);
 
-    QString getCommand(const QString &filePath, const QString &lang, const QString &runCommand, const QString &args);
+    static QString scratchRoot();
 };
 
 } // namespace Core
@@ -0,0 +1,129 @@
+/*
+ * Copyright (C) 2019-2020 Ashar Khan <ashar786khan@gmail.com>
+ *
+ * This file is part of CPEditor.
+ *
+ * CPEditor is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * I will not be responsible if CPEditor behaves in unexpected way and
+ * causes your ratings to go down and or loose any important contest.
+ *
+ * Believe Software is "Software" and it isn't immune to bugs.
+ *
+ */
+
+#ifndef SAMPLINGPROFILER_HPP
+#define SAMPLINGPROFILER_HPP
+
+#include "Core/Scheduler.hpp"
+#include "Core/Symbolizer.hpp"
+#include <QElapsedTimer>
+#include <QHash>
+#include <QMap>
+#include <QProcess>
+#include <QTemporaryDir>
+#include <QTimer>
+#include <QVector>
+
+namespace Core
+{
+
+// SamplingProfiler runs a program on an input and samples its call stacks with perf_event_open(2). It uses the
+// task-clock software event, so it works without hardware counters as long as kernel.perf_event_paranoid allows
+// profiling the own processes. The samples are symbolized with addr2line, so the program should be compiled with -g
+// and with the frame pointers. The time spent in the shared libraries is attributed to their callers in the program.
+// The run waits for a CPU slot of the Scheduler. Only supported on Linux.
+
+class SamplingProfiler : public QObject
+{
+    Q_OBJECT
+
+  public:
+    struct Function
+    {
+        QString name;
+        int self = 0, total = 0; // the samples in the function itself, and in the function and its callees
+        int line = -1;           // the hottest line of the function in the source file, 0-based, -1 if not in it
+        QString location;        // the file and the line of the hottest sample of the function
+    };
+
+    struct Profile
+    {
+        int samples = 0, lost = 0;
+        int timeUsed = 0;
+        bool timedOut = false;
+        QMap<int, int> lines; // the samples of each line of the source file, 0-based
+        QVector<Function> functions;
+    };
+
+    static const int SAMPLE_FREQUENCY = 2000; // samples per second of CPU time
+    static const int DRAIN_INTERVAL = 20;     // milliseconds between the reads of the sample buffer
+
+    explicit SamplingProfiler(QObject *parent = nullptr);
+    ~SamplingProfiler();
+    // the file I/O of the problem, see Runner::setFileIO(), the output file is not read
+    void setFileIO(const QString &inputFileName, const QString &outputFileName);
+    // the run is stopped after the time limit, and the samples until then are still reported
+    void start(const QString &binaryPath, const QString &sourcePath, const QString &input, int timeLimit);
+    void stop();
+    bool isRunning() const;
+    Profile profile() const;
+
+    static bool isSupported();
+
+  signals:
+    void statusChanged(const QString &status);
+    void profilingFinished();
+    void errorOccured(const QString &error);
+
+  private slots:
+    void onTicketGranted();
+    void onStarted();
+    void onFinished(int exitCode, QProcess::ExitStatus exitStatus);
+    void onErrorOccurred(QProcess::ProcessError error);
+    void onTimeout();
+    void drain();
+    void onSymbolized();
+    void onSymbolizerErrorOccured(const QString &error);
+
+  private:
+    struct Mapping
+    {
+        quint64 start, end;
+    };
+
+    QString binaryPath, sourcePath;
+    QString inputFileName, outputFileName;
+    QByteArray input;
+    int timeLimit = 0;
+    bool running = false;
+    QProcess *process = nullptr;
+    QTemporaryDir *scratchDir = nullptr; // the working directory of a run with file I/O
+    Symbolizer *symbolizer = nullptr;
+    QTimer *drainTimer = nullptr, *killTimer = nullptr;
+    QElapsedTimer runTimer;
+
+    int perfFd = -1;
+    void *buffer = nullptr;
+    QVector<Mapping> mappings;
+    quint64 loadBias = 0;
+
+    QHash<QVector<quint64>, int> stacks; // the addresses in the binary of each sampled stack, the innermost first
+    Profile result;
+
+    bool attach(qint64 pid);
+    void detach();
+    void readMappings(qint64 pid);
+    void addSample(const quint64 *ips, quint64 count);
+    void symbolize();
+    void aggregate();
+    void fail(const QString &error);
+    bool isSourceFile(const QString &file) const;
+};
+
+} // namespace Core
+
+#endif // SAMPLINGPROFILER_HPP
@@ -0,0 +1,43 @@
+/*
+ * Copyright (C) 2019-2020 Ashar Khan <ashar786khan@gmail.com>
+ *
+ * This file is part of CPEditor.
+ *
+ * CPEditor is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * I will not be responsible if CPEditor behaves in unexpected way and
+ * causes your ratings to go down and or loose any important contest.
+ *
+ * Believe Software is "Software" and it isn't immune to bugs.
+ *
+ */
+
+#ifndef SANITIZERREPORT_HPP
+#define SANITIZERREPORT_HPP
+
+#include <QString>
+
+namespace Core
+{
+
+// SanitizerReport finds the reports of AddressSanitizer, UndefinedBehaviorSanitizer and the other sanitizers of GCC
+// and Clang in the stderr of a run.
+
+struct SanitizerReport
+{
+    QString summary; // a line such as "AddressSanitizer: heap-buffer-overflow sol.cpp:12 in main", empty if clean
+    QString details; // the reports as printed, truncated to MAX_DETAILS characters
+    int errors = 0;  // the number of reports, UndefinedBehaviorSanitizer goes on after each error
+
+    static const int MAX_DETAILS = 4000;
+
+    bool isEmpty() const;
+    static SanitizerReport parse(const QString &err);
+};
+
+} // namespace Core
+
+#endif // SANITIZERREPORT_HPP
@@ -0,0 +1,120 @@
+/*
+ * Copyright (C) 2019-2020 Ashar Khan <ashar786khan@gmail.com>
+ *
+ * This file is part of CPEditor.
+ *
+ * CPEditor is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * I will not be responsible if CPEditor behaves in unexpected way and
+ * causes your ratings to go down and or loose any important contest.
+ *
+ * Believe Software is "Software" and it isn't immune to bugs.
+ *
+ */
+
+#ifndef SCHEDULER_HPP
+#define SCHEDULER_HPP
+
+#include <QList>
+#include <QPointer>
+
+namespace Core
+{
+
+class Scheduler;
+
+// SchedulerTicket is a place in the queue of the Scheduler. granted() is emitted when the job may start, and the
+// resources are given back when the ticket is destroyed.
+
+class SchedulerTicket : public QObject
+{
+    Q_OBJECT
+
+  public:
+    ~SchedulerTicket();
+    bool isGranted() const;
+
+  signals:
+    void granted();
+
+  private:
+    friend class Scheduler;
+
+    SchedulerTicket(Scheduler *scheduler, QObject *owner, int priority, qint64 memory, int processes,
+                    quint64 sequence, QObject *parent);
+
+    QPointer<Scheduler> scheduler;
+    QPointer<QObject> owner;
+    int priority;
+    qint64 memory;
+    int processes;
+    quint64 sequence;
+    bool isStarted = false;
+};
+
+// Scheduler limits the compile and run jobs of all the tabs by a CPU budget, the number of the jobs running at the
+// same time, and a memory budget, the sum of the memory the running jobs may use. The interactive jobs of the focused
+// tab go first, then the interactive jobs of the other tabs, then the background jobs. It's owned by the AppWindow.
+
+class Scheduler : public QObject
+{
+    Q_OBJECT
+
+  public:
+    enum Priority
+    {
+        Interactive, // started by the user and waited for, e.g. compile and run
+        Background   // e.g. stress tests and measurements
+    };
+
+    explicit Scheduler(QObject *parent = nullptr);
+    ~Scheduler();
+
+    // the scheduler of the application, nullptr if there's none, in which case the jobs start immediately
+    static Scheduler *current();
+
+    // 0 for the automatic budgets: all the CPU cores but one, and three quarters of the physical memory
+    void setBudget(int cpuSlots, qint64 memoryBytes);
+    int cpuBudget() const;
+    qint64 memoryBudget() const; // 0 if unknown, then only the CPU budget is applied
+
+    void setFocusedOwner(QObject *owner);
+
+    // the job may start when the returned ticket is granted, the memory should be an upper bound of the memory the job
+    // uses, a job of several processes running at the same time takes a CPU slot for each of them, the ticket is
+    // deleted with the parent
+    SchedulerTicket *request(QObject *owner, Priority priority, qint64 memory, QObject *parent, int processes = 1);
+
+    int runningJobs() const; // the CPU slots in use
+    int queuedJobs() const;
+    qint64 memoryInUse() const;
+
+    static const qint64 DEFAULT_RUN_MEMORY = 256 * 1024 * 1024;
+    static const qint64 DEFAULT_COMPILE_MEMORY = 512 * 1024 * 1024;
+
+  signals:
+    void statusChanged();
+
+  private:
+    friend class SchedulerTicket;
+
+    void release(SchedulerTicket *ticket);
+    void dispatch();
+    int rank(const SchedulerTicket *ticket) const;
+    static qint64 physicalMemory();
+
+    QList<SchedulerTicket *> queue, running;
+    QPointer<QObject> focusedOwner;
+    int cpuSlots = 1, usedSlots = 0;
+    qint64 memoryBytes = 0, memoryUsed = 0;
+    quint64 lastSequence = 0;
+
+    static Scheduler *instance;
+};
+
+} // namespace Core
+
+#endif // SCHEDULER_HPP
@@ -19,9 +19,11 @@
 #define SETTINGSMANAGER_HPP
 
 #include <QKeySequence>
+#include <QMap>
 #include <QRect>
 #include <QSettings>
 #include <QString>
+#include <QStringList>
 #include <string>
 
 #define SETTINGS_FILE "cp_editor_settings.ini"
@@ -41,6 +43,8 @@ struct SettingsData
     int companionPort;
     int tabStop;
     int timeLimit;
+    int regressionThreshold; // the slowdown in percent which is warned about, 0 to disable
+    double judgeSpeedFactor; // how many times slower the online judge is than this machine
 
     QRect geometry;
     QString font;
@@ -60,6 +64,9 @@ struct SettingsData
     QString compileCommandJava;
     QString compileCommandCpp;
 
+    QString buildProfile;              // the build profile of the normal C++ compilations
+    QMap<QString, QString> buildFlags; // the options of each build profile, appended to compileCommandCpp
+
     QString runCommandJava;
     QString runCommandPython;
 
@@ -78,6 +85,9 @@ struct SettingsData
     bool isCheckUpdateOnStartup;
     bool isUpdateCheckOnStartup;
     bool isFormatOnSave;
+    bool isStopAtFirstWrongAnswer;
+    bool isUseExecutor;
+    bool isHardwareCounters;
 
     QKeySequence hotkeyRun;
     QKeySequence hotkeyCompile;
@@ -91,8 +101,18 @@ struct SettingsData
     QByteArray splitterSizes;
 
     QString cfPath;
+    QString executorSession;
 };
 
+// the names of the build profiles, each profile is a set of options appended to the C++ compile command
+QStringList buildProfiles();
+// the C++ compile command of a build profile, the chosen build profile if the profile is empty
+QString compileCommandCpp(const SettingsData &data, const QString &profile = QString());
+// the time limit on this machine which is equivalent to a time limit on the judge
+int localTimeLimit(const SettingsData &data, int judgeTimeLimit);
+// the time on the judge which is equivalent to a time on this machine
+int judgeTime(const SettingsData &data, int localTime);
+
 class SettingManager
 {
   public:
@@ -107,6 +127,21 @@ class SettingManager
     int getTimeLimit();
     void setTimeLimit(int ms);
 
+    int getParallelJobs();
+    void setParallelJobs(int jobs);
+
+    int getMemoryBudget();
+    void setMemoryBudget(int megabytes);
+
+    int getRegressionThreshold();
+    void setRegressionThreshold(int percent);
+
+    double getJudgeSpeedFactor();
+    void setJudgeSpeedFactor(double factor);
+    // the calibration timings of this machine ("local") or of the judge ("judge"), 0 if unknown
+    double getCalibrationTime(const QString &machine, const QString &program);
+    void setCalibrationTime(const QString &machine, const QString &program, double time);
+
     QRect getGeometry();
     void setGeometry(const QRect &);
 
@@ -140,6 +175,11 @@ class SettingManager
     void setCompileCommandsCpp(const QString &command);
     void setCompileCommandsJava(const QString &command);
 
+    QString getBuildProfile();
+    void setBuildProfile(const QString &profile);
+    QString getBuildFlags(const QString &profile);
+    void setBuildFlags(const QString &profile, const QString &flags);
+
     QString getRunCommandJava();
     QString getRunCommandPython();
     void setRunCommandJava(const QString &command);
@@ -190,6 +230,15 @@ class SettingManager
     bool isFormatOnSave();
     void formatOnSave(bool value);
 
+    bool isStopAtFirstWrongAnswer();
+    void setStopAtFirstWrongAnswer(bool value);
+
+    bool isUseExecutor();
+    void setUseExecutor(bool value);
+
+    bool isHardwareCounters();
+    void setHardwareCounters(bool value);
+
     int getTransparency();
     void setTransparency(int val);
 
@@ -233,6 +282,8 @@ class SettingManager
     QString getCFPath();
     void setCFPath(const QString &path);
 
+    QString getExecutorSession();
+
     void resetSettings();
 
     SettingsData toData();
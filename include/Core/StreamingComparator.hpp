@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2019-2020 Ashar Khan <ashar786khan@gmail.com>
+ *
+ * This file is part of CPEditor.
+ *
+ * CPEditor is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * I will not be responsible if CPEditor behaves in unexpected way and
+ * causes your ratings to go down and or loose any important contest.
+ *
+ * Believe Software is "Software" and it isn't immune to bugs.
+ *
+ */
+
+#ifndef STREAMINGCOMPARATOR_HPP
+#define STREAMINGCOMPARATOR_HPP
+
+#include <QByteArray>
+#include <QString>
+
+namespace Core
+{
+
+// StreamingComparator compares an output with the expected output token by token while the output is still being
+// produced, so that a run can be stopped as soon as the answer is certainly wrong. The tokens are separated by any
+// whitespace, which is looser than Checker::isSameOutput(), so a mismatch here always means a wrong answer there,
+// while matching tokens still need the full comparison after the run.
+
+class StreamingComparator
+{
+  public:
+    explicit StreamingComparator(const QString &expected);
+    // returns false as soon as the output can't match the expected output anymore
+    bool feed(const QByteArray &chunk);
+    // returns false if the output ended before the expected output
+    bool finish();
+    bool hasMismatch() const;
+    // the position and the tokens of the first mismatch
+    QString mismatchMessage() const;
+
+  private:
+    QByteArray expected;
+    int expectedPosition = 0;   // the start of the next expected token
+    QByteArray current;         // the incomplete output token
+    int line = 1, column = 1;   // the position in the output
+    int tokenLine = 1, tokenColumn = 1;
+    qint64 tokenIndex = 0;
+    bool mismatch = false;
+    QString message;
+
+    bool nextExpectedToken(int &begin, int &end) const;
+    void compareToken(bool complete);
+    void setMismatch(const QString &reason);
+    static bool isSpace(char c);
+};
+
+} // namespace Core
+
+#endif // STREAMINGCOMPARATOR_HPP
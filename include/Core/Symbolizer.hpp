@@ -0,0 +1,64 @@
+/*
+ * Copyright (C) 2019-2020 Ashar Khan <ashar786khan@gmail.com>
+ *
+ * This file is part of CPEditor.
+ *
+ * CPEditor is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * I will not be responsible if CPEditor behaves in unexpected way and
+ * causes your ratings to go down and or loose any important contest.
+ *
+ * Believe Software is "Software" and it isn't immune to bugs.
+ *
+ */
+
+#ifndef SYMBOLIZER_HPP
+#define SYMBOLIZER_HPP
+
+#include <QMap>
+#include <QProcess>
+#include <QVector>
+
+namespace Core
+{
+
+// Symbolizer maps the addresses of an executable to the functions and the source lines with addr2line of binutils.
+// The file and the line are only known if the executable is compiled with -g, the function is known unless it's
+// stripped.
+
+class Symbolizer : public QObject
+{
+    Q_OBJECT
+
+  public:
+    struct Frame
+    {
+        QString function, file; // "??" if unknown
+        int line = 0;           // 1-based, 0 if unknown
+    };
+
+    explicit Symbolizer(QObject *parent = nullptr);
+    ~Symbolizer();
+    void start(const QString &binaryPath, const QList<quint64> &addresses);
+    // the inlined frames of an address, the innermost first, empty if it's not symbolized
+    QVector<Frame> frames(quint64 address) const;
+
+  signals:
+    void finished();
+    void errorOccured(const QString &error);
+
+  private slots:
+    void onFinished(int exitCode, QProcess::ExitStatus exitStatus);
+    void onErrorOccurred(QProcess::ProcessError error);
+
+  private:
+    QProcess *process = nullptr;
+    QMap<quint64, QVector<Frame>> symbols;
+};
+
+} // namespace Core
+
+#endif // SYMBOLIZER_HPP
@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2019-2020 Ashar Khan <ashar786khan@gmail.com>
+ *
+ * This file is part of CPEditor.
+ *
+ * CPEditor is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * I will not be responsible if CPEditor behaves in unexpected way and
+ * causes your ratings to go down and or loose any important contest.
+ *
+ * Believe Software is "Software" and it isn't immune to bugs.
+ *
+ */
+
+#ifndef TLEHUNTER_HPP
+#define TLEHUNTER_HPP
+
+#include "Core/Generator.hpp"
+#include "Core/Runner.hpp"
+#include <QMap>
+#include <QVector>
+
+namespace Core
+{
+
+// TLEHunter searches for the inputs on which a solution runs the slowest. It runs a generator with parameters in the
+// given bounds, runs the solution on the generated inputs in parallel, and keeps the slowest ones. The first part of
+// the budget samples the parameters randomly, the rest of it mutates the slowest parameters found so far.
+
+class TLEHunter : public QObject
+{
+    Q_OBJECT
+
+  public:
+    struct Parameters
+    {
+        qint64 n = 1;
+        qint64 minValue = 1;
+        qint64 maxValue = 1;
+        quint32 seed = 0;
+
+        QMap<QString, QString> toMap() const;
+        QString toString() const;
+    };
+
+    struct Result
+    {
+        Parameters parameters;
+        QString input;
+        ProcessStats stats;
+        int exitCode = 0;
+        bool timedOut = false;
+    };
+
+    TLEHunter(const QString &filePath, const QString &lang, const QString &runCommand, const QString &args,
+              int timeLimit, QObject *parent = nullptr);
+    ~TLEHunter();
+
+    // the file I/O of the problem, see Runner::setFileIO()
+    void setFileIO(const QString &inputFileName, const QString &outputFileName);
+    void start(const QString &generatorCommand, const Parameters &lowerBound, const Parameters &upperBound,
+               int iterations, int parallel);
+    void stop();
+    bool isRunning() const;
+    QVector<Result> worstResults() const;
+
+    static const int NUMBER_OF_KEPT_RESULTS = 10;
+
+  signals:
+    void progress(int finished, int total);
+    void worstResultsChanged();
+    void huntFinished();
+    void errorOccured(const QString &error);
+
+  private slots:
+    void onGenerated(int index, const QString &input);
+    void onGenerationFailed(int index, const QString &error);
+    void onRunFinished(int index, const QByteArray &out, const QByteArray &err, int exitCode, int timeUsed);
+    void onRunErrorOccured(int index, const QString &error);
+    void onRunTimeout(int index);
+
+  private:
+    struct Job
+    {
+        Parameters parameters;
+        QString input;
+        Generator *generator = nullptr;
+        Runner *runner = nullptr;
+        bool timedOut = false;
+    };
+
+    QString filePath, lang, runCommand, args;
+    QString inputFileName, outputFileName;
+    int timeLimit;
+    QString generatorCommand;
+    Parameters lowerBound, upperBound;
+    int iterations = 0, parallel = 1, launched = 0, finished = 0;
+    bool running = false;
+    QMap<int, Job> jobs;
+    QVector<Result> results;
+
+    void launchJobs();
+    void finishJob(int index);
+    Parameters nextParameters();
+    Parameters randomParameters();
+    Parameters mutate(const Parameters &parameters);
+    int runTimeLimit() const;
+};
+
+} // namespace Core
+
+#endif // TLEHUNTER_HPP
@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2019-2020 Ashar Khan <ashar786khan@gmail.com>
+ *
+ * This file is part of CPEditor.
+ *
+ * CPEditor is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * I will not be responsible if CPEditor behaves in unexpected way and
+ * causes your ratings to go down and or loose any important contest.
+ *
+ * Believe Software is "Software" and it isn't immune to bugs.
+ *
+ */
+
+#ifndef TOOLCHAIN_HPP
+#define TOOLCHAIN_HPP
+
+#include <QMap>
+#include <QProcess>
+#include <QStringList>
+
+class QTemporaryDir;
+
+namespace Core
+{
+
+// Toolchain checks whether the external tools (compilers, interpreters, clang-format, cf, xterm) work. The checks
+// run asynchronously, and their results are cached by the command, the options, and the path and the modification
+// time of the executable, so a tool is probed again only when the settings or the executable change. It's shared by
+// all the tabs.
+
+class Toolchain : public QObject
+{
+    Q_OBJECT
+
+  public:
+    enum Tool
+    {
+        Compiler, // also used for the run commands of Java and Python, which accept --version or -version
+        Formatter,
+        CFTools,
+        Terminal
+    };
+
+    enum Status
+    {
+        Unknown, // being probed, probeFinished() will be emitted
+        Available,
+        Unavailable
+    };
+
+    static Toolchain *instance();
+
+    // returns the cached status if it's up to date, otherwise starts a probe and returns Unknown, options is the
+    // style for the formatter and is ignored by the other tools
+    Status probe(Tool tool, const QString &command, const QString &options = QString());
+
+  signals:
+    void probeFinished(int tool, const QString &command, const QString &options, bool available);
+
+  private slots:
+    void onProcessFinished(int exitCode, QProcess::ExitStatus exitStatus);
+    void onProcessErrorOccurred(QProcess::ProcessError error);
+
+  private:
+    struct Entry
+    {
+        Status status = Unknown;
+        QString executable;
+        qint64 modified = 0;
+    };
+
+    struct Probe
+    {
+        Tool tool = Compiler;
+        QString command, options, key;
+        QString executable;
+        qint64 modified = 0;
+        QList<QStringList> attempts; // program and arguments, the tool is available if any of them succeeds
+        QTemporaryDir *tmpDir = nullptr;
+    };
+
+    explicit Toolchain(QObject *parent = nullptr);
+    ~Toolchain();
+    void startAttempt(Probe probe);
+    void finishAttempt(QProcess *process, bool success);
+
+    static QString key(Tool tool, const QString &command, const QString &options);
+    static QString findExecutable(const QString &program);
+
+    QMap<QString, Entry> cache;
+    QMap<QProcess *, Probe> probes;
+
+    static const int PROBE_TIME_LIMIT = 2000;
+};
+
+} // namespace Core
+
+#endif // TOOLCHAIN_HPP
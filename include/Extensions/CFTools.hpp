@@ -33,7 +33,6 @@ class CFTools : public QObject
     CFTools(QString path, MessageLogger *logger);
     ~CFTools();
     void submit(const QString &filePath, const QString &url, const QString &lang);
-    static bool check(QString path);
 
     void updatePath(QString p);
   private slots:
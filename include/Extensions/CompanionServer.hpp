@@ -45,6 +45,7 @@ struct CompanionData
     int timeLimit;
     bool isInputstdin;
     bool isOutputstdout;
+    QString inputFileName, outputFileName; // empty for the standard streams
     QVector<TestCases> testcases;
 
     QString toMetaString()
@@ -55,6 +56,10 @@ struct CompanionData
         ans += "URL : " + url + "\n";
         ans += "Memory Limit : " + QString::number(memoryLimit) + " MB\n";
         ans += "Time Limit : " + QString::number(timeLimit) + " ms\n";
+        if (!inputFileName.isEmpty())
+            ans += "Input File : " + inputFileName + "\n";
+        if (!outputFileName.isEmpty())
+            ans += "Output File : " + outputFileName + "\n";
         return ans;
     }
 };
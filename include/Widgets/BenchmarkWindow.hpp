@@ -0,0 +1,58 @@
+/*
+ * Copyright (C) 2019-2020 Ashar Khan <ashar786khan@gmail.com>
+ *
+ * This file is part of CPEditor.
+ *
+ * CPEditor is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * I will not be responsible if CPEditor behaves in unexpected way and
+ * causes your ratings to go down and or loose any important contest.
+ *
+ * Believe Software is "Software" and it isn't immune to bugs.
+ *
+ */
+
+#ifndef BENCHMARKWINDOW_HPP
+#define BENCHMARKWINDOW_HPP
+
+#include "Core/Benchmark.hpp"
+#include <QMainWindow>
+#include <QProgressBar>
+#include <QPushButton>
+#include <QSpinBox>
+#include <QTableWidget>
+
+class BenchmarkWindow : public QMainWindow
+{
+    Q_OBJECT
+
+  public:
+    explicit BenchmarkWindow(QWidget *parent = nullptr);
+    void setTarget(const QString &filePath, const QString &lang, const QString &runCommand, const QString &args,
+                   int timeLimit, const QStringList &inputs);
+    // the file I/O of the problem, it's applied to the target set by setTarget()
+    void setFileIO(const QString &inputFileName, const QString &outputFileName);
+
+  private slots:
+    void on_startButton_clicked();
+    void onProgress(int finished, int total);
+    void onResultChanged(int index);
+    void onBenchmarkFinished();
+
+  private:
+    Core::Benchmark *benchmark = nullptr;
+    QStringList inputs;
+
+    QSpinBox *runsSpin = nullptr, *warmUpSpin = nullptr, *coreSpin = nullptr;
+    QPushButton *startButton = nullptr;
+    QProgressBar *progressBar = nullptr;
+    QTableWidget *resultsTable = nullptr;
+
+    static QString formatTime(double time);
+    static QString formatCount(double count);
+};
+
+#endif // BENCHMARKWINDOW_HPP
@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2019-2020 Ashar Khan <ashar786khan@gmail.com>
+ *
+ * This file is part of CPEditor.
+ *
+ * CPEditor is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * I will not be responsible if CPEditor behaves in unexpected way and
+ * causes your ratings to go down and or loose any important contest.
+ *
+ * Believe Software is "Software" and it isn't immune to bugs.
+ *
+ */
+
+
+#ifndef CALIBRATIONDIALOG_HPP
+#define CALIBRATIONDIALOG_HPP
+
+#include "Core/Calibration.hpp"
+#include "Core/SettingsManager.hpp"
+#include <QDialog>
+#include <QDoubleSpinBox>
+#include <QLabel>
+#include <QPushButton>
+#include <QTableWidget>
+
+// CalibrationDialog measures the calibration programs on this machine and takes their timings on the judge, which
+// give the judge speed factor
+
+class CalibrationDialog : public QDialog
+{
+    Q_OBJECT
+
+  public:
+    CalibrationDialog(Settings::SettingManager *manager, const QString &compileCommand, QWidget *parent = nullptr);
+    // the judge speed factor given by the timings, 0 if it's unknown
+    double speedFactor() const;
+
+  public slots:
+    void accept() override;
+
+  private slots:
+    void on_measureButton_clicked();
+    void on_copyButton_clicked();
+    void onProgramStarted(const QString &program);
+    void onProgramMeasured(const QString &program, double time);
+    void onCalibrationFinished();
+    void onErrorOccured(const QString &error);
+    void updateFactor();
+
+  private:
+    Settings::SettingManager *manager;
+    QString compileCommand;
+    Core::Calibration *calibration = nullptr;
+    QMap<QString, double> localTimes;
+
+    QTableWidget *table = nullptr;
+    QVector<QDoubleSpinBox *> judgeSpins;
+    QPushButton *measureButton = nullptr, *copyButton = nullptr;
+    QLabel *factorLabel = nullptr;
+
+    QMap<QString, double> judgeTimes() const;
+};
+
+#endif // CALIBRATIONDIALOG_HPP
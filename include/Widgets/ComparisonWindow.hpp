@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2019-2020 Ashar Khan <ashar786khan@gmail.com>
+ *
+ * This file is part of CPEditor.
+ *
+ * CPEditor is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * I will not be responsible if CPEditor behaves in unexpected way and
+ * causes your ratings to go down and or loose any important contest.
+ *
+ * Believe Software is "Software" and it isn't immune to bugs.
+ *
+ */
+
+#ifndef COMPARISONWINDOW_HPP
+#define COMPARISONWINDOW_HPP
+
+#include "Core/PerformanceComparison.hpp"
+#include <QLabel>
+#include <QMainWindow>
+#include <QProgressBar>
+#include <QPushButton>
+#include <QSpinBox>
+#include <QTableWidget>
+
+class ComparisonWindow : public QMainWindow
+{
+    Q_OBJECT
+
+  public:
+    explicit ComparisonWindow(QWidget *parent = nullptr);
+    void setTargets(const Core::PerformanceComparison::Target &baseline, const QString &baselineName,
+                    const Core::PerformanceComparison::Target &current, int timeLimit, const QStringList &inputs,
+                    const QStringList &expected);
+
+  private slots:
+    void on_startButton_clicked();
+    void onProgress(int finished, int total);
+    void onResultChanged(int index);
+    void onComparisonFinished();
+
+  private:
+    Core::PerformanceComparison *comparison = nullptr;
+    QString baselineName;
+    QStringList inputs, expected;
+
+    QSpinBox *roundsSpin = nullptr, *coreSpin = nullptr;
+    QPushButton *startButton = nullptr;
+    QProgressBar *progressBar = nullptr;
+    QTableWidget *resultsTable = nullptr;
+    QLabel *summaryLabel = nullptr;
+
+    void updateSummary();
+    static QString formatTime(double time);
+    static QString formatRatio(double ratio);
+    static QString outputStatus(const Core::PerformanceComparison::Result &result);
+};
+
+#endif // COMPARISONWINDOW_HPP
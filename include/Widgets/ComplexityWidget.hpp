@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2019-2020 Ashar Khan <ashar786khan@gmail.com>
+ *
+ * This file is part of CPEditor.
+ *
+ * CPEditor is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * I will not be responsible if CPEditor behaves in unexpected way and
+ * causes your ratings to go down and or loose any important contest.
+ *
+ * Believe Software is "Software" and it isn't immune to bugs.
+ *
+ */
+
+#ifndef COMPLEXITYWIDGET_HPP
+#define COMPLEXITYWIDGET_HPP
+
+#include "Core/ComplexityProfiler.hpp"
+#include "Widgets/LineChart.hpp"
+#include <QLabel>
+#include <QLineEdit>
+#include <QPushButton>
+#include <QSpinBox>
+
+class ComplexityWidget : public QWidget
+{
+    Q_OBJECT
+
+  public:
+    explicit ComplexityWidget(QWidget *parent = nullptr);
+    void setTarget(const QString &filePath, const QString &lang, const QString &runCommand, const QString &args,
+                   int timeLimit);
+    // the file I/O of the problem, it's applied to the target set by setTarget()
+    void setFileIO(const QString &inputFileName, const QString &outputFileName);
+    void setGeneratorCommand(const QString &command);
+
+  signals:
+    void generatorCommandChanged(const QString &command);
+
+  private slots:
+    void on_startButton_clicked();
+    void on_closeButton_clicked();
+    void onSampleMeasured(qint64 n, int cpuTime, bool timedOut);
+    void onProfilingFinished();
+    void onErrorOccured(const QString &error);
+
+  private:
+    Core::ComplexityProfiler *profiler = nullptr;
+    int timeLimit = 0;
+    qint64 maxN = 0;
+
+    QLineEdit *generatorEdit = nullptr, *minNEdit = nullptr, *maxNEdit = nullptr, *limitNEdit = nullptr;
+    QSpinBox *stepsSpin = nullptr, *repetitionsSpin = nullptr;
+    QPushButton *startButton = nullptr, *closeButton = nullptr;
+    LineChart *chart = nullptr;
+    QLabel *verdictLabel = nullptr;
+
+    void updateChart(bool withFit);
+    QString verdict() const;
+    static QString formatPrediction(double milliseconds);
+};
+
+#endif // COMPLEXITYWIDGET_HPP
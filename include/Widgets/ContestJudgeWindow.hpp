@@ -0,0 +1,57 @@
+/*
+ * Copyright (C) 2019-2020 Ashar Khan <ashar786khan@gmail.com>
+ *
+ * This file is part of CPEditor.
+ *
+ * CPEditor is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * I will not be responsible if CPEditor behaves in unexpected way and
+ * causes your ratings to go down and or loose any important contest.
+ *
+ * Believe Software is "Software" and it isn't immune to bugs.
+ *
+ */
+
+#ifndef CONTESTJUDGEWINDOW_HPP
+#define CONTESTJUDGEWINDOW_HPP
+
+#include "mainwindow.hpp"
+#include <QLabel>
+#include <QMainWindow>
+#include <QPointer>
+#include <QTableWidget>
+
+// ContestJudgeWindow judges all the given tabs at once and shows the results as a matrix of the problems and the
+// tests. Clicking a test opens its diff, clicking a problem switches to its tab.
+
+class ContestJudgeWindow : public QMainWindow
+{
+    Q_OBJECT
+
+  public:
+    explicit ContestJudgeWindow(QWidget *parent = nullptr);
+    void judge(const QVector<MainWindow *> &tabs);
+
+  signals:
+    void tabRequested(MainWindow *window);
+
+  private slots:
+    void onJudgeUpdated(MainWindow *window);
+    void onCellClicked(int row, int column);
+
+  private:
+    QList<QPointer<MainWindow>> windows;
+    QTableWidget *matrix = nullptr;
+    QLabel *summaryLabel = nullptr;
+
+    void updateRow(int row);
+    void updateSummary();
+    static QString problemVerdict(const QVector<MainWindow::JudgeResult> &results, bool judging);
+    static QColor verdictColor(const QString &verdict);
+    static QString formatMemory(qint64 bytes);
+};
+
+#endif // CONTESTJUDGEWINDOW_HPP
@@ -0,0 +1,60 @@
+/*
+ * Copyright (C) 2019-2020 Ashar Khan <ashar786khan@gmail.com>
+ *
+ * This file is part of CPEditor.
+ *
+ * CPEditor is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * I will not be responsible if CPEditor behaves in unexpected way and
+ * causes your ratings to go down and or loose any important contest.
+ *
+ * Believe Software is "Software" and it isn't immune to bugs.
+ *
+ */
+
+#ifndef HEATGUTTER_HPP
+#define HEATGUTTER_HPP
+
+#include <QTextEdit>
+#include <QVector>
+#include <QWidget>
+
+// HeatGutter is a strip next to a code editor, which shows the share of each line in a profile, or the execution count
+// of each line, as a colored bar and a number. It follows the scrolling of the editor, and it's hidden when there's no
+// profile.
+
+class HeatGutter : public QWidget
+{
+    Q_OBJECT
+
+  public:
+    explicit HeatGutter(QTextEdit *editor, QWidget *parent = nullptr);
+    // the fraction of the samples of each line, indexed by the 0-based line number
+    void setHeat(const QVector<double> &heat);
+    // the execution count of each line, colored in the log scale, negative for the lines without code
+    void setCounts(const QVector<qint64> &counts);
+    QSize sizeHint() const override;
+
+  public slots:
+    void clear();
+
+  protected:
+    void paintEvent(QPaintEvent *event) override;
+    bool event(QEvent *event) override;
+
+  private:
+    QTextEdit *editor;
+    QVector<double> heat;
+    QVector<qint64> counts; // empty unless the heat is made of the execution counts
+    double maxHeat = 0;
+
+    // the top and the bottom of a line in the coordinates of the gutter
+    QPair<int, int> lineRange(int line) const;
+    int lineAt(int y) const;
+    QString label(int line) const;
+};
+
+#endif // HEATGUTTER_HPP
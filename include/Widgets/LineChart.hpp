@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2019-2020 Ashar Khan <ashar786khan@gmail.com>
+ *
+ * This file is part of CPEditor.
+ *
+ * CPEditor is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * I will not be responsible if CPEditor behaves in unexpected way and
+ * causes your ratings to go down and or loose any important contest.
+ *
+ * Believe Software is "Software" and it isn't immune to bugs.
+ *
+ */
+
+#ifndef LINECHART_HPP
+#define LINECHART_HPP
+
+#include <QColor>
+#include <QPointF>
+#include <QVector>
+#include <QWidget>
+
+// A minimal line chart painted with QPainter, so that the editor doesn't depend on the Qt Charts module
+
+class LineChart : public QWidget
+{
+    Q_OBJECT
+
+  public:
+    struct Series
+    {
+        QString name;
+        QVector<QPointF> points;
+        QColor color = Qt::blue;
+        bool markers = false;
+        bool dashed = false;
+    };
+
+    struct Marker
+    {
+        double value = 0;
+        QString label;
+        QColor color = Qt::red;
+    };
+
+    explicit LineChart(QWidget *parent = nullptr);
+    void setSeries(const QVector<Series> &series);
+    void setMarkers(const QVector<Marker> &markers);
+    void setAxisTitles(const QString &x, const QString &y);
+    void setLogScale(bool x, bool y);
+    void clear();
+    QSize sizeHint() const override;
+
+  protected:
+    void paintEvent(QPaintEvent *event) override;
+
+  private:
+    QVector<Series> series;
+    QVector<Marker> markers;
+    QString xTitle, yTitle;
+    bool logX = false, logY = false;
+
+    double transformX(double x) const;
+    double transformY(double y) const;
+    static QString formatValue(double value);
+};
+
+#endif // LINECHART_HPP
@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2019-2020 Ashar Khan <ashar786khan@gmail.com>
+ *
+ * This file is part of CPEditor.
+ *
+ * CPEditor is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * I will not be responsible if CPEditor behaves in unexpected way and
+ * causes your ratings to go down and or loose any important contest.
+ *
+ * Believe Software is "Software" and it isn't immune to bugs.
+ *
+ */
+
+#ifndef MEMORYPROFILEWIDGET_HPP
+#define MEMORYPROFILEWIDGET_HPP
+
+#include "Core/MemoryProfiler.hpp"
+#include "Widgets/LineChart.hpp"
+#include <QCheckBox>
+#include <QComboBox>
+#include <QLabel>
+#include <QPushButton>
+#include <QSpinBox>
+#include <QTableWidget>
+
+// The memory profile of a test shown in the tab, with the timeline of the resident memory against the memory limit
+// and the call sites that allocate the most
+
+class MemoryProfileWidget : public QWidget
+{
+    Q_OBJECT
+
+  public:
+    explicit MemoryProfileWidget(QWidget *parent = nullptr);
+    // memoryLimit is in MB, 0 if unknown
+    void setTarget(const QString &filePath, const QString &lang, const QString &runCommand, const QString &args,
+                   int timeLimit, int memoryLimit, const QStringList &inputs);
+    // the file I/O of the problem, it's applied to the target set by setTarget()
+    void setFileIO(const QString &inputFileName, const QString &outputFileName);
+
+  private slots:
+    void on_startButton_clicked();
+    void on_closeButton_clicked();
+    void onSampleTaken(int time, qint64 rss);
+    void onProfilingFinished();
+    void onErrorOccured(const QString &error);
+
+  private:
+    Core::MemoryProfiler *profiler = nullptr;
+    QString filePath, lang, runCommand, args;
+    QStringList inputs;
+    int timeLimit = 0, memoryLimit = 0;
+
+    QComboBox *testCombo = nullptr;
+    QSpinBox *intervalSpin = nullptr;
+    QCheckBox *allocationsCheck = nullptr;
+    QPushButton *startButton = nullptr, *closeButton = nullptr;
+    LineChart *chart = nullptr;
+    QLabel *verdictLabel = nullptr;
+    QTableWidget *allocatorsTable = nullptr;
+
+    void updateChart();
+    QString verdict() const;
+    static QString formatBytes(qint64 bytes);
+};
+
+#endif // MEMORYPROFILEWIDGET_HPP
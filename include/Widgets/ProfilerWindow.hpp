@@ -0,0 +1,59 @@
+/*
+ * Copyright (C) 2019-2020 Ashar Khan <ashar786khan@gmail.com>
+ *
+ * This file is part of CPEditor.
+ *
+ * CPEditor is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * I will not be responsible if CPEditor behaves in unexpected way and
+ * causes your ratings to go down and or loose any important contest.
+ *
+ * Believe Software is "Software" and it isn't immune to bugs.
+ *
+ */
+
+#ifndef PROFILERWINDOW_HPP
+#define PROFILERWINDOW_HPP
+
+#include "Core/SamplingProfiler.hpp"
+#include <QLabel>
+#include <QMainWindow>
+#include <QPushButton>
+#include <QTableWidget>
+
+class ProfilerWindow : public QMainWindow
+{
+    Q_OBJECT
+
+  public:
+    explicit ProfilerWindow(QWidget *parent = nullptr);
+    void start(const QString &binaryPath, const QString &sourcePath, const QString &input, int timeLimit);
+    // the file I/O of the problem, it's applied to the runs started after it
+    void setFileIO(const QString &inputFileName, const QString &outputFileName);
+
+  signals:
+    // the fraction of the samples of each line of the source file, indexed by the 0-based line number
+    void heatChanged(const QVector<double> &heat);
+    void lineRequested(int line);
+
+  private slots:
+    void on_restartButton_clicked();
+    void onStatusChanged(const QString &status);
+    void onProfilingFinished();
+    void onErrorOccured(const QString &error);
+    void onCellDoubleClicked(int row, int column);
+
+  private:
+    Core::SamplingProfiler *profiler = nullptr;
+    QString binaryPath, sourcePath, input;
+    int timeLimit = 0;
+
+    QLabel *statusLabel = nullptr;
+    QPushButton *restartButton = nullptr;
+    QTableWidget *functionsTable = nullptr;
+};
+
+#endif // PROFILERWINDOW_HPP
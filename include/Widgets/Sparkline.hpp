@@ -0,0 +1,44 @@
+/*
+ * Copyright (C) 2019-2020 Ashar Khan <ashar786khan@gmail.com>
+ *
+ * This file is part of CPEditor.
+ *
+ * CPEditor is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * I will not be responsible if CPEditor behaves in unexpected way and
+ * causes your ratings to go down and or loose any important contest.
+ *
+ * Believe Software is "Software" and it isn't immune to bugs.
+ *
+ */
+
+#ifndef SPARKLINE_HPP
+#define SPARKLINE_HPP
+
+#include <QVector>
+#include <QWidget>
+
+// A tiny line chart of a few values without axes, such as the running times of a test across the revisions. The last
+// value is marked, and the values are listed in the tooltip.
+
+class Sparkline : public QWidget
+{
+    Q_OBJECT
+
+  public:
+    explicit Sparkline(QWidget *parent = nullptr);
+    // hidden with less than two values
+    void setValues(const QVector<int> &values, const QString &unit);
+    QSize sizeHint() const override;
+
+  protected:
+    void paintEvent(QPaintEvent *event) override;
+
+  private:
+    QVector<int> values;
+};
+
+#endif // SPARKLINE_HPP
@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2019-2020 Ashar Khan <ashar786khan@gmail.com>
+ *
+ * This file is part of CPEditor.
+ *
+ * CPEditor is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * I will not be responsible if CPEditor behaves in unexpected way and
+ * causes your ratings to go down and or loose any important contest.
+ *
+ * Believe Software is "Software" and it isn't immune to bugs.
+ *
+ */
+
+#ifndef TLEHUNTERWINDOW_HPP
+#define TLEHUNTERWINDOW_HPP
+
+#include "Core/TLEHunter.hpp"
+#include <QLabel>
+#include <QLineEdit>
+#include <QMainWindow>
+#include <QProgressBar>
+#include <QPushButton>
+#include <QSpinBox>
+#include <QTableWidget>
+
+class TLEHunterWindow : public QMainWindow
+{
+    Q_OBJECT
+
+  public:
+    explicit TLEHunterWindow(const QString &generatorCommand, QWidget *parent = nullptr);
+    void setTarget(const QString &filePath, const QString &lang, const QString &runCommand, const QString &args,
+                   int timeLimit);
+    // the file I/O of the problem, it's applied to the target set by setTarget()
+    void setFileIO(const QString &inputFileName, const QString &outputFileName);
+
+  signals:
+    void generatorCommandChanged(const QString &command);
+    void addTestCaseRequested(const QString &input);
+
+  private slots:
+    void on_startButton_clicked();
+    void on_addButton_clicked();
+    void onProgress(int finished, int total);
+    void onWorstResultsChanged();
+    void onHuntFinished();
+    void onErrorOccured(const QString &error);
+
+  private:
+    Core::TLEHunter *hunter = nullptr;
+    int timeLimit = 0;
+
+    QLineEdit *generatorEdit = nullptr, *minNEdit = nullptr, *maxNEdit = nullptr, *minValueEdit = nullptr,
+              *maxValueEdit = nullptr;
+    QSpinBox *iterationsSpin = nullptr, *parallelSpin = nullptr;
+    QPushButton *startButton = nullptr, *addButton = nullptr;
+    QProgressBar *progressBar = nullptr;
+    QTableWidget *resultsTable = nullptr;
+    QLabel *summaryLabel = nullptr;
+};
+
+#endif // TLEHUNTERWINDOW_HPP
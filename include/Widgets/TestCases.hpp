@@ -19,6 +19,10 @@
 #define TESTCASES_HPP
 
 #include "Core/MessageLogger.hpp"
+#include "Core/ProcessMonitor.hpp"
+#include "Core/Runner.hpp"
+#include "Core/SanitizerReport.hpp"
+#include "Widgets/Sparkline.hpp"
 #include <QFileInfo>
 #include <QHBoxLayout>
 #include <QLabel>
@@ -55,11 +59,15 @@ class TestCase : public QWidget
     explicit TestCase(int index, MessageLogger *logger, QWidget *parent = nullptr, const QString &input = QString(),
                       const QString &expected = QString());
     void setInput(const QString &text);
-    void setOutput(const QString &text);
+    // the output is kept as it is, and it's only decoded for the preview
+    void setOutput(const QByteArray &output);
+    // shows the output of a running program, only its last Core::Runner::STREAM_TAIL bytes are kept,
+    // total is the size of the whole output so far
+    void appendOutput(const QByteArray &chunk, qint64 total);
     void setExpected(const QString &text);
     void clearOutput();
     QString input() const;
-    QString output() const;
+    QByteArray output() const;
     QString expected() const;
     void loadFromFile(const QString &pathPrefix);
     void save(const QString &pathPrefix);
@@ -73,6 +81,17 @@ class TestCase : public QWidget
     };
 
     Verdict verdict() const;
+    void setVerdict(Verdict verdict, const QString &message = QString());
+    // when a custom checker is used, the verdict is set by setVerdict() instead of comparing the output
+    void setCustomChecker(bool enabled);
+    void showDiff();
+    // shows the time next to the output, and flags the runs which spend their time in small reads and writes
+    // judgeTime is the judge-equivalent time of timeUsed
+    void setRunStats(int timeUsed, int judgeTime, const Core::ProcessStats &stats);
+    // shows the result of the run of the sanitizer build on the same input, the full report is in the tooltip
+    void setSanitizerReport(const Core::SanitizerReport &report);
+    // the CPU time of the last run of each revision of the code, the oldest first
+    void setRunHistory(const QVector<int> &times);
 
   signals:
     void deleted(TestCase *widget);
@@ -86,12 +105,16 @@ class TestCase : public QWidget
   private:
     QHBoxLayout *mainLayout = nullptr, *inputUpLayout = nullptr, *outputUpLayout = nullptr, *expectedUpLayout = nullptr;
     QVBoxLayout *inputLayout = nullptr, *outputLayout = nullptr, *expectedLayout = nullptr;
-    QLabel *inputLabel = nullptr, *outputLabel = nullptr, *expectedLabel = nullptr;
+    QLabel *inputLabel = nullptr, *outputLabel = nullptr, *expectedLabel = nullptr, *statsLabel = nullptr,
+           *sanitizerLabel = nullptr;
+    Sparkline *historySparkline = nullptr;
     QPushButton *deleteButton = nullptr, *loadInputButton = nullptr, *diffButton = nullptr,
                 *loadExpectedButton = nullptr;
     TestCaseEdit *inputEdit = nullptr, *outputEdit = nullptr, *expectedEdit = nullptr;
     MessageLogger *log;
     Verdict currentVerdict = UNKNOWN;
+    bool customChecker = false;
+    QByteArray outputData, streamedOutput;
     int id;
 
     bool isPass() const;
@@ -104,13 +127,21 @@ class TestCases : public QWidget
   public:
     explicit TestCases(MessageLogger *logger, QWidget *parent = nullptr);
     void setInput(int index, const QString &input);
-    void setOutput(int index, const QString &output);
+    void setOutput(int index, const QByteArray &output);
+    void appendOutput(int index, const QByteArray &chunk, qint64 total);
     void setExpected(int index, const QString &expected);
+    void setVerdict(int index, TestCase::Verdict verdict, const QString &message = QString());
+    TestCase::Verdict verdict(int index) const;
+    void showDiff(int index);
+    void setRunStats(int index, int timeUsed, int judgeTime, const Core::ProcessStats &stats);
+    void setSanitizerReport(int index, const Core::SanitizerReport &report);
+    void setRunHistory(int index, const QVector<int> &times);
+    void setCustomChecker(bool enabled);
     void addTestCase(const QString &input = QString(), const QString &expected = QString());
     void clearOutput();
     void clear();
     QString input(int index) const;
-    QString output(int index) const;
+    QByteArray output(int index) const;
     QString expected(int index) const;
     void loadStatus(const QStringList &inputList, const QStringList &expectedList);
     QStringList inputs() const;
@@ -135,6 +166,7 @@ class TestCases : public QWidget
     QLabel *label = nullptr, *verdicts = nullptr;
     QList<TestCase *> testcases;
     MessageLogger *log;
+    bool customChecker = false;
 
     void updateVerdicts();
     QString testFilePathPrefix(const QFileInfo &fileInfo, int index);
@@ -18,10 +18,14 @@
 #ifndef APPWINDOW_HPP
 #define APPWINDOW_HPP
 
+#include <QLabel>
 #include <QMainWindow>
 
+#include "Core/ExecutorMessage.hpp"
+#include "Core/Scheduler.hpp"
 #include "Core/SettingsManager.hpp"
 #include "Telemetry/UpdateNotifier.hpp"
+#include "Widgets/ContestJudgeWindow.hpp"
 #include "mainwindow.hpp"
 #include "preferencewindow.hpp"
 
@@ -110,8 +114,34 @@ class AppWindow : public QMainWindow
 
     void on_actionRun_Detached_triggered();
 
+    void on_actionRun_With_Sanitizers_triggered();
+
     void on_actionKill_Processes_triggered();
 
+    void on_actionTLE_Hunter_triggered();
+
+    void on_actionEstimate_Complexity_triggered();
+
+    void on_actionBenchmark_triggered();
+
+    void on_actionCompare_Performance_triggered();
+
+    void on_actionProfile_Run_triggered();
+
+    void on_actionProfile_Memory_triggered();
+
+    void on_actionCount_Line_Executions_triggered();
+
+    void on_actionJudge_All_Tabs_triggered();
+
+    void onJudgeTabRequested(MainWindow *window);
+
+    void on_actionChoose_Checker_triggered();
+
+    void on_actionChoose_Interactor_triggered();
+
+    void on_actionChoose_File_IO_triggered();
+
     void on_actionUse_Snippets_triggered();
 
     void on_actionEditor_Mode_triggered();
@@ -138,6 +168,10 @@ class AppWindow : public QMainWindow
 
     void onTabContextMenuRequested(const QPoint &pos);
 
+    void onSchedulerStatusChanged();
+
+    void onExecutorJobFinishedWhileAway(const Core::ExecutorMessage &result);
+
   private:
     Ui::AppWindow *ui;
     MessageLogger *activeLogger = nullptr;
@@ -149,6 +183,9 @@ class AppWindow : public QMainWindow
     Telemetry::UpdateNotifier *updater = nullptr;
     PreferenceWindow *preferenceWindow = nullptr;
     Network::CompanionServer *server;
+    Core::Scheduler *scheduler = nullptr;
+    QLabel *schedulerLabel = nullptr;
+    QPointer<ContestJudgeWindow> contestJudge;
 
     void setConnections();
     void allocate();
@@ -19,19 +19,33 @@
 #define MAINWINDOW_HPP
 
 #include "Extensions/CompanionServer.hpp"
+#include "Core/Checker.hpp"
 #include "Core/Compiler.hpp"
+#include "Core/CoverageProfiler.hpp"
 #include "Core/Formatter.hpp"
+#include "Core/InteractiveRunner.hpp"
+#include "Core/Toolchain.hpp"
 #include <QCodeEditor>
 #include <QFile>
 #include <QFileSystemWatcher>
 #include <QLabel>
 #include <QMainWindow>
+#include <QPointer>
 #include <QPushButton>
+#include <QSet>
 #include <QShortcut>
 #include <QSplitter>
 #include <QTemporaryDir>
+#include "Core/RunHistory.hpp"
 #include "Core/Runner.hpp"
 #include "Core/SettingsManager.hpp"
+#include "Widgets/BenchmarkWindow.hpp"
+#include "Widgets/ComparisonWindow.hpp"
+#include "Widgets/ComplexityWidget.hpp"
+#include "Widgets/HeatGutter.hpp"
+#include "Widgets/MemoryProfileWidget.hpp"
+#include "Widgets/ProfilerWindow.hpp"
+#include "Widgets/TLEHunterWindow.hpp"
 #include "Widgets/TestCases.hpp"
 #include "Telemetry/UpdateNotifier.hpp"
 #include "Extensions/CFTools.hpp"
@@ -52,8 +66,10 @@ class MainWindow : public QMainWindow
     struct EditorStatus
     {
         bool isLanguageSet;
-        QString filePath, savedText, problemURL, editorText, language;
+        QString filePath, savedText, problemURL, editorText, language, generatorCommand, checkerPath, interactorPath;
+        QString problemInputFile, problemOutputFile;
         int editorCursor, editorAnchor, horizontalScrollBarValue, verticalScrollbarValue, untitledIndex;
+        int problemTimeLimit, problemMemoryLimit;
         QStringList input, expected;
 
         EditorStatus(){};
@@ -63,6 +79,14 @@ class MainWindow : public QMainWindow
         QMap<QString, QVariant> toMap() const;
     };
 
+    struct JudgeResult
+    {
+        // AC, WA, TLE, MLE, RE, CE, FAIL, OK (no expected output), SKIP (empty input), empty if pending
+        QString verdict;
+        int timeUsed = -1; // judge-equivalent milliseconds
+        qint64 peakMemory = -1;
+    };
+
     MainWindow(QString fileOpen, const Settings::SettingsData &data, int index = 0, QWidget *parent = nullptr);
     ~MainWindow() override;
 
@@ -85,12 +109,36 @@ class MainWindow : public QMainWindow
     bool isTextChanged();
     bool closeConfirm();
 
-    void killProcesses();
+    // the sanitizer build of the current code may be kept, e.g. by the run after its own compilation
+    void killProcesses(bool keepSanitizeRun = false);
     void detachedExecution();
     void compileOnly();
     void runOnly();
     void compileAndRun();
+    // compile and run as usual for the timing, and run the sanitizer build on the same tests in parallel
+    void runWithSanitizers();
     void formatSource();
+    void huntTLE();
+    void estimateComplexity();
+    void runBenchmark();
+    // compare the performance with the saved version of the file, another file or one of the tabs
+    void comparePerformance(const QVector<MainWindow *> &tabs);
+    // compile with debug information and sample the run on a chosen test, the hot lines are shown next to the code
+    void profileRun();
+    // sample the resident memory of a test, and optionally track the allocations of each call site
+    void profileMemory();
+    // compile with the coverage counters and run the chosen tests, the execution counts are shown next to the code
+    void countLineExecutions();
+    void chooseChecker();
+    void chooseInteractor();
+    void chooseFileIO();
+
+    // compile, unless the same code is already compiled, and run all the tests, judgeUpdated() is emitted for each
+    // result
+    void judge();
+    bool isJudging() const;
+    QVector<JudgeResult> judgeResults() const;
+    void showDiff(int index);
 
     void applyCompanion(Network::CompanionData data);
 
@@ -116,10 +164,31 @@ class MainWindow : public QMainWindow
     void onCompilationErrorOccured(const QString &error);
 
     void onRunStarted(int index);
-    void onRunFinished(int index, const QString &out, const QString &err, int exitCode, int timeUsed);
+    void onRunFinished(int index, const QByteArray &out, const QByteArray &err, int exitCode, int timeUsed);
     void onRunErrorOccured(int index, const QString &error);
     void onRunTimeout(int index);
     void onRunKilled(int index);
+    void onRunWrongAnswer(int index, const QString &message);
+    void onRunOutputStreamed(int index, const QByteArray &chunk, qint64 total);
+    void onRunLeakedProcesses(int index, const QStringList &processes);
+    void onCheckFinished(int index, Core::Checker::Verdict verdict, const QString &message);
+    void onInteractionFinished(int index, const Core::InteractiveRunner::Result &result);
+    void onToolProbeFinished(int tool, const QString &command, const QString &options, bool available);
+    void onBaselineCompilationFinished(const QString &warning);
+    void onBaselineCompilationErrorOccured(const QString &error);
+    void onProfileCompilationFinished(const QString &warning);
+    void onProfileCompilationErrorOccured(const QString &error);
+    void onProfileHeatChanged(const QVector<double> &heat);
+    void onProfileLineRequested(int line);
+    void onCoverageCompilationFinished(const QString &warning);
+    void onCoverageCompilationErrorOccured(const QString &error);
+    void onCoverageFinished();
+    void onCoverageErrorOccured(const QString &error);
+    void onSanitizeCompilationFinished(const QString &warning);
+    void onSanitizeCompilationErrorOccured(const QString &error);
+    void onSanitizeRunFinished(int index, const QByteArray &out, const QByteArray &err, int exitCode, int timeUsed);
+    void onSanitizeRunErrorOccured(int index, const QString &error);
+    void onSanitizeRunTimeout(int index);
 
     void on_changeLanguageButton_clicked();
 
@@ -130,6 +199,7 @@ class MainWindow : public QMainWindow
   signals:
     void editorChanged();
     void confirmTriggered(MainWindow *widget);
+    void judgeUpdated(MainWindow *widget);
 
   private:
     enum SaveMode
@@ -142,7 +212,12 @@ class MainWindow : public QMainWindow
     {
         Nothing,
         Run,
-        RunDetached
+        RunDetached,
+        HuntTLE,
+        EstimateComplexity,
+        RunBenchmark,
+        ComparePerformance,
+        ProfileMemory
     };
     enum Verdict
     {
@@ -158,11 +233,19 @@ class MainWindow : public QMainWindow
     bool isLanguageSet = false;
 
     Core::Formatter *formatter = nullptr;
+    Core::Checker *checker = nullptr;
     Core::Compiler *compiler = nullptr;
     QVector<Core::Runner *> runner;
+    QVector<Core::InteractiveRunner *> interactiveRunner;
+    QMap<int, QString> earlyWrongAnswers;
     Core::Runner *detachedRunner = nullptr;
     QTemporaryDir *tmpDir = nullptr;
     AfterCompile afterCompile = Nothing;
+    QString compilingKey, compiledKey;
+    QString runKey; // the compile key of the binary of the current run, empty if it's unknown, e.g. after a restart
+    bool judging = false;
+    QVector<JudgeResult> judgeResult;
+    QSet<int> judgeTimeouts;
 
     MessageLogger log;
 
@@ -171,8 +254,37 @@ class MainWindow : public QMainWindow
     QString filePath;
     QString savedText;
     QString cftoolPath;
+    QSet<QString> pendingProbes;
     QFileSystemWatcher *fileWatcher;
 
+    int problemTimeLimit = 0, problemMemoryLimit = 0;
+    QString problemInputFile, problemOutputFile; // empty for the standard streams
+    QString generatorCommand, interactorPath;
+    QPointer<TLEHunterWindow> tleHunter;
+    ComplexityWidget *complexityWidget = nullptr;
+    QPointer<BenchmarkWindow> benchmarkWindow;
+    QPointer<ComparisonWindow> comparisonWindow;
+    Core::Compiler *baselineCompiler = nullptr;
+    QTemporaryDir *baselineDir = nullptr;
+    QString baselineText, baselineLanguage, baselineName;
+    QPointer<ProfilerWindow> profilerWindow;
+    Core::Compiler *profileCompiler = nullptr;
+    QTemporaryDir *profileDir = nullptr;
+    QString profiledText, profileInput;
+    HeatGutter *heatGutter = nullptr;
+    MemoryProfileWidget *memoryProfileWidget = nullptr;
+    Core::Compiler *coverageCompiler = nullptr;
+    QTemporaryDir *coverageDir = nullptr;
+    Core::CoverageProfiler *coverageProfiler = nullptr;
+    QString coveredText;
+    QVector<int> coveredTests;
+    Core::Compiler *sanitizeCompiler = nullptr;
+    QTemporaryDir *sanitizeDir = nullptr;
+    QString sanitizeCompilingKey, sanitizeCompiledKey, sanitizedText;
+    QVector<Core::Runner *> sanitizeRunners;
+    QMap<int, Core::SanitizerReport> sanitizerReports;
+    QMap<int, Core::RunHistory::Record> pendingHistory; // the runs waiting for the verdict of the custom checker
+
     QPushButton *submitToCodeforces = nullptr;
     Network::CFTools *cftools = nullptr;
 
@@ -193,6 +305,28 @@ class MainWindow : public QMainWindow
     bool saveTemp(const QString &head);
     QString tmpPath();
     void performCoreDiagonistics();
+    Core::Toolchain::Status probeTool(int tool, const QString &command, const QString &options = QString());
+    void reportToolStatus(int tool, const QString &command, bool available);
     QString getRunnerHead(int index);
+    bool getRunCommand(QString &command, QString &args);
+    bool getRunCommand(const QString &lang, QString &command, QString &args);
+    QString describeFileIO() const;
+    int getTimeLimit() const;
+    QString formatTime(int time) const;
+    void openTLEHunter();
+    void openComplexityWidget();
+    void openMemoryProfile();
+    void runSanitizeBuild();
+    void stopSanitizeRun();
+    void recordRun(int index, Core::RunHistory::Record record);
+    void openBenchmark();
+    void compileBaseline();
+    QString baselinePath() const;
+    void openComparison();
+    void setChecker(const QString &path);
+    void runInteractive(const QString &command, const QString &args);
+    QString compileKey() const;
+    void setJudgeResult(int index, const QString &verdict, int timeUsed = -1, qint64 peakMemory = -1);
+    void stopJudging(const QString &verdict);
 };
 #endif // MAINWINDOW_HPP
@@ -78,6 +78,8 @@ class PreferenceWindow : public QMainWindow
 
     void on_transparency_slider_valueChanged(int value);
 
+    void on_calibrate_clicked();
+
   private:
     Ui::PreferenceWindow *ui;
     QFont currentFont;
@@ -0,0 +1,30 @@
+// CPEditor calibration: CPU bound
+// integer arithmetic, unpredictable branches and a working set that fits in the L2 cache
+
+#include <cstdint>
+#include <cstdio>
+
+int main()
+{
+    const int N = 1 << 16;
+    const uint64_t MOD = 1000000007;
+    static uint64_t dp[N] = {1};
+    uint64_t x = 88172645463325252ULL, sum = 0;
+    for (int round = 0; round < 1200; ++round)
+    {
+        for (int i = 1; i < N; ++i)
+        {
+            x ^= x << 13;
+            x ^= x >> 7;
+            x ^= x << 17;
+            uint64_t other = dp[x & (N - 1)];
+            if (x % 3 == 0)
+                dp[i] = (dp[i - 1] + other) % MOD;
+            else
+                dp[i] = (dp[i - 1] + other * i) % MOD;
+        }
+        sum += dp[N - 1];
+    }
+    printf("%llu\n", static_cast<unsigned long long>(sum));
+    return 0;
+}
@@ -0,0 +1,32 @@
+// CPEditor calibration: I/O bound
+// formatted output and input of 2M integers through the C standard I/O, as most solutions read and write their data
+
+#include <cstdint>
+#include <cstdio>
+
+int main()
+{
+    const int N = 1 << 21;
+    FILE *file = tmpfile();
+    if (file == nullptr)
+    {
+        puts("tmpfile() failed");
+        return 1;
+    }
+    uint64_t x = 88172645463325252ULL;
+    for (int i = 0; i < N; ++i)
+    {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        fprintf(file, "%d%c", static_cast<int>(x % 2000000001) - 1000000000, i % 16 == 15 ? '\n' : ' ');
+    }
+    rewind(file);
+    long long sum = 0;
+    int value;
+    while (fscanf(file, "%d", &value) == 1)
+        sum += value;
+    fclose(file);
+    printf("%lld\n", sum);
+    return 0;
+}
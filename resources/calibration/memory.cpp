@@ -0,0 +1,43 @@
+// CPEditor calibration: memory bound
+// random accesses to 16 MB, which miss the caches and the TLB, followed by sorting 1M integers
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+int main()
+{
+    const int N = 1 << 22;
+    std::vector<int> next(N);
+    uint64_t x = 88172645463325252ULL;
+    auto random = [&x]() {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        return x;
+    };
+
+    // Sattolo's algorithm makes a single cycle through all the elements
+    for (int i = 0; i < N; ++i)
+        next[i] = i;
+    for (int i = N - 1; i > 0; --i)
+        std::swap(next[i], next[random() % i]);
+    int position = 0;
+    uint64_t sum = 0;
+    for (int step = 0; step < N; ++step)
+    {
+        position = next[position];
+        sum += position;
+    }
+
+    std::vector<uint32_t> values(N / 4);
+    for (auto &value : values)
+        value = static_cast<uint32_t>(random());
+    std::sort(values.begin(), values.end());
+    for (int i = 0; i < N / 4; i += 4096)
+        sum += values[i];
+
+    printf("%llu\n", static_cast<unsigned long long>(sum));
+    return 0;
+}
@@ -0,0 +1,254 @@
+/*
+ * Copyright (C) 2019-2020 Ashar Khan <ashar786khan@gmail.com>
+ *
+ * This file is part of CPEditor.
+ *
+ * CPEditor is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * I will not be responsible if CPEditor behaves in unexpected way and
+ * causes your ratings to go down and or loose any important contest.
+ *
+ * Believe Software is "Software" and it isn't immune to bugs.
+ *
+ */
+
+#include "Core/Benchmark.hpp"
+#include <QThread>
+#include <algorithm>
+#include <cmath>
+
+#if defined(Q_OS_LINUX)
+#include <sched.h>
+#endif
+
+namespace Core
+{
+
+Benchmark::Summary Benchmark::Result::summary() const
+{
+    return summarize(times);
+}
+
+double Benchmark::Result::medianCounter(qint64 ProcessStats::*counter) const
+{
+    QVector<double> values;
+    for (auto const &run : stats)
+    {
+        if (run.*counter >= 0)
+            values.push_back(run.*counter);
+    }
+    return values.isEmpty() ? -1 : summarize(values).median;
+}
+
+Benchmark::Benchmark(const QString &filePath, const QString &lang, const QString &runCommand, const QString &args,
+                     int timeLimit, QObject *parent)
+    : QObject(parent), filePath(filePath), lang(lang), runCommand(runCommand), args(args), timeLimit(timeLimit)
+{
+}
+
+Benchmark::~Benchmark()
+{
+    stop();
+}
+
+void Benchmark::setFileIO(const QString &inputFileName, const QString &outputFileName)
+{
+    this->inputFileName = inputFileName;
+    this->outputFileName = outputFileName;
+}
+
+void Benchmark::start(const QStringList &inputs, int runs, int warmUpRuns, int core)
+{
+    stop();
+    this->inputs = inputs;
+    this->runs = qMax(1, runs);
+    this->warmUpRuns = qMax(0, warmUpRuns);
+    this->core = core;
+    testResults.clear();
+    for (int i = 0; i < inputs.size(); ++i)
+    {
+        if (!inputs[i].trimmed().isEmpty())
+        {
+            Result result;
+            result.index = i;
+            testResults.push_back(result);
+        }
+    }
+
+    currentTest = currentRun = finished = 0;
+    if (testResults.isEmpty())
+    {
+        emit benchmarkFinished();
+        return;
+    }
+
+    running = true;
+    Runner::pauseAll();
+    emit progress(0, testResults.size() * (this->runs + this->warmUpRuns));
+    runNext();
+}
+
+void Benchmark::stop()
+{
+    if (!running)
+        return;
+    running = false;
+    if (runner != nullptr)
+    {
+        // stop() may be called from the signals of the runner
+        runner->deleteLater();
+        runner = nullptr;
+    }
+    Runner::resumeAll();
+}
+
+bool Benchmark::isRunning() const
+{
+    return running;
+}
+
+QVector<Benchmark::Result> Benchmark::results() const
+{
+    return testResults;
+}
+
+Benchmark::Summary Benchmark::summarize(QVector<double> values)
+{
+    Summary summary;
+    summary.runs = values.size();
+    if (values.isEmpty())
+        return summary;
+
+    std::sort(values.begin(), values.end());
+    int n = values.size();
+    summary.min = values.front();
+    summary.median = n % 2 == 1 ? values[n / 2] : (values[n / 2 - 1] + values[n / 2]) / 2;
+    // the nearest-rank percentile
+    summary.p95 = values[qBound(0, static_cast<int>(std::ceil(0.95 * n)) - 1, n - 1)];
+
+    double sum = 0;
+    for (auto value : values)
+        sum += value;
+    summary.mean = sum / n;
+
+    if (n > 1 && summary.mean > 0)
+    {
+        double squares = 0;
+        for (auto value : values)
+            squares += (value - summary.mean) * (value - summary.mean);
+        summary.cv = std::sqrt(squares / (n - 1)) / summary.mean;
+    }
+    return summary;
+}
+
+int Benchmark::defaultCore()
+{
+#if defined(Q_OS_LINUX)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0)
+    {
+        for (int i = CPU_SETSIZE - 1; i >= 0; --i)
+        {
+            if (CPU_ISSET(i, &set))
+                return i;
+        }
+    }
+#endif
+    return qMax(0, QThread::idealThreadCount() - 1);
+}
+
+void Benchmark::onRunFinished(int index, const QByteArray &out, const QByteArray &err, int exitCode, int timeUsed)
+{
+    if (!running || runner == nullptr)
+        return;
+
+    // the resource usage of the process itself when it exits, so the other children of the editor don't count
+    auto stats = runner->stats();
+    double time = stats.preciseCpuTime();
+    runner->deleteLater();
+    runner = nullptr;
+
+    auto &result = testResults[currentTest];
+    bool warmUp = currentRun < warmUpRuns;
+    ++currentRun;
+    emit progress(++finished, testResults.size() * (runs + warmUpRuns));
+
+    if (timedOut || exitCode != 0)
+    {
+        result.error = timedOut ? "Time Limit Exceeded" : "Exited with code " + QString::number(exitCode);
+        emit resultChanged(result.index);
+        nextTest();
+        return;
+    }
+
+    if (!warmUp)
+    {
+        result.times.push_back(time);
+        result.stats.push_back(stats);
+        emit resultChanged(result.index);
+    }
+
+    if (currentRun >= runs + warmUpRuns)
+        nextTest();
+    else
+        runNext();
+}
+
+void Benchmark::onRunErrorOccured(int index, const QString &error)
+{
+    if (!running)
+        return;
+    testResults[currentTest].error = error;
+    emit resultChanged(testResults[currentTest].index);
+    finish();
+}
+
+void Benchmark::onRunTimeout(int index)
+{
+    timedOut = true;
+}
+
+void Benchmark::runNext()
+{
+    timedOut = false;
+    runner = new Runner(testResults[currentTest].index);
+    runner->setExclusive(true);
+    runner->setCpuAffinity(core);
+    runner->setFileIO(inputFileName, outputFileName);
+    connect(runner, SIGNAL(runFinished(int, const QByteArray &, const QByteArray &, int, int)), this,
+            SLOT(onRunFinished(int, const QByteArray &, const QByteArray &, int, int)));
+    connect(runner, SIGNAL(runErrorOccured(int, const QString &)), this,
+            SLOT(onRunErrorOccured(int, const QString &)));
+    connect(runner, SIGNAL(runTimeout(int)), this, SLOT(onRunTimeout(int)));
+    runner->run(filePath, lang, runCommand, args, inputs[testResults[currentTest].index], runTimeLimit());
+}
+
+void Benchmark::nextTest()
+{
+    // the skipped runs of a failed test still count in the progress
+    finished += runs + warmUpRuns - currentRun;
+    emit progress(finished, testResults.size() * (runs + warmUpRuns));
+
+    currentRun = 0;
+    if (++currentTest >= testResults.size())
+        finish();
+    else
+        runNext();
+}
+
+void Benchmark::finish()
+{
+    stop();
+    emit benchmarkFinished();
+}
+
+int Benchmark::runTimeLimit() const
+{
+    return qMax(timeLimit * 2, timeLimit + 1000);
+}
+
+} // namespace Core
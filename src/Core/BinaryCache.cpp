@@ -0,0 +1,204 @@
+/*
+ * Copyright (C) 2019-2020 Ashar Khan <ashar786khan@gmail.com>
+ *
+ * This file is part of CPEditor.
+ *
+ * CPEditor is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * I will not be responsible if CPEditor behaves in unexpected way and
+ * causes your ratings to go down and or loose any important contest.
+ *
+ * Believe Software is "Software" and it isn't immune to bugs.
+ *
+ */
+
+#include "Core/BinaryCache.hpp"
+#include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QRegularExpression>
+#include <QStandardPaths>
+
+namespace Core
+{
+
+BinaryCache::BinaryCache(QObject *parent) : QObject(parent)
+{
+}
+
+BinaryCache *BinaryCache::instance()
+{
+    // owned by the application, so that the running compilers are killed before the application is destructed
+    static BinaryCache *cache = new BinaryCache(QCoreApplication::instance());
+    return cache;
+}
+
+bool BinaryCache::isSource(const QString &path)
+{
+    auto suffix = QFileInfo(path).suffix().toLower();
+    return suffix == "cpp" || suffix == "cc" || suffix == "cxx";
+}
+
+QString BinaryCache::cacheDirectory()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/binaries";
+}
+
+void BinaryCache::build(const QString &sourcePath, const QString &compileCommand)
+{
+    if (!isSource(sourcePath))
+    {
+        if (QFileInfo(sourcePath).isExecutable())
+            emit buildFinished(sourcePath, sourcePath);
+        else
+            emit buildFailed(sourcePath, "[" + sourcePath + "] is neither a C++ source nor an executable");
+        return;
+    }
+
+    QFile source(sourcePath);
+    if (!source.open(QIODevice::ReadOnly))
+    {
+        emit buildFailed(sourcePath, "Failed to open [" + sourcePath + "]");
+        return;
+    }
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    auto content = source.readAll();
+    hash.addData(content);
+    QSet<QString> visited = {QFileInfo(sourcePath).canonicalFilePath()};
+    addLocalIncludes(sourcePath, content, hash, visited);
+    hash.addData(compileCommand.toUtf8());
+
+    QDir dir(cacheDirectory());
+    if (!dir.mkpath("."))
+    {
+        emit buildFailed(sourcePath, "Failed to create the cache directory [" + dir.path() + "]");
+        return;
+    }
+    auto binaryPath = dir.filePath(hash.result().toHex());
+#if defined(Q_OS_WIN)
+    binaryPath += ".exe";
+#endif
+
+    if (QFile::exists(binaryPath))
+    {
+        emit buildFinished(sourcePath, binaryPath);
+        return;
+    }
+
+    for (auto it = builds.begin(); it != builds.end(); ++it)
+    {
+        if (it->binaryPath == binaryPath)
+        {
+            if (!it->sourcePaths.contains(sourcePath))
+                it->sourcePaths.push_back(sourcePath);
+            return;
+        }
+    }
+
+    // compile to a temporary name, so that a binary in the cache is always complete
+    auto process = new QProcess(this);
+    Build build;
+    build.binaryPath = binaryPath;
+    // the headers next to the source, e.g. testlib.h, should be found
+    build.command = compileCommand + " -I\"" + QFileInfo(sourcePath).canonicalPath() + "\" \"" +
+                    QFileInfo(sourcePath).canonicalFilePath() + "\" -o \"" + binaryPath + ".tmp\"";
+    build.sourcePaths.push_back(sourcePath);
+    builds[process] = build;
+    connect(process, SIGNAL(finished(int, QProcess::ExitStatus)), this,
+            SLOT(onProcessFinished(int, QProcess::ExitStatus)));
+    connect(process, SIGNAL(errorOccurred(QProcess::ProcessError)), this,
+            SLOT(onProcessErrorOccurred(QProcess::ProcessError)));
+
+    // the ticket is a child of the process, so it's released when the build finishes
+    auto scheduler = Scheduler::current();
+    if (scheduler != nullptr)
+    {
+        auto ticket = scheduler->request(nullptr, Scheduler::Background, Scheduler::DEFAULT_COMPILE_MEMORY, process);
+        if (!ticket->isGranted())
+        {
+            connect(ticket, SIGNAL(granted()), this, SLOT(onTicketGranted()));
+            return;
+        }
+    }
+    process->start(build.command);
+}
+
+void BinaryCache::onTicketGranted()
+{
+    auto process = qobject_cast<QProcess *>(sender()->parent());
+    if (process != nullptr && builds.contains(process))
+        process->start(builds[process].command);
+}
+
+void BinaryCache::onProcessFinished(int exitCode, QProcess::ExitStatus exitStatus)
+{
+    auto process = qobject_cast<QProcess *>(sender());
+    if (process == nullptr || !builds.contains(process))
+        return;
+
+    if (exitStatus != QProcess::NormalExit || exitCode != 0)
+    {
+        finishBuild(process, false, process->readAllStandardError());
+        return;
+    }
+
+    auto binaryPath = builds[process].binaryPath;
+    QFile::remove(binaryPath);
+    if (!QFile::rename(binaryPath + ".tmp", binaryPath))
+        finishBuild(process, false, "Failed to move the binary to [" + binaryPath + "]");
+    else
+        finishBuild(process, true, QString());
+}
+
+void BinaryCache::onProcessErrorOccurred(QProcess::ProcessError error)
+{
+    auto process = qobject_cast<QProcess *>(sender());
+    if (error == QProcess::FailedToStart && process != nullptr && builds.contains(process))
+        finishBuild(process, false, "Failed to start the compiler");
+}
+
+void BinaryCache::addLocalIncludes(const QString &sourcePath, const QByteArray &content, QCryptographicHash &hash,
+                                   QSet<QString> &visited)
+{
+    // only the quoted includes are followed, the system headers change with the compiler, which is in the command
+    static const QRegularExpression include("^\\s*#\\s*include\\s*\"([^\"]+)\"",
+                                            QRegularExpression::MultilineOption);
+    auto directory = QFileInfo(sourcePath).dir();
+    auto matches = include.globalMatch(QString::fromUtf8(content));
+    while (matches.hasNext())
+    {
+        auto name = matches.next().captured(1);
+        QFileInfo header(directory.filePath(name));
+        auto path = header.canonicalFilePath();
+        if (path.isEmpty() || visited.contains(path))
+            continue;
+        visited.insert(path);
+        QFile file(path);
+        if (!file.open(QIODevice::ReadOnly))
+            continue;
+        auto headerContent = file.readAll();
+        hash.addData(name.toUtf8());
+        hash.addData(headerContent);
+        addLocalIncludes(path, headerContent, hash, visited);
+    }
+}
+
+void BinaryCache::finishBuild(QProcess *process, bool success, const QString &error)
+{
+    auto build = builds.take(process);
+    process->deleteLater();
+    for (auto const &sourcePath : build.sourcePaths)
+    {
+        if (success)
+            emit buildFinished(sourcePath, build.binaryPath);
+        else
+            emit buildFailed(sourcePath, "Failed to compile [" + sourcePath + "]\n" + error);
+    }
+}
+
+} // namespace Core
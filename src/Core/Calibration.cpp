@@ -0,0 +1,209 @@
+/*
+ * Copyright (C) 2019-2020 Ashar Khan <ashar786khan@gmail.com>
+ *
+ * This file is part of CPEditor.
+ *
+ * CPEditor is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * I will not be responsible if CPEditor behaves in unexpected way and
+ * causes your ratings to go down and or loose any important contest.
+ *
+ * Believe Software is "Software" and it isn't immune to bugs.
+ *
+ */
+
+
+#include "Core/Calibration.hpp"
+#include <QDir>
+#include <QFile>
+#include <QTextStream>
+#include <cmath>
+
+namespace Core
+{
+
+const int Calibration::RUNS;
+const int Calibration::WARM_UP_RUNS;
+const int Calibration::TIME_LIMIT;
+
+Calibration::Calibration(QObject *parent) : QObject(parent)
+{
+}
+
+Calibration::~Calibration()
+{
+    stop();
+    delete tmpDir;
+}
+
+void Calibration::start(const QString &compileCommand)
+{
+    stop();
+    this->compileCommand = compileCommand;
+    measured.clear();
+    delete tmpDir;
+    tmpDir = new QTemporaryDir();
+    if (!tmpDir->isValid())
+    {
+        fail("Failed to create a temporary directory for the calibration");
+        return;
+    }
+    current = 0;
+    running = true;
+    compileNext();
+}
+
+void Calibration::stop()
+{
+    running = false;
+    // stop() may be called from the signals of the compiler or the benchmark
+    if (compiler != nullptr)
+    {
+        compiler->deleteLater();
+        compiler = nullptr;
+    }
+    if (benchmark != nullptr)
+    {
+        benchmark->stop();
+        benchmark->deleteLater();
+        benchmark = nullptr;
+    }
+}
+
+bool Calibration::isRunning() const
+{
+    return running;
+}
+
+QMap<QString, double> Calibration::timings() const
+{
+    return measured;
+}
+
+QStringList Calibration::programs()
+{
+    return {"cpu", "memory", "io"};
+}
+
+QString Calibration::description(const QString &program)
+{
+    if (program == "cpu")
+        return "CPU bound";
+    if (program == "memory")
+        return "Memory bound";
+    if (program == "io")
+        return "I/O bound";
+    return program;
+}
+
+QString Calibration::source(const QString &program)
+{
+    QFile file(":/calibration/" + program + ".cpp");
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+        return QString();
+    return QTextStream(&file).readAll();
+}
+
+double Calibration::speedFactor(const QMap<QString, double> &local, const QMap<QString, double> &judge)
+{
+    // the geometric mean doesn't let a single kind of program dominate the factor
+    double logSum = 0;
+    int count = 0;
+    for (auto const &program : programs())
+    {
+        double here = local.value(program), there = judge.value(program);
+        if (here > 0 && there > 0)
+        {
+            logSum += std::log(there / here);
+            ++count;
+        }
+    }
+    return count == 0 ? 0 : std::exp(logSum / count);
+}
+
+void Calibration::onCompilationFinished(const QString &warning)
+{
+    if (!running)
+        return;
+    compiler->deleteLater();
+    compiler = nullptr;
+
+    benchmark = new Benchmark(sourcePath(), "C++", QString(), QString(), TIME_LIMIT);
+    connect(benchmark, SIGNAL(benchmarkFinished()), this, SLOT(onBenchmarkFinished()));
+    // the programs don't read anything, but the benchmark skips the empty inputs
+    benchmark->start({"\n"}, RUNS, WARM_UP_RUNS, Benchmark::defaultCore());
+}
+
+void Calibration::onCompilationErrorOccured(const QString &error)
+{
+    if (!running)
+        return;
+    fail("Failed to compile the " + programs()[current] + " calibration program:\n" + error);
+}
+
+void Calibration::onBenchmarkFinished()
+{
+    if (!running || benchmark == nullptr)
+        return;
+    auto results = benchmark->results();
+    benchmark->deleteLater();
+    benchmark = nullptr;
+
+    auto program = programs()[current];
+    if (results.isEmpty() || !results.front().error.isEmpty() || results.front().times.isEmpty())
+    {
+        fail("The " + program + " calibration program failed: " +
+             (results.isEmpty() ? QString("no result") : results.front().error));
+        return;
+    }
+
+    double time = results.front().summary().median;
+    measured[program] = time;
+    emit programMeasured(program, time);
+
+    if (++current < programs().size())
+        compileNext();
+    else
+    {
+        stop();
+        emit calibrationFinished();
+    }
+}
+
+QString Calibration::sourcePath() const
+{
+    // each program gets its own directory, so that the binary of the previous one is never run by mistake
+    return tmpDir->path() + "/" + programs()[current] + "/sol.cpp";
+}
+
+void Calibration::compileNext()
+{
+    auto program = programs()[current];
+    emit programStarted(program);
+
+    QDir().mkpath(tmpDir->path() + "/" + program);
+    QFile file(sourcePath());
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text) || file.write(source(program).toUtf8()) < 0)
+    {
+        fail("Failed to write the " + program + " calibration program");
+        return;
+    }
+    file.close();
+
+    compiler = new Compiler();
+    connect(compiler, SIGNAL(compilationFinished(const QString &)), this, SLOT(onCompilationFinished(const QString &)));
+    connect(compiler, SIGNAL(compilationErrorOccured(const QString &)), this,
+            SLOT(onCompilationErrorOccured(const QString &)));
+    compiler->start(sourcePath(), compileCommand, "C++");
+}
+
+void Calibration::fail(const QString &error)
+{
+    stop();
+    emit errorOccured(error);
+}
+
+} // namespace Core
@@ -0,0 +1,354 @@
+/*
+ * Copyright (C) 2019-2020 Ashar Khan <ashar786khan@gmail.com>
+ *
+ * This file is part of CPEditor.
+ *
+ * CPEditor is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * I will not be responsible if CPEditor behaves in unexpected way and
+ * causes your ratings to go down and or loose any important contest.
+ *
+ * Believe Software is "Software" and it isn't immune to bugs.
+ *
+ */
+
+#include "Core/Checker.hpp"
+#include "Core/BinaryCache.hpp"
+#include "Core/ExecutorClient.hpp"
+#include <QDir>
+#include <QFile>
+#include <QTimer>
+#include <algorithm>
+#include <cctype>
+
+namespace Core
+{
+
+const int Checker::CHECKER_TIME_LIMIT;
+
+Checker::Checker(QObject *parent) : QObject(parent)
+{
+    connect(BinaryCache::instance(), SIGNAL(buildFinished(const QString &, const QString &)), this,
+            SLOT(onBuildFinished(const QString &, const QString &)));
+    connect(BinaryCache::instance(), SIGNAL(buildFailed(const QString &, const QString &)), this,
+            SLOT(onBuildFailed(const QString &, const QString &)));
+}
+
+Checker::~Checker()
+{
+    cancel();
+    if (tmpDir != nullptr)
+        delete tmpDir;
+}
+
+void Checker::setChecker(const QString &path, const QString &compileCommand)
+{
+    cancel();
+    this->path = path;
+    binaryPath.clear();
+    buildError.clear();
+    if (path.isEmpty())
+        return;
+    building = true;
+    BinaryCache::instance()->build(path, compileCommand);
+}
+
+QString Checker::checkerPath() const
+{
+    return path;
+}
+
+void Checker::setScheduling(QObject *owner, Scheduler::Priority priority)
+{
+    this->owner = owner;
+    this->priority = priority;
+}
+
+void Checker::check(int index, const QString &input, const QByteArray &output, const QString &expected)
+{
+    Check check;
+    check.index = index;
+    check.input = input;
+    check.output = output;
+    check.expected = expected;
+    if (building)
+        pending.push_back(check);
+    else if (!buildError.isEmpty())
+        emit checkFinished(index, Failed, buildError);
+    else
+        startCheck(check);
+}
+
+void Checker::cancel()
+{
+    pending.clear();
+    for (auto job : remoteJobs.keys())
+        ExecutorClient::instance()->cancel(job);
+    remoteJobs.clear();
+    remoteErrors.clear();
+    for (auto process : running.keys())
+    {
+        process->disconnect(this);
+        process->kill();
+        process->deleteLater();
+    }
+    running.clear();
+}
+
+Checker::Verdict Checker::verdictOfExitCode(int exitCode, QString &message)
+{
+    // the exit codes of testlib
+    switch (exitCode)
+    {
+    case 0:
+        return Accepted;
+    case 1:
+        return WrongAnswer;
+    case 2:
+        message = "Presentation Error: " + message;
+        return WrongAnswer;
+    case 4:
+        message = "Unexpected extra output: " + message;
+        return WrongAnswer;
+    case 7:
+        message = "Partially correct: " + message;
+        return WrongAnswer;
+    case 8:
+        message = "Unexpected end of output: " + message;
+        return WrongAnswer;
+    default:
+        message = "The checker failed with exit code " + QString::number(exitCode) + ": " + message;
+        return Failed;
+    }
+}
+
+bool Checker::isSameOutput(const QByteArray &output, const QByteArray &expected)
+{
+    // the built-in comparison, which ignores the trailing spaces and the trailing empty lines, the buffers are only
+    // copied if they contain '\r'
+    auto out = output.contains('\r') ? QByteArray(output).replace("\r", "") : output;
+    auto ans = expected.contains('\r') ? QByteArray(expected).replace("\r", "") : expected;
+    return isSameText(out.constData(), out.constData() + out.size(), ans.constData(), ans.constData() + ans.size(),
+                      '\n');
+}
+
+bool Checker::isBlank(const char *begin, const char *end)
+{
+    for (auto it = begin; it != end; ++it)
+    {
+        if (!std::isspace(static_cast<unsigned char>(*it)))
+            return false;
+    }
+    return true;
+}
+
+bool Checker::isSameText(const char *a, const char *aEnd, const char *b, const char *bEnd, char separator)
+{
+    // the texts are split like QByteArray::split(), the lines are compared by their words and the words exactly,
+    // the parts which only one of them has must be blank
+    bool aDone = false, bDone = false;
+    while (!aDone || !bDone)
+    {
+        auto aPart = aDone ? aEnd : std::find(a, aEnd, separator);
+        auto bPart = bDone ? bEnd : std::find(b, bEnd, separator);
+        if (aDone || bDone)
+        {
+            if (aDone ? !isBlank(b, bPart) : !isBlank(a, aPart))
+                return false;
+        }
+        else if (separator == '\n')
+        {
+            if (!isSameText(a, aPart, b, bPart, ' '))
+                return false;
+        }
+        else if (aPart - a != bPart - b || !std::equal(a, aPart, b))
+        {
+            return false;
+        }
+
+        if (!aDone)
+        {
+            aDone = aPart == aEnd;
+            a = aDone ? aEnd : aPart + 1;
+        }
+        if (!bDone)
+        {
+            bDone = bPart == bEnd;
+            b = bDone ? bEnd : bPart + 1;
+        }
+    }
+    return true;
+}
+
+void Checker::onBuildFinished(const QString &sourcePath, const QString &binaryPath)
+{
+    if (!building || sourcePath != path)
+        return;
+    building = false;
+    this->binaryPath = binaryPath;
+    auto checks = pending;
+    pending.clear();
+    for (auto const &check : checks)
+        startCheck(check);
+}
+
+void Checker::onBuildFailed(const QString &sourcePath, const QString &error)
+{
+    if (!building || sourcePath != path)
+        return;
+    building = false;
+    buildError = error;
+    auto checks = pending;
+    pending.clear();
+    for (auto const &check : checks)
+        emit checkFinished(check.index, Failed, buildError);
+}
+
+void Checker::onProcessFinished(int exitCode, QProcess::ExitStatus exitStatus)
+{
+    auto process = qobject_cast<QProcess *>(sender());
+    if (process == nullptr || !running.contains(process))
+        return;
+
+    QString message = QString::fromUtf8(process->readAllStandardError()).trimmed();
+    if (exitStatus != QProcess::NormalExit)
+        finishCheck(process, Failed, "The checker crashed or timed out\n" + message);
+    else
+    {
+        auto verdict = verdictOfExitCode(exitCode, message);
+        finishCheck(process, verdict, message);
+    }
+}
+
+void Checker::onProcessErrorOccurred(QProcess::ProcessError error)
+{
+    auto process = qobject_cast<QProcess *>(sender());
+    if (error == QProcess::FailedToStart && process != nullptr && running.contains(process))
+        finishCheck(process, Failed, "Failed to start the checker [" + binaryPath + "]");
+}
+
+void Checker::onTicketGranted()
+{
+    // the ticket is a child of the process it's waiting for
+    auto ticket = qobject_cast<SchedulerTicket *>(sender());
+    auto process = ticket == nullptr ? nullptr : qobject_cast<QProcess *>(ticket->parent());
+    if (process != nullptr && running.contains(process))
+        startProcess(process);
+}
+
+void Checker::onRemoteJobOutput(quint64 job, int channel, const QByteArray &data)
+{
+    if (remoteJobs.contains(job) && channel == ExecutorMessage::StandardError)
+        remoteErrors[job] += data;
+}
+
+void Checker::onRemoteJobFinished(quint64 job, const ExecutorMessage &result)
+{
+    auto process = remoteJobs.take(job);
+    QString message = QString::fromUtf8(remoteErrors.take(job)).trimmed();
+    if (process == nullptr || !running.contains(process))
+        return;
+    if (result.crashed || result.timedOut)
+        finishCheck(process, Failed, "The checker crashed or timed out\n" + message);
+    else
+    {
+        auto verdict = verdictOfExitCode(result.exitCode, message);
+        finishCheck(process, verdict, message);
+    }
+}
+
+void Checker::onRemoteJobFailed(quint64 job, const QString &error)
+{
+    auto process = remoteJobs.take(job);
+    remoteErrors.remove(job);
+    if (process != nullptr && running.contains(process))
+        finishCheck(process, Failed, error);
+}
+
+void Checker::startCheck(const Check &check)
+{
+    if (tmpDir == nullptr || !tmpDir->isValid())
+    {
+        if (tmpDir != nullptr)
+            delete tmpDir;
+        tmpDir = new QTemporaryDir();
+    }
+
+    // every check has its own files, so that the checks of the same test from different runs don't conflict
+    QString prefix = QDir(tmpDir->path()).filePath(QString::number(++serial));
+    QStringList files = {prefix + ".in", prefix + ".out", prefix + ".ans"};
+    QList<QByteArray> contents = {check.input.toUtf8(), check.output, check.expected.toUtf8()};
+    for (int i = 0; i < 3; ++i)
+    {
+        // the output is written as it is, without the text mode translation of the line endings
+        QFile file(files[i]);
+        QIODevice::OpenMode mode = QIODevice::WriteOnly;
+        if (i != 1)
+            mode |= QIODevice::Text;
+        if (!file.open(mode) || file.write(contents[i]) < 0)
+        {
+            emit checkFinished(check.index, Failed, "Failed to write the file [" + files[i] + "] for the checker");
+            return;
+        }
+    }
+
+    auto process = new QProcess(this);
+    process->setProperty("files", files);
+    running[process] = check.index;
+    connect(process, SIGNAL(finished(int, QProcess::ExitStatus)), this,
+            SLOT(onProcessFinished(int, QProcess::ExitStatus)));
+    connect(process, SIGNAL(errorOccurred(QProcess::ProcessError)), this,
+            SLOT(onProcessErrorOccurred(QProcess::ProcessError)));
+
+    // a batch of checks waits for the CPU with the runs instead of oversubscribing it
+    auto scheduler = Scheduler::current();
+    if (scheduler != nullptr)
+    {
+        auto ticket = scheduler->request(owner, priority, Scheduler::DEFAULT_RUN_MEMORY, process);
+        if (!ticket->isGranted())
+        {
+            connect(ticket, SIGNAL(granted()), this, SLOT(onTicketGranted()));
+            return;
+        }
+    }
+    startProcess(process);
+}
+
+void Checker::startProcess(QProcess *process)
+{
+    auto files = process->property("files").toStringList();
+    if (ExecutorClient::isEnabled())
+    {
+        // the process is not started, it only holds the files and the ticket of the check
+        QString command = "\"" + binaryPath + "\"";
+        for (auto const &file : files)
+            command += " \"" + file + "\"";
+        auto client = ExecutorClient::instance();
+        connect(client, SIGNAL(jobOutput(quint64, int, const QByteArray &)), this,
+                SLOT(onRemoteJobOutput(quint64, int, const QByteArray &)), Qt::UniqueConnection);
+        connect(client, SIGNAL(jobFinished(quint64, const Core::ExecutorMessage &)), this,
+                SLOT(onRemoteJobFinished(quint64, const Core::ExecutorMessage &)), Qt::UniqueConnection);
+        connect(client, SIGNAL(jobFailed(quint64, const QString &)), this,
+                SLOT(onRemoteJobFailed(quint64, const QString &)), Qt::UniqueConnection);
+        remoteJobs[client->submit(command, QString(), QByteArray(), CHECKER_TIME_LIMIT, 0)] = process;
+        return;
+    }
+    QTimer::singleShot(CHECKER_TIME_LIMIT, process, SLOT(kill()));
+    process->start(binaryPath, files);
+}
+
+void Checker::finishCheck(QProcess *process, Verdict verdict, const QString &message)
+{
+    int index = running.take(process);
+    // the scheduler gets the slot back now rather than when the process is deleted
+    delete process->findChild<SchedulerTicket *>();
+    for (auto const &file : process->property("files").toStringList())
+        QFile::remove(file);
+    process->deleteLater();
+    emit checkFinished(index, verdict, message);
+}
+
+} // namespace Core
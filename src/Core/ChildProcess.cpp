@@ -0,0 +1,148 @@
+/*
+ * Copyright (C) 2019-2020 Ashar Khan <ashar786khan@gmail.com>
+ *
+ * This file is part of CPEditor.
+ *
+ * CPEditor is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * I will not be responsible if CPEditor behaves in unexpected way and
+ * causes your ratings to go down and or loose any important contest.
+ *
+ * Believe Software is "Software" and it isn't immune to bugs.
+ *
+ */
+
+#include "Core/ChildProcess.hpp"
+
+#include <QDir>
+#include <QFile>
+
+#if defined(Q_OS_UNIX)
+#include <signal.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+#if defined(Q_OS_LINUX)
+#include <sched.h>
+#endif
+
+namespace Core
+{
+
+ChildProcess::ChildProcess(QObject *parent) : QProcess(parent)
+{
+}
+
+void ChildProcess::setCpuAffinity(int core)
+{
+    affinity = core;
+}
+
+int ChildProcess::cpuAffinity() const
+{
+    return affinity;
+}
+
+void ChildProcess::setMemoryLimit(qint64 bytes)
+{
+    memory = bytes;
+}
+
+qint64 ChildProcess::memoryLimit() const
+{
+    return memory;
+}
+
+void ChildProcess::setCpuTimeLimit(int seconds)
+{
+    cpuSeconds = seconds;
+}
+
+QStringList ChildProcess::groupMembers(qint64 groupId)
+{
+    QStringList members;
+    // the signal 0 only checks whether the group has any process, which is the usual case that skips the scan
+    if (!signalGroup(groupId, 0))
+        return members;
+#if defined(Q_OS_LINUX)
+    for (auto const &entry : QDir("/proc").entryList(QDir::Dirs | QDir::NoDotAndDotDot))
+    {
+        bool isProcess = false;
+        entry.toLongLong(&isProcess);
+        if (!isProcess)
+            continue;
+        QFile file("/proc/" + entry + "/stat");
+        if (!file.open(QIODevice::ReadOnly))
+            continue;
+        // pid (comm) state ppid pgrp ..., the name may contain spaces and parentheses
+        auto stat = file.readAll();
+        int open = stat.indexOf('('), close = stat.lastIndexOf(')');
+        if (open < 0 || close < open)
+            continue;
+        auto fields = stat.mid(close + 2).split(' ');
+        // a zombie is already dead, it's only waiting for its parent
+        if (fields.size() > 2 && fields[0] != "Z" && fields[2].toLongLong() == groupId)
+            members.push_back(QString::fromUtf8(stat.mid(open + 1, close - open - 1)) + " (" + entry + ")");
+    }
+#else
+    members.push_back("process group " + QString::number(groupId));
+#endif
+    return members;
+}
+
+bool ChildProcess::signalGroup(qint64 groupId, int signal)
+{
+#if defined(Q_OS_UNIX)
+    return groupId > 0 && ::kill(static_cast<pid_t>(-groupId), signal) == 0;
+#else
+    return false;
+#endif
+}
+
+void ChildProcess::killTree()
+{
+#if defined(Q_OS_UNIX)
+    if (state() != NotRunning)
+        signalGroup(processId(), SIGKILL);
+#endif
+    // the child itself is killed anyway, in case it has left its process group
+    kill();
+}
+
+void ChildProcess::setupChildProcess()
+{
+#if defined(Q_OS_UNIX)
+    setpgid(0, 0);
+#endif
+#if defined(Q_OS_LINUX)
+    if (affinity >= 0 && affinity < CPU_SETSIZE)
+    {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(affinity, &set);
+        sched_setaffinity(0, sizeof(set), &set);
+    }
+#endif
+#if defined(Q_OS_UNIX)
+    if (memory > 0)
+    {
+        rlimit limit;
+        limit.rlim_cur = limit.rlim_max = static_cast<rlim_t>(memory);
+        setrlimit(RLIMIT_AS, &limit);
+    }
+    if (cpuSeconds > 0)
+    {
+        // SIGXCPU at the soft limit may be caught, the hard limit one second later kills the child anyway
+        rlimit limit;
+        limit.rlim_cur = static_cast<rlim_t>(cpuSeconds);
+        limit.rlim_max = static_cast<rlim_t>(cpuSeconds + 1);
+        setrlimit(RLIMIT_CPU, &limit);
+    }
+#endif
+}
+
+} // namespace Core
@@ -16,6 +16,8 @@
  */
 
 #include "Core/Compiler.hpp"
+#include "Core/ExecutorClient.hpp"
+#include "Core/Scheduler.hpp"
 #include <QFileInfo>
 
 namespace Core
@@ -23,7 +25,7 @@ namespace Core
 
 Compiler::Compiler()
 {
-    compileProcess = new QProcess();
+    compileProcess = new ChildProcess();
     connect(compileProcess, SIGNAL(started()), this, SIGNAL(compilationStarted()));
     connect(compileProcess, SIGNAL(finished(int, QProcess::ExitStatus)), this,
             SLOT(onProcessFinished(int, QProcess::ExitStatus)));
@@ -33,8 +35,13 @@ Compiler::~Compiler()
 {
     if (compileProcess != nullptr)
     {
+        // the compiler driver runs the compiler proper, the assembler and the linker as its own children
+        if (compileProcess->state() != QProcess::NotRunning)
+            compileProcess->killTree();
         delete compileProcess;
     }
+    if (remoteJob != 0)
+        ExecutorClient::instance()->cancel(remoteJob);
 }
 
 void Compiler::start(const QString &filePath, const QString &compileCommand, const QString &lang)
@@ -67,24 +74,49 @@ void Compiler::start(const QString &filePath, const QString &compileCommand, con
         return;
     }
 
-    compileProcess->start(command);
+    auto scheduler = Scheduler::current();
+    if (scheduler != nullptr)
+    {
+        ticket = scheduler->request(owner, priority, Scheduler::DEFAULT_COMPILE_MEMORY, this);
+        if (!ticket->isGranted())
+        {
+            pendingCommand = command;
+            connect(ticket, SIGNAL(granted()), this, SLOT(onTicketGranted()));
+            return;
+        }
+    }
+
+    startCommand(command);
 }
 
-bool Compiler::check(const QString &compileCommand)
+void Compiler::setScheduling(QObject *owner, Scheduler::Priority priority)
 {
-    QProcess checkProcess;
-    checkProcess.start(compileCommand.trimmed().split(' ').front() + " --version");
-    bool finished = checkProcess.waitForFinished(1000);
-    if (finished && checkProcess.exitCode() == 0)
-        return true;
-    checkProcess.kill();
-    checkProcess.start(compileCommand.trimmed().split(' ').front() + " -version");
-    finished = checkProcess.waitForFinished(1000);
-    return finished && checkProcess.exitCode() == 0;
+    this->owner = owner;
+    this->priority = priority;
+}
+
+void Compiler::startCommand(const QString &command)
+{
+    if (ExecutorClient::isEnabled())
+    {
+        auto client = ExecutorClient::instance();
+        connect(client, SIGNAL(jobStarted(quint64)), this, SLOT(onRemoteJobStarted(quint64)));
+        connect(client, SIGNAL(jobOutput(quint64, int, const QByteArray &)), this,
+                SLOT(onRemoteJobOutput(quint64, int, const QByteArray &)));
+        connect(client, SIGNAL(jobFinished(quint64, const Core::ExecutorMessage &)), this,
+                SLOT(onRemoteJobFinished(quint64, const Core::ExecutorMessage &)));
+        connect(client, SIGNAL(jobFailed(quint64, const QString &)), this,
+                SLOT(onRemoteJobFailed(quint64, const QString &)));
+        remoteJob = client->submit(command, QString(), QByteArray(), 0, 0);
+        return;
+    }
+
+    compileProcess->start(command);
 }
 
 void Compiler::onProcessFinished(int exitCode, QProcess::ExitStatus exitStatus)
 {
+    releaseTicket();
     if (exitCode == 0)
     {
         emit compilationFinished(compileProcess->readAllStandardError());
@@ -95,4 +127,51 @@ void Compiler::onProcessFinished(int exitCode, QProcess::ExitStatus exitStatus)
     }
 }
 
+void Compiler::onTicketGranted()
+{
+    startCommand(pendingCommand);
+}
+
+void Compiler::releaseTicket()
+{
+    if (ticket != nullptr)
+    {
+        delete ticket;
+        ticket = nullptr;
+    }
+}
+
+void Compiler::onRemoteJobStarted(quint64 job)
+{
+    if (job == remoteJob)
+        emit compilationStarted();
+}
+
+void Compiler::onRemoteJobOutput(quint64 job, int channel, const QByteArray &data)
+{
+    if (job == remoteJob && channel == ExecutorMessage::StandardError)
+        remoteError += data;
+}
+
+void Compiler::onRemoteJobFinished(quint64 job, const ExecutorMessage &result)
+{
+    if (job != remoteJob)
+        return;
+    remoteJob = 0;
+    releaseTicket();
+    if (result.exitCode == 0 && !result.crashed)
+        emit compilationFinished(remoteError);
+    else
+        emit compilationErrorOccured(remoteError);
+}
+
+void Compiler::onRemoteJobFailed(quint64 job, const QString &error)
+{
+    if (job != remoteJob)
+        return;
+    remoteJob = 0;
+    releaseTicket();
+    emit compilationErrorOccured(error);
+}
+
 } // namespace Core
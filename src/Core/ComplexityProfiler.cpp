@@ -0,0 +1,315 @@
+/*
+ * Copyright (C) 2019-2020 Ashar Khan <ashar786khan@gmail.com>
+ *
+ * This file is part of CPEditor.
+ *
+ * CPEditor is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * I will not be responsible if CPEditor behaves in unexpected way and
+ * causes your ratings to go down and or loose any important contest.
+ *
+ * Believe Software is "Software" and it isn't immune to bugs.
+ *
+ */
+
+#include "Core/ComplexityProfiler.hpp"
+#include <QMap>
+#include <QRandomGenerator>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace Core
+{
+
+const int ComplexityProfiler::MIN_MEASURABLE_TIME;
+const int ComplexityProfiler::MIN_NUMBER_OF_SAMPLES;
+
+double ComplexityProfiler::Fit::predict(qint64 n) const
+{
+    return constant + coefficient * modelValue(model, n);
+}
+
+QString ComplexityProfiler::Fit::name() const
+{
+    switch (model)
+    {
+    case Linear:
+        return "O(n)";
+    case LinearLogarithmic:
+        return "O(n log n)";
+    case Quadratic:
+        return "O(n^2)";
+    case Cubic:
+        return "O(n^3)";
+    }
+    return QString();
+}
+
+ComplexityProfiler::ComplexityProfiler(const QString &filePath, const QString &lang, const QString &runCommand,
+                                       const QString &args, int timeLimit, QObject *parent)
+    : QObject(parent), filePath(filePath), lang(lang), runCommand(runCommand), args(args), timeLimit(timeLimit)
+{
+}
+
+ComplexityProfiler::~ComplexityProfiler()
+{
+    stop();
+}
+
+void ComplexityProfiler::setFileIO(const QString &inputFileName, const QString &outputFileName)
+{
+    this->inputFileName = inputFileName;
+    this->outputFileName = outputFileName;
+}
+
+void ComplexityProfiler::start(const QString &generatorCommand, qint64 minN, qint64 maxN, int steps, int repetitions)
+{
+    stop();
+    this->generatorCommand = generatorCommand;
+    this->repetitions = qMax(1, repetitions);
+    measured.clear();
+    sizes.clear();
+
+    minN = qMax<qint64>(1, minN);
+    maxN = qMax(minN, maxN);
+    steps = qMax(2, steps);
+    double ratio = std::pow(static_cast<double>(maxN) / minN, 1.0 / (steps - 1));
+    for (int i = 0; i < steps; ++i)
+    {
+        qint64 n = i == steps - 1 ? maxN : static_cast<qint64>(std::llround(minN * std::pow(ratio, i)));
+        if (sizes.isEmpty() || n > sizes.back())
+            sizes.push_back(n);
+    }
+
+    currentSize = 0;
+    running = true;
+    generateNext();
+}
+
+void ComplexityProfiler::stop()
+{
+    running = false;
+    // stop() may be called from the signals of the generator or the runner
+    if (generator != nullptr)
+    {
+        generator->deleteLater();
+        generator = nullptr;
+    }
+    if (runner != nullptr)
+    {
+        runner->deleteLater();
+        runner = nullptr;
+    }
+}
+
+bool ComplexityProfiler::isRunning() const
+{
+    return running;
+}
+
+QVector<ComplexityProfiler::Sample> ComplexityProfiler::samples() const
+{
+    return measured;
+}
+
+double ComplexityProfiler::modelValue(Model model, qint64 n)
+{
+    double x = static_cast<double>(n);
+    switch (model)
+    {
+    case Linear:
+        return x;
+    case LinearLogarithmic:
+        return x * std::log2(qMax(2.0, x));
+    case Quadratic:
+        return x * x;
+    case Cubic:
+        return x * x * x;
+    }
+    return x;
+}
+
+QVector<ComplexityProfiler::Fit> ComplexityProfiler::fit(const QVector<Sample> &samples)
+{
+    QVector<Sample> usable;
+    for (auto const &sample : samples)
+    {
+        if (!sample.timedOut && sample.cpuTime >= MIN_MEASURABLE_TIME)
+            usable.push_back(sample);
+    }
+
+    QVector<Fit> fits;
+    for (auto model : {Linear, LinearLogarithmic, Quadratic, Cubic})
+    {
+        Fit result;
+        result.model = model;
+        if (usable.size() < MIN_NUMBER_OF_SAMPLES)
+        {
+            fits.push_back(result);
+            continue;
+        }
+
+        // weighted least squares of time = constant + coefficient * f(n), weighted by 1 / time^2 so that the relative
+        // errors are minimized, and f(n) is scaled by its largest value to keep the sums well conditioned
+        double scale = modelValue(model, usable.back().n);
+        double s = 0, sf = 0, st = 0, sff = 0, sft = 0;
+        for (auto const &sample : usable)
+        {
+            double t = sample.cpuTime, f = modelValue(model, sample.n) / scale, w = 1.0 / (t * t);
+            s += w;
+            sf += w * f;
+            st += w * t;
+            sff += w * f * f;
+            sft += w * f * t;
+        }
+        double det = s * sff - sf * sf;
+        double coefficient = std::abs(det) > std::numeric_limits<double>::epsilon() * s * sff
+                                 ? (s * sft - sf * st) / det
+                                 : sft / sff;
+        double constant = (st - coefficient * sf) / s;
+        if (constant < 0)
+        {
+            constant = 0;
+            coefficient = sft / sff;
+        }
+
+        result.valid = coefficient > 0;
+        result.constant = constant;
+        result.coefficient = coefficient / scale;
+        if (result.valid)
+        {
+            double error = 0;
+            for (auto const &sample : usable)
+            {
+                double relative = (result.predict(sample.n) - sample.cpuTime) / sample.cpuTime;
+                error += relative * relative;
+            }
+            result.error = std::sqrt(error / usable.size());
+        }
+        fits.push_back(result);
+    }
+
+    std::stable_sort(fits.begin(), fits.end(), [](const Fit &a, const Fit &b) {
+        if (a.valid != b.valid)
+            return a.valid;
+        return a.error < b.error;
+    });
+    return fits;
+}
+
+void ComplexityProfiler::onGenerated(int index, const QString &input)
+{
+    if (!running || index != currentSize)
+        return;
+    generator->deleteLater();
+    generator = nullptr;
+    currentInput = input;
+    currentTimes.clear();
+    currentTimedOut = false;
+    runNext();
+}
+
+void ComplexityProfiler::onGenerationFailed(int index, const QString &error)
+{
+    if (!running || index != currentSize)
+        return;
+    emit errorOccured(error);
+    finish();
+}
+
+void ComplexityProfiler::onRunFinished(int index, const QByteArray &out, const QByteArray &err, int exitCode,
+                                       int timeUsed)
+{
+    if (!running || runner == nullptr)
+        return;
+
+    currentTimes.push_back(currentTimedOut ? qMax(runner->stats().cpuTime, runTimeLimit()) : runner->stats().cpuTime);
+    runner->deleteLater();
+    runner = nullptr;
+
+    if (!currentTimedOut && exitCode != 0)
+    {
+        emit errorOccured("The solution exited with code " + QString::number(exitCode) + " on n = " +
+                          QString::number(sizes[currentSize]) + "\n" + QString::fromUtf8(err.left(1000)));
+        finish();
+        return;
+    }
+
+    // a timed out run won't get any faster when it's repeated
+    if (currentTimedOut || currentTimes.size() >= repetitions)
+        finishSize();
+    else
+        runNext();
+}
+
+void ComplexityProfiler::onRunErrorOccured(int index, const QString &error)
+{
+    if (!running)
+        return;
+    emit errorOccured(error);
+    finish();
+}
+
+void ComplexityProfiler::onRunTimeout(int index)
+{
+    currentTimedOut = true;
+}
+
+void ComplexityProfiler::generateNext()
+{
+    QMap<QString, QString> parameters;
+    parameters["n"] = QString::number(sizes[currentSize]);
+    parameters["seed"] = QString::number(QRandomGenerator::global()->generate());
+    generator = new Generator(currentSize);
+    connect(generator, SIGNAL(generated(int, const QString &)), this, SLOT(onGenerated(int, const QString &)));
+    connect(generator, SIGNAL(generationFailed(int, const QString &)), this,
+            SLOT(onGenerationFailed(int, const QString &)));
+    generator->generate(generatorCommand, parameters, qMax(10000, timeLimit * 5));
+}
+
+void ComplexityProfiler::runNext()
+{
+    runner = new Runner(currentSize);
+    runner->setFileIO(inputFileName, outputFileName);
+    connect(runner, SIGNAL(runFinished(int, const QByteArray &, const QByteArray &, int, int)), this,
+            SLOT(onRunFinished(int, const QByteArray &, const QByteArray &, int, int)));
+    connect(runner, SIGNAL(runErrorOccured(int, const QString &)), this,
+            SLOT(onRunErrorOccured(int, const QString &)));
+    connect(runner, SIGNAL(runTimeout(int)), this, SLOT(onRunTimeout(int)));
+    runner->run(filePath, lang, runCommand, args, currentInput, runTimeLimit());
+}
+
+void ComplexityProfiler::finishSize()
+{
+    // the median is robust against the runs disturbed by other processes
+    std::sort(currentTimes.begin(), currentTimes.end());
+    Sample sample;
+    sample.n = sizes[currentSize];
+    sample.cpuTime = currentTimes[currentTimes.size() / 2];
+    sample.timedOut = currentTimedOut;
+    measured.push_back(sample);
+    emit sampleMeasured(sample.n, sample.cpuTime, sample.timedOut);
+
+    // larger inputs would only time out as well
+    if (currentTimedOut || ++currentSize >= sizes.size())
+        finish();
+    else
+        generateNext();
+}
+
+void ComplexityProfiler::finish()
+{
+    stop();
+    emit profilingFinished();
+}
+
+int ComplexityProfiler::runTimeLimit() const
+{
+    return qMax(timeLimit * 2, timeLimit + 1000);
+}
+
+} // namespace Core
@@ -0,0 +1,278 @@
+/*
+ * Copyright (C) 2019-2020 Ashar Khan <ashar786khan@gmail.com>
+ *
+ * This file is part of CPEditor.
+ *
+ * CPEditor is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * I will not be responsible if CPEditor behaves in unexpected way and
+ * causes your ratings to go down and or loose any important contest.
+ *
+ * Believe Software is "Software" and it isn't immune to bugs.
+ *
+ */
+
+#include "Core/CoverageProfiler.hpp"
+#include "Core/Runner.hpp"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+
+namespace Core
+{
+
+CoverageProfiler::CoverageProfiler(QObject *parent) : QObject(parent)
+{
+}
+
+CoverageProfiler::~CoverageProfiler()
+{
+    stop();
+}
+
+void CoverageProfiler::start(const QString &binaryPath, const QString &sourcePath, const QStringList &inputs,
+                             int timeLimit, int parallel)
+{
+    stop();
+    this->binaryPath = binaryPath;
+    this->sourcePath = sourcePath;
+    this->inputs = inputs;
+    this->timeLimit = timeLimit;
+    this->parallel = qMax(1, parallel);
+    next = finished = 0;
+    counts = Result();
+
+    // the counters of the previous profile would be merged into the new ones
+    QDir directory = QFileInfo(binaryPath).dir();
+    for (auto const &file : directory.entryList({"*.gcda", "*.gcov"}, QDir::Files))
+        directory.remove(file);
+
+    if (inputs.isEmpty())
+    {
+        emit errorOccured("There's no test to run");
+        return;
+    }
+
+    running = true;
+    while (running && runs.size() < this->parallel && next < inputs.size())
+        startNext();
+}
+
+void CoverageProfiler::setFileIO(const QString &inputFileName, const QString &outputFileName)
+{
+    this->inputFileName = inputFileName;
+    this->outputFileName = outputFileName;
+}
+
+void CoverageProfiler::stop()
+{
+    running = false;
+    // stop() may be called from the signals of the processes
+    for (auto process : runs)
+    {
+        process->disconnect(this);
+        process->kill();
+        process->deleteLater();
+    }
+    runs.clear();
+    qDeleteAll(scratchDirs);
+    scratchDirs.clear();
+    if (gcov != nullptr)
+    {
+        gcov->disconnect(this);
+        gcov->kill();
+        gcov->deleteLater();
+        gcov = nullptr;
+    }
+}
+
+void CoverageProfiler::setScheduling(QObject *owner, Scheduler::Priority priority)
+{
+    this->owner = owner;
+    this->priority = priority;
+}
+
+bool CoverageProfiler::isRunning() const
+{
+    return running;
+}
+
+CoverageProfiler::Result CoverageProfiler::result() const
+{
+    return counts;
+}
+
+void CoverageProfiler::startNext()
+{
+    int index = next++;
+    auto process = new QProcess(this);
+    process->setProperty("index", index);
+    process->setWorkingDirectory(QFileInfo(binaryPath).path());
+    connect(process, SIGNAL(finished(int, QProcess::ExitStatus)), this, SLOT(onRunFinished(int, QProcess::ExitStatus)));
+    auto killTimer = new QTimer(process);
+    killTimer->setObjectName("killTimer");
+    killTimer->setSingleShot(true);
+    connect(killTimer, SIGNAL(timeout()), this, SLOT(onTimeout()));
+    runs.push_back(process);
+
+    // the counters are written next to the object files whatever the working directory is
+    if (!inputFileName.isEmpty() || !outputFileName.isEmpty())
+    {
+        auto directory = Runner::createScratchDirectory(inputFileName, inputs[index]);
+        if (directory == nullptr)
+        {
+            fail("Failed to prepare the working directory for the file I/O");
+            return;
+        }
+        scratchDirs[process] = directory;
+        process->setWorkingDirectory(directory->path());
+    }
+
+    // the ticket is a child of the process, so it's released when the process is deleted
+    auto scheduler = Scheduler::current();
+    if (scheduler != nullptr)
+    {
+        auto ticket = scheduler->request(owner, priority, Scheduler::DEFAULT_RUN_MEMORY, process);
+        if (!ticket->isGranted())
+        {
+            connect(ticket, SIGNAL(granted()), this, SLOT(onTicketGranted()));
+            return;
+        }
+    }
+    launch(process);
+}
+
+void CoverageProfiler::onTicketGranted()
+{
+    auto process = qobject_cast<QProcess *>(sender()->parent());
+    if (running && process != nullptr && runs.contains(process))
+        launch(process);
+}
+
+void CoverageProfiler::launch(QProcess *process)
+{
+    process->start(binaryPath, QStringList());
+    if (!process->waitForStarted(2000))
+    {
+        fail("Failed to start the instrumented program");
+        return;
+    }
+    process->findChild<QTimer *>("killTimer", Qt::FindDirectChildrenOnly)->start(timeLimit);
+    if (inputFileName.isEmpty())
+        process->write(inputs[process->property("index").toInt()].toUtf8());
+    process->closeWriteChannel();
+}
+
+void CoverageProfiler::onRunFinished(int exitCode, QProcess::ExitStatus exitStatus)
+{
+    auto process = qobject_cast<QProcess *>(sender());
+    if (!running || process == nullptr)
+        return;
+    int index = process->property("index").toInt();
+    runs.removeAll(process);
+    process->deleteLater();
+    delete scratchDirs.take(process);
+
+    // a crashed run doesn't write its counters either
+    if (exitStatus == QProcess::NormalExit)
+        ++counts.runs;
+    else if (!counts.killed.contains(index))
+        counts.killed.push_back(index);
+    emit testFinished(index, ++finished, inputs.size());
+
+    if (next < inputs.size())
+    {
+        startNext();
+        return;
+    }
+    if (!runs.isEmpty())
+        return;
+
+    if (counts.runs == 0)
+    {
+        fail("No run exited normally, so there are no counts");
+        return;
+    }
+
+    // gcov writes the annotated source to the working directory, the .gcno file is named after the binary by newer
+    // versions of GCC, so it's passed explicitly
+    QDir directory = QFileInfo(binaryPath).dir();
+    auto notes = directory.entryList({"*.gcno"}, QDir::Files);
+    if (notes.isEmpty())
+    {
+        fail("The coverage notes are not found, the program is probably not compiled with --coverage");
+        return;
+    }
+    gcov = new QProcess(this);
+    gcov->setWorkingDirectory(directory.path());
+    connect(gcov, SIGNAL(finished(int, QProcess::ExitStatus)), this, SLOT(onGcovFinished(int, QProcess::ExitStatus)));
+    gcov->start("gcov", {"-o", directory.filePath(notes.front()), sourcePath});
+    if (!gcov->waitForStarted(2000))
+        fail("Failed to start gcov, please make sure it's installed together with the compiler");
+}
+
+void CoverageProfiler::onGcovFinished(int exitCode, QProcess::ExitStatus exitStatus)
+{
+    if (!running || gcov == nullptr)
+        return;
+    QString error = gcov->readAllStandardError();
+    gcov->deleteLater();
+    gcov = nullptr;
+    if (exitStatus != QProcess::NormalExit || exitCode != 0)
+    {
+        fail("gcov failed: " + error);
+        return;
+    }
+    readCounts();
+}
+
+void CoverageProfiler::onTimeout()
+{
+    auto process = qobject_cast<QProcess *>(sender()->parent());
+    if (process == nullptr)
+        return;
+    counts.killed.push_back(process->property("index").toInt());
+    process->kill();
+}
+
+void CoverageProfiler::readCounts()
+{
+    QFile annotated(QFileInfo(binaryPath).dir().filePath(QFileInfo(sourcePath).fileName() + ".gcov"));
+    if (!annotated.open(QIODevice::ReadOnly))
+    {
+        fail("gcov didn't write the line counts");
+        return;
+    }
+
+    // each line is "count:line number:source", the count is "-" for the lines without code, "#####" or "=====" for
+    // the lines never executed, and it's followed by "*" if a part of the line is never executed
+    for (auto const &line : annotated.readAll().split('\n'))
+    {
+        auto fields = line.split(':');
+        if (fields.size() < 3)
+            continue;
+        auto count = fields[0].trimmed();
+        int number = fields[1].trimmed().toInt();
+        if (number <= 0 || count == "-")
+            continue;
+        while (counts.lines.size() < number)
+            counts.lines.push_back(-1);
+        if (count.endsWith('*'))
+            count.chop(1);
+        counts.lines[number - 1] = count.startsWith('#') || count.startsWith('=') ? 0 : count.toLongLong();
+    }
+
+    running = false;
+    emit profilingFinished();
+}
+
+void CoverageProfiler::fail(const QString &error)
+{
+    stop();
+    emit errorOccured(error);
+}
+
+} // namespace Core
@@ -0,0 +1,238 @@
+/*
+ * Copyright (C) 2019-2020 Ashar Khan <ashar786khan@gmail.com>
+ *
+ * This file is part of CPEditor.
+ *
+ * CPEditor is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * I will not be responsible if CPEditor behaves in unexpected way and
+ * causes your ratings to go down and or loose any important contest.
+ *
+ * Believe Software is "Software" and it isn't immune to bugs.
+ *
+ */
+
+#include "Core/ExecutorClient.hpp"
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QProcess>
+
+namespace Core
+{
+
+bool ExecutorClient::enabled = false;
+
+const int ExecutorClient::RETRY_INTERVAL;
+const int ExecutorClient::MAX_RETRIES;
+
+ExecutorClient *ExecutorClient::instance()
+{
+    static ExecutorClient *client = new ExecutorClient(QCoreApplication::instance());
+    return client;
+}
+
+bool ExecutorClient::isEnabled()
+{
+    return enabled;
+}
+
+void ExecutorClient::setEnabled(bool value)
+{
+    enabled = value;
+}
+
+ExecutorClient::ExecutorClient(QObject *parent) : QObject(parent)
+{
+    // there are less than a thousand jobs per millisecond, so the IDs don't repeat after a restart
+    lastJob = static_cast<quint64>(QDateTime::currentMSecsSinceEpoch()) * 1000;
+
+    socket = new QLocalSocket(this);
+    connect(socket, SIGNAL(connected()), this, SLOT(onConnected()));
+    connect(socket, SIGNAL(disconnected()), this, SLOT(onDisconnected()));
+    connect(socket, SIGNAL(error(QLocalSocket::LocalSocketError)), this,
+            SLOT(onErrorOccurred(QLocalSocket::LocalSocketError)));
+    connect(socket, SIGNAL(readyRead()), this, SLOT(onReadyRead()));
+
+    retryTimer = new QTimer(this);
+    retryTimer->setSingleShot(true);
+    retryTimer->setInterval(RETRY_INTERVAL);
+    connect(retryTimer, SIGNAL(timeout()), this, SLOT(onRetryTimeout()));
+}
+
+void ExecutorClient::setSession(const QString &session)
+{
+    this->session = session;
+}
+
+void ExecutorClient::attach()
+{
+    if (socket->state() == QLocalSocket::UnconnectedState && !retryTimer->isActive())
+        connectToDaemon();
+}
+
+quint64 ExecutorClient::submit(const QString &command, const QString &workingDirectory, const QByteArray &input,
+                               int timeLimit, qint64 memoryLimit)
+{
+    ExecutorMessage message;
+    message.type = ExecutorMessage::Submit;
+    message.job = ++lastJob;
+    message.text = command;
+    message.workingDirectory = workingDirectory;
+    message.data = input;
+    message.timeLimit = timeLimit;
+    message.memoryLimit = memoryLimit;
+    pending.push_back(message.job);
+    send(message);
+    return message.job;
+}
+
+void ExecutorClient::cancel(quint64 job)
+{
+    if (!pending.contains(job))
+        return;
+    if (detaching)
+    {
+        pending.removeOne(job);
+        return;
+    }
+    ExecutorMessage message;
+    message.type = ExecutorMessage::Cancel;
+    message.job = job;
+    send(message);
+}
+
+void ExecutorClient::setDetaching(bool value)
+{
+    detaching = value;
+}
+
+void ExecutorClient::onConnected()
+{
+    retries = 0;
+    daemonStarted = false;
+
+    ExecutorMessage hello;
+    hello.type = ExecutorMessage::Hello;
+    hello.text = session.isEmpty() ? QString::number(QCoreApplication::applicationPid()) : session;
+    hello.timeLimit = ExecutorMessage::PROTOCOL_VERSION;
+    socket->write(hello.encode());
+    for (auto const &data : queue)
+        socket->write(data);
+    queue.clear();
+}
+
+void ExecutorClient::onDisconnected()
+{
+    buffer.clear();
+    if (pending.isEmpty())
+        return;
+
+    // the daemon keeps running the jobs, ask for them again on the next connection, and it fails the ones it lost
+    for (auto job : pending)
+    {
+        ExecutorMessage message;
+        message.type = ExecutorMessage::Attach;
+        message.job = job;
+        queue.push_back(message.encode());
+    }
+    retryTimer->start();
+}
+
+void ExecutorClient::onErrorOccurred(QLocalSocket::LocalSocketError error)
+{
+    // the errors of an established connection are followed by disconnected()
+    if (socket->state() == QLocalSocket::ConnectedState || queue.isEmpty())
+        return;
+
+    if (!daemonStarted)
+    {
+        daemonStarted = QProcess::startDetached(QCoreApplication::applicationFilePath(), {"--executor"});
+        if (!daemonStarted)
+        {
+            queue.clear();
+            failPendingJobs("Failed to start the executor daemon");
+            return;
+        }
+    }
+
+    if (++retries > MAX_RETRIES)
+    {
+        retries = 0;
+        daemonStarted = false;
+        queue.clear();
+        failPendingJobs("Failed to connect to the executor daemon: " + socket->errorString());
+        return;
+    }
+    retryTimer->start();
+}
+
+void ExecutorClient::onReadyRead()
+{
+    buffer += socket->readAll();
+
+    ExecutorMessage message;
+    bool corrupted = false;
+    while (ExecutorMessage::decode(buffer, message, &corrupted))
+    {
+        switch (message.type)
+        {
+        case ExecutorMessage::Started:
+            emit jobStarted(message.job);
+            break;
+        case ExecutorMessage::Output:
+            emit jobOutput(message.job, message.channel, message.data);
+            break;
+        case ExecutorMessage::Finished:
+            if (pending.removeOne(message.job))
+                emit jobFinished(message.job, message);
+            else
+                emit jobFinishedWhileAway(message);
+            break;
+        case ExecutorMessage::Failed:
+            if (pending.removeOne(message.job))
+                emit jobFailed(message.job, message.text);
+            else if (message.job != 0)
+                emit jobFinishedWhileAway(message);
+            break;
+        default:
+            break;
+        }
+    }
+    if (corrupted)
+        socket->abort();
+}
+
+void ExecutorClient::onRetryTimeout()
+{
+    connectToDaemon();
+}
+
+void ExecutorClient::send(const ExecutorMessage &message)
+{
+    if (socket->state() == QLocalSocket::ConnectedState)
+    {
+        socket->write(message.encode());
+        return;
+    }
+    queue.push_back(message.encode());
+    if (socket->state() == QLocalSocket::UnconnectedState && !retryTimer->isActive())
+        connectToDaemon();
+}
+
+void ExecutorClient::connectToDaemon()
+{
+    socket->connectToServer(ExecutorMessage::serverName());
+}
+
+void ExecutorClient::failPendingJobs(const QString &error)
+{
+    auto jobs = pending;
+    pending.clear();
+    for (auto job : jobs)
+        emit jobFailed(job, error);
+}
+
+} // namespace Core
@@ -0,0 +1,339 @@
+/*
+ * Copyright (C) 2019-2020 Ashar Khan <ashar786khan@gmail.com>
+ *
+ * This file is part of CPEditor.
+ *
+ * CPEditor is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * I will not be responsible if CPEditor behaves in unexpected way and
+ * causes your ratings to go down and or loose any important contest.
+ *
+ * Believe Software is "Software" and it isn't immune to bugs.
+ *
+ */
+
+#include "Core/ExecutorDaemon.hpp"
+#include <QCoreApplication>
+#include <QLocalServer>
+#include <QLocalSocket>
+
+namespace Core
+{
+
+const int ExecutorDaemon::IDLE_TIMEOUT;
+const qint64 ExecutorDaemon::MAX_BACKLOG_OUTPUT;
+const int ExecutorDaemon::MAX_FINISHED;
+
+ExecutorDaemon::ExecutorDaemon(QObject *parent) : QObject(parent)
+{
+    server = new QLocalServer(this);
+    server->setSocketOptions(QLocalServer::UserAccessOption);
+    connect(server, SIGNAL(newConnection()), this, SLOT(onNewConnection()));
+    idleTimer = new QTimer(this);
+    idleTimer->setSingleShot(true);
+    idleTimer->setInterval(IDLE_TIMEOUT);
+    connect(idleTimer, SIGNAL(timeout()), this, SLOT(onIdleTimeout()));
+}
+
+ExecutorDaemon::~ExecutorDaemon()
+{
+    for (auto job : jobs)
+    {
+        job->process->disconnect(this);
+        job->process->killTree();
+        job->process->waitForFinished(100);
+        delete job->process;
+        delete job;
+    }
+}
+
+bool ExecutorDaemon::listen()
+{
+    auto name = ExecutorMessage::serverName();
+    QLocalSocket existing;
+    existing.connectToServer(name);
+    if (existing.waitForConnected(500))
+        return false;
+    // the socket file of a crashed daemon is left on Unix
+    QLocalServer::removeServer(name);
+    if (!server->listen(name))
+        return false;
+    updateIdleTimer();
+    return true;
+}
+
+void ExecutorDaemon::onNewConnection()
+{
+    while (server->hasPendingConnections())
+    {
+        auto socket = server->nextPendingConnection();
+        clients[socket] = Client();
+        connect(socket, SIGNAL(readyRead()), this, SLOT(onSocketReadyRead()));
+        connect(socket, SIGNAL(disconnected()), this, SLOT(onSocketDisconnected()));
+    }
+    updateIdleTimer();
+}
+
+void ExecutorDaemon::onSocketReadyRead()
+{
+    auto socket = qobject_cast<QLocalSocket *>(sender());
+    if (socket == nullptr || !clients.contains(socket))
+        return;
+    clients[socket].buffer += socket->readAll();
+
+    ExecutorMessage message;
+    bool corrupted = false;
+    while (clients.contains(socket) && ExecutorMessage::decode(clients[socket].buffer, message, &corrupted))
+        handle(socket, message);
+    if (corrupted)
+        socket->abort();
+}
+
+void ExecutorDaemon::onSocketDisconnected()
+{
+    auto socket = qobject_cast<QLocalSocket *>(sender());
+    if (socket == nullptr)
+        return;
+    clients.remove(socket);
+    socket->deleteLater();
+    updateIdleTimer();
+}
+
+void ExecutorDaemon::handle(QLocalSocket *socket, const ExecutorMessage &message)
+{
+    auto &client = clients[socket];
+    switch (message.type)
+    {
+    case ExecutorMessage::Hello: {
+        if (message.timeLimit != ExecutorMessage::PROTOCOL_VERSION)
+        {
+            // an editor of another version is connecting, let it start its own daemon and quit after the jobs
+            ExecutorMessage reply;
+            reply.type = ExecutorMessage::Failed;
+            reply.text = "The executor daemon uses another protocol version";
+            socket->write(reply.encode());
+            socket->disconnectFromServer();
+            server->close();
+            return;
+        }
+        client.session = message.text;
+        for (auto const &data : backlogs.take(client.session).messages)
+            socket->write(data);
+        break;
+    }
+    case ExecutorMessage::Attach: {
+        // the results of the jobs finished during the disconnection are in the backlog sent on Hello
+        bool known = finished.value(client.session).contains(message.job);
+        for (auto job : jobs)
+            known = known || (job->session == client.session && job->id == message.job);
+        if (!known)
+        {
+            ExecutorMessage reply;
+            reply.type = ExecutorMessage::Failed;
+            reply.job = message.job;
+            reply.text = "The job is lost by the executor daemon";
+            socket->write(reply.encode());
+        }
+        break;
+    }
+    case ExecutorMessage::Submit:
+        if (!client.session.isEmpty())
+            submit(client.session, message);
+        break;
+    case ExecutorMessage::Cancel:
+        for (auto job : jobs)
+        {
+            if (job->session == client.session && job->id == message.job)
+            {
+                job->process->killTree();
+                break;
+            }
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+void ExecutorDaemon::submit(const QString &session, const ExecutorMessage &message)
+{
+    auto job = new Job();
+    job->session = session;
+    job->id = message.job;
+    job->command = message.text;
+    job->input = message.data;
+    job->process = new ChildProcess(this);
+    job->process->setMemoryLimit(message.memoryLimit);
+    if (!message.workingDirectory.isEmpty())
+        job->process->setWorkingDirectory(message.workingDirectory);
+    job->monitor = new ProcessMonitor(job->process, job->process);
+    if (message.timeLimit > 0)
+    {
+        job->killTimer = new QTimer(job->process);
+        job->killTimer->setSingleShot(true);
+        job->killTimer->setInterval(message.timeLimit);
+        connect(job->killTimer, SIGNAL(timeout()), this, SLOT(onJobTimeout()));
+    }
+    connect(job->process, SIGNAL(started()), this, SLOT(onJobStarted()));
+    connect(job->process, SIGNAL(readyReadStandardOutput()), this, SLOT(onJobReadyRead()));
+    connect(job->process, SIGNAL(readyReadStandardError()), this, SLOT(onJobReadyRead()));
+    connect(job->process, SIGNAL(finished(int, QProcess::ExitStatus)), this,
+            SLOT(onJobFinished(int, QProcess::ExitStatus)));
+    connect(job->process, SIGNAL(errorOccurred(QProcess::ProcessError)), this,
+            SLOT(onJobErrorOccurred(QProcess::ProcessError)));
+    jobs.push_back(job);
+    updateIdleTimer();
+    job->process->start(message.text);
+}
+
+void ExecutorDaemon::onJobStarted()
+{
+    auto job = jobOf(sender());
+    if (job == nullptr)
+        return;
+    job->timer.start();
+    job->monitor->start();
+    if (job->killTimer != nullptr)
+        job->killTimer->start();
+
+    ExecutorMessage message;
+    message.type = ExecutorMessage::Started;
+    message.job = job->id;
+    send(job->session, message);
+
+    job->process->write(job->input);
+    job->process->closeWriteChannel();
+    job->input.clear();
+}
+
+void ExecutorDaemon::onJobReadyRead()
+{
+    auto job = jobOf(sender());
+    if (job == nullptr)
+        return;
+
+    ExecutorMessage message;
+    message.type = ExecutorMessage::Output;
+    message.job = job->id;
+    message.data = job->process->readAllStandardOutput();
+    if (!message.data.isEmpty())
+        send(job->session, message);
+    message.channel = ExecutorMessage::StandardError;
+    message.data = job->process->readAllStandardError();
+    if (!message.data.isEmpty())
+        send(job->session, message);
+}
+
+void ExecutorDaemon::onJobFinished(int exitCode, QProcess::ExitStatus exitStatus)
+{
+    auto job = jobOf(sender());
+    if (job == nullptr)
+        return;
+    onJobReadyRead();
+    job->monitor->stop();
+
+    ExecutorMessage message;
+    message.type = ExecutorMessage::Finished;
+    message.job = job->id;
+    message.exitCode = exitCode;
+    message.crashed = exitStatus == QProcess::CrashExit;
+    message.timedOut = job->timedOut;
+    message.timeUsed = job->timer.isValid() ? static_cast<int>(job->timer.elapsed()) : 0;
+    message.cpuTime = job->monitor->stats().cpuTime;
+    message.peakMemory = job->monitor->stats().peakMemory;
+    message.text = job->command;
+    send(job->session, message);
+    finishJob(job);
+}
+
+void ExecutorDaemon::onJobErrorOccurred(QProcess::ProcessError error)
+{
+    // the other errors are followed by finished()
+    auto job = jobOf(sender());
+    if (job == nullptr || error != QProcess::FailedToStart)
+        return;
+
+    ExecutorMessage message;
+    message.type = ExecutorMessage::Failed;
+    message.job = job->id;
+    message.text = "Failed to start [" + job->process->program() + "]: " + job->process->errorString();
+    send(job->session, message);
+    finishJob(job);
+}
+
+void ExecutorDaemon::onJobTimeout()
+{
+    auto timer = sender();
+    auto job = timer == nullptr ? nullptr : jobOf(timer->parent());
+    if (job == nullptr || job->process->state() != QProcess::Running)
+        return;
+    job->timedOut = true;
+    job->monitor->stop();
+    job->process->killTree();
+}
+
+void ExecutorDaemon::onIdleTimeout()
+{
+    QCoreApplication::quit();
+}
+
+void ExecutorDaemon::send(const QString &session, const ExecutorMessage &message)
+{
+    for (auto it = clients.begin(); it != clients.end(); ++it)
+    {
+        if (it->session == session && it.key()->state() == QLocalSocket::ConnectedState)
+        {
+            it.key()->write(message.encode());
+            return;
+        }
+    }
+
+    // keep the messages until the editor connects again, the output beyond the limit is dropped but the results are
+    // always kept, so the editor learns how every job ends
+    auto &backlog = backlogs[session];
+    if (message.type == ExecutorMessage::Output)
+    {
+        if (backlog.outputSize + message.data.size() > MAX_BACKLOG_OUTPUT)
+            return;
+        backlog.outputSize += message.data.size();
+    }
+    backlog.messages.push_back(message.encode());
+}
+
+void ExecutorDaemon::finishJob(Job *job)
+{
+    auto &ids = finished[job->session];
+    ids.push_back(job->id);
+    if (ids.size() > MAX_FINISHED)
+        ids.removeFirst();
+    jobs.removeOne(job);
+    job->process->disconnect(this);
+    job->process->deleteLater();
+    delete job;
+    updateIdleTimer();
+}
+
+ExecutorDaemon::Job *ExecutorDaemon::jobOf(QObject *object) const
+{
+    for (auto job : jobs)
+    {
+        if (job->process == object)
+            return job;
+    }
+    return nullptr;
+}
+
+void ExecutorDaemon::updateIdleTimer()
+{
+    if (!clients.isEmpty() || !jobs.isEmpty())
+        idleTimer->stop();
+    else if (!server->isListening())
+        QCoreApplication::quit();
+    else if (!idleTimer->isActive())
+        idleTimer->start();
+}
+
+} // namespace Core
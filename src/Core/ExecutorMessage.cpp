@@ -0,0 +1,137 @@
+/*
+ * Copyright (C) 2019-2020 Ashar Khan <ashar786khan@gmail.com>
+ *
+ * This file is part of CPEditor.
+ *
+ * CPEditor is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * I will not be responsible if CPEditor behaves in unexpected way and
+ * causes your ratings to go down and or loose any important contest.
+ *
+ * Believe Software is "Software" and it isn't immune to bugs.
+ *
+ */
+
+#include "Core/ExecutorMessage.hpp"
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDir>
+#include <QtEndian>
+
+namespace Core
+{
+
+const int ExecutorMessage::PROTOCOL_VERSION;
+const int ExecutorMessage::MAX_MESSAGE_SIZE;
+
+QByteArray ExecutorMessage::encode() const
+{
+    QByteArray payload;
+    QDataStream stream(&payload, QIODevice::WriteOnly);
+    stream.setVersion(QDataStream::Qt_5_12);
+    stream << static_cast<quint8>(type) << job;
+    switch (type)
+    {
+    case Hello:
+        stream << text << static_cast<qint32>(timeLimit);
+        break;
+    case Submit:
+        stream << text << workingDirectory << data << static_cast<qint32>(timeLimit) << memoryLimit;
+        break;
+    case Output:
+        stream << static_cast<quint8>(channel) << data;
+        break;
+    case Finished:
+        stream << static_cast<qint32>(exitCode) << crashed << timedOut << static_cast<qint32>(timeUsed)
+               << static_cast<qint32>(cpuTime) << peakMemory << text;
+        break;
+    case Failed:
+        stream << text;
+        break;
+    case Cancel:
+    case Started:
+    case Attach:
+        break;
+    }
+
+    QByteArray frame(4, '\0');
+    qToBigEndian(static_cast<quint32>(payload.size()), reinterpret_cast<uchar *>(frame.data()));
+    return frame + payload;
+}
+
+bool ExecutorMessage::decode(QByteArray &buffer, ExecutorMessage &message, bool *corrupted)
+{
+    if (corrupted != nullptr)
+        *corrupted = false;
+    if (buffer.size() < 4)
+        return false;
+    quint32 size = qFromBigEndian<quint32>(reinterpret_cast<const uchar *>(buffer.constData()));
+    if (size > static_cast<quint32>(MAX_MESSAGE_SIZE))
+    {
+        if (corrupted != nullptr)
+            *corrupted = true;
+        return false;
+    }
+    if (static_cast<quint32>(buffer.size()) < size + 4)
+        return false;
+
+    QByteArray payload = buffer.mid(4, static_cast<int>(size));
+    buffer.remove(0, static_cast<int>(size) + 4);
+
+    QDataStream stream(payload);
+    stream.setVersion(QDataStream::Qt_5_12);
+    quint8 type = 0, channel = 0;
+    qint32 timeLimit = 0, exitCode = 0, timeUsed = 0, cpuTime = 0;
+    message = ExecutorMessage();
+    stream >> type >> message.job;
+    message.type = static_cast<Type>(type);
+    switch (message.type)
+    {
+    case Hello:
+        stream >> message.text >> timeLimit;
+        break;
+    case Submit:
+        stream >> message.text >> message.workingDirectory >> message.data >> timeLimit >> message.memoryLimit;
+        break;
+    case Output:
+        stream >> channel >> message.data;
+        break;
+    case Finished:
+        stream >> exitCode >> message.crashed >> message.timedOut >> timeUsed >> cpuTime >> message.peakMemory >>
+            message.text;
+        break;
+    case Failed:
+        stream >> message.text;
+        break;
+    case Cancel:
+    case Started:
+    case Attach:
+        break;
+    default:
+        stream.setStatus(QDataStream::ReadCorruptData);
+    }
+    message.timeLimit = timeLimit;
+    message.channel = channel;
+    message.exitCode = exitCode;
+    message.timeUsed = timeUsed;
+    message.cpuTime = cpuTime;
+
+    if (stream.status() != QDataStream::Ok)
+    {
+        if (corrupted != nullptr)
+            *corrupted = true;
+        return false;
+    }
+    return true;
+}
+
+QString ExecutorMessage::serverName()
+{
+    auto hash = QCryptographicHash::hash(QDir::homePath().toUtf8(), QCryptographicHash::Sha1).toHex().left(12);
+    return "cpeditor-executor-" + QString::fromLatin1(hash);
+}
+
+} // namespace Core
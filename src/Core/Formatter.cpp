@@ -29,26 +29,6 @@ Formatter::Formatter(const QString &clangFormatBinary, const QString &clangForma
     updateStyle(clangFormatStyle);
 }
 
-bool Formatter::check(const QString &checkBinary, const QString &checkStyle)
-{
-    QTemporaryDir tmpDir;
-    if (!tmpDir.isValid())
-        return false;
-    QFile tmpFile(tmpDir.filePath("tmp.cpp"));
-    tmpFile.open(QIODevice::WriteOnly | QIODevice::Text);
-    tmpFile.write("int main(){}");
-    tmpFile.close();
-    QFile styleFile(tmpDir.filePath(".clang-format"));
-    styleFile.open(QIODevice::WriteOnly | QIODevice::Text);
-    styleFile.write(checkStyle.toStdString().c_str());
-    styleFile.close();
-    QProcess program;
-    program.start(checkBinary, {"--cursor=0", "--offset=0", "--length=0", "--style=file", tmpFile.fileName()});
-    if (!program.waitForFinished(2000))
-        program.kill();
-    return program.exitCode() == 0;
-}
-
 void Formatter::updateBinary(const QString& newBinary)
 {
     binary = newBinary;
@@ -0,0 +1,133 @@
+/*
+ * Copyright (C) 2019-2020 Ashar Khan <ashar786khan@gmail.com>
+ *
+ * This file is part of CPEditor.
+ *
+ * CPEditor is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * I will not be responsible if CPEditor behaves in unexpected way and
+ * causes your ratings to go down and or loose any important contest.
+ *
+ * Believe Software is "Software" and it isn't immune to bugs.
+ *
+ */
+
+#include "Core/Generator.hpp"
+
+namespace Core
+{
+
+Generator::Generator(int index, QObject *parent) : QObject(parent), generatorIndex(index)
+{
+    process = new QProcess(this);
+    killTimer = new QTimer(this);
+    killTimer->setSingleShot(true);
+    connect(process, SIGNAL(finished(int, QProcess::ExitStatus)), this, SLOT(onFinished(int, QProcess::ExitStatus)));
+    connect(process, SIGNAL(errorOccurred(QProcess::ProcessError)), this,
+            SLOT(onErrorOccurred(QProcess::ProcessError)));
+    connect(killTimer, SIGNAL(timeout()), this, SLOT(onTimeout()));
+}
+
+Generator::~Generator()
+{
+    if (process->state() != QProcess::NotRunning)
+    {
+        process->disconnect(this);
+        process->kill();
+        process->waitForFinished(1000);
+    }
+}
+
+void Generator::generate(const QString &command, const QMap<QString, QString> &parameters, int timeLimit)
+{
+    expandedCommand = expandCommand(command, parameters);
+    if (expandedCommand.trimmed().isEmpty())
+    {
+        emit generationFailed(generatorIndex, "The generator command is empty");
+        return;
+    }
+    killTimer->setInterval(timeLimit);
+
+    auto scheduler = Scheduler::current();
+    if (scheduler != nullptr)
+    {
+        ticket = scheduler->request(nullptr, Scheduler::Background, Scheduler::DEFAULT_RUN_MEMORY, this);
+        if (!ticket->isGranted())
+        {
+            connect(ticket, SIGNAL(granted()), this, SLOT(onTicketGranted()));
+            return;
+        }
+    }
+    start();
+}
+
+void Generator::onTicketGranted()
+{
+    start();
+}
+
+void Generator::start()
+{
+    // the time limit starts when the generator does, not while it's queued
+    killTimer->start();
+    process->start(expandedCommand);
+}
+
+void Generator::releaseTicket()
+{
+    if (ticket != nullptr)
+    {
+        delete ticket;
+        ticket = nullptr;
+    }
+}
+
+QString Generator::expandCommand(const QString &command, const QMap<QString, QString> &parameters)
+{
+    QString result = command;
+    for (auto it = parameters.constBegin(); it != parameters.constEnd(); ++it)
+        result.replace("{" + it.key() + "}", it.value());
+    return result;
+}
+
+void Generator::onFinished(int exitCode, QProcess::ExitStatus exitStatus)
+{
+    killTimer->stop();
+    releaseTicket();
+    if (exitStatus == QProcess::NormalExit && exitCode == 0)
+    {
+        emit generated(generatorIndex, process->readAllStandardOutput());
+    }
+    else
+    {
+        emit generationFailed(generatorIndex, "The generator [" + expandedCommand + "] exited with code " +
+                                                  QString::number(exitCode) + "\n" +
+                                                  process->readAllStandardError());
+    }
+}
+
+void Generator::onErrorOccurred(QProcess::ProcessError error)
+{
+    if (error == QProcess::FailedToStart)
+    {
+        killTimer->stop();
+        releaseTicket();
+        emit generationFailed(generatorIndex, "Failed to start the generator [" + expandedCommand + "]");
+    }
+}
+
+void Generator::onTimeout()
+{
+    if (process->state() != QProcess::NotRunning)
+    {
+        process->disconnect(this);
+        process->kill();
+        releaseTicket();
+        emit generationFailed(generatorIndex, "The generator [" + expandedCommand + "] took too long");
+    }
+}
+
+} // namespace Core
@@ -0,0 +1,366 @@
+/*
+ * Copyright (C) 2019-2020 Ashar Khan <ashar786khan@gmail.com>
+ *
+ * This file is part of CPEditor.
+ *
+ * CPEditor is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * I will not be responsible if CPEditor behaves in unexpected way and
+ * causes your ratings to go down and or loose any important contest.
+ *
+ * Believe Software is "Software" and it isn't immune to bugs.
+ *
+ */
+
+#include "Core/HeadlessJudge.hpp"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+
+namespace Core
+{
+
+HeadlessJudge::HeadlessJudge(const Options &options, const Settings::SettingsData &data, QObject *parent)
+    : QObject(parent), options(options), data(data)
+{
+    scheduler = new Scheduler(this);
+    scheduler->setBudget(options.jobs, 0);
+    checker = new Checker(this);
+    checker->setScheduling(this, Scheduler::Interactive);
+    connect(checker, &Checker::checkFinished, this, &HeadlessJudge::onCheckFinished);
+    if (!options.checkerPath.isEmpty())
+        checker->setChecker(options.checkerPath, data.compileCommandCpp);
+    if (this->options.timeLimit <= 0)
+        this->options.timeLimit = data.timeLimit;
+}
+
+HeadlessJudge::~HeadlessJudge()
+{
+    for (auto compiler : compilers.keys())
+        delete compiler;
+    for (auto &test : tests)
+        delete test.runner;
+    for (auto &solution : solutions)
+        delete solution.buildDir;
+}
+
+void HeadlessJudge::start()
+{
+    for (auto const &source : options.sources)
+    {
+        Solution solution;
+        solution.source = QFileInfo(source).absoluteFilePath();
+        solution.language = languageOf(source);
+        solution.buildPath = solution.source;
+        if (solution.language == "Java")
+        {
+            solution.buildDir = new QTemporaryDir();
+            auto copy = solution.buildDir->filePath(QFileInfo(source).fileName());
+            if (solution.buildDir->isValid() && QFile::copy(solution.source, copy))
+                solution.buildPath = copy;
+        }
+        solutions.push_back(solution);
+        loadTests(solutions.size() - 1);
+    }
+
+    // every solution is pending until its compilation is finished
+    pending = solutions.size();
+    if (pending == 0)
+    {
+        emit finished();
+        return;
+    }
+
+    for (int i = 0; i < solutions.size(); ++i)
+    {
+        QString command;
+        if (solutions[i].language == "C++")
+            command = Settings::compileCommandCpp(data);
+        else if (solutions[i].language == "Java")
+            command = data.compileCommandJava;
+
+        auto compiler = new Compiler();
+        compilers[compiler] = i;
+        compiler->setScheduling(this, Scheduler::Interactive);
+        connect(compiler, SIGNAL(compilationFinished(const QString &)), this,
+                SLOT(onCompilationFinished(const QString &)));
+        connect(compiler, SIGNAL(compilationErrorOccured(const QString &)), this,
+                SLOT(onCompilationErrorOccured(const QString &)));
+        compiler->start(solutions[i].buildPath, command, solutions[i].language);
+    }
+}
+
+bool HeadlessJudge::isSuccessful() const
+{
+    for (auto const &solution : solutions)
+    {
+        if (!solution.compiled || solution.tests.isEmpty())
+            return false;
+    }
+    for (auto const &test : tests)
+    {
+        if (test.verdict != "AC" && test.verdict != "OK" && test.verdict != "SKIP")
+            return false;
+    }
+    return true;
+}
+
+bool HeadlessJudge::hasSolutionWithoutTests() const
+{
+    for (auto const &solution : solutions)
+    {
+        if (solution.tests.isEmpty())
+            return true;
+    }
+    return false;
+}
+
+QJsonObject HeadlessJudge::report() const
+{
+    QJsonArray solutionsArray;
+    for (auto const &solution : solutions)
+    {
+        QJsonObject solutionObject;
+        solutionObject["source"] = solution.source;
+        solutionObject["language"] = solution.language;
+        solutionObject["compiled"] = solution.compiled;
+        if (!solution.compileError.isEmpty())
+            solutionObject["compileError"] = solution.compileError;
+        if (!solution.testsError.isEmpty())
+            solutionObject["error"] = solution.testsError;
+
+        QJsonArray testsArray;
+        int passed = 0, maxCpuTime = 0, totalCpuTime = 0;
+        qint64 maxMemory = -1;
+        for (int index : solution.tests)
+        {
+            auto const &test = tests[index];
+            QJsonObject testObject;
+            testObject["test"] = test.number;
+            testObject["verdict"] = test.verdict;
+            if (!test.message.isEmpty())
+                testObject["message"] = test.message;
+            if (test.timeUsed >= 0)
+            {
+                testObject["exitCode"] = test.exitCode;
+                testObject["wallTime"] = test.timeUsed;
+                testObject["cpuTime"] = test.cpuTime;
+                testObject["judgeCpuTime"] = Settings::judgeTime(data, test.cpuTime);
+                testObject["peakMemory"] = test.peakMemory;
+                maxCpuTime = qMax(maxCpuTime, test.cpuTime);
+                totalCpuTime += qMax(0, test.cpuTime);
+                maxMemory = qMax(maxMemory, test.peakMemory);
+            }
+            if (test.verdict == "AC" || test.verdict == "OK")
+                ++passed;
+            testsArray.push_back(testObject);
+        }
+        solutionObject["tests"] = testsArray;
+        solutionObject["passed"] = passed;
+        solutionObject["maxCpuTime"] = maxCpuTime;
+        solutionObject["totalCpuTime"] = totalCpuTime;
+        solutionObject["maxPeakMemory"] = maxMemory;
+        solutionsArray.push_back(solutionObject);
+    }
+
+    QJsonObject result;
+    result["timeLimit"] = options.timeLimit;
+    result["localTimeLimit"] = Settings::localTimeLimit(data, options.timeLimit);
+    result["success"] = isSuccessful();
+    result["solutions"] = solutionsArray;
+    return result;
+}
+
+QString HeadlessJudge::languageOf(const QString &filePath)
+{
+    auto suffix = QFileInfo(filePath).suffix().toLower();
+    if (suffix == "cpp" || suffix == "cc" || suffix == "cxx")
+        return "C++";
+    if (suffix == "java")
+        return "Java";
+    if (suffix == "py" || suffix == "py3")
+        return "Python";
+    return QString();
+}
+
+void HeadlessJudge::onCompilationFinished(const QString &warning)
+{
+    auto compiler = qobject_cast<Compiler *>(sender());
+    if (compiler == nullptr || !compilers.contains(compiler))
+        return;
+    int solution = compilers.take(compiler);
+    compiler->deleteLater();
+    solutions[solution].compiled = true;
+    --pending;
+    runTests(solution);
+}
+
+void HeadlessJudge::onCompilationErrorOccured(const QString &error)
+{
+    auto compiler = qobject_cast<Compiler *>(sender());
+    if (compiler == nullptr || !compilers.contains(compiler))
+        return;
+    int solution = compilers.take(compiler);
+    compiler->deleteLater();
+    solutions[solution].compileError = error.isEmpty() ? "Compilation failed" : error;
+    for (int index : solutions[solution].tests)
+        tests[index].verdict = "CE";
+    if (--pending == 0)
+        emit finished();
+}
+
+void HeadlessJudge::onRunFinished(int index, const QByteArray &out, const QByteArray &err, int exitCode, int timeUsed)
+{
+    auto &test = tests[index];
+    if (test.runner == nullptr || !test.verdict.isEmpty())
+        return;
+    auto stats = test.runner->stats();
+    test.exitCode = exitCode;
+    test.timeUsed = timeUsed;
+    test.cpuTime = stats.cpuTime;
+    test.peakMemory = stats.peakMemory;
+    test.runner->deleteLater();
+    test.runner = nullptr;
+
+    if (test.timedOut)
+        finishTest(index, "TLE");
+    else if (exitCode != 0)
+        finishTest(index, "RE", QString::fromUtf8(err.left(1000)));
+    else if (test.expected.trimmed().isEmpty())
+        finishTest(index, "OK");
+    else if (!checker->checkerPath().isEmpty())
+        checker->check(index, test.input, out, test.expected);
+    else
+        finishTest(index, Checker::isSameOutput(out, test.expected.toUtf8()) ? "AC" : "WA");
+}
+
+void HeadlessJudge::onRunErrorOccured(int index, const QString &error)
+{
+    if (tests[index].runner != nullptr)
+    {
+        tests[index].runner->deleteLater();
+        tests[index].runner = nullptr;
+    }
+    finishTest(index, "FAIL", error);
+}
+
+void HeadlessJudge::onRunTimeout(int index)
+{
+    tests[index].timedOut = true;
+}
+
+void HeadlessJudge::onCheckFinished(int index, Checker::Verdict verdict, const QString &message)
+{
+    switch (verdict)
+    {
+    case Checker::Accepted:
+        finishTest(index, "AC", message);
+        break;
+    case Checker::WrongAnswer:
+        finishTest(index, "WA", message);
+        break;
+    case Checker::Failed:
+        finishTest(index, "FAIL", message);
+        break;
+    }
+}
+
+void HeadlessJudge::loadTests(int solution)
+{
+    QFileInfo info(options.testsFrom.isEmpty() ? solutions[solution].source : options.testsFrom);
+    auto name = info.completeBaseName();
+    int maxNumber = 0;
+    for (auto const &entry : info.dir().entryInfoList({name + "_*.in", name + "_*.ans"}, QDir::Files))
+    {
+        bool ok = false;
+        int number = entry.completeBaseName().mid(name.length() + 1).toInt(&ok);
+        if (ok)
+            maxNumber = qMax(maxNumber, number);
+    }
+
+    if (maxNumber == 0)
+    {
+        auto prefix = QDir::toNativeSeparators(info.dir().filePath(name + "_1"));
+        solutions[solution].testsError = "No tests found, expected " + prefix + ".in and " + prefix + ".ans";
+        return;
+    }
+
+    for (int number = 1; number <= maxNumber; ++number)
+    {
+        auto prefix = info.dir().filePath(name + "_" + QString::number(number));
+        Test test;
+        test.solution = solution;
+        test.number = number;
+        test.input = readFile(prefix + ".in");
+        test.expected = readFile(prefix + ".ans");
+        solutions[solution].tests.push_back(tests.size());
+        tests.push_back(test);
+    }
+}
+
+void HeadlessJudge::runTests(int solution)
+{
+    QString command, args;
+    auto const &language = solutions[solution].language;
+    if (language == "C++")
+        args = data.runtimeArgumentsCpp;
+    else if (language == "Java")
+    {
+        command = data.runCommandJava;
+        args = data.runtimeArgumentsJava;
+    }
+    else if (language == "Python")
+    {
+        command = data.runCommandPython;
+        args = data.runtimeArgumentsPython;
+    }
+
+    for (int index : solutions[solution].tests)
+    {
+        auto &test = tests[index];
+        // the same as the editor, an empty input is not run
+        if (test.input.trimmed().isEmpty())
+        {
+            test.verdict = "SKIP";
+            continue;
+        }
+        ++pending;
+        test.runner = new Runner(index);
+        test.runner->setScheduling(this, Scheduler::Interactive);
+        test.runner->setFileIO(options.inputFileName, options.outputFileName);
+        connect(test.runner, SIGNAL(runFinished(int, const QByteArray &, const QByteArray &, int, int)), this,
+                SLOT(onRunFinished(int, const QByteArray &, const QByteArray &, int, int)));
+        connect(test.runner, SIGNAL(runErrorOccured(int, const QString &)), this,
+                SLOT(onRunErrorOccured(int, const QString &)));
+        connect(test.runner, SIGNAL(runTimeout(int)), this, SLOT(onRunTimeout(int)));
+        test.runner->run(solutions[solution].buildPath, language, command, args, test.input,
+                         Settings::localTimeLimit(data, options.timeLimit));
+    }
+
+    if (pending == 0)
+        emit finished();
+}
+
+void HeadlessJudge::finishTest(int index, const QString &verdict, const QString &message)
+{
+    if (!tests[index].verdict.isEmpty())
+        return;
+    tests[index].verdict = verdict;
+    tests[index].message = message;
+    if (--pending == 0)
+        emit finished();
+}
+
+QString HeadlessJudge::readFile(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+        return QString();
+    return file.readAll();
+}
+
+} // namespace Core
@@ -0,0 +1,412 @@
+/*
+ * Copyright (C) 2019-2020 Ashar Khan <ashar786khan@gmail.com>
+ *
+ * This file is part of CPEditor.
+ *
+ * CPEditor is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * I will not be responsible if CPEditor behaves in unexpected way and
+ * causes your ratings to go down and or loose any important contest.
+ *
+ * Believe Software is "Software" and it isn't immune to bugs.
+ *
+ */
+
+#include "Core/InteractiveRunner.hpp"
+#include "Core/BinaryCache.hpp"
+#include "Core/Checker.hpp"
+#include "Core/Runner.hpp"
+#include <QDir>
+#include <QFile>
+
+namespace Core
+{
+
+const int InteractiveRunner::MAX_TRANSCRIPT_LENGTH;
+const int InteractiveRunner::INTERACTOR_TIME_LIMIT;
+const qint64 InteractiveRunner::INTERACTOR_MEMORY_LIMIT;
+const qint64 InteractiveRunner::MAX_PENDING_RELAY;
+
+InteractiveRunner::InteractiveRunner(int index, QObject *parent) : QObject(parent), runnerIndex(index)
+{
+}
+
+InteractiveRunner::~InteractiveRunner()
+{
+    for (auto process : {solution, interactor})
+    {
+        if (process != nullptr && process->state() != QProcess::NotRunning)
+        {
+            process->disconnect(this);
+            process->killTree();
+            process->waitForFinished(1000);
+        }
+    }
+    if (tmpDir != nullptr)
+        delete tmpDir;
+}
+
+void InteractiveRunner::run(const QString &filePath, const QString &lang, const QString &runCommand,
+                            const QString &args, const QString &interactorPath, const QString &compileCommand,
+                            const QString &input, const QString &expected, int timeLimit, int memoryLimit)
+{
+    solutionCommand = Runner::getCommand(filePath, lang, runCommand, args);
+    if (!QFile::exists(filePath) || solutionCommand.isEmpty())
+    {
+        fail("Failed to get the command of the solution, please compile it first");
+        return;
+    }
+
+    this->lang = lang;
+    this->interactorPath = interactorPath;
+    this->input = input;
+    this->expected = expected;
+    this->timeLimit = timeLimit;
+    this->memoryLimit = memoryLimit * 1024LL * 1024LL;
+
+    waitingForBuild = true;
+    connect(BinaryCache::instance(), SIGNAL(buildFinished(const QString &, const QString &)), this,
+            SLOT(onBuildFinished(const QString &, const QString &)));
+    connect(BinaryCache::instance(), SIGNAL(buildFailed(const QString &, const QString &)), this,
+            SLOT(onBuildFailed(const QString &, const QString &)));
+    BinaryCache::instance()->build(interactorPath, compileCommand);
+}
+
+void InteractiveRunner::setScheduling(QObject *owner, Scheduler::Priority priority)
+{
+    this->owner = owner;
+    this->priority = priority;
+}
+
+QString InteractiveRunner::verdictName(Verdict verdict)
+{
+    switch (verdict)
+    {
+    case Accepted:
+        return "Accepted";
+    case WrongAnswer:
+        return "Wrong Answer";
+    case TimeLimitExceeded:
+        return "Time Limit Exceeded";
+    case MemoryLimitExceeded:
+        return "Memory Limit Exceeded";
+    case RuntimeError:
+        return "Runtime Error";
+    case Failed:
+        return "Interactor Failed";
+    }
+    return QString();
+}
+
+void InteractiveRunner::onBuildFinished(const QString &sourcePath, const QString &binaryPath)
+{
+    if (!waitingForBuild || sourcePath != interactorPath)
+        return;
+    waitingForBuild = false;
+    BinaryCache::instance()->disconnect(this);
+    start(binaryPath);
+}
+
+void InteractiveRunner::onBuildFailed(const QString &sourcePath, const QString &error)
+{
+    if (!waitingForBuild || sourcePath != interactorPath)
+        return;
+    waitingForBuild = false;
+    BinaryCache::instance()->disconnect(this);
+    fail(error);
+}
+
+void InteractiveRunner::start(const QString &interactorBinary)
+{
+    this->interactorBinary = interactorBinary;
+    auto scheduler = Scheduler::current();
+    if (scheduler != nullptr)
+    {
+        qint64 memory = (memoryLimit > 0 ? memoryLimit : Scheduler::DEFAULT_RUN_MEMORY) + INTERACTOR_MEMORY_LIMIT;
+        ticket = scheduler->request(owner, priority, memory, this, 2);
+        if (!ticket->isGranted())
+        {
+            connect(ticket, SIGNAL(granted()), this, SLOT(onTicketGranted()));
+            return;
+        }
+    }
+    launch();
+}
+
+void InteractiveRunner::onTicketGranted()
+{
+    launch();
+}
+
+void InteractiveRunner::releaseTicket()
+{
+    if (ticket != nullptr)
+    {
+        delete ticket;
+        ticket = nullptr;
+    }
+}
+
+void InteractiveRunner::launch()
+{
+    tmpDir = new QTemporaryDir();
+    QDir dir(tmpDir->path());
+    QFile inputFile(dir.filePath("input.txt")), answerFile(dir.filePath("answer.txt"));
+    if (!tmpDir->isValid() || !inputFile.open(QIODevice::WriteOnly | QIODevice::Text) ||
+        !answerFile.open(QIODevice::WriteOnly | QIODevice::Text))
+    {
+        fail("Failed to write the input of the interactor");
+        return;
+    }
+    inputFile.write(input.toUtf8());
+    answerFile.write(expected.toUtf8());
+    inputFile.close();
+    answerFile.close();
+
+    interactor = new ChildProcess(this);
+    solution = new ChildProcess(this);
+    // the JVM and the interpreters reserve much more address space than they use
+    if (lang == "C++")
+        solution->setMemoryLimit(memoryLimit);
+    interactor->setMemoryLimit(INTERACTOR_MEMORY_LIMIT);
+    interactor->setCpuTimeLimit((timeLimit + INTERACTOR_TIME_LIMIT + 999) / 1000);
+    monitor = new ProcessMonitor(solution, this);
+
+    connect(solution, &QProcess::started, monitor, &ProcessMonitor::start);
+    connect(solution, SIGNAL(readyReadStandardOutput()), this, SLOT(onSolutionOutput()));
+    connect(interactor, SIGNAL(readyReadStandardOutput()), this, SLOT(onInteractorOutput()));
+    connect(solution, SIGNAL(finished(int, QProcess::ExitStatus)), this,
+            SLOT(onSolutionFinished(int, QProcess::ExitStatus)));
+    connect(interactor, SIGNAL(finished(int, QProcess::ExitStatus)), this,
+            SLOT(onInteractorFinished(int, QProcess::ExitStatus)));
+    connect(solution, SIGNAL(errorOccurred(QProcess::ProcessError)), this,
+            SLOT(onSolutionErrorOccurred(QProcess::ProcessError)));
+    connect(interactor, SIGNAL(errorOccurred(QProcess::ProcessError)), this,
+            SLOT(onInteractorErrorOccurred(QProcess::ProcessError)));
+
+    killTimer = new QTimer(this);
+    killTimer->setSingleShot(true);
+    killTimer->setInterval(timeLimit);
+    connect(killTimer, SIGNAL(timeout()), this, SLOT(onTimeout()));
+    // the CPU time limit doesn't stop an interactor which waits forever for a solution which has already exited
+    QTimer::singleShot(timeLimit + INTERACTOR_TIME_LIMIT, interactor, SLOT(killTree()));
+
+    interactor->start(interactorBinary,
+                      {dir.filePath("input.txt"), dir.filePath("output.txt"), dir.filePath("answer.txt")});
+    solution->start(solutionCommand);
+    killTimer->start();
+}
+
+void InteractiveRunner::onSolutionOutput()
+{
+    auto data = solution->readAllStandardOutput();
+    appendTranscript('<', data);
+    if (relayStopped || interactor->state() != QProcess::Running)
+        return;
+    interactor->write(data);
+    if (interactor->bytesToWrite() > MAX_PENDING_RELAY)
+    {
+        stopRelay("The solution wrote more than " + QString::number(MAX_PENDING_RELAY >> 20) +
+                  "MB which the interactor didn't read");
+    }
+}
+
+void InteractiveRunner::onInteractorOutput()
+{
+    auto data = interactor->readAllStandardOutput();
+    appendTranscript('>', data);
+    if (relayStopped || solution->state() != QProcess::Running)
+        return;
+    solution->write(data);
+    if (solution->bytesToWrite() > MAX_PENDING_RELAY)
+    {
+        stopRelay("The interactor wrote more than " + QString::number(MAX_PENDING_RELAY >> 20) +
+                  "MB which the solution didn't read");
+    }
+}
+
+void InteractiveRunner::onSolutionFinished(int exitCode, QProcess::ExitStatus exitStatus)
+{
+    monitor->stop();
+    killTimer->stop();
+    onSolutionOutput();
+    solutionFinished = true;
+    solutionExitCode = exitCode;
+    solutionExitStatus = exitStatus;
+    if (interactor->state() == QProcess::Running)
+        interactor->closeWriteChannel();
+    tryFinish();
+}
+
+void InteractiveRunner::onInteractorFinished(int exitCode, QProcess::ExitStatus exitStatus)
+{
+    onInteractorOutput();
+    interactorFinished = true;
+    interactorExitCode = exitCode;
+    interactorExitStatus = exitStatus;
+    interactorError = QString::fromUtf8(interactor->readAllStandardError()).trimmed();
+    if (solution->state() != QProcess::NotRunning)
+    {
+        // the solution can't get a better verdict, and it may be waiting for the input forever
+        if (exitStatus != QProcess::NormalExit || exitCode != 0)
+        {
+            killedByInteractor = true;
+            solution->killTree();
+        }
+        else
+        {
+            solution->closeWriteChannel();
+        }
+    }
+    tryFinish();
+}
+
+void InteractiveRunner::onSolutionErrorOccurred(QProcess::ProcessError error)
+{
+    if (error == QProcess::FailedToStart)
+        fail("Failed to start the solution, please compile it first");
+}
+
+void InteractiveRunner::onInteractorErrorOccurred(QProcess::ProcessError error)
+{
+    if (error == QProcess::FailedToStart)
+        fail("Failed to start the interactor [" + interactorPath + "]");
+}
+
+void InteractiveRunner::onTimeout()
+{
+    if (solution->state() != QProcess::NotRunning)
+    {
+        timedOut = true;
+        monitor->stop();
+        solution->killTree();
+    }
+}
+
+void InteractiveRunner::appendTranscript(char direction, const QByteArray &data)
+{
+    if (truncated)
+        return;
+    for (char c : data)
+    {
+        if (direction != lastDirection && !atLineStart)
+        {
+            transcript += '\n';
+            atLineStart = true;
+        }
+        lastDirection = direction;
+        if (atLineStart)
+        {
+            transcript += direction;
+            transcript += ' ';
+            atLineStart = false;
+        }
+        transcript += c;
+        if (c == '\n')
+            atLineStart = true;
+        if (transcript.size() >= MAX_TRANSCRIPT_LENGTH)
+        {
+            transcript += "\n... (truncated)";
+            truncated = true;
+            return;
+        }
+    }
+}
+
+void InteractiveRunner::fail(const QString &message)
+{
+    if (finished)
+        return;
+    finished = true;
+    releaseTicket();
+    for (auto process : {solution, interactor})
+    {
+        if (process != nullptr && process->state() != QProcess::NotRunning)
+        {
+            process->disconnect(this);
+            process->killTree();
+        }
+    }
+
+    Result result;
+    result.verdict = Failed;
+    result.message = message;
+    result.transcript = QString::fromUtf8(transcript);
+    emit interactionFinished(runnerIndex, result);
+}
+
+void InteractiveRunner::stopRelay(const QString &message)
+{
+    // the buffered data would grow the editor without a bound, so the run is ended like a judge ends an idle one
+    relayStopped = true;
+    relayError = message;
+    monitor->stop();
+    killTimer->stop();
+    for (auto process : {solution, interactor})
+    {
+        if (process->state() != QProcess::NotRunning)
+            process->killTree();
+    }
+}
+
+void InteractiveRunner::tryFinish()
+{
+    if (finished || !solutionFinished || !interactorFinished)
+        return;
+    finished = true;
+    releaseTicket();
+
+    Result result;
+    result.transcript = QString::fromUtf8(transcript);
+    result.stats = monitor->stats();
+    result.exitCode = solutionExitCode;
+
+    if (relayStopped)
+    {
+        result.verdict = WrongAnswer;
+        result.message = relayError;
+    }
+    else if (timedOut)
+    {
+        result.verdict = TimeLimitExceeded;
+    }
+    else if (memoryLimit > 0 && result.stats.peakMemory > memoryLimit)
+    {
+        result.verdict = MemoryLimitExceeded;
+    }
+    else if (!killedByInteractor && (solutionExitStatus != QProcess::NormalExit || solutionExitCode != 0))
+    {
+        result.verdict = RuntimeError;
+        result.message = "The solution exited with code " + QString::number(solutionExitCode);
+        if (memoryLimit > 0)
+            result.message += ", it may have run out of the memory limit";
+    }
+    else if (interactorExitStatus != QProcess::NormalExit)
+    {
+        result.verdict = Failed;
+        result.message = "The interactor crashed or timed out\n" + interactorError;
+    }
+    else
+    {
+        result.message = interactorError;
+        switch (Checker::verdictOfExitCode(interactorExitCode, result.message))
+        {
+        case Checker::Accepted:
+            result.verdict = Accepted;
+            break;
+        case Checker::WrongAnswer:
+            result.verdict = WrongAnswer;
+            break;
+        case Checker::Failed:
+            result.verdict = Failed;
+            break;
+        }
+    }
+
+    emit interactionFinished(runnerIndex, result);
+}
+
+} // namespace Core
@@ -0,0 +1,945 @@
+/*
+ * Copyright (C) 2019-2020 Ashar Khan <ashar786khan@gmail.com>
+ *
+ * This file is part of CPEditor.
+ *
+ * CPEditor is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * I will not be responsible if CPEditor behaves in unexpected way and
+ * causes your ratings to go down and or loose any important contest.
+ *
+ * Believe Software is "Software" and it isn't immune to bugs.
+ *
+ */
+
+#include "Core/Launcher.hpp"
+#include <QCoreApplication>
+#include <QFile>
+#include <QSocketNotifier>
+
+#if defined(Q_OS_UNIX)
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <map>
+#include <poll.h>
+#include <spawn.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+extern char **environ;
+#endif
+
+#if defined(Q_OS_LINUX)
+#include <sched.h>
+#endif
+
+namespace Core
+{
+
+int Launcher::controlFd = -1;
+const int Launcher::SIGNAL_TIMEOUT;
+
+#if defined(Q_OS_UNIX)
+namespace
+{
+
+// the messages between the editor and the zygote, each one is a datagram of the control socket
+
+enum RequestType : quint32
+{
+    SpawnRequest = 1,
+    SignalRequest
+};
+
+enum ReplyType : quint32
+{
+    SpawnedReply = 1, // with the ends of the stdin, stdout and stderr pipes
+    SpawnFailedReply,
+    ExitedReply
+};
+
+struct RequestHeader
+{
+    quint32 type;
+    quint64 id;
+    qint64 memoryLimit;
+    qint32 core;
+    qint32 signal;
+    // followed by the working directory and the arguments of a spawn request, each one is terminated by '\0', an
+    // empty working directory keeps the one of the zygote
+};
+
+struct Reply
+{
+    quint32 type;
+    quint64 id;
+    qint64 pid;
+    qint32 status;     // the wait status of an exited process, or the errno of a failed spawn
+    qint64 cpuTime;    // microseconds
+    qint64 peakMemory; // bytes
+    qint64 bytesRead, bytesWritten, readCalls, writeCalls; // -1 if unknown
+    qint64 voluntarySwitches, involuntarySwitches;
+};
+
+const int MAX_REQUEST_SIZE = 64 * 1024;
+const int MAX_READS_PER_EVENT = 16;
+
+int childSignalPipe[2] = {-1, -1};
+
+void onChildSignal(int)
+{
+    int savedErrno = errno;
+    char byte = 0;
+    ssize_t written = ::write(childSignalPipe[1], &byte, 1);
+    Q_UNUSED(written);
+    errno = savedErrno;
+}
+
+void setCloseOnExec(int fd)
+{
+    fcntl(fd, F_SETFD, fcntl(fd, F_GETFD) | FD_CLOEXEC);
+}
+
+void setNonBlocking(int fd)
+{
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+}
+
+bool makePipe(int fds[2])
+{
+    if (::pipe(fds) != 0)
+        return false;
+    setCloseOnExec(fds[0]);
+    setCloseOnExec(fds[1]);
+    return true;
+}
+
+void closeAll(std::initializer_list<int> fds)
+{
+    for (int fd : fds)
+    {
+        if (fd >= 0)
+            ::close(fd);
+    }
+}
+
+void sendReply(int fd, const Reply &reply, const int *fds = nullptr, int count = 0)
+{
+    msghdr message;
+    memset(&message, 0, sizeof(message));
+    iovec vector;
+    vector.iov_base = const_cast<Reply *>(&reply);
+    vector.iov_len = sizeof(reply);
+    message.msg_iov = &vector;
+    message.msg_iovlen = 1;
+
+    char control[CMSG_SPACE(3 * sizeof(int))];
+    if (count > 0)
+    {
+        memset(control, 0, sizeof(control));
+        message.msg_control = control;
+        message.msg_controllen = CMSG_SPACE(count * sizeof(int));
+        auto header = CMSG_FIRSTHDR(&message);
+        header->cmsg_level = SOL_SOCKET;
+        header->cmsg_type = SCM_RIGHTS;
+        header->cmsg_len = CMSG_LEN(count * sizeof(int));
+        memcpy(CMSG_DATA(header), fds, count * sizeof(int));
+    }
+
+    while (::sendmsg(fd, &message, 0) < 0 && errno == EINTR)
+    {
+    }
+}
+
+void spawnChild(int fd, const RequestHeader &request, const char *arguments, size_t size,
+                std::map<pid_t, quint64> &children)
+{
+    Reply reply;
+    memset(&reply, 0, sizeof(reply));
+    reply.id = request.id;
+    reply.type = SpawnFailedReply;
+
+    if (size == 0 || arguments[size - 1] != '\0')
+    {
+        reply.status = EINVAL;
+        sendReply(fd, reply);
+        return;
+    }
+    const char *directory = arguments;
+    size_t directorySize = strlen(directory) + 1;
+    arguments += directorySize;
+    size -= directorySize;
+
+    std::vector<char *> argv;
+    for (size_t i = 0; i < size; i += strlen(arguments + i) + 1)
+        argv.push_back(const_cast<char *>(arguments + i));
+    argv.push_back(nullptr);
+    if (argv.size() < 2 || size == 0 || arguments[size - 1] != '\0')
+    {
+        reply.status = EINVAL;
+        sendReply(fd, reply);
+        return;
+    }
+
+    int in[2] = {-1, -1}, out[2] = {-1, -1}, err[2] = {-1, -1};
+    if (!makePipe(in) || !makePipe(out) || !makePipe(err))
+    {
+        reply.status = errno;
+        closeAll({in[0], in[1], out[0], out[1], err[0], err[1]});
+        sendReply(fd, reply);
+        return;
+    }
+
+    // the pipes are close-on-exec, dup2() clears the flag of the standard streams of the child
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_adddup2(&actions, in[0], STDIN_FILENO);
+    posix_spawn_file_actions_adddup2(&actions, out[1], STDOUT_FILENO);
+    posix_spawn_file_actions_adddup2(&actions, err[1], STDERR_FILENO);
+
+    // the ignored SIGPIPE and the SIGCHLD handler of the zygote must not leak into the child
+    posix_spawnattr_t attributes;
+    posix_spawnattr_init(&attributes);
+    sigset_t signals;
+    sigemptyset(&signals);
+    posix_spawnattr_setsigmask(&attributes, &signals);
+    sigaddset(&signals, SIGPIPE);
+    sigaddset(&signals, SIGCHLD);
+    posix_spawnattr_setsigdefault(&attributes, &signals);
+    // each child leads a process group of its own, so that it's killed together with the processes it starts
+    posix_spawnattr_setpgroup(&attributes, 0);
+    short flags = POSIX_SPAWN_SETSIGMASK | POSIX_SPAWN_SETSIGDEF | POSIX_SPAWN_SETPGROUP;
+#if defined(POSIX_SPAWN_USEVFORK)
+    flags |= POSIX_SPAWN_USEVFORK;
+#endif
+    posix_spawnattr_setflags(&attributes, flags);
+
+    // posix_spawn can't set up the child, but the child inherits the limits and the affinity, and the zygote is
+    // single-threaded, so they are set on the zygote around the spawn
+    rlimit oldLimit;
+    bool limited = false;
+    if (request.memoryLimit > 0 && getrlimit(RLIMIT_AS, &oldLimit) == 0)
+    {
+        rlimit limit = oldLimit;
+        limit.rlim_cur = static_cast<rlim_t>(request.memoryLimit);
+        if (oldLimit.rlim_max != RLIM_INFINITY && limit.rlim_cur > oldLimit.rlim_max)
+            limit.rlim_cur = oldLimit.rlim_max;
+        limited = setrlimit(RLIMIT_AS, &limit) == 0;
+    }
+#if defined(Q_OS_LINUX)
+    cpu_set_t oldSet;
+    bool pinned = false;
+    if (request.core >= 0 && request.core < CPU_SETSIZE && sched_getaffinity(0, sizeof(oldSet), &oldSet) == 0)
+    {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(request.core, &set);
+        pinned = sched_setaffinity(0, sizeof(set), &set) == 0;
+    }
+#endif
+
+    // the working directory is changed around the spawn as well, posix_spawn_file_actions_addchdir_np is too new
+    int oldDirectory = -1, result = 0;
+    if (directory[0] != '\0')
+    {
+        oldDirectory = ::open(".", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (oldDirectory < 0 || ::chdir(directory) != 0)
+            result = errno;
+    }
+
+    pid_t pid = 0;
+    if (result == 0)
+        result = posix_spawnp(&pid, argv[0], &actions, &attributes, argv.data(), environ);
+
+    if (oldDirectory >= 0)
+    {
+        // the zygote doesn't use relative paths, so a failure only leaves it in another directory
+        int restored = ::fchdir(oldDirectory);
+        static_cast<void>(restored);
+        ::close(oldDirectory);
+    }
+
+    if (limited)
+        setrlimit(RLIMIT_AS, &oldLimit);
+#if defined(Q_OS_LINUX)
+    if (pinned)
+        sched_setaffinity(0, sizeof(oldSet), &oldSet);
+#endif
+    posix_spawn_file_actions_destroy(&actions);
+    posix_spawnattr_destroy(&attributes);
+    closeAll({in[0], out[1], err[1]});
+
+    if (result != 0)
+    {
+        reply.status = result;
+        closeAll({in[1], out[0], err[0]});
+        sendReply(fd, reply);
+        return;
+    }
+
+    children[pid] = request.id;
+    reply.type = SpawnedReply;
+    reply.pid = pid;
+    int fds[3] = {in[1], out[0], err[0]};
+    sendReply(fd, reply, fds, 3);
+    closeAll({in[1], out[0], err[0]});
+}
+
+// reads the final I/O counters of an exited but not yet reaped child, the zombie keeps them until it's reaped
+void readIOCounters(pid_t pid, Reply &reply)
+{
+    reply.bytesRead = reply.bytesWritten = reply.readCalls = reply.writeCalls = -1;
+#if defined(Q_OS_LINUX)
+    char path[64];
+    snprintf(path, sizeof(path), "/proc/%d/io", static_cast<int>(pid));
+    int ioFd = ::open(path, O_RDONLY | O_CLOEXEC);
+    if (ioFd < 0)
+        return;
+    char buffer[1024];
+    ssize_t size = ::read(ioFd, buffer, sizeof(buffer) - 1);
+    ::close(ioFd);
+    if (size <= 0)
+        return;
+    buffer[size] = '\0';
+
+    const std::pair<const char *, qint64 *> fields[] = {{"rchar:", &reply.bytesRead},
+                                                        {"wchar:", &reply.bytesWritten},
+                                                        {"syscr:", &reply.readCalls},
+                                                        {"syscw:", &reply.writeCalls}};
+    for (auto const &field : fields)
+    {
+        const char *line = strstr(buffer, field.first);
+        if (line != nullptr)
+            *field.second = strtoll(line + strlen(field.first), nullptr, 10);
+    }
+#else
+    Q_UNUSED(pid);
+#endif
+}
+
+void reapChildren(int fd, std::map<pid_t, quint64> &children)
+{
+    char buffer[64];
+    while (::read(childSignalPipe[0], buffer, sizeof(buffer)) > 0)
+    {
+    }
+
+    int status = 0;
+    rusage usage;
+    for (;;)
+    {
+        // peek at the next exited child without reaping it, so that its /proc entry can still be read
+        siginfo_t info;
+        memset(&info, 0, sizeof(info));
+        if (waitid(P_ALL, 0, &info, WEXITED | WNOHANG | WNOWAIT) != 0 || info.si_pid == 0)
+            break;
+        pid_t pid = info.si_pid;
+        Reply reply;
+        memset(&reply, 0, sizeof(reply));
+        readIOCounters(pid, reply);
+        if (wait4(pid, &status, WNOHANG, &usage) <= 0)
+            break;
+
+        auto it = children.find(pid);
+        if (it == children.end())
+            continue;
+        reply.type = ExitedReply;
+        reply.id = it->second;
+        reply.pid = pid;
+        reply.status = status;
+        reply.voluntarySwitches = usage.ru_nvcsw;
+        reply.involuntarySwitches = usage.ru_nivcsw;
+        reply.cpuTime = (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000000LL + usage.ru_utime.tv_usec +
+                        usage.ru_stime.tv_usec;
+#if defined(Q_OS_MACOS)
+        reply.peakMemory = usage.ru_maxrss;
+#else
+        reply.peakMemory = usage.ru_maxrss * 1024LL;
+#endif
+        children.erase(it);
+        sendReply(fd, reply);
+    }
+}
+
+[[noreturn]] void runZygote(int fd, pid_t parent)
+{
+    signal(SIGPIPE, SIG_IGN);
+    makePipe(childSignalPipe);
+    setNonBlocking(childSignalPipe[0]);
+    setNonBlocking(childSignalPipe[1]);
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = onChildSignal;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESTART | SA_NOCLDSTOP;
+    sigaction(SIGCHLD, &action, nullptr);
+
+    std::map<pid_t, quint64> children;
+    std::vector<char> buffer(MAX_REQUEST_SIZE);
+    while (true)
+    {
+        pollfd fds[2] = {{fd, POLLIN, 0}, {childSignalPipe[0], POLLIN, 0}};
+        int ready = poll(fds, 2, 1000);
+        // a datagram socket doesn't report the close of the other end, so the editor is watched by the parent PID
+        if (getppid() != parent)
+            break;
+        if (ready < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            break;
+        }
+        if (fds[1].revents & POLLIN)
+            reapChildren(fd, children);
+        if (fds[0].revents & (POLLERR | POLLHUP | POLLNVAL))
+            break;
+        if (!(fds[0].revents & POLLIN))
+            continue;
+
+        ssize_t size = ::recv(fd, buffer.data(), buffer.size(), 0);
+        if (size < 0 && errno != EINTR && errno != EAGAIN)
+            break;
+        if (size < static_cast<ssize_t>(sizeof(RequestHeader)))
+            continue;
+        RequestHeader request;
+        memcpy(&request, buffer.data(), sizeof(request));
+        if (request.type == SpawnRequest)
+        {
+            spawnChild(fd, request, buffer.data() + sizeof(request), static_cast<size_t>(size) - sizeof(request),
+                       children);
+        }
+        else if (request.type == SignalRequest)
+        {
+            for (auto const &child : children)
+            {
+                if (child.second == request.id)
+                {
+                    // the signals are sent to the whole process group, e.g. SIGSTOP pauses the forked processes too
+                    if (::kill(-child.first, request.signal) != 0)
+                        ::kill(child.first, request.signal);
+                    break;
+                }
+            }
+        }
+    }
+
+    for (auto const &child : children)
+    {
+        ::kill(-child.first, SIGKILL);
+        ::kill(child.first, SIGKILL);
+    }
+    _exit(0);
+}
+
+} // namespace
+#endif
+
+LaunchedProcess::LaunchedProcess(quint64 id, QObject *parent) : QObject(parent), id(id)
+{
+}
+
+LaunchedProcess::~LaunchedProcess()
+{
+    if (running)
+        kill();
+    Launcher::instance()->processes.remove(id);
+    Launcher::instance()->startTimers.remove(id);
+    closePipes();
+}
+
+qint64 LaunchedProcess::processId() const
+{
+    return pid;
+}
+
+bool LaunchedProcess::isRunning() const
+{
+    return running;
+}
+
+void LaunchedProcess::write(const QByteArray &data)
+{
+    input += data;
+    flushInput();
+}
+
+void LaunchedProcess::closeWriteChannel()
+{
+    closeRequested = true;
+    flushInput();
+}
+
+QByteArray LaunchedProcess::readAllStandardOutput()
+{
+    auto data = output;
+    output.clear();
+    return data;
+}
+
+QByteArray LaunchedProcess::readAllStandardError()
+{
+    auto data = error;
+    error.clear();
+    return data;
+}
+
+void LaunchedProcess::kill()
+{
+#if defined(Q_OS_UNIX)
+    sendSignal(SIGKILL);
+#endif
+}
+
+void LaunchedProcess::sendSignal(int signal)
+{
+    if (!running)
+        return;
+#if defined(Q_OS_UNIX)
+    // the zygote is stuck or gone, signal the process group directly, it's led by the process
+    if (!Launcher::instance()->sendSignal(id, signal) && pid > 0 && ::kill(-static_cast<pid_t>(pid), signal) != 0)
+        ::kill(static_cast<pid_t>(pid), signal);
+#endif
+}
+
+ProcessStats LaunchedProcess::stats() const
+{
+    return processStats;
+}
+
+void LaunchedProcess::onStdinActivated()
+{
+    flushInput();
+}
+
+void LaunchedProcess::onStdoutActivated()
+{
+    if (readPipe(stdoutFd, stdoutNotifier, output))
+        emit readyReadStandardOutput();
+}
+
+void LaunchedProcess::onStderrActivated()
+{
+    readPipe(stderrFd, stderrNotifier, error);
+}
+
+void LaunchedProcess::setStarted(qint64 pid, int stdinFd, int stdoutFd, int stderrFd, int startLatency)
+{
+#if defined(Q_OS_UNIX)
+    this->pid = pid;
+    this->stdinFd = stdinFd;
+    this->stdoutFd = stdoutFd;
+    this->stderrFd = stderrFd;
+    running = true;
+    processStats.startLatency = startLatency;
+    setNonBlocking(stdinFd);
+    setNonBlocking(stdoutFd);
+    setNonBlocking(stderrFd);
+
+    stdinNotifier = new QSocketNotifier(stdinFd, QSocketNotifier::Write, this);
+    stdinNotifier->setEnabled(false);
+    connect(stdinNotifier, SIGNAL(activated(int)), this, SLOT(onStdinActivated()));
+    stdoutNotifier = new QSocketNotifier(stdoutFd, QSocketNotifier::Read, this);
+    connect(stdoutNotifier, SIGNAL(activated(int)), this, SLOT(onStdoutActivated()));
+    stderrNotifier = new QSocketNotifier(stderrFd, QSocketNotifier::Read, this);
+    connect(stderrNotifier, SIGNAL(activated(int)), this, SLOT(onStderrActivated()));
+
+    emit started();
+    flushInput();
+#endif
+}
+
+void LaunchedProcess::setFinished(int status, const ProcessStats &stats)
+{
+#if defined(Q_OS_UNIX)
+    running = false;
+    // take what's left in the pipes without waiting for the end of file, which may be delayed by a background child
+    bool hasOutput = readPipe(stdoutFd, stdoutNotifier, output);
+    readPipe(stderrFd, stderrNotifier, error);
+    closePipes();
+    int startLatency = processStats.startLatency;
+    processStats = stats;
+    processStats.startLatency = startLatency;
+    if (hasOutput)
+        emit readyReadStandardOutput();
+    bool crashed = WIFSIGNALED(status);
+    emit finished(crashed ? WTERMSIG(status) : WEXITSTATUS(status), crashed);
+#endif
+}
+
+void LaunchedProcess::setFailed(const QString &error)
+{
+    running = false;
+    closePipes();
+    emit errorOccurred(error);
+}
+
+void LaunchedProcess::flushInput()
+{
+#if defined(Q_OS_UNIX)
+    if (stdinFd < 0)
+        return;
+    while (!input.isEmpty())
+    {
+        ssize_t written = ::write(stdinFd, input.constData(), static_cast<size_t>(input.size()));
+        if (written > 0)
+            input.remove(0, static_cast<int>(written));
+        else if (written < 0 && errno == EINTR)
+            continue;
+        else if (written < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+        {
+            stdinNotifier->setEnabled(true);
+            return;
+        }
+        else
+        {
+            // the process has closed its stdin
+            input.clear();
+        }
+    }
+    stdinNotifier->setEnabled(false);
+    if (closeRequested)
+    {
+        stdinNotifier->deleteLater();
+        stdinNotifier = nullptr;
+        ::close(stdinFd);
+        stdinFd = -1;
+    }
+#endif
+}
+
+bool LaunchedProcess::readPipe(int &fd, QSocketNotifier *&notifier, QByteArray &buffer)
+{
+    bool hasRead = false;
+#if defined(Q_OS_UNIX)
+    // a bounded number of reads, so a process which keeps writing doesn't starve the event loop
+    char chunk[65536];
+    for (int i = 0; i < MAX_READS_PER_EVENT && fd >= 0; ++i)
+    {
+        ssize_t size = ::read(fd, chunk, sizeof(chunk));
+        if (size > 0)
+        {
+            buffer.append(chunk, static_cast<int>(size));
+            hasRead = true;
+        }
+        else if (size < 0 && errno == EINTR)
+            continue;
+        else if (size < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            break;
+        else
+        {
+            notifier->setEnabled(false);
+            notifier->deleteLater();
+            notifier = nullptr;
+            ::close(fd);
+            fd = -1;
+        }
+    }
+#endif
+    return hasRead;
+}
+
+void LaunchedProcess::closePipes()
+{
+#if defined(Q_OS_UNIX)
+    for (auto pipe : {std::make_pair(&stdinFd, &stdinNotifier), std::make_pair(&stdoutFd, &stdoutNotifier),
+                      std::make_pair(&stderrFd, &stderrNotifier)})
+    {
+        if (*pipe.second != nullptr)
+        {
+            (*pipe.second)->setEnabled(false);
+            (*pipe.second)->deleteLater();
+            *pipe.second = nullptr;
+        }
+        if (*pipe.first >= 0)
+        {
+            ::close(*pipe.first);
+            *pipe.first = -1;
+        }
+    }
+#endif
+}
+
+void Launcher::startZygote()
+{
+#if defined(Q_OS_UNIX)
+    int fds[2];
+    if (::socketpair(AF_UNIX, SOCK_DGRAM, 0, fds) != 0)
+        return;
+    setCloseOnExec(fds[0]);
+    setCloseOnExec(fds[1]);
+    pid_t parent = getpid();
+    pid_t pid = fork();
+    if (pid < 0)
+    {
+        closeAll({fds[0], fds[1]});
+        return;
+    }
+    if (pid == 0)
+    {
+        ::close(fds[0]);
+        runZygote(fds[1], parent);
+    }
+    ::close(fds[1]);
+    setNonBlocking(fds[0]);
+    controlFd = fds[0];
+    // like QProcess, a write to the stdin of a finished process should fail instead of killing the editor
+    signal(SIGPIPE, SIG_IGN);
+#endif
+}
+
+bool Launcher::isAvailable()
+{
+    return controlFd >= 0;
+}
+
+Launcher *Launcher::instance()
+{
+    static Launcher *launcher = new Launcher(QCoreApplication::instance());
+    return launcher;
+}
+
+Launcher::Launcher(QObject *parent) : QObject(parent)
+{
+    if (controlFd >= 0)
+    {
+        notifier = new QSocketNotifier(controlFd, QSocketNotifier::Read, this);
+        connect(notifier, SIGNAL(activated(int)), this, SLOT(onControlActivated()));
+    }
+}
+
+LaunchedProcess *Launcher::spawn(const QString &command, qint64 memoryLimit, int core, const QString &workingDirectory,
+                                 QObject *parent)
+{
+#if defined(Q_OS_UNIX)
+    auto arguments = splitCommand(command);
+    if (controlFd < 0 || arguments.isEmpty())
+        return nullptr;
+
+    RequestHeader header;
+    memset(&header, 0, sizeof(header));
+    header.type = SpawnRequest;
+    header.id = ++lastId;
+    header.memoryLimit = memoryLimit;
+    header.core = core;
+    QByteArray request(reinterpret_cast<const char *>(&header), sizeof(header));
+    request += QFile::encodeName(workingDirectory);
+    request += '\0';
+    for (auto const &argument : arguments)
+    {
+        request += QFile::encodeName(argument);
+        request += '\0';
+    }
+    if (request.size() > MAX_REQUEST_SIZE)
+        return nullptr;
+
+    QElapsedTimer timer;
+    timer.start();
+    if (::send(controlFd, request.constData(), static_cast<size_t>(request.size()), 0) < 0)
+    {
+        if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+            setUnavailable();
+        return nullptr;
+    }
+    auto process = new LaunchedProcess(header.id, parent);
+    processes[header.id] = process;
+    startTimers[header.id] = timer;
+    return process;
+#else
+    return nullptr;
+#endif
+}
+
+QStringList Launcher::splitCommand(const QString &command)
+{
+    // the same rules as QProcess: a quoted part may contain spaces, and three quotes are a literal quote
+    QStringList arguments;
+    QString current;
+    int quotes = 0;
+    bool inQuote = false;
+    for (auto ch : command)
+    {
+        if (ch == '"')
+        {
+            if (++quotes == 3)
+            {
+                quotes = 0;
+                current += ch;
+            }
+            continue;
+        }
+        if (quotes != 0)
+        {
+            if (quotes == 1)
+                inQuote = !inQuote;
+            quotes = 0;
+        }
+        if (!inQuote && ch.isSpace())
+        {
+            if (!current.isEmpty())
+            {
+                arguments.push_back(current);
+                current.clear();
+            }
+        }
+        else
+        {
+            current += ch;
+        }
+    }
+    if (!current.isEmpty())
+        arguments.push_back(current);
+    return arguments;
+}
+
+void Launcher::onControlActivated()
+{
+#if defined(Q_OS_UNIX)
+    while (controlFd >= 0)
+    {
+        Reply reply;
+        iovec vector;
+        vector.iov_base = &reply;
+        vector.iov_len = sizeof(reply);
+        char control[CMSG_SPACE(3 * sizeof(int))];
+        msghdr message;
+        memset(&message, 0, sizeof(message));
+        message.msg_iov = &vector;
+        message.msg_iovlen = 1;
+        message.msg_control = control;
+        message.msg_controllen = sizeof(control);
+
+        ssize_t size = ::recvmsg(controlFd, &message, 0);
+        if (size < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK)
+                setUnavailable();
+            return;
+        }
+
+        int fds[3] = {-1, -1, -1};
+        int count = 0;
+        for (auto header = CMSG_FIRSTHDR(&message); header != nullptr; header = CMSG_NXTHDR(&message, header))
+        {
+            if (header->cmsg_level != SOL_SOCKET || header->cmsg_type != SCM_RIGHTS)
+                continue;
+            int received = static_cast<int>((header->cmsg_len - CMSG_LEN(0)) / sizeof(int));
+            for (int i = 0; i < received; ++i)
+            {
+                int fd;
+                memcpy(&fd, CMSG_DATA(header) + i * sizeof(int), sizeof(int));
+                if (count < 3)
+                {
+                    setCloseOnExec(fd);
+                    fds[count++] = fd;
+                }
+                else
+                    ::close(fd);
+            }
+        }
+
+        auto process = size == sizeof(reply) ? processes.value(reply.id) : nullptr;
+        if (process == nullptr || (reply.type == SpawnedReply && count != 3))
+        {
+            closeAll({fds[0], fds[1], fds[2]});
+            // the process was destroyed before it started
+            if (size == sizeof(reply) && reply.type == SpawnedReply && !sendSignal(reply.id, SIGKILL) && reply.pid > 0)
+                ::kill(-static_cast<pid_t>(reply.pid), SIGKILL);
+            continue;
+        }
+
+        switch (reply.type)
+        {
+        case SpawnedReply:
+            process->setStarted(reply.pid, fds[0], fds[1], fds[2],
+                                static_cast<int>(startTimers.take(reply.id).nsecsElapsed() / 1000));
+            break;
+        case SpawnFailedReply:
+            processes.remove(reply.id);
+            startTimers.remove(reply.id);
+            process->setFailed(QString("Failed to start the process: ") + strerror(reply.status));
+            break;
+        case ExitedReply:
+        {
+            processes.remove(reply.id);
+            ProcessStats stats;
+            stats.cpuTime = static_cast<int>(reply.cpuTime / 1000);
+            stats.cpuTimeMicroseconds = reply.cpuTime;
+            stats.peakMemory = reply.peakMemory;
+            stats.bytesRead = reply.bytesRead;
+            stats.bytesWritten = reply.bytesWritten;
+            stats.readCalls = reply.readCalls;
+            stats.writeCalls = reply.writeCalls;
+            stats.voluntarySwitches = reply.voluntarySwitches;
+            stats.involuntarySwitches = reply.involuntarySwitches;
+            process->setFinished(reply.status, stats);
+            break;
+        }
+        }
+    }
+#endif
+}
+
+bool Launcher::sendSignal(quint64 id, int signal)
+{
+#if defined(Q_OS_UNIX)
+    if (controlFd < 0)
+        return false;
+    RequestHeader header;
+    memset(&header, 0, sizeof(header));
+    header.type = SignalRequest;
+    header.id = id;
+    header.signal = signal;
+
+    // the socket is non-blocking, and its queue may be full during a burst of spawn requests, but a kill or a stop
+    // must not be lost, so wait a little for the zygote to catch up
+    QElapsedTimer timer;
+    timer.start();
+    while (::send(controlFd, &header, sizeof(header), 0) != sizeof(header))
+    {
+        if (errno == EINTR)
+            continue;
+        int remaining = SIGNAL_TIMEOUT - static_cast<int>(timer.elapsed());
+        if ((errno != EAGAIN && errno != EWOULDBLOCK) || remaining <= 0)
+            return false;
+        pollfd fd;
+        fd.fd = controlFd;
+        fd.events = POLLOUT;
+        fd.revents = 0;
+        ::poll(&fd, 1, remaining);
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+void Launcher::setUnavailable()
+{
+#if defined(Q_OS_UNIX)
+    if (notifier != nullptr)
+        notifier->setEnabled(false);
+    if (controlFd >= 0)
+        ::close(controlFd);
+    controlFd = -1;
+    auto lost = processes;
+    processes.clear();
+    startTimers.clear();
+    for (auto process : lost)
+        process->setFailed("The process launcher has stopped");
+#endif
+}
+
+} // namespace Core
@@ -0,0 +1,404 @@
+/*
+ * Copyright (C) 2019-2020 Ashar Khan <ashar786khan@gmail.com>
+ *
+ * This file is part of CPEditor.
+ *
+ * CPEditor is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * I will not be responsible if CPEditor behaves in unexpected way and
+ * causes your ratings to go down and or loose any important contest.
+ *
+ * Believe Software is "Software" and it isn't immune to bugs.
+ *
+ */
+
+#include "Core/MemoryProfiler.hpp"
+#include "Core/Runner.hpp"
+#include <QCoreApplication>
+#include <QFile>
+#include <QFileInfo>
+#include <QMap>
+#include <QSet>
+#include <algorithm>
+
+namespace Core
+{
+
+const int MemoryProfiler::MAX_ALLOCATORS;
+
+MemoryProfiler::MemoryProfiler(QObject *parent) : QObject(parent)
+{
+    sampleTimer = new QTimer(this);
+    connect(sampleTimer, SIGNAL(timeout()), this, SLOT(takeSample()));
+    killTimer = new QTimer(this);
+    killTimer->setSingleShot(true);
+    connect(killTimer, SIGNAL(timeout()), this, SLOT(onTimeout()));
+}
+
+MemoryProfiler::~MemoryProfiler()
+{
+    stop();
+}
+
+void MemoryProfiler::start(const QString &filePath, const QString &lang, const QString &runCommand,
+                           const QString &args, const QString &input, int timeLimit, int sampleInterval,
+                           bool trackAllocations)
+{
+    stop();
+    QFileInfo fileInfo(filePath);
+    binaryPath = fileInfo.canonicalPath() + "/" + fileInfo.completeBaseName();
+    sourcePath = fileInfo.canonicalFilePath();
+    this->input = input.toUtf8();
+    this->timeLimit = timeLimit;
+    sites.clear();
+    result = Profile();
+
+    if (!isSupported())
+    {
+        emit errorOccured("Memory profiling is only supported on Linux");
+        return;
+    }
+    command = Runner::getCommand(filePath, lang, runCommand, args);
+    if (command.isEmpty())
+    {
+        emit errorOccured("Failed to get run command. It's probably a bug");
+        return;
+    }
+
+    running = true;
+    process = new QProcess(this);
+    connect(process, SIGNAL(started()), this, SLOT(onStarted()));
+    connect(process, SIGNAL(finished(int, QProcess::ExitStatus)), this, SLOT(onFinished(int, QProcess::ExitStatus)));
+    connect(process, SIGNAL(errorOccurred(QProcess::ProcessError)), this,
+            SLOT(onErrorOccurred(QProcess::ProcessError)));
+    if (!inputFileName.isEmpty() || !outputFileName.isEmpty())
+    {
+        scratchDir = Runner::createScratchDirectory(inputFileName, input);
+        if (scratchDir == nullptr)
+        {
+            fail("Failed to prepare the working directory for the file I/O");
+            return;
+        }
+        process->setWorkingDirectory(scratchDir->path());
+        if (!inputFileName.isEmpty())
+            this->input.clear();
+    }
+
+    if (trackAllocations)
+    {
+        if (lang != "C++")
+            result.allocationError = "The allocations can only be tracked for C++";
+        else if (shimPath().isEmpty())
+            result.allocationError = "The memory shim is not built with the editor";
+        else
+        {
+            reportDir = new QTemporaryDir();
+            auto environment = QProcessEnvironment::systemEnvironment();
+            environment.insert("LD_PRELOAD", shimPath());
+            environment.insert("CPEDITOR_MEMORY_SHIM_OUTPUT", reportDir->filePath("report"));
+            process->setProcessEnvironment(environment);
+        }
+    }
+
+    sampleTimer->setInterval(qMax(1, sampleInterval));
+
+    // the ticket is a child of the process, so it's released when the process is deleted
+    auto scheduler = Scheduler::current();
+    if (scheduler != nullptr)
+    {
+        auto ticket = scheduler->request(nullptr, Scheduler::Interactive, Scheduler::DEFAULT_RUN_MEMORY, process);
+        if (!ticket->isGranted())
+        {
+            connect(ticket, SIGNAL(granted()), this, SLOT(onTicketGranted()));
+            return;
+        }
+    }
+    process->start(command);
+}
+
+void MemoryProfiler::onTicketGranted()
+{
+    if (running && process != nullptr && sender()->parent() == process)
+        process->start(command);
+}
+
+void MemoryProfiler::setFileIO(const QString &inputFileName, const QString &outputFileName)
+{
+    this->inputFileName = inputFileName;
+    this->outputFileName = outputFileName;
+}
+
+void MemoryProfiler::stop()
+{
+    running = false;
+    sampleTimer->stop();
+    killTimer->stop();
+    // stop() may be called from the signals of the processes
+    if (process != nullptr)
+    {
+        process->disconnect(this);
+        process->kill();
+        process->deleteLater();
+        process = nullptr;
+    }
+    if (symbolizer != nullptr)
+    {
+        symbolizer->disconnect(this);
+        symbolizer->deleteLater();
+        symbolizer = nullptr;
+    }
+    delete reportDir;
+    reportDir = nullptr;
+    delete scratchDir;
+    scratchDir = nullptr;
+}
+
+bool MemoryProfiler::isRunning() const
+{
+    return running;
+}
+
+MemoryProfiler::Profile MemoryProfiler::profile() const
+{
+    return result;
+}
+
+bool MemoryProfiler::isSupported()
+{
+#if defined(Q_OS_LINUX)
+    return true;
+#else
+    return false;
+#endif
+}
+
+QString MemoryProfiler::shimPath()
+{
+    // the shim is built next to the executable, see CMakeLists.txt
+    QString path = QCoreApplication::applicationDirPath() + "/libcpeditor-memory-shim.so";
+    return QFile::exists(path) ? path : QString();
+}
+
+void MemoryProfiler::onStarted()
+{
+    runTimer.start();
+    takeSample();
+    sampleTimer->start();
+    killTimer->start(timeLimit);
+    process->write(input);
+    process->closeWriteChannel();
+}
+
+void MemoryProfiler::onFinished(int exitCode, QProcess::ExitStatus exitStatus)
+{
+    if (!running)
+        return;
+    result.timeUsed = static_cast<int>(runTimer.elapsed());
+    sampleTimer->stop();
+    killTimer->stop();
+    process->deleteLater();
+    process = nullptr;
+    delete scratchDir;
+    scratchDir = nullptr;
+
+    result.exitCode = exitStatus == QProcess::NormalExit ? exitCode : -1;
+
+    if (reportDir == nullptr)
+    {
+        finish();
+        return;
+    }
+    readReport();
+    QSet<quint64> addresses;
+    for (auto const &site : sites)
+    {
+        if (site.address != 0)
+            addresses.insert(site.address);
+    }
+    if (addresses.isEmpty())
+    {
+        aggregate();
+        finish();
+        return;
+    }
+    symbolizer = new Symbolizer(this);
+    connect(symbolizer, SIGNAL(finished()), this, SLOT(onSymbolized()));
+    connect(symbolizer, SIGNAL(errorOccured(const QString &)), this, SLOT(onSymbolizerErrorOccured(const QString &)));
+    symbolizer->start(binaryPath, addresses.toList());
+}
+
+void MemoryProfiler::onErrorOccurred(QProcess::ProcessError error)
+{
+    if (error == QProcess::FailedToStart)
+        fail("Failed to start running. Please compile first");
+}
+
+void MemoryProfiler::onTimeout()
+{
+    if (process == nullptr)
+        return;
+    result.timedOut = true;
+    process->kill();
+}
+
+void MemoryProfiler::takeSample()
+{
+    if (process == nullptr || process->processId() <= 0)
+        return;
+    QFile status("/proc/" + QString::number(process->processId()) + "/status");
+    if (!status.open(QIODevice::ReadOnly))
+        return;
+    // the values are in kB, e.g. "VmRSS:      1234 kB"
+    qint64 rss = -1, peak = 0, shared = 0;
+    for (auto const &line : status.readAll().split('\n'))
+    {
+        auto fields = line.simplified().split(' ');
+        if (fields.size() < 2)
+            continue;
+        if (fields[0] == "VmRSS:")
+            rss = fields[1].toLongLong() * 1024;
+        else if (fields[0] == "VmHWM:")
+            peak = fields[1].toLongLong() * 1024;
+        else if (fields[0] == "RssShmem:")
+            shared = fields[1].toLongLong() * 1024;
+    }
+    // a zombie has no memory left, so its sample is dropped
+    if (rss <= 0)
+        return;
+    // the tables of the shim are its shared memory, they only grow, so the peak without their current size is a lower
+    // bound of the peak of the solution itself
+    if (reportDir != nullptr)
+    {
+        result.shimMemory = qMax(result.shimMemory, shared);
+        rss = qMax<qint64>(0, rss - shared);
+        peak = qMax<qint64>(0, peak - shared);
+    }
+    result.peakMemory = qMax(result.peakMemory, qMax(peak, rss));
+    Sample sample;
+    sample.time = static_cast<int>(runTimer.elapsed());
+    sample.rss = rss;
+    result.samples.push_back(sample);
+    emit sampleTaken(sample.time, sample.rss);
+}
+
+void MemoryProfiler::onSymbolized()
+{
+    if (!running || symbolizer == nullptr)
+        return;
+    aggregate();
+    symbolizer->deleteLater();
+    symbolizer = nullptr;
+    finish();
+}
+
+void MemoryProfiler::onSymbolizerErrorOccured(const QString &error)
+{
+    if (!running || symbolizer == nullptr)
+        return;
+    // the call sites are still listed by their addresses
+    symbolizer->deleteLater();
+    symbolizer = nullptr;
+    aggregate();
+    result.allocationError = error;
+    finish();
+}
+
+void MemoryProfiler::readReport()
+{
+    QFile report(reportDir->filePath("report"));
+    if (!report.open(QIODevice::ReadOnly))
+    {
+        result.allocationError = result.timedOut
+                                     ? "The program was killed, so the memory shim couldn't write its report"
+                                     : "The memory shim didn't write its report, the program may be linked statically";
+        return;
+    }
+
+    // see src/Shim/MemoryShim.cpp for the format
+    for (auto const &line : report.readAll().split('\n'))
+    {
+        auto fields = line.split(' ');
+        if (fields.size() == 2 && fields[0] == "peak")
+            result.peakHeap = fields[1].toLongLong();
+        if (fields.size() < 5 || (fields[0] != "exe" && fields[0] != "lib"))
+            continue;
+        Site site;
+        site.count = fields[1].toLongLong();
+        site.totalBytes = fields[2].toLongLong();
+        site.peakLive = fields[3].toLongLong();
+        // the return address is after the call, the address before it is in the calling line
+        site.address = fields[0] == "exe" ? fields[4].toULongLong(nullptr, 16) - 1 : 0;
+        site.name = QString::fromUtf8(fields.mid(4).join(' '));
+        sites.push_back(site);
+    }
+}
+
+void MemoryProfiler::aggregate()
+{
+    QMap<QString, Allocator> allocators;
+    for (auto const &site : sites)
+    {
+        Allocator allocator;
+        if (site.address == 0)
+            allocator.function = site.name;
+        else
+        {
+            QVector<Symbolizer::Frame> frames;
+            if (symbolizer != nullptr)
+                frames = symbolizer->frames(site.address);
+            if (frames.isEmpty())
+                allocator.function = "0x" + QString::number(site.address, 16);
+            else
+            {
+                // the innermost frame in the source file is the line that allocates, the library code inlined into
+                // it is skipped, and without the debug information the outermost function is the caller
+                auto frame = frames.back();
+                for (auto const &candidate : frames)
+                {
+                    if (candidate.line > 0 && QFileInfo(candidate.file).canonicalFilePath() == sourcePath)
+                    {
+                        frame = candidate;
+                        break;
+                    }
+                }
+                allocator.function = frame.function;
+                if (frame.line > 0)
+                    allocator.location = QFileInfo(frame.file).fileName() + ":" + QString::number(frame.line);
+            }
+        }
+
+        auto &merged = allocators[allocator.function + "\n" + allocator.location];
+        merged.function = allocator.function;
+        merged.location = allocator.location;
+        merged.count += site.count;
+        merged.totalBytes += site.totalBytes;
+        // the peaks of the call sites happen at different times, so their sum may never have been live at once
+        merged.peakLive = qMax(merged.peakLive, site.peakLive);
+    }
+
+    result.allocators = allocators.values().toVector();
+    std::sort(result.allocators.begin(), result.allocators.end(), [](const Allocator &a, const Allocator &b) {
+        return a.peakLive != b.peakLive ? a.peakLive > b.peakLive : a.totalBytes > b.totalBytes;
+    });
+    if (result.allocators.size() > MAX_ALLOCATORS)
+        result.allocators.resize(MAX_ALLOCATORS);
+}
+
+void MemoryProfiler::finish()
+{
+    running = false;
+    delete reportDir;
+    reportDir = nullptr;
+    emit profilingFinished();
+}
+
+void MemoryProfiler::fail(const QString &error)
+{
+    stop();
+    emit errorOccured(error);
+}
+
+} // namespace Core
@@ -0,0 +1,170 @@
+/*
+ * Copyright (C) 2019-2020 Ashar Khan <ashar786khan@gmail.com>
+ *
+ * This file is part of CPEditor.
+ *
+ * CPEditor is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * I will not be responsible if CPEditor behaves in unexpected way and
+ * causes your ratings to go down and or loose any important contest.
+ *
+ * Believe Software is "Software" and it isn't immune to bugs.
+ *
+ */
+
+#include "Core/PerfCounters.hpp"
+#include <cstring>
+
+#if defined(Q_OS_LINUX)
+#include <cerrno>
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace Core
+{
+
+bool PerfCounters::enabled = false;
+int PerfCounters::probeResult = 0;
+
+#if defined(Q_OS_LINUX)
+namespace
+{
+
+const quint64 EVENT_CONFIGS[] = {PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_CACHE_MISSES,
+                                 PERF_COUNT_HW_BRANCH_MISSES};
+
+int openCounter(pid_t pid, quint64 config)
+{
+    perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = config;
+    // the user space only, which is allowed by the default perf_event_paranoid of most distributions
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    // count the threads and the child processes as well, e.g. the JVM or a shell wrapper
+    attr.inherit = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return static_cast<int>(syscall(__NR_perf_event_open, &attr, pid, -1, -1, PERF_FLAG_FD_CLOEXEC));
+}
+
+} // namespace
+#endif
+
+PerfCounters::PerfCounters()
+{
+    for (int &fd : fds)
+        fd = -1;
+}
+
+PerfCounters::~PerfCounters()
+{
+#if defined(Q_OS_LINUX)
+    for (int fd : fds)
+    {
+        if (fd >= 0)
+            ::close(fd);
+    }
+#endif
+}
+
+bool PerfCounters::attach(qint64 pid)
+{
+#if defined(Q_OS_LINUX)
+    if (!enabled || pid <= 0 || !isAvailable())
+        return false;
+    for (int i = 0; i < NumberOfEvents; ++i)
+    {
+        if (fds[i] < 0)
+            fds[i] = openCounter(static_cast<pid_t>(pid), EVENT_CONFIGS[i]);
+    }
+    // some virtual machines expose only a part of the events, the others stay unknown
+    return fds[Instructions] >= 0;
+#else
+    Q_UNUSED(pid);
+    return false;
+#endif
+}
+
+void PerfCounters::read(ProcessStats &stats) const
+{
+#if defined(Q_OS_LINUX)
+    qint64 *targets[] = {&stats.instructions, &stats.cycles, &stats.cacheMisses, &stats.branchMisses};
+    for (int i = 0; i < NumberOfEvents; ++i)
+    {
+        quint64 values[3]; // the count, the time enabled and the time running
+        if (fds[i] < 0 || ::read(fds[i], values, sizeof(values)) != static_cast<ssize_t>(sizeof(values)) ||
+            values[2] == 0)
+            continue;
+        // the kernel multiplexes the counters when there are more events than hardware counters, so the count is
+        // scaled to the whole time
+        double scaled = static_cast<double>(values[0]) * values[1] / values[2];
+        *targets[i] = static_cast<qint64>(scaled);
+    }
+#else
+    Q_UNUSED(stats);
+#endif
+}
+
+void PerfCounters::setEnabled(bool value)
+{
+    enabled = value;
+}
+
+bool PerfCounters::isEnabled()
+{
+    return enabled;
+}
+
+bool PerfCounters::isAvailable()
+{
+#if defined(Q_OS_LINUX)
+    if (probeResult == 0)
+    {
+        int fd = openCounter(0, PERF_COUNT_HW_INSTRUCTIONS);
+        if (fd >= 0)
+        {
+            ::close(fd);
+            probeResult = 1;
+        }
+        else
+        {
+            probeResult = -qMax(1, errno);
+        }
+    }
+    return probeResult == 1;
+#else
+    return false;
+#endif
+}
+
+QString PerfCounters::unavailableReason()
+{
+#if defined(Q_OS_LINUX)
+    if (isAvailable())
+        return QString();
+    switch (-probeResult)
+    {
+    case EACCES:
+    case EPERM:
+        return "Hardware counters are not permitted, lower /proc/sys/kernel/perf_event_paranoid to 2 or less";
+    case ENOENT:
+    case EOPNOTSUPP:
+        return "The CPU doesn't expose hardware counters, which is common in virtual machines";
+    case ENOSYS:
+        return "The kernel doesn't support perf_event_open, or it's blocked by the container";
+    default:
+        return QString("Failed to open hardware counters: ") + strerror(-probeResult);
+    }
+#else
+    return "Hardware counters are only supported on Linux";
+#endif
+}
+
+} // namespace Core
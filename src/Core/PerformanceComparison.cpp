@@ -0,0 +1,286 @@
+/*
+ * Copyright (C) 2019-2020 Ashar Khan <ashar786khan@gmail.com>
+ *
+ * This file is part of CPEditor.
+ *
+ * CPEditor is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * I will not be responsible if CPEditor behaves in unexpected way and
+ * causes your ratings to go down and or loose any important contest.
+ *
+ * Believe Software is "Software" and it isn't immune to bugs.
+ *
+ */
+
+#include "Core/PerformanceComparison.hpp"
+#include "Core/Checker.hpp"
+#include <cmath>
+
+namespace Core
+{
+
+Benchmark::Summary PerformanceComparison::Result::summary(Side side) const
+{
+    return Benchmark::summarize(times[side]);
+}
+
+PerformanceComparison::Estimate PerformanceComparison::Result::speedUp() const
+{
+    return estimate(logRatios(*this));
+}
+
+PerformanceComparison::PerformanceComparison(const Target &baseline, const Target &current, int timeLimit,
+                                             QObject *parent)
+    : QObject(parent), timeLimit(timeLimit)
+{
+    targets[Baseline] = baseline;
+    targets[Current] = current;
+}
+
+PerformanceComparison::~PerformanceComparison()
+{
+    stop();
+}
+
+void PerformanceComparison::start(const QStringList &inputs, const QStringList &expected, int rounds, int core)
+{
+    stop();
+    this->inputs = inputs;
+    this->expected = expected;
+    this->rounds = qMax(1, rounds);
+    this->core = core;
+    testResults.clear();
+    for (int i = 0; i < inputs.size(); ++i)
+    {
+        if (!inputs[i].trimmed().isEmpty())
+        {
+            Result result;
+            result.index = i;
+            testResults.push_back(result);
+        }
+    }
+
+    currentTest = currentRound = currentStep = finished = 0;
+    if (testResults.isEmpty())
+    {
+        emit comparisonFinished();
+        return;
+    }
+
+    running = true;
+    Runner::pauseAll();
+    emit progress(0, totalRuns());
+    runNext();
+}
+
+void PerformanceComparison::stop()
+{
+    if (!running)
+        return;
+    running = false;
+    if (runner != nullptr)
+    {
+        // stop() may be called from the signals of the runner
+        runner->deleteLater();
+        runner = nullptr;
+    }
+    Runner::resumeAll();
+}
+
+bool PerformanceComparison::isRunning() const
+{
+    return running;
+}
+
+QVector<PerformanceComparison::Result> PerformanceComparison::results() const
+{
+    return testResults;
+}
+
+PerformanceComparison::Estimate PerformanceComparison::overallSpeedUp() const
+{
+    // each test has the same weight, so the tests are the samples when there are several of them
+    QVector<double> means;
+    const Result *measured = nullptr;
+    for (auto const &result : testResults)
+    {
+        auto logs = logRatios(result);
+        if (logs.isEmpty())
+            continue;
+        double sum = 0;
+        for (auto value : logs)
+            sum += value;
+        means.push_back(sum / logs.size());
+        measured = &result;
+    }
+    if (means.size() == 1)
+        return measured->speedUp();
+    return estimate(means);
+}
+
+PerformanceComparison::Estimate PerformanceComparison::estimate(const QVector<double> &logRatios)
+{
+    Estimate result;
+    int n = logRatios.size();
+    if (n < 2)
+        return result;
+
+    double mean = 0;
+    for (auto value : logRatios)
+        mean += value;
+    mean /= n;
+    double squares = 0;
+    for (auto value : logRatios)
+        squares += (value - mean) * (value - mean);
+    double standardError = std::sqrt(squares / (n - 1) / n);
+
+    // the 97.5% quantiles of Student's t-distribution
+    static const double quantiles[] = {12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+                                       2.201,  2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+                                       2.080,  2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042};
+    int degrees = n - 1;
+    double t = degrees <= 30 ? quantiles[degrees - 1] : 1.96 + 2.5 / degrees;
+
+    result.valid = true;
+    result.value = std::exp(mean);
+    result.low = std::exp(mean - t * standardError);
+    result.high = std::exp(mean + t * standardError);
+    return result;
+}
+
+void PerformanceComparison::onRunFinished(int index, const QByteArray &out, const QByteArray &err, int exitCode,
+                                          int timeUsed)
+{
+    if (!running || runner == nullptr)
+        return;
+
+    double time = runner->stats().preciseCpuTime();
+    runner->deleteLater();
+    runner = nullptr;
+
+    auto &result = testResults[currentTest];
+    auto side = currentSide();
+    emit progress(++finished, totalRuns());
+
+    if (timedOut || exitCode != 0)
+    {
+        result.error = QString(side == Baseline ? "Baseline: " : "Current: ") +
+                       (timedOut ? "Time Limit Exceeded" : "Exited with code " + QString::number(exitCode));
+        emit resultChanged(result.index);
+        ++currentStep;
+        nextTest();
+        return;
+    }
+
+    if (currentRound == 0)
+    {
+        // the outputs are compared on the warm-up round only, a solution is expected to be deterministic
+        result.output[side] = out;
+        auto const &answer = expected.value(result.index);
+        if (!answer.trimmed().isEmpty())
+            result.correct[side] = Checker::isSameOutput(out, answer.toUtf8()) ? 1 : 0;
+    }
+    else
+    {
+        result.times[side].push_back(time);
+    }
+
+    if (++currentStep < 2)
+    {
+        runNext();
+        return;
+    }
+
+    currentStep = 0;
+    if (currentRound == 0)
+        result.sameOutput = Checker::isSameOutput(result.output[Current], result.output[Baseline]);
+    emit resultChanged(result.index);
+    if (++currentRound > rounds)
+        nextTest();
+    else
+        runNext();
+}
+
+void PerformanceComparison::onRunErrorOccured(int index, const QString &error)
+{
+    if (!running)
+        return;
+    testResults[currentTest].error = QString(currentSide() == Baseline ? "Baseline: " : "Current: ") + error;
+    emit resultChanged(testResults[currentTest].index);
+    finish();
+}
+
+void PerformanceComparison::onRunTimeout(int index)
+{
+    timedOut = true;
+}
+
+PerformanceComparison::Side PerformanceComparison::currentSide() const
+{
+    // ABBA: the order is swapped in every other round
+    bool baselineFirst = currentRound % 2 == 0;
+    return (currentStep == 0) == baselineFirst ? Baseline : Current;
+}
+
+int PerformanceComparison::totalRuns() const
+{
+    return testResults.size() * (rounds + 1) * 2;
+}
+
+void PerformanceComparison::runNext()
+{
+    timedOut = false;
+    auto const &target = targets[currentSide()];
+    runner = new Runner(testResults[currentTest].index);
+    runner->setExclusive(true);
+    runner->setCpuAffinity(core);
+    runner->setFileIO(target.inputFileName, target.outputFileName);
+    connect(runner, SIGNAL(runFinished(int, const QByteArray &, const QByteArray &, int, int)), this,
+            SLOT(onRunFinished(int, const QByteArray &, const QByteArray &, int, int)));
+    connect(runner, SIGNAL(runErrorOccured(int, const QString &)), this,
+            SLOT(onRunErrorOccured(int, const QString &)));
+    connect(runner, SIGNAL(runTimeout(int)), this, SLOT(onRunTimeout(int)));
+    runner->run(target.filePath, target.lang, target.runCommand, target.args, inputs[testResults[currentTest].index],
+                runTimeLimit());
+}
+
+void PerformanceComparison::nextTest()
+{
+    // the skipped runs of a failed test still count in the progress
+    finished += (rounds + 1 - currentRound) * 2 - currentStep;
+    emit progress(finished, totalRuns());
+
+    currentRound = currentStep = 0;
+    if (++currentTest >= testResults.size())
+        finish();
+    else
+        runNext();
+}
+
+void PerformanceComparison::finish()
+{
+    stop();
+    emit comparisonFinished();
+}
+
+int PerformanceComparison::runTimeLimit() const
+{
+    return qMax(timeLimit * 2, timeLimit + 1000);
+}
+
+QVector<double> PerformanceComparison::logRatios(const Result &result)
+{
+    QVector<double> logs;
+    int n = qMin(result.times[Baseline].size(), result.times[Current].size());
+    for (int i = 0; i < n; ++i)
+    {
+        if (result.times[Baseline][i] > 0 && result.times[Current][i] > 0)
+            logs.push_back(std::log(result.times[Baseline][i] / result.times[Current][i]));
+    }
+    return logs;
+}
+
+} // namespace Core
@@ -0,0 +1,184 @@
+/*
+ * Copyright (C) 2019-2020 Ashar Khan <ashar786khan@gmail.com>
+ *
+ * This file is part of CPEditor.
+ *
+ * CPEditor is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * I will not be responsible if CPEditor behaves in unexpected way and
+ * causes your ratings to go down and or loose any important contest.
+ *
+ * Believe Software is "Software" and it isn't immune to bugs.
+ *
+ */
+
+#include "Core/ProcessMonitor.hpp"
+#include <QFile>
+#include <QStringList>
+
+#if defined(Q_OS_LINUX)
+#include <unistd.h>
+#endif
+
+namespace Core
+{
+
+const int ProcessMonitor::SAMPLE_INTERVAL;
+
+double ProcessStats::preciseCpuTime() const
+{
+    return cpuTimeMicroseconds >= 0 ? cpuTimeMicroseconds / 1000.0 : cpuTime;
+}
+
+bool ProcessStats::isIOBound() const
+{
+    // a buffered stream makes one syscall per several kilobytes, so a few dozen bytes per syscall on thousands of
+    // syscalls means the stream is flushed or unbuffered
+    const qint64 minCalls = 1000, maxBytesPerCall = 64;
+    if (readCalls < 0 || writeCalls < 0 || bytesRead < 0 || bytesWritten < 0)
+        return false;
+    qint64 calls = readCalls + writeCalls;
+    return calls >= minCalls && bytesRead + bytesWritten < calls * maxBytesPerCall;
+}
+
+QString ProcessStats::ioSummary() const
+{
+    QStringList parts;
+    if (readCalls >= 0 && writeCalls >= 0)
+    {
+        parts.push_back("read " + QString::number(bytesRead) + " bytes in " + QString::number(readCalls) +
+                        " syscalls, wrote " + QString::number(bytesWritten) + " bytes in " +
+                        QString::number(writeCalls) + " syscalls");
+    }
+    if (voluntarySwitches >= 0 && involuntarySwitches >= 0)
+    {
+        parts.push_back(QString::number(voluntarySwitches) + " voluntary and " + QString::number(involuntarySwitches) +
+                        " involuntary context switches");
+    }
+    if (peakMemory >= 0)
+        parts.push_back("peak memory " + QString::number(peakMemory / 1024.0 / 1024.0, 'f', 1) + "MB");
+    return parts.join(", ");
+}
+
+double ProcessStats::ipc() const
+{
+    return instructions >= 0 && cycles > 0 ? static_cast<double>(instructions) / cycles : 0;
+}
+
+QString ProcessStats::countersSummary() const
+{
+    QStringList parts;
+    if (instructions >= 0)
+        parts.push_back(QString::number(instructions) + " instructions");
+    if (cycles >= 0)
+        parts.push_back(QString::number(cycles) + " cycles");
+    if (ipc() > 0)
+        parts.push_back("IPC " + QString::number(ipc(), 'f', 2));
+    if (cacheMisses >= 0)
+        parts.push_back(QString::number(cacheMisses) + " cache misses");
+    if (branchMisses >= 0)
+        parts.push_back(QString::number(branchMisses) + " branch misses");
+    return parts.join(", ");
+}
+
+ProcessMonitor::ProcessMonitor(QProcess *process, QObject *parent) : QObject(parent), process(process)
+{
+    timer = new QTimer(this);
+    timer->setInterval(SAMPLE_INTERVAL);
+    connect(timer, SIGNAL(timeout()), this, SLOT(sample()));
+}
+
+void ProcessMonitor::start()
+{
+    current = ProcessStats();
+    sampled = false;
+    pid = process->processId();
+    wallTimer.start();
+    if (isSupported())
+        timer->start();
+}
+
+void ProcessMonitor::stop()
+{
+    // a run stopped on a timeout or a wrong answer is still alive, so its last interval can be read, but the pid of a
+    // reaped process may already belong to another one
+    if (timer->isActive() && process->state() != QProcess::NotRunning)
+        sample();
+    timer->stop();
+    if (!sampled && wallTimer.isValid())
+        current.cpuTime = static_cast<int>(wallTimer.elapsed());
+}
+
+ProcessStats ProcessMonitor::stats() const
+{
+    return current;
+}
+
+bool ProcessMonitor::isSupported()
+{
+#if defined(Q_OS_LINUX)
+    return true;
+#else
+    return false;
+#endif
+}
+
+void ProcessMonitor::sample()
+{
+#if defined(Q_OS_LINUX)
+    if (pid <= 0)
+        return;
+
+    auto procPath = "/proc/" + QString::number(pid);
+
+    QFile statFile(procPath + "/stat");
+    if (!statFile.open(QIODevice::ReadOnly))
+        return;
+    auto stat = statFile.readAll();
+    // the second field is the executable name in parentheses, which may contain spaces
+    auto fields = stat.mid(stat.lastIndexOf(')') + 2).split(' ');
+    if (fields.size() < 18)
+        return;
+    qint64 ticks = fields[11].toLongLong() + fields[12].toLongLong();
+    current.cpuTime = qMax(current.cpuTime, static_cast<int>(ticks * 1000 / sysconf(_SC_CLK_TCK)));
+
+    // the counters only grow, so the latest values are kept
+    auto valueOf = [](const QByteArray &line) { return line.mid(line.indexOf(':') + 1).simplified().split(' ')[0]; };
+    QFile statusFile(procPath + "/status");
+    if (statusFile.open(QIODevice::ReadOnly))
+    {
+        for (auto line : statusFile.readAll().split('\n'))
+        {
+            if (line.startsWith("VmHWM:"))
+                current.peakMemory = qMax(current.peakMemory, valueOf(line).toLongLong() * 1024);
+            else if (line.startsWith("voluntary_ctxt_switches:"))
+                current.voluntarySwitches = qMax(current.voluntarySwitches, valueOf(line).toLongLong());
+            else if (line.startsWith("nonvoluntary_ctxt_switches:"))
+                current.involuntarySwitches = qMax(current.involuntarySwitches, valueOf(line).toLongLong());
+        }
+    }
+
+    QFile ioFile(procPath + "/io");
+    if (ioFile.open(QIODevice::ReadOnly))
+    {
+        for (auto line : ioFile.readAll().split('\n'))
+        {
+            if (line.startsWith("rchar:"))
+                current.bytesRead = qMax(current.bytesRead, valueOf(line).toLongLong());
+            else if (line.startsWith("wchar:"))
+                current.bytesWritten = qMax(current.bytesWritten, valueOf(line).toLongLong());
+            else if (line.startsWith("syscr:"))
+                current.readCalls = qMax(current.readCalls, valueOf(line).toLongLong());
+            else if (line.startsWith("syscw:"))
+                current.writeCalls = qMax(current.writeCalls, valueOf(line).toLongLong());
+        }
+    }
+
+    sampled = true;
+#endif
+}
+
+} // namespace Core
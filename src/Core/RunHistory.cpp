@@ -0,0 +1,226 @@
+/*
+ * Copyright (C) 2019-2020 Ashar Khan <ashar786khan@gmail.com>
+ *
+ * This file is part of CPEditor.
+ *
+ * CPEditor is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * I will not be responsible if CPEditor behaves in unexpected way and
+ * causes your ratings to go down and or loose any important contest.
+ *
+ * Believe Software is "Software" and it isn't immune to bugs.
+ *
+ */
+
+#include "Core/RunHistory.hpp"
+#include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDir>
+#include <QStandardPaths>
+#include <QtEndian>
+
+namespace Core
+{
+
+const int RunHistory::MAX_RECORDS_PER_QUERY;
+
+namespace
+{
+const char LOG_MAGIC[] = "CPEHLOG1";
+const char INDEX_MAGIC[] = "CPEHIDX1";
+const int MAGIC_SIZE = 8;
+const int INDEX_ENTRY_SIZE = 16; // the 8-byte key and the 8-byte offset, both little endian
+const quint32 MAX_RECORD_SIZE = 1 << 16;
+
+quint64 keyOf(const QByteArray &testHash)
+{
+    return testHash.size() >= 8 ? qFromLittleEndian<quint64>(testHash.constData()) : 0;
+}
+} // namespace
+
+RunHistory::RunHistory(QObject *parent) : QObject(parent)
+{
+}
+
+RunHistory *RunHistory::instance()
+{
+    static RunHistory *history = new RunHistory(QCoreApplication::instance());
+    return history;
+}
+
+QByteArray RunHistory::hash(const QString &text)
+{
+    return QCryptographicHash::hash(text.toUtf8(), QCryptographicHash::Sha1);
+}
+
+QString RunHistory::directory()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::AppConfigLocation) + "/history";
+}
+
+bool RunHistory::open()
+{
+    if (opened || failed)
+        return opened;
+    // a broken store is not retried for every run
+    failed = true;
+
+    QDir dir(directory());
+    if (!dir.mkpath("."))
+        return false;
+    log.setFileName(dir.filePath("runs.log"));
+    index.setFileName(dir.filePath("runs.idx"));
+    if (!log.open(QIODevice::ReadWrite) || !index.open(QIODevice::ReadWrite))
+        return false;
+
+    if (log.size() < MAGIC_SIZE)
+    {
+        log.resize(0);
+        log.write(LOG_MAGIC, MAGIC_SIZE);
+    }
+    else if (log.read(MAGIC_SIZE) != QByteArray(LOG_MAGIC, MAGIC_SIZE))
+        return false;
+
+    // the index is trusted up to its last complete entry, the rest of the log is indexed again
+    qint64 indexed = MAGIC_SIZE;
+    if (index.size() < MAGIC_SIZE || index.read(MAGIC_SIZE) != QByteArray(INDEX_MAGIC, MAGIC_SIZE))
+    {
+        index.resize(0);
+        index.write(INDEX_MAGIC, MAGIC_SIZE);
+    }
+    else
+    {
+        index.resize(MAGIC_SIZE + (index.size() - MAGIC_SIZE) / INDEX_ENTRY_SIZE * INDEX_ENTRY_SIZE);
+        auto entries = index.readAll();
+        for (int i = 0; i + INDEX_ENTRY_SIZE <= entries.size(); i += INDEX_ENTRY_SIZE)
+        {
+            quint64 key = qFromLittleEndian<quint64>(entries.constData() + i);
+            qint64 offset = qFromLittleEndian<qint64>(entries.constData() + i + 8);
+            if (offset < MAGIC_SIZE || offset >= log.size())
+                continue;
+            offsets[key].push_back(offset);
+            indexed = qMax(indexed, offset);
+        }
+        if (indexed > MAGIC_SIZE)
+        {
+            // skip the last indexed record itself
+            Record record;
+            log.seek(indexed);
+            indexed = readRecord(log, record) ? log.pos() : log.size();
+        }
+    }
+
+    log.seek(indexed);
+    while (log.pos() < log.size())
+    {
+        qint64 offset = log.pos();
+        Record record;
+        if (!readRecord(log, record))
+        {
+            // a record cut by a crash is dropped, so that the next ones are readable
+            log.resize(offset);
+            break;
+        }
+        indexRecord(record.testHash, offset);
+    }
+
+    opened = true;
+    failed = false;
+    return true;
+}
+
+bool RunHistory::readRecord(QFile &file, Record &record)
+{
+    auto header = file.read(4);
+    if (header.size() != 4)
+        return false;
+    quint32 size = qFromLittleEndian<quint32>(header.constData());
+    if (size > MAX_RECORD_SIZE)
+        return false;
+    auto payload = file.read(size);
+    if (payload.size() != static_cast<int>(size))
+        return false;
+
+    QDataStream stream(payload);
+    stream.setVersion(QDataStream::Qt_5_12);
+    stream >> record.timestamp >> record.sourceHash >> record.testHash >> record.profile >> record.verdict;
+    qint32 cpuTime;
+    stream >> cpuTime >> record.peakMemory;
+    record.cpuTime = cpuTime;
+    return stream.status() == QDataStream::Ok;
+}
+
+void RunHistory::indexRecord(const QByteArray &testHash, qint64 offset)
+{
+    char entry[INDEX_ENTRY_SIZE];
+    qToLittleEndian<quint64>(keyOf(testHash), entry);
+    qToLittleEndian<qint64>(offset, entry + 8);
+    index.seek(index.size());
+    index.write(entry, INDEX_ENTRY_SIZE);
+    index.flush();
+    offsets[keyOf(testHash)].push_back(offset);
+}
+
+void RunHistory::append(const Record &record)
+{
+    if (!open())
+        return;
+
+    QByteArray payload;
+    QDataStream stream(&payload, QIODevice::WriteOnly);
+    stream.setVersion(QDataStream::Qt_5_12);
+    stream << record.timestamp << record.sourceHash << record.testHash << record.profile << record.verdict
+           << static_cast<qint32>(record.cpuTime) << record.peakMemory;
+
+    char header[4];
+    qToLittleEndian<quint32>(static_cast<quint32>(payload.size()), header);
+    qint64 offset = log.size();
+    log.seek(offset);
+    log.write(header, 4);
+    log.write(payload);
+    log.flush();
+    indexRecord(record.testHash, offset);
+}
+
+QVector<RunHistory::Record> RunHistory::records(const QByteArray &testHash)
+{
+    QVector<Record> result;
+    if (!open())
+        return result;
+
+    auto const &list = offsets.value(keyOf(testHash));
+    for (int i = qMax(0, list.size() - MAX_RECORDS_PER_QUERY); i < list.size(); ++i)
+    {
+        Record record;
+        log.seek(list[i]);
+        // the key is only a prefix of the hash
+        if (readRecord(log, record) && record.testHash == testHash)
+            result.push_back(record);
+    }
+    return result;
+}
+
+QVector<int> RunHistory::timesPerRevision(const QVector<Record> &records, const QString &profile, int limit)
+{
+    QVector<int> times;
+    QByteArray lastRevision;
+    for (auto const &record : records)
+    {
+        if (record.profile != profile || record.verdict == "TLE" || record.verdict == "RE")
+            continue;
+        if (!times.isEmpty() && record.sourceHash == lastRevision)
+            times.back() = record.cpuTime;
+        else
+            times.push_back(record.cpuTime);
+        lastRevision = record.sourceHash;
+    }
+    if (times.size() > limit)
+        times.remove(0, times.size() - limit);
+    return times;
+}
+
+} // namespace Core
@@ -15,20 +15,37 @@
  *
  */
 
+#include <QDir>
 #include <QFileInfo>
 #include "Core/Runner.hpp"
+#include "Core/ExecutorClient.hpp"
+#include "Core/Launcher.hpp"
+#include "Core/Toolchain.hpp"
+
+#if defined(Q_OS_UNIX)
+#include <signal.h>
+#endif
 
 namespace Core
 {
 
+const int Runner::STREAM_INTERVAL;
+const int Runner::STREAM_TAIL;
+
+QList<Runner *> Runner::runners;
+int Runner::pauseDepth = 0;
+
 Runner::Runner(int index) : runnerIndex(index)
 {
-    runProcess = new QProcess();
+    runProcess = new ChildProcess();
+    monitor = new ProcessMonitor(runProcess, this);
     connect(runProcess, SIGNAL(started()), this, SLOT(onStarted()));
+    runners.push_back(this);
 }
 
 Runner::~Runner()
 {
+    runners.removeOne(this);
     if (killTimer != nullptr)
     {
         delete killTimer;
@@ -37,15 +54,42 @@ Runner::~Runner()
     {
         if (runProcess->state() == QProcess::Running)
         {
-            runProcess->kill();
+            resume();
+            runProcess->killTree();
             emit runKilled(runnerIndex);
         }
         delete runProcess;
     }
+    if (launched != nullptr && launched->isRunning())
+    {
+        resume();
+        emit runKilled(runnerIndex);
+    }
+#if defined(Q_OS_UNIX)
+    // the processes started by the program are killed even if the program itself has already exited
+    ChildProcess::signalGroup(groupId, SIGKILL);
+#endif
+    if (remoteJob != 0)
+    {
+        ExecutorClient::instance()->cancel(remoteJob);
+        emit runKilled(runnerIndex);
+    }
     if (runTimer != nullptr)
     {
         delete runTimer;
     }
+    if (comparator != nullptr)
+    {
+        delete comparator;
+    }
+    if (counters != nullptr)
+    {
+        delete counters;
+    }
+    if (scratchDir != nullptr)
+    {
+        delete scratchDir;
+    }
 }
 
 void Runner::run(const QString &filePath, const QString &lang, const QString &runCommand, const QString &args,
@@ -64,7 +108,51 @@ void Runner::run(const QString &filePath, const QString &lang, const QString &ru
         return;
     }
 
-    connect(runProcess, SIGNAL(finished(int, QProcess::ExitStatus)), this, SLOT(onFinished(int, QProcess::ExitStatus)));
+    runProcess->setMemoryLimit(lang == "C++" ? memoryLimit : 0);
+
+    // the exclusive runs pause all the other runs by themselves
+    auto scheduler = Scheduler::current();
+    if (scheduler != nullptr && !exclusive)
+    {
+        qint64 memory = memoryLimit > 0 ? memoryLimit : Scheduler::DEFAULT_RUN_MEMORY;
+        ticket = scheduler->request(owner, priority, memory, this);
+        if (!ticket->isGranted())
+        {
+            pendingCommand = command;
+            pendingInput = input;
+            pendingTimeLimit = timeLimit;
+            connect(ticket, SIGNAL(granted()), this, SLOT(onTicketGranted()));
+            return;
+        }
+    }
+
+    start(command, input, timeLimit);
+}
+
+void Runner::start(const QString &command, const QString &input, int timeLimit)
+{
+    QString workingDirectory, standardInput = input;
+    if (!inputFileName.isEmpty() || !outputFileName.isEmpty())
+    {
+        if (!prepareScratchDirectory(input))
+        {
+            releaseTicket();
+            emit runErrorOccured(runnerIndex, "Failed to prepare the working directory for the file I/O");
+            return;
+        }
+        workingDirectory = scratchDir->path();
+        runProcess->setWorkingDirectory(workingDirectory);
+        // the judges don't give the input on stdin either when it's read from a file
+        if (!inputFileName.isEmpty())
+            standardInput.clear();
+    }
+
+    // the pinned and the exclusive runs need the local machine to be quiet, so they are not sent to the daemon
+    if (ExecutorClient::isEnabled() && !exclusive && runProcess->cpuAffinity() < 0)
+    {
+        runRemotely(command, standardInput, workingDirectory, timeLimit);
+        return;
+    }
 
     killTimer = new QTimer(runProcess);
     killTimer->setSingleShot(true);
@@ -73,32 +161,56 @@ void Runner::run(const QString &filePath, const QString &lang, const QString &ru
 
     runTimer = new QElapsedTimer();
 
+    if (Launcher::isAvailable())
+    {
+        launched = Launcher::instance()->spawn(command, runProcess->memoryLimit(), runProcess->cpuAffinity(),
+                                               workingDirectory, this);
+        if (launched != nullptr)
+        {
+            connect(launched, SIGNAL(started()), this, SLOT(onLaunchedStarted()));
+            connect(launched, SIGNAL(readyReadStandardOutput()), this, SLOT(onReadyReadStandardOutput()));
+            connect(launched, SIGNAL(finished(int, bool)), this, SLOT(onLaunchedFinished(int, bool)));
+            connect(launched, SIGNAL(errorOccurred(const QString &)), this,
+                    SLOT(onLaunchedErrorOccurred(const QString &)));
+            // the input is kept until the process is started
+            launched->write(standardInput.toUtf8());
+            launched->closeWriteChannel();
+            return;
+        }
+    }
+
+    connect(runProcess, SIGNAL(finished(int, QProcess::ExitStatus)), this, SLOT(onFinished(int, QProcess::ExitStatus)));
+
     killTimer->start();
     runTimer->start();
 
+    QElapsedTimer startTimer;
+    startTimer.start();
     runProcess->start(command);
     bool started = runProcess->waitForStarted(2000);
     if (!started)
     {
+        releaseTicket();
         emit runErrorOccured(runnerIndex, "Failed to start running. Please compile first");
         runProcess->kill();
         return;
     }
-    runProcess->write(input.toStdString().c_str());
+    startLatency = static_cast<int>(startTimer.nsecsElapsed() / 1000);
+    runProcess->write(standardInput.toStdString().c_str());
     runProcess->closeWriteChannel();
 }
 
 void Runner::runDetached(const QString &filePath, const QString &lang, const QString &runCommand, const QString &args)
 {
 #if defined(__unix__)
-    QProcess testProcess;
-    testProcess.start("xterm -v");
-    bool finished = testProcess.waitForFinished(2000);
-    if (!finished || testProcess.exitCode() != 0)
+    // the probe is asynchronous, if it's not finished yet, a missing xterm is reported by onDetachedErrorOccurred()
+    if (Toolchain::instance()->probe(Toolchain::Terminal, "xterm") == Toolchain::Unavailable)
     {
         emit runErrorOccured(runnerIndex, "Please install xterm in order to use Detached Run");
         return;
     }
+    connect(runProcess, SIGNAL(errorOccurred(QProcess::ProcessError)), this,
+            SLOT(onDetachedErrorOccurred(QProcess::ProcessError)));
     runProcess->setProgram("xterm");
     runProcess->setArguments({"-e", getCommand(filePath, lang, runCommand, args) +
                                         "; read -n 1 -s -r -p '\nExecution Done\nPress any key to exit'"});
@@ -109,26 +221,427 @@ void Runner::runDetached(const QString &filePath, const QString &lang, const QSt
 #endif
 }
 
+ProcessStats Runner::stats() const
+{
+    if (remote)
+        return remoteStats;
+    auto result = launched != nullptr ? launched->stats() : monitor->stats();
+    if (launched == nullptr)
+        result.startLatency = startLatency;
+    if (counters != nullptr)
+        counters->read(result);
+    return result;
+}
+
+void Runner::setCpuAffinity(int core)
+{
+    runProcess->setCpuAffinity(core);
+}
+
+void Runner::setExpectedOutput(const QString &expected)
+{
+    if (comparator != nullptr)
+        delete comparator;
+    comparator = new StreamingComparator(expected);
+    connect(runProcess, SIGNAL(readyReadStandardOutput()), this, SLOT(onReadyReadStandardOutput()),
+            Qt::UniqueConnection);
+}
+
+void Runner::setOutputStreaming(bool value)
+{
+    if (!value)
+    {
+        if (streamTimer != nullptr)
+        {
+            delete streamTimer;
+            streamTimer = nullptr;
+        }
+        return;
+    }
+    if (streamTimer != nullptr)
+        return;
+    streamTimer = new QTimer(this);
+    streamTimer->setSingleShot(true);
+    streamTimer->setInterval(STREAM_INTERVAL);
+    connect(streamTimer, SIGNAL(timeout()), this, SLOT(onStreamTimeout()));
+    // the output is drained as it's written, which also keeps the pipe from filling up
+    connect(runProcess, SIGNAL(readyReadStandardOutput()), this, SLOT(onReadyReadStandardOutput()),
+            Qt::UniqueConnection);
+}
+
+void Runner::setFileIO(const QString &inputFileName, const QString &outputFileName)
+{
+    this->inputFileName = inputFileName;
+    this->outputFileName = outputFileName;
+}
+
+bool Runner::isValidFileIOName(const QString &name)
+{
+    // the files are created in the working directory of each run, so they can't point elsewhere
+    return name.isEmpty() || (QFileInfo(name).fileName() == name && name != "." && name != "..");
+}
+
+void Runner::setMemoryLimit(qint64 bytes)
+{
+    memoryLimit = bytes;
+}
+
+void Runner::setScheduling(QObject *owner, Scheduler::Priority priority)
+{
+    this->owner = owner;
+    this->priority = priority;
+}
+
+void Runner::setExclusive(bool value)
+{
+    exclusive = value;
+}
+
+void Runner::pauseAll()
+{
+    if (pauseDepth++ == 0)
+    {
+        for (auto runner : runners)
+            runner->pause();
+    }
+}
+
+void Runner::resumeAll()
+{
+    if (pauseDepth > 0 && --pauseDepth == 0)
+    {
+        for (auto runner : runners)
+            runner->resume();
+    }
+}
+
+void Runner::pause()
+{
+#if defined(Q_OS_UNIX)
+    if (exclusive || paused || !isRunning())
+        return;
+    if (launched != nullptr)
+        launched->sendSignal(SIGSTOP);
+    else if (runProcess->processId() > 0)
+    {
+        if (!ChildProcess::signalGroup(runProcess->processId(), SIGSTOP))
+            ::kill(static_cast<pid_t>(runProcess->processId()), SIGSTOP);
+    }
+    else
+        return;
+    paused = true;
+    // the time limit doesn't elapse while the process is stopped
+    if (killTimer != nullptr && killTimer->isActive())
+    {
+        remainingTime = killTimer->remainingTime();
+        killTimer->stop();
+    }
+    else
+    {
+        remainingTime = -1;
+    }
+#endif
+}
+
+void Runner::resume()
+{
+#if defined(Q_OS_UNIX)
+    if (!paused)
+        return;
+    paused = false;
+    if (launched != nullptr && launched->isRunning())
+        launched->sendSignal(SIGCONT);
+    else if (launched == nullptr && runProcess->state() == QProcess::Running &&
+             !ChildProcess::signalGroup(runProcess->processId(), SIGCONT))
+        ::kill(static_cast<pid_t>(runProcess->processId()), SIGCONT);
+    if (killTimer != nullptr && remainingTime >= 0)
+        killTimer->start(remainingTime);
+#endif
+}
+
 void Runner::onFinished(int exitCode, QProcess::ExitStatus exitStatus)
 {
-    emit runFinished(runnerIndex, runProcess->readAllStandardOutput(), runProcess->readAllStandardError(), exitCode,
-                     runTimer->elapsed());
+    monitor->stop();
+    releaseTicket();
+    stopStreaming();
+    reapProcessGroup();
+    output += runProcess->readAllStandardOutput();
+    auto error = runProcess->readAllStandardError();
+    collectOutputFile(error);
+    emit runFinished(runnerIndex, output, error, exitCode, runTimer->elapsed());
 }
 
 void Runner::onStarted()
 {
+    if (pauseDepth > 0)
+        pause();
+    groupId = runProcess->processId();
+    monitor->start();
+    attachCounters(runProcess->processId());
     emit runStarted(runnerIndex);
 }
 
+void Runner::onDetachedErrorOccurred(QProcess::ProcessError error)
+{
+    if (error == QProcess::FailedToStart)
+        emit runErrorOccured(runnerIndex, "Please install xterm in order to use Detached Run");
+}
+
+void Runner::onLaunchedStarted()
+{
+    killTimer->start();
+    runTimer->start();
+    groupId = launched->processId();
+    attachCounters(launched->processId());
+    if (pauseDepth > 0)
+        pause();
+    emit runStarted(runnerIndex);
+}
+
+void Runner::onLaunchedFinished(int exitCode, bool crashed)
+{
+    releaseTicket();
+    stopStreaming();
+    reapProcessGroup();
+    output += launched->readAllStandardOutput();
+    auto error = launched->readAllStandardError();
+    collectOutputFile(error);
+    emit runFinished(runnerIndex, output, error, exitCode, runTimer->elapsed());
+}
+
+void Runner::onLaunchedErrorOccurred(const QString &error)
+{
+    releaseTicket();
+    emit runErrorOccured(runnerIndex, error);
+}
+
 void Runner::onTimeout()
 {
-    if (runProcess->state() == QProcess::Running)
+    if (isRunning())
     {
-        runProcess->kill();
+        monitor->stop();
+        resume();
+        killProcess();
         emit runTimeout(runnerIndex);
     }
 }
 
+void Runner::onReadyReadStandardOutput()
+{
+    // the output is read straight into the end of the buffer instead of a new array for each chunk
+    int from = output.size();
+    if (launched != nullptr)
+        output += launched->readAllStandardOutput();
+    else
+    {
+        qint64 available = runProcess->bytesAvailable();
+        output.resize(from + static_cast<int>(available));
+        qint64 read = runProcess->read(output.data() + from, available);
+        output.resize(from + static_cast<int>(qMax<qint64>(0, read)));
+    }
+    if (output.size() == from)
+        return;
+
+    auto chunk = QByteArray::fromRawData(output.constData() + from, output.size() - from);
+    if (comparator != nullptr && !comparator->hasMismatch() && !comparator->feed(chunk) && isRunning())
+    {
+        monitor->stop();
+        resume();
+        killProcess();
+        emit runWrongAnswer(runnerIndex, comparator->mismatchMessage());
+    }
+    if (streamTimer != nullptr && !streamTimer->isActive())
+        streamTimer->start();
+}
+
+void Runner::onStreamTimeout()
+{
+    if (streamed >= output.size())
+        return;
+    int from = qMax(streamed, output.size() - STREAM_TAIL);
+    streamed = output.size();
+    emit runOutputStreamed(runnerIndex, output.mid(from), output.size());
+}
+
+void Runner::onTicketGranted()
+{
+    start(pendingCommand, pendingInput, pendingTimeLimit);
+    pendingCommand.clear();
+    pendingInput.clear();
+}
+
+void Runner::stopStreaming()
+{
+    // the whole output is reported by runFinished(), a later chunk would overwrite it
+    if (streamTimer != nullptr)
+        streamTimer->stop();
+}
+
+void Runner::releaseTicket()
+{
+    if (ticket != nullptr)
+    {
+        delete ticket;
+        ticket = nullptr;
+    }
+}
+
+bool Runner::isRunning() const
+{
+    if (launched != nullptr)
+        return launched->isRunning();
+    return runProcess->state() == QProcess::Running;
+}
+
+void Runner::killProcess()
+{
+    // the whole process tree is killed, so the time limit holds for the processes the program starts as well
+    if (launched != nullptr)
+        launched->kill();
+    else
+        runProcess->killTree();
+}
+
+void Runner::reapProcessGroup()
+{
+    // the processes left behind by a program which forks would keep using the CPU and spoil the timing of later runs
+    auto leaked = ChildProcess::groupMembers(groupId);
+#if defined(Q_OS_UNIX)
+    ChildProcess::signalGroup(groupId, SIGKILL);
+#endif
+    groupId = 0;
+    if (!leaked.isEmpty())
+        emit runLeakedProcesses(runnerIndex, leaked);
+}
+
+void Runner::attachCounters(qint64 pid)
+{
+    if (!PerfCounters::isEnabled())
+        return;
+    if (counters != nullptr)
+        delete counters;
+    counters = new PerfCounters();
+    counters->attach(pid);
+}
+
+void Runner::runRemotely(const QString &command, const QString &input, const QString &workingDirectory, int timeLimit)
+{
+    auto client = ExecutorClient::instance();
+    connect(client, SIGNAL(jobStarted(quint64)), this, SLOT(onRemoteJobStarted(quint64)));
+    connect(client, SIGNAL(jobOutput(quint64, int, const QByteArray &)), this,
+            SLOT(onRemoteJobOutput(quint64, int, const QByteArray &)));
+    connect(client, SIGNAL(jobFinished(quint64, const Core::ExecutorMessage &)), this,
+            SLOT(onRemoteJobFinished(quint64, const Core::ExecutorMessage &)));
+    connect(client, SIGNAL(jobFailed(quint64, const QString &)), this,
+            SLOT(onRemoteJobFailed(quint64, const QString &)));
+    remote = true;
+    remoteJob = client->submit(command, workingDirectory, input.toUtf8(), timeLimit, runProcess->memoryLimit());
+}
+
+bool Runner::prepareScratchDirectory(const QString &input)
+{
+    if (scratchDir != nullptr)
+        delete scratchDir;
+    scratchDir = createScratchDirectory(inputFileName, input);
+    return scratchDir != nullptr;
+}
+
+QTemporaryDir *Runner::createScratchDirectory(const QString &inputFileName, const QString &input)
+{
+    // each run has a directory of its own, so the tests can run in parallel without overwriting the files of others
+    auto directory = new QTemporaryDir(scratchRoot() + "/cpeditor-run-XXXXXX");
+    if (directory->isValid() && inputFileName.isEmpty())
+        return directory;
+    QFile file(directory->filePath(inputFileName));
+    if (directory->isValid() && file.open(QIODevice::WriteOnly) && file.write(input.toUtf8()) >= 0)
+        return directory;
+    delete directory;
+    return nullptr;
+}
+
+void Runner::collectOutputFile(QByteArray &error)
+{
+    if (scratchDir == nullptr)
+        return;
+    if (!outputFileName.isEmpty())
+    {
+        // the output written to stdout is only streamed for debugging, the judges ignore it as well
+        QFile file(scratchDir->filePath(outputFileName));
+        if (file.open(QIODevice::ReadOnly))
+            output = file.readAll();
+        else
+        {
+            output.clear();
+            error += "\nThe output file " + QFile::encodeName(outputFileName) + " was not created\n";
+        }
+    }
+    // the directory may be in the memory, so it's removed as soon as it's not needed
+    delete scratchDir;
+    scratchDir = nullptr;
+}
+
+QString Runner::scratchRoot()
+{
+#if defined(Q_OS_LINUX)
+    // a tmpfs keeps the files in the memory, so the file I/O is as cheap as the pipes
+    QFileInfo shm("/dev/shm");
+    if (shm.isDir() && shm.isWritable())
+        return shm.absoluteFilePath();
+#endif
+    return QDir::tempPath();
+}
+
+void Runner::onRemoteJobStarted(quint64 job)
+{
+    if (job == remoteJob)
+        emit runStarted(runnerIndex);
+}
+
+void Runner::onRemoteJobOutput(quint64 job, int channel, const QByteArray &data)
+{
+    if (job != remoteJob)
+        return;
+    if (channel == ExecutorMessage::StandardError)
+    {
+        remoteError += data;
+        return;
+    }
+    output += data;
+    if (comparator != nullptr && !comparator->hasMismatch() && !comparator->feed(data))
+    {
+        // the daemon reports the killed job as finished
+        ExecutorClient::instance()->cancel(remoteJob);
+        emit runWrongAnswer(runnerIndex, comparator->mismatchMessage());
+    }
+    if (streamTimer != nullptr && !streamTimer->isActive())
+        streamTimer->start();
+}
+
+void Runner::onRemoteJobFinished(quint64 job, const ExecutorMessage &result)
+{
+    if (job != remoteJob)
+        return;
+    remoteJob = 0;
+    releaseTicket();
+    stopStreaming();
+    remoteStats.cpuTime = result.cpuTime;
+    remoteStats.peakMemory = result.peakMemory;
+    // a local run reports the time limit before it's killed, and the result after that
+    if (result.timedOut)
+        emit runTimeout(runnerIndex);
+    collectOutputFile(remoteError);
+    emit runFinished(runnerIndex, output, remoteError, result.exitCode, result.timeUsed);
+}
+
+void Runner::onRemoteJobFailed(quint64 job, const QString &error)
+{
+    if (job != remoteJob)
+        return;
+    remoteJob = 0;
+    releaseTicket();
+    emit runErrorOccured(runnerIndex, error);
+}
+
 QString Runner::getCommand(const QString &filePath, const QString &lang, const QString &runCommand, const QString &args)
 {
     QFileInfo fileInfo(filePath);
@@ -0,0 +1,550 @@
+/*
+ * Copyright (C) 2019-2020 Ashar Khan <ashar786khan@gmail.com>
+ *
+ * This file is part of CPEditor.
+ *
+ * CPEditor is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * I will not be responsible if CPEditor behaves in unexpected way and
+ * causes your ratings to go down and or loose any important contest.
+ *
+ * Believe Software is "Software" and it isn't immune to bugs.
+ *
+ */
+
+#include "Core/SamplingProfiler.hpp"
+#include "Core/Runner.hpp"
+#include <QFile>
+#include <QFileInfo>
+#include <QSet>
+#include <algorithm>
+#include <cstring>
+
+#if defined(Q_OS_LINUX)
+#include <cerrno>
+#include <linux/perf_event.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace Core
+{
+
+const int SamplingProfiler::SAMPLE_FREQUENCY;
+const int SamplingProfiler::DRAIN_INTERVAL;
+
+namespace
+{
+// 2^n pages of samples after the metadata page, 256KB holds more than the samples of a drain interval
+const int BUFFER_PAGES = 64;
+// the symbolized addresses are capped, the rarest stacks are dropped first
+const int MAX_ADDRESSES = 20000;
+} // namespace
+
+SamplingProfiler::SamplingProfiler(QObject *parent) : QObject(parent)
+{
+    drainTimer = new QTimer(this);
+    drainTimer->setInterval(DRAIN_INTERVAL);
+    connect(drainTimer, SIGNAL(timeout()), this, SLOT(drain()));
+    killTimer = new QTimer(this);
+    killTimer->setSingleShot(true);
+    connect(killTimer, SIGNAL(timeout()), this, SLOT(onTimeout()));
+}
+
+SamplingProfiler::~SamplingProfiler()
+{
+    stop();
+}
+
+void SamplingProfiler::start(const QString &binaryPath, const QString &sourcePath, const QString &input,
+                             int timeLimit)
+{
+    stop();
+    this->binaryPath = QFileInfo(binaryPath).canonicalFilePath();
+    this->sourcePath = QFileInfo(sourcePath).canonicalFilePath();
+    this->input = input.toUtf8();
+    this->timeLimit = timeLimit;
+    stacks.clear();
+    mappings.clear();
+    result = Profile();
+
+    if (!isSupported())
+    {
+        emit errorOccured("Profiling is only supported on Linux");
+        return;
+    }
+    if (this->binaryPath.isEmpty())
+    {
+        emit errorOccured("The executable " + binaryPath + " doesn't exist, please compile first");
+        return;
+    }
+
+    running = true;
+    process = new QProcess(this);
+    connect(process, SIGNAL(started()), this, SLOT(onStarted()));
+    connect(process, SIGNAL(finished(int, QProcess::ExitStatus)), this, SLOT(onFinished(int, QProcess::ExitStatus)));
+    connect(process, SIGNAL(errorOccurred(QProcess::ProcessError)), this,
+            SLOT(onErrorOccurred(QProcess::ProcessError)));
+    if (!inputFileName.isEmpty() || !outputFileName.isEmpty())
+    {
+        scratchDir = Runner::createScratchDirectory(inputFileName, input);
+        if (scratchDir == nullptr)
+        {
+            fail("Failed to prepare the working directory for the file I/O");
+            return;
+        }
+        process->setWorkingDirectory(scratchDir->path());
+        if (!inputFileName.isEmpty())
+            this->input.clear();
+    }
+
+    // the ticket is a child of the process, so it's released when the process is deleted
+    auto scheduler = Scheduler::current();
+    if (scheduler != nullptr)
+    {
+        auto ticket = scheduler->request(nullptr, Scheduler::Interactive, Scheduler::DEFAULT_RUN_MEMORY, process);
+        if (!ticket->isGranted())
+        {
+            connect(ticket, SIGNAL(granted()), this, SLOT(onTicketGranted()));
+            emit statusChanged("Waiting for the other jobs...");
+            return;
+        }
+    }
+    emit statusChanged("Running...");
+    process->start(this->binaryPath, QStringList());
+}
+
+void SamplingProfiler::onTicketGranted()
+{
+    if (!running || process == nullptr || sender()->parent() != process)
+        return;
+    emit statusChanged("Running...");
+    process->start(binaryPath, QStringList());
+}
+
+void SamplingProfiler::setFileIO(const QString &inputFileName, const QString &outputFileName)
+{
+    this->inputFileName = inputFileName;
+    this->outputFileName = outputFileName;
+}
+
+void SamplingProfiler::stop()
+{
+    running = false;
+    drainTimer->stop();
+    killTimer->stop();
+    detach();
+    // stop() may be called from the signals of the processes
+    if (process != nullptr)
+    {
+        process->disconnect(this);
+        process->kill();
+        process->deleteLater();
+        process = nullptr;
+    }
+    if (symbolizer != nullptr)
+    {
+        symbolizer->disconnect(this);
+        symbolizer->deleteLater();
+        symbolizer = nullptr;
+    }
+    delete scratchDir;
+    scratchDir = nullptr;
+}
+
+bool SamplingProfiler::isRunning() const
+{
+    return running;
+}
+
+SamplingProfiler::Profile SamplingProfiler::profile() const
+{
+    return result;
+}
+
+bool SamplingProfiler::isSupported()
+{
+#if defined(Q_OS_LINUX)
+    return true;
+#else
+    return false;
+#endif
+}
+
+void SamplingProfiler::onStarted()
+{
+    // the program waits for its input, so the samples are taken from the start of the actual work
+    if (!attach(process->processId()))
+        return;
+    runTimer.start();
+    drainTimer->start();
+    killTimer->start(timeLimit);
+    process->write(input);
+    process->closeWriteChannel();
+}
+
+void SamplingProfiler::onFinished(int exitCode, QProcess::ExitStatus exitStatus)
+{
+    if (!running)
+        return;
+    result.timeUsed = static_cast<int>(runTimer.elapsed());
+    drain();
+    detach();
+    drainTimer->stop();
+    killTimer->stop();
+    process->deleteLater();
+    process = nullptr;
+    delete scratchDir;
+    scratchDir = nullptr;
+
+    if (!result.timedOut && (exitStatus != QProcess::NormalExit || exitCode != 0))
+        emit statusChanged("The program exited with code " + QString::number(exitCode) + ", the profile is partial");
+    if (result.samples == 0)
+    {
+        fail("No samples were taken, the run is too short to be profiled");
+        return;
+    }
+    symbolize();
+}
+
+void SamplingProfiler::onErrorOccurred(QProcess::ProcessError error)
+{
+    if (error == QProcess::FailedToStart)
+        fail("Failed to start " + binaryPath);
+}
+
+void SamplingProfiler::onTimeout()
+{
+    if (process == nullptr)
+        return;
+    result.timedOut = true;
+    process->kill();
+}
+
+#if defined(Q_OS_LINUX)
+
+bool SamplingProfiler::attach(qint64 pid)
+{
+    readMappings(pid);
+    if (mappings.isEmpty())
+    {
+        fail("The program finished before it could be profiled");
+        return false;
+    }
+
+    perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_SOFTWARE;
+    attr.config = PERF_COUNT_SW_TASK_CLOCK;
+    attr.freq = 1;
+    attr.sample_freq = SAMPLE_FREQUENCY;
+    attr.sample_type = PERF_SAMPLE_IP | PERF_SAMPLE_CALLCHAIN;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.exclude_callchain_kernel = 1;
+    // the kernel doesn't map the buffer of an inherited per-task event, so only the main thread is sampled
+    attr.inherit = 0;
+    perfFd = static_cast<int>(
+        syscall(__NR_perf_event_open, &attr, static_cast<pid_t>(pid), -1, -1, PERF_FLAG_FD_CLOEXEC));
+    if (perfFd < 0)
+    {
+        int savedErrno = errno;
+        process->kill();
+        if (savedErrno == EACCES || savedErrno == EPERM)
+            fail("Profiling is not permitted, lower /proc/sys/kernel/perf_event_paranoid to 2 or less");
+        else
+            fail(QString("Failed to start the sampler: ") + strerror(savedErrno));
+        return false;
+    }
+
+    size_t size = static_cast<size_t>(1 + BUFFER_PAGES) * sysconf(_SC_PAGESIZE);
+    buffer = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, perfFd, 0);
+    if (buffer == MAP_FAILED)
+    {
+        buffer = nullptr;
+        int savedErrno = errno;
+        process->kill();
+        fail(QString("Failed to map the sample buffer: ") + strerror(savedErrno));
+        return false;
+    }
+    return true;
+}
+
+void SamplingProfiler::detach()
+{
+    if (buffer != nullptr)
+    {
+        munmap(buffer, static_cast<size_t>(1 + BUFFER_PAGES) * sysconf(_SC_PAGESIZE));
+        buffer = nullptr;
+    }
+    if (perfFd >= 0)
+    {
+        ::close(perfFd);
+        perfFd = -1;
+    }
+}
+
+void SamplingProfiler::readMappings(qint64 pid)
+{
+    QFile maps("/proc/" + QString::number(pid) + "/maps");
+    if (!maps.open(QIODevice::ReadOnly))
+        return;
+
+    // the position independent executables are loaded at a random address, the other ones at their link address
+    bool positionIndependent = false;
+    QFile binary(binaryPath);
+    if (binary.open(QIODevice::ReadOnly))
+    {
+        auto header = binary.read(18);
+        positionIndependent = header.size() == 18 && header.mid(1, 3) == "ELF" && header[16] == 3; // ET_DYN
+    }
+
+    loadBias = 0;
+    bool first = true;
+    for (auto const &line : maps.readAll().split('\n'))
+    {
+        // start-end permissions offset device inode path
+        auto fields = line.simplified().split(' ');
+        if (fields.size() < 6 || QString::fromUtf8(fields.mid(5).join(' ')) != binaryPath)
+            continue;
+        auto range = fields[0].split('-');
+        Mapping mapping;
+        mapping.start = range[0].toULongLong(nullptr, 16);
+        mapping.end = range.value(1).toULongLong(nullptr, 16);
+        if (positionIndependent && (first || mapping.start < loadBias))
+            loadBias = mapping.start;
+        first = false;
+        if (fields[1].contains('x'))
+            mappings.push_back(mapping);
+    }
+}
+
+void SamplingProfiler::drain()
+{
+    if (buffer == nullptr)
+        return;
+    auto metadata = static_cast<perf_event_mmap_page *>(buffer);
+    auto data = static_cast<const char *>(buffer) + metadata->data_offset;
+    quint64 dataSize = metadata->data_size;
+    quint64 head = metadata->data_head;
+    __sync_synchronize();
+    quint64 tail = metadata->data_tail;
+
+    QByteArray record;
+    while (tail < head)
+    {
+        // a record may wrap around the end of the buffer
+        perf_event_header header;
+        for (size_t i = 0; i < sizeof(header); ++i)
+            reinterpret_cast<char *>(&header)[i] = data[(tail + i) % dataSize];
+        if (header.size < sizeof(header))
+            break;
+        record.resize(header.size);
+        for (int i = 0; i < header.size; ++i)
+            record[i] = data[(tail + i) % dataSize];
+        tail += header.size;
+
+        auto body = reinterpret_cast<const quint64 *>(record.constData() + sizeof(header));
+        quint64 words = (header.size - sizeof(header)) / sizeof(quint64);
+        if (header.type == PERF_RECORD_SAMPLE && words >= 2)
+        {
+            // the instruction pointer, the number of the callers and the callers, which start with the pointer
+            quint64 count = qMin(body[1], words - 2);
+            addSample(body + 2, count);
+        }
+        else if (header.type == PERF_RECORD_LOST && words >= 2)
+        {
+            result.lost += static_cast<int>(body[1]);
+        }
+    }
+
+    __sync_synchronize();
+    metadata->data_tail = tail;
+}
+
+#else
+
+bool SamplingProfiler::attach(qint64 pid)
+{
+    Q_UNUSED(pid);
+    return false;
+}
+
+void SamplingProfiler::detach()
+{
+}
+
+void SamplingProfiler::readMappings(qint64 pid)
+{
+    Q_UNUSED(pid);
+}
+
+void SamplingProfiler::drain()
+{
+}
+
+#endif
+
+void SamplingProfiler::addSample(const quint64 *ips, quint64 count)
+{
+    QVector<quint64> stack;
+    bool leaf = true;
+    for (quint64 i = 0; i < count; ++i)
+    {
+        // the context markers of the call chains are the largest 4095 values
+        if (ips[i] >= static_cast<quint64>(-4095))
+            continue;
+        for (auto const &mapping : mappings)
+        {
+            if (ips[i] >= mapping.start && ips[i] < mapping.end)
+            {
+                // the callers are return addresses, which may belong to the line after the call
+                quint64 address = ips[i] - loadBias - (leaf ? 0 : 1);
+                if (stack.isEmpty() || stack.back() != address)
+                    stack.push_back(address);
+                break;
+            }
+        }
+        leaf = false;
+    }
+    ++result.samples;
+    if (!stack.isEmpty())
+        ++stacks[stack];
+}
+
+void SamplingProfiler::symbolize()
+{
+    // the addresses of the most frequent stacks first, so that the cap drops the rare ones
+    QVector<QPair<int, QVector<quint64>>> sorted;
+    for (auto it = stacks.constBegin(); it != stacks.constEnd(); ++it)
+        sorted.push_back(qMakePair(it.value(), it.key()));
+    std::sort(sorted.begin(), sorted.end(),
+              [](const QPair<int, QVector<quint64>> &a, const QPair<int, QVector<quint64>> &b) {
+                  return a.first > b.first;
+              });
+    QSet<quint64> addresses;
+    for (auto const &stack : sorted)
+    {
+        for (auto address : stack.second)
+        {
+            if (addresses.size() < MAX_ADDRESSES)
+                addresses.insert(address);
+        }
+    }
+
+    emit statusChanged("Symbolizing " + QString::number(result.samples) + " samples...");
+    symbolizer = new Symbolizer(this);
+    connect(symbolizer, SIGNAL(finished()), this, SLOT(onSymbolized()));
+    connect(symbolizer, SIGNAL(errorOccured(const QString &)), this, SLOT(onSymbolizerErrorOccured(const QString &)));
+    symbolizer->start(binaryPath, addresses.toList());
+}
+
+void SamplingProfiler::onSymbolized()
+{
+    if (!running || symbolizer == nullptr)
+        return;
+    aggregate();
+    symbolizer->deleteLater();
+    symbolizer = nullptr;
+    running = false;
+    emit profilingFinished();
+}
+
+void SamplingProfiler::onSymbolizerErrorOccured(const QString &error)
+{
+    fail(error);
+}
+
+void SamplingProfiler::aggregate()
+{
+    QMap<QString, Function> functions;
+    QMap<QString, QMap<int, int>> functionLines;
+
+    for (auto it = stacks.constBegin(); it != stacks.constEnd(); ++it)
+    {
+        int count = it.value();
+        QVector<Symbolizer::Frame> frames;
+        for (auto address : it.key())
+        {
+            auto symbol = symbolizer->frames(address);
+            if (symbol.isEmpty())
+            {
+                Symbolizer::Frame unknown;
+                unknown.function = "0x" + QString::number(address, 16);
+                symbol.push_back(unknown);
+            }
+            frames += symbol;
+        }
+
+        bool lineCounted = false;
+        QSet<QString> seen;
+        for (int i = 0; i < frames.size(); ++i)
+        {
+            auto const &frame = frames[i];
+            bool inSource = isSourceFile(frame.file) && frame.line > 0;
+            // the time in the library code inlined into the source is attributed to the calling line
+            if (inSource && !lineCounted)
+            {
+                result.lines[frame.line - 1] += count;
+                lineCounted = true;
+            }
+
+            auto &function = functions[frame.function];
+            function.name = frame.function;
+            if (i == 0)
+                function.self += count;
+            if (!seen.contains(frame.function))
+            {
+                seen.insert(frame.function);
+                function.total += count;
+                if (inSource)
+                    functionLines[frame.function][frame.line - 1] += count;
+                else if (function.location.isEmpty() && !frame.file.isEmpty() && frame.file != "??")
+                    function.location = QFileInfo(frame.file).fileName() + ":" + QString::number(frame.line);
+            }
+        }
+    }
+
+    for (auto function : functions)
+    {
+        auto lines = functionLines.value(function.name);
+        int best = 0;
+        for (auto it = lines.constBegin(); it != lines.constEnd(); ++it)
+        {
+            if (it.value() > best)
+            {
+                best = it.value();
+                function.line = it.key();
+            }
+        }
+        if (function.line >= 0)
+            function.location = QFileInfo(sourcePath).fileName() + ":" + QString::number(function.line + 1);
+        result.functions.push_back(function);
+    }
+    std::sort(result.functions.begin(), result.functions.end(), [](const Function &a, const Function &b) {
+        return a.self != b.self ? a.self > b.self : a.total > b.total;
+    });
+}
+
+void SamplingProfiler::fail(const QString &error)
+{
+    stop();
+    emit errorOccured(error);
+}
+
+bool SamplingProfiler::isSourceFile(const QString &file) const
+{
+    if (file.isEmpty() || file == "??")
+        return false;
+    if (file == sourcePath)
+        return true;
+    auto canonical = QFileInfo(file).canonicalFilePath();
+    return !canonical.isEmpty() && canonical == sourcePath;
+}
+
+} // namespace Core
@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2019-2020 Ashar Khan <ashar786khan@gmail.com>
+ *
+ * This file is part of CPEditor.
+ *
+ * CPEditor is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * I will not be responsible if CPEditor behaves in unexpected way and
+ * causes your ratings to go down and or loose any important contest.
+ *
+ * Believe Software is "Software" and it isn't immune to bugs.
+ *
+ */
+
+#include "Core/SanitizerReport.hpp"
+#include <QRegularExpression>
+#include <QStringList>
+
+namespace Core
+{
+
+const int SanitizerReport::MAX_DETAILS;
+
+bool SanitizerReport::isEmpty() const
+{
+    return errors == 0;
+}
+
+SanitizerReport SanitizerReport::parse(const QString &err)
+{
+    // "==123==ERROR: AddressSanitizer: ..." starts a report, and "SUMMARY: AddressSanitizer: ..." ends it, while
+    // UndefinedBehaviorSanitizer prints a single line "sol.cpp:12:5: runtime error: ..." for each error
+    static const QRegularExpression summaryPattern("^SUMMARY: (\\w+Sanitizer: .*)$");
+    static const QRegularExpression startPattern("^==\\d+==(ERROR|WARNING): \\w+Sanitizer");
+    static const QRegularExpression runtimeErrorPattern("^(.*):(\\d+):\\d+: runtime error: (.*)$");
+
+    SanitizerReport report;
+    QString firstRuntimeError;
+    bool inReport = false;
+    for (auto const &line : err.split('\n'))
+    {
+        auto summary = summaryPattern.match(line);
+        auto runtimeError = runtimeErrorPattern.match(line);
+        if (startPattern.match(line).hasMatch())
+        {
+            inReport = true;
+            ++report.errors;
+        }
+        else if (runtimeError.hasMatch())
+        {
+            ++report.errors;
+            if (firstRuntimeError.isEmpty())
+            {
+                firstRuntimeError = "runtime error on line " + runtimeError.captured(2) + ": " +
+                                    runtimeError.captured(3);
+            }
+        }
+
+        if (inReport || runtimeError.hasMatch())
+            report.details += line + "\n";
+        if (summary.hasMatch())
+        {
+            // the summary of UndefinedBehaviorSanitizer repeats the first runtime error, which is more readable
+            if (report.summary.isEmpty() && !summary.captured(1).startsWith("UndefinedBehaviorSanitizer"))
+                report.summary = summary.captured(1);
+            inReport = false;
+        }
+    }
+
+    if (report.summary.isEmpty())
+        report.summary = firstRuntimeError;
+    if (report.details.size() > MAX_DETAILS)
+        report.details = report.details.left(MAX_DETAILS) + "\n...";
+    return report;
+}
+
+} // namespace Core
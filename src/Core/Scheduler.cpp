@@ -0,0 +1,187 @@
+/*
+ * Copyright (C) 2019-2020 Ashar Khan <ashar786khan@gmail.com>
+ *
+ * This file is part of CPEditor.
+ *
+ * CPEditor is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * I will not be responsible if CPEditor behaves in unexpected way and
+ * causes your ratings to go down and or loose any important contest.
+ *
+ * Believe Software is "Software" and it isn't immune to bugs.
+ *
+ */
+
+#include "Core/Scheduler.hpp"
+#include <QThread>
+#include <algorithm>
+
+#if defined(Q_OS_UNIX)
+#include <unistd.h>
+#elif defined(Q_OS_WIN)
+#include <windows.h>
+#endif
+
+namespace Core
+{
+
+const qint64 Scheduler::DEFAULT_RUN_MEMORY;
+const qint64 Scheduler::DEFAULT_COMPILE_MEMORY;
+
+Scheduler *Scheduler::instance = nullptr;
+
+SchedulerTicket::SchedulerTicket(Scheduler *scheduler, QObject *owner, int priority, qint64 memory, int processes,
+                                 quint64 sequence, QObject *parent)
+    : QObject(parent), scheduler(scheduler), owner(owner), priority(priority), memory(memory), processes(processes),
+      sequence(sequence)
+{
+}
+
+SchedulerTicket::~SchedulerTicket()
+{
+    if (scheduler != nullptr)
+        scheduler->release(this);
+}
+
+bool SchedulerTicket::isGranted() const
+{
+    return isStarted;
+}
+
+Scheduler::Scheduler(QObject *parent) : QObject(parent)
+{
+    instance = this;
+    setBudget(0, 0);
+}
+
+Scheduler::~Scheduler()
+{
+    if (instance == this)
+        instance = nullptr;
+}
+
+Scheduler *Scheduler::current()
+{
+    return instance;
+}
+
+void Scheduler::setBudget(int cpuSlots, qint64 memoryBytes)
+{
+    this->cpuSlots = cpuSlots > 0 ? cpuSlots : qMax(1, QThread::idealThreadCount() - 1);
+    this->memoryBytes = memoryBytes > 0 ? memoryBytes : physicalMemory() / 4 * 3;
+    dispatch();
+    emit statusChanged();
+}
+
+int Scheduler::cpuBudget() const
+{
+    return cpuSlots;
+}
+
+qint64 Scheduler::memoryBudget() const
+{
+    return memoryBytes;
+}
+
+void Scheduler::setFocusedOwner(QObject *owner)
+{
+    focusedOwner = owner;
+}
+
+SchedulerTicket *Scheduler::request(QObject *owner, Priority priority, qint64 memory, QObject *parent, int processes)
+{
+    auto ticket = new SchedulerTicket(this, owner, priority, qMax<qint64>(0, memory), qMax(1, processes),
+                                      ++lastSequence, parent);
+    queue.push_back(ticket);
+    dispatch();
+    emit statusChanged();
+    return ticket;
+}
+
+int Scheduler::runningJobs() const
+{
+    return usedSlots;
+}
+
+int Scheduler::queuedJobs() const
+{
+    return queue.size();
+}
+
+qint64 Scheduler::memoryInUse() const
+{
+    return memoryUsed;
+}
+
+void Scheduler::release(SchedulerTicket *ticket)
+{
+    if (running.removeOne(ticket))
+    {
+        memoryUsed -= ticket->memory;
+        usedSlots -= ticket->processes;
+    }
+    else
+        queue.removeOne(ticket);
+    dispatch();
+    emit statusChanged();
+}
+
+void Scheduler::dispatch()
+{
+    // the focus may have changed since the jobs were queued, so the order is computed here
+    std::stable_sort(queue.begin(), queue.end(), [this](SchedulerTicket *a, SchedulerTicket *b) {
+        int rankA = rank(a), rankB = rank(b);
+        return rankA != rankB ? rankA < rankB : a->sequence < b->sequence;
+    });
+
+    // the jobs start in order, so a large job is not overtaken by the small ones forever, and a job larger than the
+    // CPU or the memory budget still starts when nothing else is running
+    QList<QPointer<SchedulerTicket>> granted;
+    while (!queue.isEmpty() && usedSlots < cpuSlots)
+    {
+        auto ticket = queue.front();
+        if (!running.isEmpty() && usedSlots + ticket->processes > cpuSlots)
+            break;
+        if (!running.isEmpty() && memoryBytes > 0 && memoryUsed + ticket->memory > memoryBytes)
+            break;
+        queue.pop_front();
+        running.push_back(ticket);
+        memoryUsed += ticket->memory;
+        usedSlots += ticket->processes;
+        ticket->isStarted = true;
+        granted.push_back(ticket);
+    }
+
+    // a slot of granted() may release or request tickets
+    for (auto const &ticket : granted)
+    {
+        if (ticket != nullptr)
+            emit ticket->granted();
+    }
+}
+
+int Scheduler::rank(const SchedulerTicket *ticket) const
+{
+    bool focused = ticket->owner != nullptr && ticket->owner == focusedOwner;
+    return (ticket->priority == Interactive ? 0 : 2) + (focused ? 0 : 1);
+}
+
+qint64 Scheduler::physicalMemory()
+{
+#if defined(Q_OS_UNIX) && defined(_SC_PHYS_PAGES)
+    long pages = sysconf(_SC_PHYS_PAGES), pageSize = sysconf(_SC_PAGESIZE);
+    if (pages > 0 && pageSize > 0)
+        return static_cast<qint64>(pages) * pageSize;
+#elif defined(Q_OS_WIN)
+    MEMORYSTATUSEX status;
+    status.dwLength = sizeof(status);
+    if (GlobalMemoryStatusEx(&status))
+        return static_cast<qint64>(status.ullTotalPhys);
+#endif
+    return 0;
+}
+
+} // namespace Core
@@ -19,9 +19,36 @@
 #include "Core/MessageLogger.hpp"
 #include <QApplication>
 #include <QStandardPaths>
+#include <QUuid>
 
 namespace Settings
 {
+
+QStringList buildProfiles()
+{
+    return {"Fast", "Debug", "Sanitize"};
+}
+
+QString compileCommandCpp(const SettingsData &data, const QString &profile)
+{
+    QString flags = data.buildFlags.value(profile.isEmpty() ? data.buildProfile : profile);
+    return flags.trimmed().isEmpty() ? data.compileCommandCpp : data.compileCommandCpp + " " + flags.trimmed();
+}
+
+int localTimeLimit(const SettingsData &data, int judgeTimeLimit)
+{
+    if (data.judgeSpeedFactor <= 0)
+        return judgeTimeLimit;
+    return qMax(1, qRound(judgeTimeLimit / data.judgeSpeedFactor));
+}
+
+int judgeTime(const SettingsData &data, int localTime)
+{
+    if (data.judgeSpeedFactor <= 0)
+        return localTime;
+    return qRound(localTime * data.judgeSpeedFactor);
+}
+
 SettingManager::SettingManager()
 {
     mSettingsFile = QStandardPaths::writableLocation(QStandardPaths::HomeLocation) + "/" + SETTINGS_FILE;
@@ -105,6 +132,21 @@ bool SettingManager::isFormatOnSave()
     return mSettings->value("format_on_save", "false").toBool();
 }
 
+bool SettingManager::isStopAtFirstWrongAnswer()
+{
+    return mSettings->value("stop_at_first_wa", "false").toBool();
+}
+
+bool SettingManager::isUseExecutor()
+{
+    return mSettings->value("use_executor", "false").toBool();
+}
+
+bool SettingManager::isHardwareCounters()
+{
+    return mSettings->value("hardware_counters", "false").toBool();
+}
+
 QString SettingManager::getRunCommandJava()
 {
     return mSettings->value("run_java", "java").toString();
@@ -121,6 +163,21 @@ QString SettingManager::getCompileCommandJava()
 {
     return mSettings->value("compile_java", "javac").toString();
 }
+QString SettingManager::getBuildProfile()
+{
+    QString profile = mSettings->value("build_profile", "Fast").toString();
+    return buildProfiles().contains(profile) ? profile : "Fast";
+}
+QString SettingManager::getBuildFlags(const QString &profile)
+{
+    // the Fast profile adds nothing by default, so the compile command of an existing setup is kept as it is
+    QString defaultFlags;
+    if (profile == "Debug")
+        defaultFlags = "-O0 -g";
+    else if (profile == "Sanitize")
+        defaultFlags = "-O1 -g -fsanitize=address,undefined -fno-omit-frame-pointer";
+    return mSettings->value("build_flags/" + profile, defaultFlags).toString();
+}
 QString SettingManager::getClangFormatBinary()
 {
     return mSettings->value("clang_format_binary", "clang-format").toString();
@@ -289,6 +346,30 @@ void SettingManager::formatOnSave(bool value)
         mSettings->setValue("format_on_save", QString::fromStdString("false"));
 }
 
+void SettingManager::setStopAtFirstWrongAnswer(bool value)
+{
+    if (value)
+        mSettings->setValue("stop_at_first_wa", QString::fromStdString("true"));
+    else
+        mSettings->setValue("stop_at_first_wa", QString::fromStdString("false"));
+}
+
+void SettingManager::setUseExecutor(bool value)
+{
+    if (value)
+        mSettings->setValue("use_executor", QString::fromStdString("true"));
+    else
+        mSettings->setValue("use_executor", QString::fromStdString("false"));
+}
+
+void SettingManager::setHardwareCounters(bool value)
+{
+    if (value)
+        mSettings->setValue("hardware_counters", QString::fromStdString("true"));
+    else
+        mSettings->setValue("hardware_counters", QString::fromStdString("false"));
+}
+
 void SettingManager::setTabStop(int num)
 {
     mSettings->setValue("tab_stop", num);
@@ -304,6 +385,57 @@ void SettingManager::setTimeLimit(int val)
     mSettings->setValue("time_limit", val);
 }
 
+int SettingManager::getParallelJobs()
+{
+    return mSettings->value("parallel_jobs", 0).toInt();
+}
+
+void SettingManager::setParallelJobs(int jobs)
+{
+    mSettings->setValue("parallel_jobs", jobs);
+}
+
+int SettingManager::getMemoryBudget()
+{
+    return mSettings->value("memory_budget", 0).toInt();
+}
+
+void SettingManager::setMemoryBudget(int megabytes)
+{
+    mSettings->setValue("memory_budget", megabytes);
+}
+
+int SettingManager::getRegressionThreshold()
+{
+    return mSettings->value("regression_threshold", 20).toInt();
+}
+
+void SettingManager::setRegressionThreshold(int percent)
+{
+    mSettings->setValue("regression_threshold", percent);
+}
+
+double SettingManager::getJudgeSpeedFactor()
+{
+    double factor = mSettings->value("judge_speed_factor", 1.0).toDouble();
+    return factor > 0 ? factor : 1.0;
+}
+
+void SettingManager::setJudgeSpeedFactor(double factor)
+{
+    mSettings->setValue("judge_speed_factor", factor);
+}
+
+double SettingManager::getCalibrationTime(const QString &machine, const QString &program)
+{
+    return mSettings->value("calibration/" + machine + "/" + program, 0.0).toDouble();
+}
+
+void SettingManager::setCalibrationTime(const QString &machine, const QString &program, double time)
+{
+    mSettings->setValue("calibration/" + machine + "/" + program, time);
+}
+
 void SettingManager::setRunCommandJava(const QString &command)
 {
     mSettings->setValue("run_java", command);
@@ -316,6 +448,14 @@ void SettingManager::setCompileCommandsCpp(const QString &command)
 {
     mSettings->setValue("compile_cpp", command);
 }
+void SettingManager::setBuildProfile(const QString &profile)
+{
+    mSettings->setValue("build_profile", profile);
+}
+void SettingManager::setBuildFlags(const QString &profile, const QString &flags)
+{
+    mSettings->setValue("build_flags/" + profile, flags);
+}
 void SettingManager::setEditorTheme(const QString &themeName)
 {
     mSettings->setValue("editor_theme", themeName);
@@ -476,6 +616,18 @@ void SettingManager::setCFPath(const QString &path)
     mSettings->setValue("cf_path", path);
 }
 
+QString SettingManager::getExecutorSession()
+{
+    // the session is created once, so the executor daemon knows the editor after a restart
+    auto session = mSettings->value("executor_session").toString();
+    if (session.isEmpty())
+    {
+        session = QUuid::createUuid().toString();
+        mSettings->setValue("executor_session", session);
+    }
+    return session;
+}
+
 void SettingManager::setHotkeyViewModeToggler(const QKeySequence &sequence)
 {
     mSettings->setValue("hotkey_mode_toggle", sequence.toString());
@@ -560,6 +712,8 @@ SettingsData SettingManager::toData()
     data.companionPort = getConnectionPort();
     data.tabStop = getTabStop();
     data.timeLimit = getTimeLimit();
+    data.regressionThreshold = getRegressionThreshold();
+    data.judgeSpeedFactor = getJudgeSpeedFactor();
     data.geometry = getGeometry();
     data.font = getFont();
     data.defaultLanguage = getDefaultLang();
@@ -573,6 +727,9 @@ SettingsData SettingManager::toData()
     data.clangFormatStyle = getClangFormatStyle();
     data.compileCommandCpp = getCompileCommandCpp();
     data.compileCommandJava = getCompileCommandJava();
+    data.buildProfile = getBuildProfile();
+    for (auto const &profile : buildProfiles())
+        data.buildFlags[profile] = getBuildFlags(profile);
     data.runCommandJava = getRunCommandJava();
     data.runCommandPython = getRunCommandPython();
     data.editorTheme = getEditorTheme();
@@ -588,6 +745,9 @@ SettingsData SettingManager::toData()
     data.isWindowMaximized = isMaximizedWindow();
     data.isCheckUpdateOnStartup = isCheckUpdateOnStartup();
     data.isFormatOnSave = isFormatOnSave();
+    data.isStopAtFirstWrongAnswer = isStopAtFirstWrongAnswer();
+    data.isUseExecutor = isUseExecutor();
+    data.isHardwareCounters = isHardwareCounters();
     data.hotkeyCompile = getHotkeyCompile();
     data.hotkeyRun = getHotkeyRun();
     data.hotkeyCompileRun = getHotkeyCompileRun();
@@ -598,6 +758,7 @@ SettingsData SettingManager::toData()
     data.viewMode = getViewMode();
     data.splitterSizes = getSplitterSizes();
     data.cfPath = getCFPath();
+    data.executorSession = getExecutorSession();
 
     return data;
 }
@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2019-2020 Ashar Khan <ashar786khan@gmail.com>
+ *
+ * This file is part of CPEditor.
+ *
+ * CPEditor is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * I will not be responsible if CPEditor behaves in unexpected way and
+ * causes your ratings to go down and or loose any important contest.
+ *
+ * Believe Software is "Software" and it isn't immune to bugs.
+ *
+ */
+
+#include "Core/StreamingComparator.hpp"
+
+namespace Core
+{
+
+static QString quoted(const QByteArray &token)
+{
+    const int maxLength = 40;
+    if (token.size() > maxLength)
+        return "\"" + QString::fromUtf8(token.left(maxLength)) + "...\"";
+    return "\"" + QString::fromUtf8(token) + "\"";
+}
+
+StreamingComparator::StreamingComparator(const QString &expected) : expected(expected.toUtf8())
+{
+}
+
+bool StreamingComparator::feed(const QByteArray &chunk)
+{
+    for (char c : chunk)
+    {
+        if (mismatch)
+            return false;
+
+        if (isSpace(c))
+        {
+            if (!current.isEmpty())
+            {
+                compareToken(true);
+                current.clear();
+            }
+        }
+        else
+        {
+            if (current.isEmpty())
+            {
+                tokenLine = line;
+                tokenColumn = column;
+            }
+            current += c;
+        }
+
+        if (c == '\n')
+        {
+            ++line;
+            column = 1;
+        }
+        else
+        {
+            ++column;
+        }
+    }
+
+    // the incomplete token can already be wrong, e.g. when a number is longer than expected
+    if (!mismatch && !current.isEmpty())
+        compareToken(false);
+    return !mismatch;
+}
+
+bool StreamingComparator::finish()
+{
+    if (mismatch)
+        return false;
+    if (!current.isEmpty())
+    {
+        compareToken(true);
+        current.clear();
+    }
+    int begin, end;
+    if (!mismatch && nextExpectedToken(begin, end))
+    {
+        tokenLine = line;
+        tokenColumn = column;
+        setMismatch("the output ended, expected " + quoted(expected.mid(begin, end - begin)));
+    }
+    return !mismatch;
+}
+
+bool StreamingComparator::hasMismatch() const
+{
+    return mismatch;
+}
+
+QString StreamingComparator::mismatchMessage() const
+{
+    return message;
+}
+
+bool StreamingComparator::nextExpectedToken(int &begin, int &end) const
+{
+    begin = expectedPosition;
+    while (begin < expected.size() && isSpace(expected[begin]))
+        ++begin;
+    end = begin;
+    while (end < expected.size() && !isSpace(expected[end]))
+        ++end;
+    return begin < end;
+}
+
+void StreamingComparator::compareToken(bool complete)
+{
+    int begin, end;
+    if (!nextExpectedToken(begin, end))
+    {
+        setMismatch("found " + quoted(current) + " after the end of the expected output");
+        return;
+    }
+
+    int length = end - begin;
+    bool matching = complete ? length == current.size() && expected.mid(begin, length) == current
+                             : length >= current.size() && expected.mid(begin, current.size()) == current;
+    if (!matching)
+    {
+        setMismatch("expected " + quoted(expected.mid(begin, length)) + ", found " + quoted(current));
+        return;
+    }
+
+    if (complete)
+    {
+        expectedPosition = end;
+        ++tokenIndex;
+    }
+}
+
+void StreamingComparator::setMismatch(const QString &reason)
+{
+    mismatch = true;
+    message = "Wrong answer at line " + QString::number(tokenLine) + ", column " + QString::number(tokenColumn) +
+              " (token " + QString::number(tokenIndex + 1) + "): " + reason;
+}
+
+bool StreamingComparator::isSpace(char c)
+{
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t' || c == '\v' || c == '\f';
+}
+
+} // namespace Core
@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2019-2020 Ashar Khan <ashar786khan@gmail.com>
+ *
+ * This file is part of CPEditor.
+ *
+ * CPEditor is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * I will not be responsible if CPEditor behaves in unexpected way and
+ * causes your ratings to go down and or loose any important contest.
+ *
+ * Believe Software is "Software" and it isn't immune to bugs.
+ *
+ */
+
+#include "Core/Symbolizer.hpp"
+
+namespace Core
+{
+
+Symbolizer::Symbolizer(QObject *parent) : QObject(parent)
+{
+}
+
+Symbolizer::~Symbolizer()
+{
+    if (process != nullptr)
+    {
+        process->disconnect(this);
+        process->kill();
+        delete process;
+    }
+}
+
+void Symbolizer::start(const QString &binaryPath, const QList<quint64> &addresses)
+{
+    if (process != nullptr)
+    {
+        process->disconnect(this);
+        process->kill();
+        process->deleteLater();
+    }
+    symbols.clear();
+
+    QByteArray request;
+    for (auto address : addresses)
+        request += "0x" + QByteArray::number(address, 16) + "\n";
+
+    process = new QProcess(this);
+    connect(process, SIGNAL(finished(int, QProcess::ExitStatus)), this, SLOT(onFinished(int, QProcess::ExitStatus)));
+    connect(process, SIGNAL(errorOccurred(QProcess::ProcessError)), this,
+            SLOT(onErrorOccurred(QProcess::ProcessError)));
+    // -a prints each address before its frames, -i prints the inlined frames as well, the addresses are read from
+    // stdin so that there's no limit of the command line
+    process->start("addr2line", {"-a", "-i", "-f", "-C", "-e", binaryPath});
+    process->write(request);
+    process->closeWriteChannel();
+}
+
+QVector<Symbolizer::Frame> Symbolizer::frames(quint64 address) const
+{
+    return symbols.value(address);
+}
+
+void Symbolizer::onFinished(int exitCode, QProcess::ExitStatus exitStatus)
+{
+    auto lines = process->readAllStandardOutput().split('\n');
+    process->deleteLater();
+    process = nullptr;
+    if (exitStatus != QProcess::NormalExit || exitCode != 0)
+    {
+        emit errorOccured("addr2line failed to symbolize the addresses");
+        return;
+    }
+
+    quint64 address = 0;
+    bool hasAddress = false;
+    for (int i = 0; i < lines.size(); ++i)
+    {
+        if (lines[i].startsWith("0x"))
+        {
+            address = lines[i].mid(2).toULongLong(&hasAddress, 16);
+            continue;
+        }
+        if (!hasAddress || lines[i].isEmpty() || i + 1 >= lines.size())
+            continue;
+        // the function and then its file and line, e.g. "/path/sol.cpp:12 (discriminator 3)"
+        Frame frame;
+        frame.function = QString::fromUtf8(lines[i]);
+        auto location = QString::fromUtf8(lines[++i]).section(' ', 0, 0);
+        frame.file = location.section(':', 0, -2);
+        frame.line = location.section(':', -1).toInt();
+        symbols[address].push_back(frame);
+    }
+    emit finished();
+}
+
+void Symbolizer::onErrorOccurred(QProcess::ProcessError error)
+{
+    if (error != QProcess::FailedToStart)
+        return;
+    process->deleteLater();
+    process = nullptr;
+    emit errorOccured("Please install binutils, addr2line is needed to map the addresses to the source lines");
+}
+
+} // namespace Core
@@ -0,0 +1,301 @@
+/*
+ * Copyright (C) 2019-2020 Ashar Khan <ashar786khan@gmail.com>
+ *
+ * This file is part of CPEditor.
+ *
+ * CPEditor is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * I will not be responsible if CPEditor behaves in unexpected way and
+ * causes your ratings to go down and or loose any important contest.
+ *
+ * Believe Software is "Software" and it isn't immune to bugs.
+ *
+ */
+
+#include "Core/TLEHunter.hpp"
+#include <QRandomGenerator>
+#include <cmath>
+
+namespace Core
+{
+
+const int TLEHunter::NUMBER_OF_KEPT_RESULTS;
+
+static qint64 randomBetween(qint64 lowest, qint64 highest)
+{
+    if (highest <= lowest)
+        return lowest;
+    double value = lowest + QRandomGenerator::global()->generateDouble() * (static_cast<double>(highest - lowest) + 1);
+    return qBound(lowest, static_cast<qint64>(value), highest);
+}
+
+static qint64 logRandomBetween(qint64 lowest, qint64 highest)
+{
+    if (lowest < 1 || highest <= lowest)
+        return randomBetween(lowest, highest);
+    double value = std::exp(std::log(static_cast<double>(lowest)) +
+                            QRandomGenerator::global()->generateDouble() *
+                                (std::log(static_cast<double>(highest)) - std::log(static_cast<double>(lowest))));
+    return qBound(lowest, static_cast<qint64>(std::llround(value)), highest);
+}
+
+QMap<QString, QString> TLEHunter::Parameters::toMap() const
+{
+    QMap<QString, QString> map;
+    map["n"] = QString::number(n);
+    map["min"] = QString::number(minValue);
+    map["max"] = QString::number(maxValue);
+    map["seed"] = QString::number(seed);
+    return map;
+}
+
+QString TLEHunter::Parameters::toString() const
+{
+    return "n=" + QString::number(n) + ", values=[" + QString::number(minValue) + ", " + QString::number(maxValue) +
+           "], seed=" + QString::number(seed);
+}
+
+TLEHunter::TLEHunter(const QString &filePath, const QString &lang, const QString &runCommand, const QString &args,
+                     int timeLimit, QObject *parent)
+    : QObject(parent), filePath(filePath), lang(lang), runCommand(runCommand), args(args), timeLimit(timeLimit)
+{
+}
+
+TLEHunter::~TLEHunter()
+{
+    stop();
+}
+
+void TLEHunter::setFileIO(const QString &inputFileName, const QString &outputFileName)
+{
+    this->inputFileName = inputFileName;
+    this->outputFileName = outputFileName;
+}
+
+void TLEHunter::start(const QString &generatorCommand, const Parameters &lowerBound, const Parameters &upperBound,
+                      int iterations, int parallel)
+{
+    stop();
+    this->generatorCommand = generatorCommand;
+    this->lowerBound = lowerBound;
+    this->upperBound = upperBound;
+    this->iterations = qMax(1, iterations);
+    this->parallel = qMax(1, parallel);
+    launched = finished = 0;
+    results.clear();
+    running = true;
+    emit worstResultsChanged();
+    emit progress(0, this->iterations);
+    launchJobs();
+}
+
+void TLEHunter::stop()
+{
+    running = false;
+    // the jobs may be stopped from their own signals, so they can't be deleted immediately
+    for (auto &job : jobs)
+    {
+        if (job.generator != nullptr)
+            job.generator->deleteLater();
+        if (job.runner != nullptr)
+            job.runner->deleteLater();
+    }
+    jobs.clear();
+}
+
+bool TLEHunter::isRunning() const
+{
+    return running;
+}
+
+QVector<TLEHunter::Result> TLEHunter::worstResults() const
+{
+    return results;
+}
+
+void TLEHunter::onGenerated(int index, const QString &input)
+{
+    if (!jobs.contains(index))
+        return;
+    auto &job = jobs[index];
+    job.generator->deleteLater();
+    job.generator = nullptr;
+    job.input = input;
+    job.runner = new Runner(index);
+    job.runner->setFileIO(inputFileName, outputFileName);
+    connect(job.runner, SIGNAL(runFinished(int, const QByteArray &, const QByteArray &, int, int)), this,
+            SLOT(onRunFinished(int, const QByteArray &, const QByteArray &, int, int)));
+    connect(job.runner, SIGNAL(runErrorOccured(int, const QString &)), this,
+            SLOT(onRunErrorOccured(int, const QString &)));
+    connect(job.runner, SIGNAL(runTimeout(int)), this, SLOT(onRunTimeout(int)));
+    job.runner->run(filePath, lang, runCommand, args, input, runTimeLimit());
+}
+
+void TLEHunter::onGenerationFailed(int index, const QString &error)
+{
+    if (!jobs.contains(index))
+        return;
+    emit errorOccured(error);
+    stop();
+    emit huntFinished();
+}
+
+void TLEHunter::onRunFinished(int index, const QByteArray &out, const QByteArray &err, int exitCode, int timeUsed)
+{
+    if (!jobs.contains(index))
+        return;
+
+    auto &job = jobs[index];
+    Result result;
+    result.parameters = job.parameters;
+    result.input = job.input;
+    result.stats = job.runner->stats();
+    result.exitCode = exitCode;
+    result.timedOut = job.timedOut;
+    if (result.timedOut)
+        result.stats.cpuTime = qMax(result.stats.cpuTime, runTimeLimit());
+
+    int position = 0;
+    while (position < results.size() && results[position].stats.cpuTime >= result.stats.cpuTime)
+        ++position;
+    if (position < NUMBER_OF_KEPT_RESULTS)
+    {
+        results.insert(position, result);
+        if (results.size() > NUMBER_OF_KEPT_RESULTS)
+            results.removeLast();
+        emit worstResultsChanged();
+    }
+
+    finishJob(index);
+}
+
+void TLEHunter::onRunErrorOccured(int index, const QString &error)
+{
+    if (!jobs.contains(index))
+        return;
+    emit errorOccured(error);
+    stop();
+    emit huntFinished();
+}
+
+void TLEHunter::onRunTimeout(int index)
+{
+    if (jobs.contains(index))
+        jobs[index].timedOut = true;
+}
+
+void TLEHunter::launchJobs()
+{
+    while (running && jobs.size() < parallel && launched < iterations)
+    {
+        int index = launched++;
+        Job job;
+        job.parameters = nextParameters();
+        job.generator = new Generator(index);
+        connect(job.generator, SIGNAL(generated(int, const QString &)), this, SLOT(onGenerated(int, const QString &)));
+        connect(job.generator, SIGNAL(generationFailed(int, const QString &)), this,
+                SLOT(onGenerationFailed(int, const QString &)));
+        jobs[index] = job;
+        job.generator->generate(generatorCommand, job.parameters.toMap(), qMax(10000, timeLimit * 5));
+    }
+}
+
+void TLEHunter::finishJob(int index)
+{
+    auto job = jobs.take(index);
+    if (job.generator != nullptr)
+        job.generator->deleteLater();
+    if (job.runner != nullptr)
+        job.runner->deleteLater();
+
+    emit progress(++finished, iterations);
+
+    if (finished >= iterations)
+    {
+        running = false;
+        emit huntFinished();
+    }
+    else
+    {
+        launchJobs();
+    }
+}
+
+TLEHunter::Parameters TLEHunter::nextParameters()
+{
+    // always try the largest test first, as it's the most likely one to be the slowest
+    if (launched == 1)
+    {
+        Parameters parameters = upperBound;
+        parameters.minValue = lowerBound.minValue;
+        parameters.seed = QRandomGenerator::global()->generate();
+        return parameters;
+    }
+
+    // explore randomly for the first third of the budget, then search around the slowest inputs
+    if (results.isEmpty() || launched <= qMax(parallel, iterations / 3))
+        return randomParameters();
+    return mutate(results[static_cast<int>(randomBetween(0, qMin(results.size(), 3) - 1))].parameters);
+}
+
+TLEHunter::Parameters TLEHunter::randomParameters()
+{
+    Parameters parameters;
+    parameters.n = logRandomBetween(lowerBound.n, upperBound.n);
+    if (QRandomGenerator::global()->bounded(2) == 0)
+    {
+        parameters.minValue = lowerBound.minValue;
+        parameters.maxValue = upperBound.maxValue;
+    }
+    else
+    {
+        qint64 first = randomBetween(lowerBound.minValue, upperBound.maxValue);
+        qint64 second = randomBetween(lowerBound.minValue, upperBound.maxValue);
+        parameters.minValue = qMin(first, second);
+        parameters.maxValue = qMax(first, second);
+    }
+    parameters.seed = QRandomGenerator::global()->generate();
+    return parameters;
+}
+
+TLEHunter::Parameters TLEHunter::mutate(const Parameters &parameters)
+{
+    Parameters result = parameters;
+
+    // move n towards the upper bound most of the time, and shake it a bit otherwise
+    double step = QRandomGenerator::global()->generateDouble();
+    if (QRandomGenerator::global()->bounded(4) != 0)
+        result.n += static_cast<qint64>((upperBound.n - result.n) * step * 0.5);
+    else
+        result.n = static_cast<qint64>(result.n * (0.8 + 0.4 * step));
+    result.n = qBound(lowerBound.n, result.n, upperBound.n);
+
+    // either widen or narrow the value range
+    switch (QRandomGenerator::global()->bounded(3))
+    {
+    case 0:
+        result.minValue = randomBetween(lowerBound.minValue, result.minValue);
+        result.maxValue = randomBetween(result.maxValue, upperBound.maxValue);
+        break;
+    case 1:
+        result.minValue = randomBetween(result.minValue, result.maxValue);
+        break;
+    case 2:
+        result.maxValue = randomBetween(result.minValue, result.maxValue);
+        break;
+    }
+
+    result.seed = QRandomGenerator::global()->generate();
+    return result;
+}
+
+int TLEHunter::runTimeLimit() const
+{
+    // let the slow runs go a bit beyond the time limit, so that the slowest ones can be told apart
+    return qMax(timeLimit * 2, timeLimit + 1000);
+}
+
+} // namespace Core
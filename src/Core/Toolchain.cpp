@@ -0,0 +1,190 @@
+/*
+ * Copyright (C) 2019-2020 Ashar Khan <ashar786khan@gmail.com>
+ *
+ * This file is part of CPEditor.
+ *
+ * CPEditor is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * I will not be responsible if CPEditor behaves in unexpected way and
+ * causes your ratings to go down and or loose any important contest.
+ *
+ * Believe Software is "Software" and it isn't immune to bugs.
+ *
+ */
+
+#include "Core/Toolchain.hpp"
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QStandardPaths>
+#include <QTemporaryDir>
+#include <QTimer>
+
+namespace Core
+{
+
+const int Toolchain::PROBE_TIME_LIMIT;
+
+Toolchain *Toolchain::instance()
+{
+    static Toolchain *toolchain = new Toolchain(QCoreApplication::instance());
+    return toolchain;
+}
+
+Toolchain::Toolchain(QObject *parent) : QObject(parent)
+{
+}
+
+Toolchain::~Toolchain()
+{
+    for (auto process : probes.keys())
+    {
+        process->disconnect(this);
+        process->kill();
+        process->waitForFinished(100);
+        delete probes[process].tmpDir;
+        delete process;
+    }
+}
+
+Toolchain::Status Toolchain::probe(Tool tool, const QString &command, const QString &options)
+{
+    // the compilers and the interpreters are checked by the first word of the command, the other tools are paths
+    QString program = tool == Compiler ? command.trimmed().split(' ').front() : command.trimmed();
+    QString executable = findExecutable(program);
+    qint64 modified = executable.isEmpty() ? 0 : QFileInfo(executable).lastModified().toMSecsSinceEpoch();
+
+    QString probeKey = key(tool, command, options);
+    auto it = cache.find(probeKey);
+    if (it != cache.end() && it->executable == executable && it->modified == modified)
+        return it->status;
+
+    Entry entry;
+    entry.executable = executable;
+    entry.modified = modified;
+    if (executable.isEmpty())
+    {
+        // nothing to start, and a missing tool doesn't need to be reported asynchronously
+        entry.status = Unavailable;
+        cache[probeKey] = entry;
+        return Unavailable;
+    }
+    cache[probeKey] = entry;
+
+    Probe probe;
+    probe.tool = tool;
+    probe.command = command;
+    probe.options = options;
+    probe.key = probeKey;
+    probe.executable = executable;
+    probe.modified = modified;
+
+    switch (tool)
+    {
+    case Compiler:
+        probe.attempts = {{executable, "--version"}, {executable, "-version"}};
+        break;
+    case Formatter: {
+        probe.tmpDir = new QTemporaryDir();
+        if (!probe.tmpDir->isValid())
+        {
+            delete probe.tmpDir;
+            cache[probeKey].status = Unavailable;
+            return Unavailable;
+        }
+        QFile tmpFile(probe.tmpDir->filePath("tmp.cpp"));
+        tmpFile.open(QIODevice::WriteOnly | QIODevice::Text);
+        tmpFile.write("int main(){}");
+        tmpFile.close();
+        QFile styleFile(probe.tmpDir->filePath(".clang-format"));
+        styleFile.open(QIODevice::WriteOnly | QIODevice::Text);
+        styleFile.write(options.toUtf8());
+        styleFile.close();
+        probe.attempts = {
+            {executable, "--cursor=0", "--offset=0", "--length=0", "--style=file", tmpFile.fileName()}};
+        break;
+    }
+    case CFTools:
+        probe.attempts = {{executable, "--version"}};
+        break;
+    case Terminal:
+        probe.attempts = {{executable, "-v"}};
+        break;
+    }
+
+    startAttempt(probe);
+    return Unknown;
+}
+
+void Toolchain::onProcessFinished(int exitCode, QProcess::ExitStatus exitStatus)
+{
+    auto process = qobject_cast<QProcess *>(sender());
+    if (process != nullptr)
+        finishAttempt(process, exitStatus == QProcess::NormalExit && exitCode == 0);
+}
+
+void Toolchain::onProcessErrorOccurred(QProcess::ProcessError error)
+{
+    // a crash or a timeout is followed by finished(), which is handled there
+    auto process = qobject_cast<QProcess *>(sender());
+    if (process != nullptr && error == QProcess::FailedToStart)
+        finishAttempt(process, false);
+}
+
+void Toolchain::startAttempt(Probe probe)
+{
+    auto attempt = probe.attempts.takeFirst();
+    auto process = new QProcess(this);
+    probes[process] = probe;
+    connect(process, SIGNAL(finished(int, QProcess::ExitStatus)), this,
+            SLOT(onProcessFinished(int, QProcess::ExitStatus)));
+    connect(process, SIGNAL(errorOccurred(QProcess::ProcessError)), this,
+            SLOT(onProcessErrorOccurred(QProcess::ProcessError)));
+    QTimer::singleShot(PROBE_TIME_LIMIT, process, SLOT(kill()));
+    process->start(attempt.takeFirst(), attempt);
+}
+
+void Toolchain::finishAttempt(QProcess *process, bool success)
+{
+    if (!probes.contains(process))
+        return;
+    auto probe = probes.take(process);
+    process->disconnect(this);
+    process->deleteLater();
+
+    if (!success && !probe.attempts.isEmpty())
+    {
+        startAttempt(probe);
+        return;
+    }
+
+    delete probe.tmpDir;
+    // the entry is replaced if the executable changed while probing, the new probe will report it
+    auto it = cache.find(probe.key);
+    if (it == cache.end() || it->status != Unknown || it->executable != probe.executable ||
+        it->modified != probe.modified)
+        return;
+    it->status = success ? Available : Unavailable;
+    emit probeFinished(probe.tool, probe.command, probe.options, success);
+}
+
+QString Toolchain::key(Tool tool, const QString &command, const QString &options)
+{
+    return QString::number(tool) + '\n' + command.trimmed() + '\n' + options;
+}
+
+QString Toolchain::findExecutable(const QString &program)
+{
+    if (program.isEmpty())
+        return QString();
+    QFileInfo info(program);
+    if (info.isAbsolute() || program.contains('/'))
+        return info.isFile() && info.isExecutable() ? info.absoluteFilePath() : QString();
+    return QStandardPaths::findExecutable(program);
+}
+
+} // namespace Core
@@ -70,16 +70,6 @@ void CFTools::submit(const QString &filePath, const QString &url, const QString
     CFToolProcess->start();
 }
 
-bool CFTools::check(QString path)
-{
-    QProcess checkProcess;
-
-    checkProcess.start(path, {"--version"});
-
-    bool finished = checkProcess.waitForFinished(2000);
-    return finished && checkProcess.exitCode() == 0;
-}
-
 void CFTools::updatePath(QString p)
 {
     path = p;
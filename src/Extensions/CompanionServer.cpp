@@ -118,6 +118,10 @@ void CompanionServer::onReadReady()
             payload.timeLimit = doc["timeLimit"].toInt();
             payload.isInputstdin = doc["input"].toObject()["type"].toString() == "stdin";
             payload.isOutputstdout = doc["output"].toObject()["type"].toString() == "stdout";
+            if (doc["input"].toObject()["type"].toString() == "file")
+                payload.inputFileName = doc["input"].toObject()["fileName"].toString();
+            if (doc["output"].toObject()["type"].toString() == "file")
+                payload.outputFileName = doc["output"].toObject()["fileName"].toString();
 
             QJsonArray testArray = doc["tests"].toArray();
             for (auto tests : testArray)
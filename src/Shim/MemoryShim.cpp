@@ -0,0 +1,421 @@
+/*
+ * Copyright (C) 2019-2020 Ashar Khan <ashar786khan@gmail.com>
+ *
+ * This file is part of CPEditor.
+ *
+ * CPEditor is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * I will not be responsible if CPEditor behaves in unexpected way and
+ * causes your ratings to go down and or loose any important contest.
+ *
+ * Believe Software is "Software" and it isn't immune to bugs.
+ *
+ */
+
+// The memory shim is preloaded into a solution by the memory profile of the editor. It counts the allocations of
+// malloc() and operator new by their call sites, tracks the live bytes of each call site, and writes the report to
+// the file named by CPEDITOR_MEMORY_SHIM_OUTPUT when the program exits. It's a separate library because it's loaded
+// into the solution instead of the editor, so it doesn't use Qt and it never allocates with the hooked functions.
+// Its tables are shared memory of a memfd, so the memory profile can tell them apart from the memory of the solution.
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <dlfcn.h>
+#include <link.h>
+#include <new>
+#include <sys/mman.h>
+#include <unistd.h>
+
+extern "C"
+{
+    void *__libc_malloc(size_t size);
+    void *__libc_calloc(size_t count, size_t size);
+    void *__libc_realloc(void *pointer, size_t size);
+    void __libc_free(void *pointer);
+}
+
+namespace
+{
+
+const size_t MAX_SITES = 1 << 14;          // a power of two, the call sites beyond 3/4 of it are merged
+const size_t INITIAL_ALLOCATIONS = 1 << 12; // a power of two, the table is doubled when it's 3/4 full
+const size_t MAX_ALLOCATIONS = 1 << 22;     // a power of two, the allocations beyond 3/4 of it are not tracked
+const uintptr_t OTHER_SITES_ADDRESS = 1;    // the address of the merged call sites
+
+struct Site
+{
+    uintptr_t address;
+    unsigned long long count, total, live, peakLive;
+};
+
+struct Allocation
+{
+    uintptr_t pointer;
+    size_t size;
+    size_t site;
+};
+
+Site *sites = nullptr;             // MAX_SITES call sites and the merged ones at the end
+Allocation *allocations = nullptr; // open addressing with linear probing
+size_t siteCount = 0, allocationCount = 0, allocationCapacity = 0;
+unsigned long long liveBytes = 0, peakBytes = 0;
+bool disabled = false;
+std::atomic_flag lock = ATOMIC_FLAG_INIT;
+// set while the shim itself runs, so that the allocations of the C library made on its behalf are not counted
+__thread bool inside __attribute__((tls_model("initial-exec"))) = false;
+
+size_t hashOf(uintptr_t value)
+{
+    unsigned long long x = value;
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    return static_cast<size_t>(x);
+}
+
+// the pages are only committed when they are touched, and they are counted as RssShmem instead of RssAnon, unless
+// memfd_create() is not supported
+void *mapTable(size_t bytes)
+{
+    void *memory = MAP_FAILED;
+    int fd = memfd_create("cpeditor-memory-shim", MFD_CLOEXEC);
+    if (fd >= 0)
+    {
+        if (ftruncate(fd, static_cast<off_t>(bytes)) == 0)
+            memory = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+    }
+    if (memory == MAP_FAILED)
+        memory = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    return memory == MAP_FAILED ? nullptr : memory;
+}
+
+bool initialize()
+{
+    if (sites != nullptr)
+        return true;
+    if (disabled)
+        return false;
+    sites = static_cast<Site *>(mapTable((MAX_SITES + 1) * sizeof(Site)));
+    allocations = static_cast<Allocation *>(mapTable(INITIAL_ALLOCATIONS * sizeof(Allocation)));
+    if (sites == nullptr || allocations == nullptr)
+    {
+        if (sites != nullptr)
+            munmap(sites, (MAX_SITES + 1) * sizeof(Site));
+        sites = nullptr;
+        disabled = true;
+        return false;
+    }
+    allocationCapacity = INITIAL_ALLOCATIONS;
+    sites[MAX_SITES].address = OTHER_SITES_ADDRESS;
+    return true;
+}
+
+size_t siteOf(uintptr_t address)
+{
+    size_t i = hashOf(address) & (MAX_SITES - 1);
+    while (sites[i].address != 0)
+    {
+        if (sites[i].address == address)
+            return i;
+        i = (i + 1) & (MAX_SITES - 1);
+    }
+    if (siteCount >= MAX_SITES * 3 / 4)
+        return MAX_SITES;
+    ++siteCount;
+    sites[i].address = address;
+    return i;
+}
+
+void placeAllocation(const Allocation &allocation)
+{
+    const size_t mask = allocationCapacity - 1;
+    size_t i = hashOf(allocation.pointer) & mask;
+    while (allocations[i].pointer != 0)
+        i = (i + 1) & mask;
+    allocations[i] = allocation;
+}
+
+// the table is as large as the live allocations need, so a program with few of them doesn't get a large table in its
+// resident memory, the hashes scatter the entries over all the pages
+bool growAllocations()
+{
+    if (allocationCapacity >= MAX_ALLOCATIONS)
+        return false;
+    auto table = static_cast<Allocation *>(mapTable(allocationCapacity * 2 * sizeof(Allocation)));
+    if (table == nullptr)
+        return false;
+    Allocation *old = allocations;
+    size_t oldCapacity = allocationCapacity;
+    allocations = table;
+    allocationCapacity *= 2;
+    for (size_t i = 0; i < oldCapacity; ++i)
+    {
+        if (old[i].pointer != 0)
+            placeAllocation(old[i]);
+    }
+    munmap(old, oldCapacity * sizeof(Allocation));
+    return true;
+}
+
+void insertAllocation(uintptr_t pointer, size_t size, size_t site)
+{
+    if (allocationCount >= allocationCapacity * 3 / 4 && !growAllocations())
+        return;
+    Allocation allocation;
+    allocation.pointer = pointer;
+    allocation.size = size;
+    allocation.site = site;
+    placeAllocation(allocation);
+    ++allocationCount;
+}
+
+bool removeAllocation(uintptr_t pointer, Allocation &removed)
+{
+    const size_t mask = allocationCapacity - 1;
+    size_t i = hashOf(pointer) & mask;
+    while (allocations[i].pointer != pointer)
+    {
+        if (allocations[i].pointer == 0)
+            return false;
+        i = (i + 1) & mask;
+    }
+    removed = allocations[i];
+
+    // shift the following entries back, so that no probe sequence is broken by the hole
+    for (size_t j = (i + 1) & mask; allocations[j].pointer != 0; j = (j + 1) & mask)
+    {
+        size_t home = hashOf(allocations[j].pointer) & mask;
+        bool stays = i <= j ? (i < home && home <= j) : (i < home || home <= j);
+        if (stays)
+            continue;
+        allocations[i] = allocations[j];
+        i = j;
+    }
+    allocations[i].pointer = 0;
+    --allocationCount;
+    return true;
+}
+
+void lockTables()
+{
+    while (lock.test_and_set(std::memory_order_acquire))
+    {
+    }
+}
+
+void unlockTables()
+{
+    lock.clear(std::memory_order_release);
+}
+
+void recordAllocation(void *pointer, size_t size, void *caller)
+{
+    if (pointer == nullptr || inside)
+        return;
+    inside = true;
+    lockTables();
+    if (initialize())
+    {
+        size_t site = siteOf(reinterpret_cast<uintptr_t>(caller));
+        ++sites[site].count;
+        sites[site].total += size;
+        sites[site].live += size;
+        if (sites[site].live > sites[site].peakLive)
+            sites[site].peakLive = sites[site].live;
+        liveBytes += size;
+        if (liveBytes > peakBytes)
+            peakBytes = liveBytes;
+        insertAllocation(reinterpret_cast<uintptr_t>(pointer), size, site);
+    }
+    unlockTables();
+    inside = false;
+}
+
+void recordFree(void *pointer)
+{
+    if (pointer == nullptr || inside)
+        return;
+    inside = true;
+    lockTables();
+    Allocation removed;
+    if (sites != nullptr && removeAllocation(reinterpret_cast<uintptr_t>(pointer), removed))
+    {
+        sites[removed.site].live -= removed.size;
+        liveBytes -= removed.size;
+    }
+    unlockTables();
+    inside = false;
+}
+
+struct Executable
+{
+    uintptr_t bias = 0;
+    uintptr_t start[16], end[16];
+    int segments = 0;
+};
+
+int findExecutable(dl_phdr_info *info, size_t, void *data)
+{
+    // the first object is the executable itself
+    auto executable = static_cast<Executable *>(data);
+    executable->bias = info->dlpi_addr;
+    for (int i = 0; i < info->dlpi_phnum && executable->segments < 16; ++i)
+    {
+        if (info->dlpi_phdr[i].p_type != PT_LOAD)
+            continue;
+        executable->start[executable->segments] = info->dlpi_addr + info->dlpi_phdr[i].p_vaddr;
+        executable->end[executable->segments] = executable->start[executable->segments] + info->dlpi_phdr[i].p_memsz;
+        ++executable->segments;
+    }
+    return 1;
+}
+
+// the report has a line for the peak of the live bytes, and a line for each call site:
+//   peak <bytes>
+//   exe <count> <total bytes> <peak live bytes> <hex address in the executable>
+//   lib <count> <total bytes> <peak live bytes> <symbol or library>
+__attribute__((destructor)) void writeReport()
+{
+    const char *path = getenv("CPEDITOR_MEMORY_SHIM_OUTPUT");
+    if (path == nullptr || sites == nullptr)
+        return;
+    inside = true;
+    lockTables();
+
+    Executable executable;
+    dl_iterate_phdr(findExecutable, &executable);
+
+    FILE *file = fopen(path, "w");
+    if (file != nullptr)
+    {
+        fprintf(file, "peak %llu\n", peakBytes);
+        for (size_t i = 0; i <= MAX_SITES; ++i)
+        {
+            const Site &site = sites[i];
+            if (site.address == 0 || site.count == 0)
+                continue;
+            if (site.address == OTHER_SITES_ADDRESS)
+            {
+                fprintf(file, "lib %llu %llu %llu (other call sites)\n", site.count, site.total, site.peakLive);
+                continue;
+            }
+            bool inExecutable = false;
+            for (int j = 0; j < executable.segments; ++j)
+                inExecutable |= site.address >= executable.start[j] && site.address < executable.end[j];
+            if (inExecutable)
+            {
+                fprintf(file, "exe %llu %llu %llu %lx\n", site.count, site.total, site.peakLive,
+                        static_cast<unsigned long>(site.address - executable.bias));
+                continue;
+            }
+            Dl_info info;
+            const char *name = "??";
+            if (dladdr(reinterpret_cast<void *>(site.address), &info) != 0)
+                name = info.dli_sname != nullptr ? info.dli_sname : (info.dli_fname != nullptr ? info.dli_fname : name);
+            fprintf(file, "lib %llu %llu %llu %s\n", site.count, site.total, site.peakLive, name);
+        }
+        fclose(file);
+    }
+
+    unlockTables();
+    inside = false;
+}
+
+} // namespace
+
+extern "C"
+{
+
+    void *malloc(size_t size)
+    {
+        void *pointer = __libc_malloc(size);
+        recordAllocation(pointer, size, __builtin_return_address(0));
+        return pointer;
+    }
+
+    void *calloc(size_t count, size_t size)
+    {
+        void *pointer = __libc_calloc(count, size);
+        recordAllocation(pointer, count * size, __builtin_return_address(0));
+        return pointer;
+    }
+
+    void *realloc(void *old, size_t size)
+    {
+        recordFree(old);
+        void *pointer = __libc_realloc(old, size);
+        recordAllocation(pointer, size, __builtin_return_address(0));
+        return pointer;
+    }
+
+    void free(void *pointer)
+    {
+        recordFree(pointer);
+        __libc_free(pointer);
+    }
+}
+
+// operator new is hooked as well, so that the call sites are in the solution instead of the C++ library
+
+void *operator new(size_t size)
+{
+    void *pointer = __libc_malloc(size == 0 ? 1 : size);
+    if (pointer == nullptr)
+        throw std::bad_alloc();
+    recordAllocation(pointer, size, __builtin_return_address(0));
+    return pointer;
+}
+
+void *operator new[](size_t size)
+{
+    void *pointer = __libc_malloc(size == 0 ? 1 : size);
+    if (pointer == nullptr)
+        throw std::bad_alloc();
+    recordAllocation(pointer, size, __builtin_return_address(0));
+    return pointer;
+}
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept
+{
+    void *pointer = __libc_malloc(size == 0 ? 1 : size);
+    recordAllocation(pointer, size, __builtin_return_address(0));
+    return pointer;
+}
+
+void *operator new[](size_t size, const std::nothrow_t &) noexcept
+{
+    void *pointer = __libc_malloc(size == 0 ? 1 : size);
+    recordAllocation(pointer, size, __builtin_return_address(0));
+    return pointer;
+}
+
+void operator delete(void *pointer) noexcept
+{
+    recordFree(pointer);
+    __libc_free(pointer);
+}
+
+void operator delete[](void *pointer) noexcept
+{
+    recordFree(pointer);
+    __libc_free(pointer);
+}
+
+void operator delete(void *pointer, size_t) noexcept
+{
+    recordFree(pointer);
+    __libc_free(pointer);
+}
+
+void operator delete[](void *pointer, size_t) noexcept
+{
+    recordFree(pointer);
+    __libc_free(pointer);
+}
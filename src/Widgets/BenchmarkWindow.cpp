@@ -0,0 +1,173 @@
+/*
+ * Copyright (C) 2019-2020 Ashar Khan <ashar786khan@gmail.com>
+ *
+ * This file is part of CPEditor.
+ *
+ * CPEditor is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * I will not be responsible if CPEditor behaves in unexpected way and
+ * causes your ratings to go down and or loose any important contest.
+ *
+ * Believe Software is "Software" and it isn't immune to bugs.
+ *
+ */
+
+#include "Widgets/BenchmarkWindow.hpp"
+#include "Core/PerfCounters.hpp"
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QThread>
+#include <QVBoxLayout>
+
+BenchmarkWindow::BenchmarkWindow(QWidget *parent) : QMainWindow(parent)
+{
+    auto widget = new QWidget(this);
+    auto mainLayout = new QVBoxLayout(widget);
+    auto optionsLayout = new QHBoxLayout();
+
+    runsSpin = new QSpinBox();
+    runsSpin->setRange(1, 1000);
+    runsSpin->setValue(10);
+    warmUpSpin = new QSpinBox();
+    warmUpSpin->setRange(0, 100);
+    warmUpSpin->setValue(1);
+    coreSpin = new QSpinBox();
+    coreSpin->setRange(-1, qMax(0, QThread::idealThreadCount() - 1));
+    coreSpin->setSpecialValueText("Any");
+    coreSpin->setValue(Core::Benchmark::defaultCore());
+    coreSpin->setToolTip("The CPU core all the runs are pinned to");
+    startButton = new QPushButton("Start");
+    progressBar = new QProgressBar();
+
+    resultsTable = new QTableWidget(0, 11);
+    resultsTable->setHorizontalHeaderLabels({"Test", "Runs", "Min", "Median", "P95", "CV", "Instructions", "IPC",
+                                             "Cache Misses", "Branch Misses", "Status"});
+    resultsTable->horizontalHeader()->setSectionResizeMode(10, QHeaderView::Stretch);
+    resultsTable->verticalHeader()->hide();
+    resultsTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    resultsTable->setSelectionBehavior(QAbstractItemView::SelectRows);
+
+    optionsLayout->addWidget(new QLabel("Runs:"));
+    optionsLayout->addWidget(runsSpin);
+    optionsLayout->addWidget(new QLabel("Warm-up runs:"));
+    optionsLayout->addWidget(warmUpSpin);
+    optionsLayout->addWidget(new QLabel("CPU core:"));
+    optionsLayout->addWidget(coreSpin);
+    optionsLayout->addStretch();
+    optionsLayout->addWidget(startButton);
+    mainLayout->addLayout(optionsLayout);
+    mainLayout->addWidget(progressBar);
+    mainLayout->addWidget(resultsTable);
+
+    setCentralWidget(widget);
+    setWindowTitle("Benchmark");
+    resize(900, 400);
+
+    connect(startButton, SIGNAL(clicked()), this, SLOT(on_startButton_clicked()));
+}
+
+void BenchmarkWindow::setTarget(const QString &filePath, const QString &lang, const QString &runCommand,
+                                const QString &args, int timeLimit, const QStringList &inputs)
+{
+    if (benchmark != nullptr)
+        delete benchmark;
+    this->inputs = inputs;
+    benchmark = new Core::Benchmark(filePath, lang, runCommand, args, timeLimit, this);
+    connect(benchmark, SIGNAL(progress(int, int)), this, SLOT(onProgress(int, int)));
+    connect(benchmark, SIGNAL(resultChanged(int)), this, SLOT(onResultChanged(int)));
+    connect(benchmark, SIGNAL(benchmarkFinished()), this, SLOT(onBenchmarkFinished()));
+    startButton->setText("Start");
+    resultsTable->setRowCount(0);
+    progressBar->reset();
+    // the medians of the hardware counters of the measured runs
+    for (int column = 6; column <= 9; ++column)
+        resultsTable->setColumnHidden(column, !Core::PerfCounters::isEnabled());
+}
+
+void BenchmarkWindow::setFileIO(const QString &inputFileName, const QString &outputFileName)
+{
+    if (benchmark != nullptr)
+        benchmark->setFileIO(inputFileName, outputFileName);
+}
+
+void BenchmarkWindow::on_startButton_clicked()
+{
+    if (benchmark == nullptr)
+        return;
+
+    if (benchmark->isRunning())
+    {
+        benchmark->stop();
+        onBenchmarkFinished();
+        return;
+    }
+
+    startButton->setText("Stop");
+    resultsTable->setRowCount(0);
+    benchmark->start(inputs, runsSpin->value(), warmUpSpin->value(), coreSpin->value());
+}
+
+void BenchmarkWindow::onProgress(int finished, int total)
+{
+    progressBar->setMaximum(total);
+    progressBar->setValue(finished);
+}
+
+void BenchmarkWindow::onResultChanged(int index)
+{
+    auto results = benchmark->results();
+    resultsTable->setRowCount(results.size());
+    for (int i = 0; i < results.size(); ++i)
+    {
+        if (results[i].index != index)
+            continue;
+        auto summary = results[i].summary();
+        QString status = results[i].error;
+        if (status.isEmpty())
+            status = summary.cv > 0.05 ? "Noisy" : "OK";
+        resultsTable->setItem(i, 0, new QTableWidgetItem("#" + QString::number(index + 1)));
+        resultsTable->setItem(i, 1, new QTableWidgetItem(QString::number(summary.runs)));
+        resultsTable->setItem(i, 2, new QTableWidgetItem(formatTime(summary.min)));
+        resultsTable->setItem(i, 3, new QTableWidgetItem(formatTime(summary.median)));
+        resultsTable->setItem(i, 4, new QTableWidgetItem(formatTime(summary.p95)));
+        resultsTable->setItem(i, 5, new QTableWidgetItem(QString::number(summary.cv * 100, 'f', 1) + "%"));
+        double instructions = results[i].medianCounter(&Core::ProcessStats::instructions);
+        double cycles = results[i].medianCounter(&Core::ProcessStats::cycles);
+        resultsTable->setItem(i, 6, new QTableWidgetItem(formatCount(instructions)));
+        resultsTable->setItem(
+            i, 7, new QTableWidgetItem(instructions >= 0 && cycles > 0 ? QString::number(instructions / cycles, 'f', 2)
+                                                                       : "-"));
+        resultsTable->setItem(
+            i, 8, new QTableWidgetItem(formatCount(results[i].medianCounter(&Core::ProcessStats::cacheMisses))));
+        resultsTable->setItem(
+            i, 9, new QTableWidgetItem(formatCount(results[i].medianCounter(&Core::ProcessStats::branchMisses))));
+        resultsTable->setItem(i, 10, new QTableWidgetItem(status));
+    }
+}
+
+void BenchmarkWindow::onBenchmarkFinished()
+{
+    startButton->setText("Start");
+}
+
+QString BenchmarkWindow::formatTime(double time)
+{
+    return QString::number(time, 'f', time < 100 ? 2 : 1) + "ms";
+}
+
+QString BenchmarkWindow::formatCount(double count)
+{
+    if (count < 0)
+        return "-";
+    if (count >= 1e9)
+        return QString::number(count / 1e9, 'f', 2) + "G";
+    if (count >= 1e6)
+        return QString::number(count / 1e6, 'f', 2) + "M";
+    if (count >= 1e3)
+        return QString::number(count / 1e3, 'f', 2) + "k";
+    return QString::number(count, 'f', 0);
+}
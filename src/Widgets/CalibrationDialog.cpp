@@ -0,0 +1,184 @@
+/*
+ * Copyright (C) 2019-2020 Ashar Khan <ashar786khan@gmail.com>
+ *
+ * This file is part of CPEditor.
+ *
+ * CPEditor is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * I will not be responsible if CPEditor behaves in unexpected way and
+ * causes your ratings to go down and or loose any important contest.
+ *
+ * Believe Software is "Software" and it isn't immune to bugs.
+ *
+ */
+
+
+#include "Widgets/CalibrationDialog.hpp"
+#include <QApplication>
+#include <QClipboard>
+#include <QDialogButtonBox>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QMessageBox>
+#include <QVBoxLayout>
+
+CalibrationDialog::CalibrationDialog(Settings::SettingManager *manager, const QString &compileCommand,
+                                     QWidget *parent)
+    : QDialog(parent), manager(manager), compileCommand(compileCommand)
+{
+    setWindowTitle("Judge Speed Calibration");
+    calibration = new Core::Calibration(this);
+    connect(calibration, SIGNAL(programStarted(const QString &)), this, SLOT(onProgramStarted(const QString &)));
+    connect(calibration, SIGNAL(programMeasured(const QString &, double)), this,
+            SLOT(onProgramMeasured(const QString &, double)));
+    connect(calibration, SIGNAL(calibrationFinished()), this, SLOT(onCalibrationFinished()));
+    connect(calibration, SIGNAL(errorOccured(const QString &)), this, SLOT(onErrorOccured(const QString &)));
+
+    auto mainLayout = new QVBoxLayout(this);
+    auto buttonsLayout = new QHBoxLayout();
+
+    auto infoLabel = new QLabel("Measure the programs on this machine, then run each of them on the judge, e.g. in its "
+                                "custom invocation, and enter the time it reports. The time limits are scaled by the "
+                                "ratio of the timings.");
+    infoLabel->setWordWrap(true);
+
+    auto programs = Core::Calibration::programs();
+    table = new QTableWidget(programs.size(), 3);
+    table->setHorizontalHeaderLabels({"Program", "Here", "On the judge"});
+    table->setSelectionBehavior(QAbstractItemView::SelectRows);
+    table->setSelectionMode(QAbstractItemView::SingleSelection);
+    table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    table->verticalHeader()->hide();
+    table->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    for (int i = 0; i < programs.size(); ++i)
+    {
+        localTimes[programs[i]] = manager->getCalibrationTime("local", programs[i]);
+        table->setItem(i, 0, new QTableWidgetItem(Core::Calibration::description(programs[i])));
+        table->setItem(i, 1, new QTableWidgetItem(localTimes[programs[i]] > 0
+                                                      ? QString::number(localTimes[programs[i]], 'f', 1) + "ms"
+                                                      : QString("Not measured")));
+        auto spin = new QDoubleSpinBox();
+        spin->setRange(0, 1000000);
+        spin->setDecimals(1);
+        spin->setSuffix("ms");
+        spin->setSpecialValueText("Unknown");
+        spin->setValue(manager->getCalibrationTime("judge", programs[i]));
+        connect(spin, SIGNAL(valueChanged(double)), this, SLOT(updateFactor()));
+        table->setCellWidget(i, 2, spin);
+        judgeSpins.push_back(spin);
+    }
+    table->selectRow(0);
+
+    measureButton = new QPushButton("Measure");
+    copyButton = new QPushButton("Copy Source");
+    copyButton->setToolTip("Copy the source of the selected program, to run it on the judge");
+    factorLabel = new QLabel();
+    auto buttonBox = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel);
+
+    buttonsLayout->addWidget(measureButton);
+    buttonsLayout->addWidget(copyButton);
+    buttonsLayout->addStretch();
+    mainLayout->addWidget(infoLabel);
+    mainLayout->addWidget(table);
+    mainLayout->addLayout(buttonsLayout);
+    mainLayout->addWidget(factorLabel);
+    mainLayout->addWidget(buttonBox);
+
+    connect(measureButton, SIGNAL(clicked()), this, SLOT(on_measureButton_clicked()));
+    connect(copyButton, SIGNAL(clicked()), this, SLOT(on_copyButton_clicked()));
+    connect(buttonBox, SIGNAL(accepted()), this, SLOT(accept()));
+    connect(buttonBox, SIGNAL(rejected()), this, SLOT(reject()));
+
+    resize(500, 320);
+    updateFactor();
+}
+
+double CalibrationDialog::speedFactor() const
+{
+    return Core::Calibration::speedFactor(localTimes, judgeTimes());
+}
+
+void CalibrationDialog::accept()
+{
+    calibration->stop();
+    for (auto const &program : Core::Calibration::programs())
+    {
+        manager->setCalibrationTime("local", program, localTimes.value(program));
+        manager->setCalibrationTime("judge", program, judgeTimes().value(program));
+    }
+    QDialog::accept();
+}
+
+void CalibrationDialog::on_measureButton_clicked()
+{
+    if (calibration->isRunning())
+    {
+        calibration->stop();
+        onCalibrationFinished();
+        return;
+    }
+    measureButton->setText("Stop");
+    calibration->start(compileCommand);
+}
+
+void CalibrationDialog::on_copyButton_clicked()
+{
+    int row = table->currentRow();
+    if (row < 0)
+        return;
+    QApplication::clipboard()->setText(Core::Calibration::source(Core::Calibration::programs()[row]));
+}
+
+void CalibrationDialog::onProgramStarted(const QString &program)
+{
+    int row = Core::Calibration::programs().indexOf(program);
+    table->item(row, 1)->setText("Measuring...");
+}
+
+void CalibrationDialog::onProgramMeasured(const QString &program, double time)
+{
+    int row = Core::Calibration::programs().indexOf(program);
+    localTimes[program] = time;
+    table->item(row, 1)->setText(QString::number(time, 'f', 1) + "ms");
+    updateFactor();
+}
+
+void CalibrationDialog::onCalibrationFinished()
+{
+    measureButton->setText("Measure");
+    for (int i = 0; i < table->rowCount(); ++i)
+    {
+        if (table->item(i, 1)->text() == "Measuring...")
+            table->item(i, 1)->setText("Not measured");
+    }
+}
+
+void CalibrationDialog::onErrorOccured(const QString &error)
+{
+    onCalibrationFinished();
+    QMessageBox::warning(this, "Calibration", error);
+}
+
+void CalibrationDialog::updateFactor()
+{
+    double factor = speedFactor();
+    if (factor <= 0)
+        factorLabel->setText("Measure the programs and enter their timings on the judge to get the speed factor.");
+    else
+    {
+        factorLabel->setText("The judge is " + QString::number(factor >= 1 ? factor : 1 / factor, 'f', 2) + "x " +
+                             (factor >= 1 ? "slower" : "faster") + " than this machine.");
+    }
+}
+
+QMap<QString, double> CalibrationDialog::judgeTimes() const
+{
+    QMap<QString, double> times;
+    auto programs = Core::Calibration::programs();
+    for (int i = 0; i < programs.size(); ++i)
+        times[programs[i]] = judgeSpins[i]->value();
+    return times;
+}
@@ -0,0 +1,197 @@
+/*
+ * Copyright (C) 2019-2020 Ashar Khan <ashar786khan@gmail.com>
+ *
+ * This file is part of CPEditor.
+ *
+ * CPEditor is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * I will not be responsible if CPEditor behaves in unexpected way and
+ * causes your ratings to go down and or loose any important contest.
+ *
+ * Believe Software is "Software" and it isn't immune to bugs.
+ *
+ */
+
+#include "Widgets/ComparisonWindow.hpp"
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QThread>
+#include <QVBoxLayout>
+
+ComparisonWindow::ComparisonWindow(QWidget *parent) : QMainWindow(parent)
+{
+    auto widget = new QWidget(this);
+    auto mainLayout = new QVBoxLayout(widget);
+    auto optionsLayout = new QHBoxLayout();
+
+    roundsSpin = new QSpinBox();
+    roundsSpin->setRange(2, 1000);
+    roundsSpin->setValue(10);
+    roundsSpin->setToolTip("The number of measured runs of each version on each test, after a warm-up run");
+    coreSpin = new QSpinBox();
+    coreSpin->setRange(-1, qMax(0, QThread::idealThreadCount() - 1));
+    coreSpin->setSpecialValueText("Any");
+    coreSpin->setValue(Core::Benchmark::defaultCore());
+    coreSpin->setToolTip("The CPU core all the runs are pinned to");
+    startButton = new QPushButton("Start");
+    progressBar = new QProgressBar();
+    summaryLabel = new QLabel();
+    summaryLabel->setTextFormat(Qt::RichText);
+    summaryLabel->setWordWrap(true);
+
+    resultsTable = new QTableWidget(0, 6);
+    resultsTable->setHorizontalHeaderLabels({"Test", "Baseline", "Current", "Speed-up", "95% CI", "Output"});
+    resultsTable->horizontalHeader()->setSectionResizeMode(5, QHeaderView::Stretch);
+    resultsTable->verticalHeader()->hide();
+    resultsTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    resultsTable->setSelectionBehavior(QAbstractItemView::SelectRows);
+
+    optionsLayout->addWidget(new QLabel("Runs:"));
+    optionsLayout->addWidget(roundsSpin);
+    optionsLayout->addWidget(new QLabel("CPU core:"));
+    optionsLayout->addWidget(coreSpin);
+    optionsLayout->addStretch();
+    optionsLayout->addWidget(startButton);
+    mainLayout->addLayout(optionsLayout);
+    mainLayout->addWidget(progressBar);
+    mainLayout->addWidget(summaryLabel);
+    mainLayout->addWidget(resultsTable);
+
+    setCentralWidget(widget);
+    setWindowTitle("Compare Performance");
+    resize(750, 450);
+
+    connect(startButton, SIGNAL(clicked()), this, SLOT(on_startButton_clicked()));
+}
+
+void ComparisonWindow::setTargets(const Core::PerformanceComparison::Target &baseline, const QString &baselineName,
+                                  const Core::PerformanceComparison::Target &current, int timeLimit,
+                                  const QStringList &inputs, const QStringList &expected)
+{
+    if (comparison != nullptr)
+        delete comparison;
+    this->baselineName = baselineName;
+    this->inputs = inputs;
+    this->expected = expected;
+    comparison = new Core::PerformanceComparison(baseline, current, timeLimit, this);
+    connect(comparison, SIGNAL(progress(int, int)), this, SLOT(onProgress(int, int)));
+    connect(comparison, SIGNAL(resultChanged(int)), this, SLOT(onResultChanged(int)));
+    connect(comparison, SIGNAL(comparisonFinished()), this, SLOT(onComparisonFinished()));
+    startButton->setText("Start");
+    resultsTable->setRowCount(0);
+    progressBar->reset();
+    summaryLabel->setText("Baseline: " + baselineName.toHtmlEscaped());
+}
+
+void ComparisonWindow::on_startButton_clicked()
+{
+    if (comparison == nullptr)
+        return;
+
+    if (comparison->isRunning())
+    {
+        comparison->stop();
+        onComparisonFinished();
+        return;
+    }
+
+    startButton->setText("Stop");
+    resultsTable->setRowCount(0);
+    comparison->start(inputs, expected, roundsSpin->value(), coreSpin->value());
+}
+
+void ComparisonWindow::onProgress(int finished, int total)
+{
+    progressBar->setMaximum(total);
+    progressBar->setValue(finished);
+}
+
+void ComparisonWindow::onResultChanged(int index)
+{
+    auto results = comparison->results();
+    resultsTable->setRowCount(results.size());
+    for (int i = 0; i < results.size(); ++i)
+    {
+        if (results[i].index != index)
+            continue;
+        auto const &result = results[i];
+        auto baseline = result.summary(Core::PerformanceComparison::Baseline);
+        auto current = result.summary(Core::PerformanceComparison::Current);
+        auto speedUp = result.speedUp();
+        resultsTable->setItem(i, 0, new QTableWidgetItem("#" + QString::number(index + 1)));
+        resultsTable->setItem(i, 1, new QTableWidgetItem(baseline.runs > 0 ? formatTime(baseline.median) : "-"));
+        resultsTable->setItem(i, 2, new QTableWidgetItem(current.runs > 0 ? formatTime(current.median) : "-"));
+        resultsTable->setItem(i, 3, new QTableWidgetItem(speedUp.valid ? formatRatio(speedUp.value) : "-"));
+        resultsTable->setItem(i, 4,
+                              new QTableWidgetItem(speedUp.valid ? formatRatio(speedUp.low) + " - " +
+                                                                       formatRatio(speedUp.high)
+                                                                 : "-"));
+        resultsTable->setItem(i, 5, new QTableWidgetItem(result.error.isEmpty() ? outputStatus(result) : result.error));
+        if (!result.sameOutput)
+            resultsTable->item(i, 5)->setForeground(Qt::red);
+    }
+    updateSummary();
+}
+
+void ComparisonWindow::onComparisonFinished()
+{
+    startButton->setText("Start");
+    updateSummary();
+}
+
+void ComparisonWindow::updateSummary()
+{
+    QString text = "Baseline: " + baselineName.toHtmlEscaped();
+    auto overall = comparison->overallSpeedUp();
+    if (overall.valid)
+    {
+        QString verdict;
+        if (overall.low > 1)
+            verdict = "<span style=\"color:green\">the current version is faster</span>";
+        else if (overall.high < 1)
+            verdict = "<span style=\"color:red\">the current version is slower</span>";
+        else
+            verdict = "no significant difference";
+        text += "<br>Speed-up: <b>" + formatRatio(overall.value) + "</b> (95% CI " + formatRatio(overall.low) +
+                " - " + formatRatio(overall.high) + "), " + verdict;
+    }
+
+    int different = 0;
+    for (auto const &result : comparison->results())
+    {
+        if (!result.sameOutput)
+            ++different;
+    }
+    if (different > 0)
+    {
+        text += "<br><span style=\"color:red\">The outputs differ on " + QString::number(different) + " test" +
+                (different > 1 ? "s" : "") + "</span>";
+    }
+    summaryLabel->setText(text);
+}
+
+QString ComparisonWindow::formatTime(double time)
+{
+    return QString::number(time, 'f', time < 100 ? 2 : 1) + "ms";
+}
+
+QString ComparisonWindow::formatRatio(double ratio)
+{
+    return QString::number(ratio, 'f', 3) + "x";
+}
+
+QString ComparisonWindow::outputStatus(const Core::PerformanceComparison::Result &result)
+{
+    QString status = result.sameOutput ? "Same" : "Different";
+    const int baseline = Core::PerformanceComparison::Baseline, current = Core::PerformanceComparison::Current;
+    if (result.correct[baseline] == 0 || result.correct[current] == 0)
+    {
+        status += QString(", wrong answer of ") +
+                  (result.correct[baseline] == 0 ? (result.correct[current] == 0 ? "both" : "the baseline")
+                                                 : "the current version");
+    }
+    return status;
+}
@@ -0,0 +1,269 @@
+/*
+ * Copyright (C) 2019-2020 Ashar Khan <ashar786khan@gmail.com>
+ *
+ * This file is part of CPEditor.
+ *
+ * CPEditor is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * I will not be responsible if CPEditor behaves in unexpected way and
+ * causes your ratings to go down and or loose any important contest.
+ *
+ * Believe Software is "Software" and it isn't immune to bugs.
+ *
+ */
+
+#include "Widgets/ComplexityWidget.hpp"
+#include <QFormLayout>
+#include <QHBoxLayout>
+#include <QMessageBox>
+#include <QVBoxLayout>
+#include <cmath>
+
+ComplexityWidget::ComplexityWidget(QWidget *parent) : QWidget(parent)
+{
+    auto mainLayout = new QVBoxLayout(this);
+    auto formLayout = new QFormLayout();
+    auto nLayout = new QHBoxLayout();
+    auto buttonsLayout = new QHBoxLayout();
+
+    generatorEdit = new QLineEdit();
+    generatorEdit->setPlaceholderText("./gen {n} {seed}");
+    generatorEdit->setToolTip("The generator should print a test of size {n} to stdout");
+    minNEdit = new QLineEdit("1000");
+    maxNEdit = new QLineEdit("100000");
+    limitNEdit = new QLineEdit("200000");
+    limitNEdit->setToolTip("The maximum n of the problem, the running time is extrapolated to it");
+    stepsSpin = new QSpinBox();
+    stepsSpin->setRange(3, 30);
+    stepsSpin->setValue(8);
+    stepsSpin->setPrefix("Sizes: ");
+    repetitionsSpin = new QSpinBox();
+    repetitionsSpin->setRange(1, 20);
+    repetitionsSpin->setValue(3);
+    repetitionsSpin->setPrefix("Repetitions: ");
+    startButton = new QPushButton("Start");
+    closeButton = new QPushButton("Close");
+    chart = new LineChart();
+    chart->setLogScale(true, true);
+    chart->setAxisTitles("n", "CPU time (ms)");
+    verdictLabel = new QLabel();
+    verdictLabel->setWordWrap(true);
+    verdictLabel->setTextFormat(Qt::RichText);
+    verdictLabel->setTextInteractionFlags(Qt::TextSelectableByMouse);
+
+    nLayout->addWidget(minNEdit);
+    nLayout->addWidget(new QLabel("to"));
+    nLayout->addWidget(maxNEdit);
+    formLayout->addRow("Generator", generatorEdit);
+    formLayout->addRow("Measured n", nLayout);
+    formLayout->addRow("Maximum n", limitNEdit);
+    buttonsLayout->addWidget(stepsSpin);
+    buttonsLayout->addWidget(repetitionsSpin);
+    buttonsLayout->addStretch();
+    buttonsLayout->addWidget(startButton);
+    buttonsLayout->addWidget(closeButton);
+    mainLayout->addLayout(formLayout);
+    mainLayout->addLayout(buttonsLayout);
+    mainLayout->addWidget(chart, 1);
+    mainLayout->addWidget(verdictLabel);
+
+    connect(startButton, SIGNAL(clicked()), this, SLOT(on_startButton_clicked()));
+    connect(closeButton, SIGNAL(clicked()), this, SLOT(on_closeButton_clicked()));
+}
+
+void ComplexityWidget::setTarget(const QString &filePath, const QString &lang, const QString &runCommand,
+                                 const QString &args, int timeLimit)
+{
+    if (profiler != nullptr)
+        delete profiler;
+    this->timeLimit = timeLimit;
+    profiler = new Core::ComplexityProfiler(filePath, lang, runCommand, args, timeLimit, this);
+    connect(profiler, SIGNAL(sampleMeasured(qint64, int, bool)), this, SLOT(onSampleMeasured(qint64, int, bool)));
+    connect(profiler, SIGNAL(profilingFinished()), this, SLOT(onProfilingFinished()));
+    connect(profiler, SIGNAL(errorOccured(const QString &)), this, SLOT(onErrorOccured(const QString &)));
+    startButton->setText("Start");
+    chart->clear();
+    verdictLabel->setText("Time limit: " + QString::number(timeLimit) + "ms");
+}
+
+void ComplexityWidget::setFileIO(const QString &inputFileName, const QString &outputFileName)
+{
+    if (profiler != nullptr)
+        profiler->setFileIO(inputFileName, outputFileName);
+}
+
+void ComplexityWidget::setGeneratorCommand(const QString &command)
+{
+    if (generatorEdit->text().isEmpty())
+        generatorEdit->setText(command);
+}
+
+void ComplexityWidget::on_startButton_clicked()
+{
+    if (profiler == nullptr)
+        return;
+
+    if (profiler->isRunning())
+    {
+        profiler->stop();
+        onProfilingFinished();
+        return;
+    }
+
+    bool minOk, maxOk, limitOk;
+    qint64 minN = minNEdit->text().toLongLong(&minOk);
+    qint64 measuredMaxN = maxNEdit->text().toLongLong(&maxOk);
+    maxN = limitNEdit->text().toLongLong(&limitOk);
+    if (!minOk || !maxOk || !limitOk || minN < 1 || minN >= measuredMaxN || maxN < 1)
+    {
+        QMessageBox::warning(this, "Complexity", "The measured n should be a valid range of positive integers, and "
+                                                 "the maximum n should be a positive integer.");
+        return;
+    }
+    if (generatorEdit->text().trimmed().isEmpty())
+    {
+        QMessageBox::warning(this, "Complexity", "Please set the generator command.");
+        return;
+    }
+
+    emit generatorCommandChanged(generatorEdit->text());
+    startButton->setText("Stop");
+    chart->clear();
+    verdictLabel->setText("Measuring...");
+    profiler->start(generatorEdit->text(), minN, measuredMaxN, stepsSpin->value(), repetitionsSpin->value());
+}
+
+void ComplexityWidget::on_closeButton_clicked()
+{
+    if (profiler != nullptr)
+        profiler->stop();
+    startButton->setText("Start");
+    hide();
+}
+
+void ComplexityWidget::onSampleMeasured(qint64 n, int cpuTime, bool timedOut)
+{
+    updateChart(false);
+    verdictLabel->setText("n = " + QString::number(n) + ": " + QString::number(cpuTime) + "ms" +
+                          (timedOut ? " (time limit exceeded)" : ""));
+}
+
+void ComplexityWidget::onProfilingFinished()
+{
+    startButton->setText("Start");
+    updateChart(true);
+    verdictLabel->setText(verdict());
+}
+
+void ComplexityWidget::onErrorOccured(const QString &error)
+{
+    QMessageBox::warning(this, "Complexity", error);
+}
+
+void ComplexityWidget::updateChart(bool withFit)
+{
+    auto samples = profiler->samples();
+    QVector<LineChart::Series> series;
+
+    LineChart::Series measured;
+    measured.name = "Measured";
+    measured.markers = true;
+    measured.color = QColor(0, 120, 215);
+    for (auto const &sample : samples)
+        measured.points.push_back(QPointF(sample.n, qMax(1, sample.cpuTime)));
+    series.push_back(measured);
+
+    auto fits = Core::ComplexityProfiler::fit(samples);
+    if (withFit && !samples.isEmpty() && fits.front().valid)
+    {
+        auto best = fits.front();
+        LineChart::Series fitted;
+        fitted.name = best.name() + " fit";
+        fitted.color = QColor(230, 120, 0);
+        fitted.dashed = true;
+        const int points = 32;
+        double first = samples.front().n, last = qMax(maxN, samples.back().n);
+        double ratio = std::pow(last / first, 1.0 / points);
+        for (int i = 0; i <= points; ++i)
+        {
+            double n = first * std::pow(ratio, i);
+            fitted.points.push_back(QPointF(n, qMax(1.0, best.predict(static_cast<qint64>(n)))));
+        }
+        series.push_back(fitted);
+    }
+
+    chart->setSeries(series);
+
+    LineChart::Marker limit;
+    limit.value = timeLimit;
+    limit.label = "Time limit";
+    chart->setMarkers({limit});
+}
+
+QString ComplexityWidget::verdict() const
+{
+    auto samples = profiler->samples();
+    if (samples.isEmpty())
+        return "No measurement";
+
+    if (samples.back().timedOut)
+    {
+        return "<span style=\"color:red\">Time limit exceeded already on n = " + QString::number(samples.back().n) +
+               "</span>";
+    }
+
+    auto fits = Core::ComplexityProfiler::fit(samples);
+    auto best = fits.front();
+    if (!best.valid)
+    {
+        return "The solution is too fast to be measured on these sizes (" + QString::number(samples.back().cpuTime) +
+               "ms on n = " + QString::number(samples.back().n) + "). Try larger inputs.";
+    }
+
+    // the slope in the log-log scale of the two largest measurable sizes shows the growth rate directly
+    QString slope;
+    if (samples.size() >= 2 && samples[samples.size() - 2].cpuTime >= Core::ComplexityProfiler::MIN_MEASURABLE_TIME)
+    {
+        auto const &a = samples[samples.size() - 2], &b = samples.back();
+        slope = ", local exponent " +
+                QString::number(std::log(static_cast<double>(b.cpuTime) / a.cpuTime) /
+                                    std::log(static_cast<double>(b.n) / a.n),
+                                'f', 2);
+    }
+
+    double predicted = best.predict(maxN);
+    QString color = "green", conclusion = "should pass";
+    if (predicted > timeLimit)
+    {
+        color = "red";
+        conclusion = "is likely to exceed the time limit";
+    }
+    else if (predicted * 2 > timeLimit)
+    {
+        color = "orange";
+        conclusion = "is close to the time limit";
+    }
+
+    QString result = "Looks like <b>" + best.name() + "</b> (fit error " + QString::number(best.error * 100, 'f', 1) +
+                     "%" + slope + ").<br>Predicted time on n = " + QString::number(maxN) + ": <span style=\"color:" +
+                     color + "\">" + formatPrediction(predicted) + "</span> of the time limit " +
+                     QString::number(timeLimit) + "ms, it " + conclusion + ".";
+    if (fits.size() >= 2 && fits[1].valid && fits[1].error < best.error * 1.2)
+    {
+        result += "<br>" + fits[1].name() + " fits almost as well and predicts " +
+                  formatPrediction(fits[1].predict(maxN)) + ", measure larger sizes to tell them apart.";
+    }
+    return result;
+}
+
+QString ComplexityWidget::formatPrediction(double milliseconds)
+{
+    // a quadratic or cubic fit reaches billions of milliseconds on the maximum n, which doesn't fit in an int
+    const double limit = 1e7;
+    if (!(milliseconds < limit))
+        return "more than " + QString::number(limit / 1000, 'f', 0) + "s";
+    return QString::number(std::llround(qMax(0.0, milliseconds))) + "ms";
+}
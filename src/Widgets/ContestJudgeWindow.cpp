@@ -0,0 +1,202 @@
+/*
+ * Copyright (C) 2019-2020 Ashar Khan <ashar786khan@gmail.com>
+ *
+ * This file is part of CPEditor.
+ *
+ * CPEditor is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * I will not be responsible if CPEditor behaves in unexpected way and
+ * causes your ratings to go down and or loose any important contest.
+ *
+ * Believe Software is "Software" and it isn't immune to bugs.
+ *
+ */
+
+#include "Widgets/ContestJudgeWindow.hpp"
+#include <QHeaderView>
+#include <QVBoxLayout>
+
+ContestJudgeWindow::ContestJudgeWindow(QWidget *parent) : QMainWindow(parent)
+{
+    auto widget = new QWidget(this);
+    auto mainLayout = new QVBoxLayout(widget);
+
+    summaryLabel = new QLabel();
+    matrix = new QTableWidget(0, 2);
+    matrix->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    matrix->setSelectionMode(QAbstractItemView::SingleSelection);
+    matrix->verticalHeader()->hide();
+    matrix->setWordWrap(true);
+
+    mainLayout->addWidget(summaryLabel);
+    mainLayout->addWidget(matrix);
+
+    setCentralWidget(widget);
+    setWindowTitle("Judge All Tabs");
+    resize(800, 400);
+
+    connect(matrix, SIGNAL(cellClicked(int, int)), this, SLOT(onCellClicked(int, int)));
+}
+
+void ContestJudgeWindow::judge(const QVector<MainWindow *> &tabs)
+{
+    for (auto const &window : windows)
+    {
+        if (window != nullptr)
+            disconnect(window, SIGNAL(judgeUpdated(MainWindow *)), this, SLOT(onJudgeUpdated(MainWindow *)));
+    }
+    windows.clear();
+
+    for (auto tab : tabs)
+    {
+        windows.push_back(tab);
+        connect(tab, SIGNAL(judgeUpdated(MainWindow *)), this, SLOT(onJudgeUpdated(MainWindow *)));
+    }
+    matrix->setRowCount(windows.size());
+    matrix->setColumnCount(2);
+
+    // all the tabs are started at once, the compilations and the runs are queued by the scheduler
+    for (auto tab : tabs)
+        tab->judge();
+
+    for (int i = 0; i < windows.size(); ++i)
+        updateRow(i);
+    updateSummary();
+}
+
+void ContestJudgeWindow::onJudgeUpdated(MainWindow *window)
+{
+    int row = windows.indexOf(window);
+    if (row == -1)
+        return;
+    updateRow(row);
+    updateSummary();
+}
+
+void ContestJudgeWindow::onCellClicked(int row, int column)
+{
+    if (row < 0 || row >= windows.size() || windows[row] == nullptr)
+        return;
+    auto window = windows[row];
+    emit tabRequested(window);
+
+    int test = column - 2;
+    if (test < 0 || test >= window->judgeResults().size())
+        return;
+    auto verdict = window->judgeResults()[test].verdict;
+    if (!verdict.isEmpty() && verdict != "SKIP" && verdict != "CE")
+        window->showDiff(test);
+}
+
+void ContestJudgeWindow::updateRow(int row)
+{
+    auto window = windows[row];
+    if (window == nullptr)
+    {
+        matrix->setItem(row, 1, new QTableWidgetItem("Closed"));
+        return;
+    }
+
+    auto results = window->judgeResults();
+    if (matrix->columnCount() < results.size() + 2)
+    {
+        matrix->setColumnCount(results.size() + 2);
+        QStringList headers = {"Problem", "Verdict"};
+        for (int i = 0; i + 2 < matrix->columnCount(); ++i)
+            headers.push_back("#" + QString::number(i + 1));
+        matrix->setHorizontalHeaderLabels(headers);
+    }
+
+    matrix->setItem(row, 0, new QTableWidgetItem(window->getTabTitle(false, false)));
+    auto problem = problemVerdict(results, window->isJudging());
+    auto problemItem = new QTableWidgetItem(problem);
+    problemItem->setBackground(verdictColor(problem == "Accepted" ? "AC" : (problem == "Rejected" ? "WA" : problem)));
+    matrix->setItem(row, 1, problemItem);
+
+    for (int i = 0; i + 2 < matrix->columnCount(); ++i)
+    {
+        if (i >= results.size())
+        {
+            delete matrix->takeItem(row, i + 2);
+            continue;
+        }
+        auto const &result = results[i];
+        QString text = result.verdict.isEmpty() ? "..." : result.verdict;
+        if (result.timeUsed >= 0)
+            text += "\n" + QString::number(result.timeUsed) + "ms";
+        if (result.peakMemory >= 0)
+            text += (result.timeUsed >= 0 ? ", " : "\n") + formatMemory(result.peakMemory);
+        auto item = new QTableWidgetItem(text);
+        item->setBackground(verdictColor(result.verdict));
+        item->setTextAlignment(Qt::AlignCenter);
+        if (!result.verdict.isEmpty() && result.verdict != "SKIP" && result.verdict != "CE")
+            item->setToolTip("Click to show the diff of the output and the expected output");
+        matrix->setItem(row, i + 2, item);
+    }
+    matrix->resizeRowToContents(row);
+}
+
+void ContestJudgeWindow::updateSummary()
+{
+    int judging = 0, accepted = 0;
+    for (auto const &window : windows)
+    {
+        if (window == nullptr)
+            continue;
+        if (window->isJudging())
+            ++judging;
+        else if (problemVerdict(window->judgeResults(), false) == "Accepted")
+            ++accepted;
+    }
+    if (judging > 0)
+        summaryLabel->setText("Judging " + QString::number(judging) + " of " + QString::number(windows.size()) +
+                              " problems...");
+    else
+        summaryLabel->setText(QString::number(accepted) + " of " + QString::number(windows.size()) +
+                              " problems pass all the tests");
+}
+
+QString ContestJudgeWindow::problemVerdict(const QVector<MainWindow::JudgeResult> &results, bool judging)
+{
+    if (judging)
+        return "Judging";
+    bool unchecked = false, tested = false;
+    for (auto const &result : results)
+    {
+        if (result.verdict == "CE")
+            return "CE";
+        if (result.verdict == "SKIP")
+            continue;
+        tested = true;
+        if (result.verdict == "OK")
+            unchecked = true;
+        else if (result.verdict != "AC")
+            return "Rejected";
+    }
+    if (!tested)
+        return "No tests";
+    return unchecked ? "Unchecked" : "Accepted";
+}
+
+QColor ContestJudgeWindow::verdictColor(const QString &verdict)
+{
+    if (verdict == "AC")
+        return QColor(200, 240, 200);
+    if (verdict == "WA" || verdict == "RE")
+        return QColor(250, 200, 200);
+    if (verdict == "TLE")
+        return QColor(250, 225, 180);
+    if (verdict == "MLE")
+        return QColor(240, 210, 240);
+    if (verdict == "CE" || verdict == "FAIL")
+        return QColor(220, 220, 220);
+    return QColor(Qt::transparent);
+}
+
+QString ContestJudgeWindow::formatMemory(qint64 bytes)
+{
+    return QString::number(bytes / 1024.0 / 1024.0, 'f', 1) + "MB";
+}
@@ -0,0 +1,150 @@
+/*
+ * Copyright (C) 2019-2020 Ashar Khan <ashar786khan@gmail.com>
+ *
+ * This file is part of CPEditor.
+ *
+ * CPEditor is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * I will not be responsible if CPEditor behaves in unexpected way and
+ * causes your ratings to go down and or loose any important contest.
+ *
+ * Believe Software is "Software" and it isn't immune to bugs.
+ *
+ */
+
+#include "Widgets/HeatGutter.hpp"
+#include <QAbstractTextDocumentLayout>
+#include <QHelpEvent>
+#include <QPainter>
+#include <QScrollBar>
+#include <QTextBlock>
+#include <QToolTip>
+#include <cmath>
+
+HeatGutter::HeatGutter(QTextEdit *editor, QWidget *parent) : QWidget(parent), editor(editor)
+{
+    hide();
+    connect(editor->verticalScrollBar(), SIGNAL(valueChanged(int)), this, SLOT(update()));
+    // the lines shift when the text is edited, so the profile doesn't apply any more
+    connect(editor, SIGNAL(textChanged()), this, SLOT(clear()));
+}
+
+void HeatGutter::setHeat(const QVector<double> &heat)
+{
+    this->heat = heat;
+    counts.clear();
+    maxHeat = 0;
+    for (auto value : heat)
+        maxHeat = qMax(maxHeat, value);
+    setVisible(maxHeat > 0);
+    update();
+}
+
+void HeatGutter::setCounts(const QVector<qint64> &counts)
+{
+    // the inner loops run orders of magnitude more often than the rest, so the colors are in the log scale
+    QVector<double> logarithms;
+    for (auto count : counts)
+        logarithms.push_back(count > 0 ? std::log10(count + 1.0) : 0);
+    setHeat(logarithms);
+    this->counts = counts;
+}
+
+QSize HeatGutter::sizeHint() const
+{
+    return QSize(fontMetrics().horizontalAdvance("100.0%") + 8, 0);
+}
+
+void HeatGutter::clear()
+{
+    heat.clear();
+    counts.clear();
+    maxHeat = 0;
+    hide();
+}
+
+void HeatGutter::paintEvent(QPaintEvent *event)
+{
+    QPainter painter(this);
+    painter.fillRect(rect(), palette().window());
+    if (maxHeat <= 0)
+        return;
+
+    auto block = editor->cursorForPosition(QPoint(0, 0)).block();
+    for (; block.isValid(); block = block.next())
+    {
+        auto range = lineRange(block.blockNumber());
+        if (range.first > height())
+            break;
+        double value = heat.value(block.blockNumber());
+        if (value <= 0)
+            continue;
+
+        // the hottest line is full red, the others are scaled relative to it
+        QColor color(230, 30, 0);
+        color.setAlphaF(0.15 + 0.85 * value / maxHeat);
+        QRect bar(0, range.first, width(), range.second - range.first);
+        painter.fillRect(bar, color);
+        painter.setPen(palette().color(QPalette::Text));
+        painter.drawText(bar.adjusted(2, 0, -2, 0), Qt::AlignRight | Qt::AlignVCenter, label(block.blockNumber()));
+    }
+}
+
+bool HeatGutter::event(QEvent *event)
+{
+    if (event->type() == QEvent::ToolTip)
+    {
+        auto helpEvent = static_cast<QHelpEvent *>(event);
+        int line = lineAt(helpEvent->pos().y());
+        if (line >= 0 && heat.value(line) > 0)
+        {
+            QString text = counts.isEmpty() ? QString::number(heat[line] * 100, 'f', 2) + "% of the samples"
+                                            : "executed " + QString::number(counts[line]) + " times";
+            QToolTip::showText(helpEvent->globalPos(), "Line " + QString::number(line + 1) + ": " + text);
+        }
+        else
+        {
+            QToolTip::hideText();
+            event->ignore();
+        }
+        return true;
+    }
+    return QWidget::event(event);
+}
+
+QPair<int, int> HeatGutter::lineRange(int line) const
+{
+    auto block = editor->document()->findBlockByNumber(line);
+    auto rect = editor->document()->documentLayout()->blockBoundingRect(block);
+    int scroll = editor->verticalScrollBar()->value();
+    int top = mapFromGlobal(editor->viewport()->mapToGlobal(QPoint(0, static_cast<int>(rect.top()) - scroll))).y();
+    return qMakePair(top, top + static_cast<int>(rect.height()));
+}
+
+int HeatGutter::lineAt(int y) const
+{
+    auto point = editor->viewport()->mapFromGlobal(mapToGlobal(QPoint(0, y)));
+    if (point.y() < 0 || point.y() >= editor->viewport()->height())
+        return -1;
+    return editor->cursorForPosition(QPoint(0, point.y())).blockNumber();
+}
+
+QString HeatGutter::label(int line) const
+{
+    if (counts.isEmpty())
+    {
+        double value = heat.value(line);
+        return QString::number(value * 100, 'f', value < 0.1 ? 2 : 1) + "%";
+    }
+    qint64 count = counts.value(line);
+    if (count >= 1000000000)
+        return QString::number(count / 1e9, 'f', 1) + "G";
+    if (count >= 1000000)
+        return QString::number(count / 1e6, 'f', 1) + "M";
+    if (count >= 10000)
+        return QString::number(count / 1e3, 'f', 1) + "k";
+    return QString::number(count);
+}
@@ -0,0 +1,214 @@
+/*
+ * Copyright (C) 2019-2020 Ashar Khan <ashar786khan@gmail.com>
+ *
+ * This file is part of CPEditor.
+ *
+ * CPEditor is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * I will not be responsible if CPEditor behaves in unexpected way and
+ * causes your ratings to go down and or loose any important contest.
+ *
+ * Believe Software is "Software" and it isn't immune to bugs.
+ *
+ */
+
+#include "Widgets/LineChart.hpp"
+#include <QPainter>
+#include <QPainterPath>
+#include <cmath>
+
+LineChart::LineChart(QWidget *parent) : QWidget(parent)
+{
+    setMinimumSize(200, 120);
+}
+
+void LineChart::setSeries(const QVector<Series> &series)
+{
+    this->series = series;
+    update();
+}
+
+void LineChart::setMarkers(const QVector<Marker> &markers)
+{
+    this->markers = markers;
+    update();
+}
+
+void LineChart::setAxisTitles(const QString &x, const QString &y)
+{
+    xTitle = x;
+    yTitle = y;
+    update();
+}
+
+void LineChart::setLogScale(bool x, bool y)
+{
+    logX = x;
+    logY = y;
+    update();
+}
+
+void LineChart::clear()
+{
+    series.clear();
+    markers.clear();
+    update();
+}
+
+QSize LineChart::sizeHint() const
+{
+    return QSize(400, 250);
+}
+
+void LineChart::paintEvent(QPaintEvent *event)
+{
+    QPainter painter(this);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.fillRect(rect(), palette().base());
+
+    auto metrics = painter.fontMetrics();
+    QRectF area = QRectF(rect()).adjusted(metrics.height() * 4, metrics.height(), -metrics.height(),
+                                          -metrics.height() * 3);
+    if (area.width() <= 0 || area.height() <= 0)
+        return;
+
+    bool empty = true;
+    double minX = 0, maxX = 0, minY = 0, maxY = 0;
+    auto include = [&](double x, double y) {
+        if ((logX && x <= 0) || (logY && y <= 0))
+            return;
+        x = transformX(x);
+        y = transformY(y);
+        if (empty)
+        {
+            minX = maxX = x;
+            minY = maxY = y;
+            empty = false;
+        }
+        minX = qMin(minX, x);
+        maxX = qMax(maxX, x);
+        minY = qMin(minY, y);
+        maxY = qMax(maxY, y);
+    };
+    for (auto const &s : series)
+        for (auto const &point : s.points)
+            include(point.x(), point.y());
+    if (empty)
+    {
+        painter.setPen(palette().color(QPalette::Disabled, QPalette::Text));
+        painter.drawText(area, Qt::AlignCenter, "No data");
+        return;
+    }
+    for (auto const &marker : markers)
+        include(logX ? std::pow(10.0, minX) : minX, marker.value);
+    if (!logY)
+        minY = qMin(minY, 0.0);
+    if (maxX - minX < 1e-9)
+        maxX = minX + 1;
+    if (maxY - minY < 1e-9)
+        maxY = minY + 1;
+
+    auto toScreen = [&](double x, double y) {
+        return QPointF(area.left() + (transformX(x) - minX) / (maxX - minX) * area.width(),
+                       area.bottom() - (transformY(y) - minY) / (maxY - minY) * area.height());
+    };
+
+    // axes and labels
+    QColor textColor = palette().color(QPalette::Text);
+    painter.setPen(textColor);
+    painter.drawLine(area.bottomLeft(), area.bottomRight());
+    painter.drawLine(area.bottomLeft(), area.topLeft());
+    const int ticks = 4;
+    for (int i = 0; i <= ticks; ++i)
+    {
+        double x = minX + (maxX - minX) * i / ticks, y = minY + (maxY - minY) * i / ticks;
+        double sx = area.left() + area.width() * i / ticks, sy = area.bottom() - area.height() * i / ticks;
+        painter.drawLine(QPointF(sx, area.bottom()), QPointF(sx, area.bottom() + 3));
+        painter.drawLine(QPointF(area.left() - 3, sy), QPointF(area.left(), sy));
+        painter.drawText(QRectF(sx - 50, area.bottom() + 4, 100, metrics.height()), Qt::AlignHCenter,
+                         formatValue(logX ? std::pow(10.0, x) : x));
+        painter.drawText(QRectF(0, sy - metrics.height() / 2.0, area.left() - 5, metrics.height()), Qt::AlignRight,
+                         formatValue(logY ? std::pow(10.0, y) : y));
+    }
+    painter.drawText(QRectF(area.left(), area.bottom() + metrics.height() + 4, area.width(), metrics.height()),
+                     Qt::AlignHCenter, xTitle);
+    painter.drawText(QRectF(area.left() + 4, area.top(), area.width(), metrics.height()), Qt::AlignLeft, yTitle);
+
+    painter.setClipRect(area.adjusted(-4, -4, 4, 4));
+
+    for (auto const &marker : markers)
+    {
+        if (logY && marker.value <= 0)
+            continue;
+        double y = toScreen(logX ? std::pow(10.0, minX) : minX, marker.value).y();
+        painter.setPen(QPen(marker.color, 1, Qt::DotLine));
+        painter.drawLine(QPointF(area.left(), y), QPointF(area.right(), y));
+        painter.drawText(QRectF(area.left(), y - metrics.height(), area.width() - 4, metrics.height()), Qt::AlignRight,
+                         marker.label);
+    }
+
+    // the series, with a legend at the top left corner
+    int legendY = static_cast<int>(area.top()) + metrics.height();
+    for (auto const &s : series)
+    {
+        QPainterPath path;
+        bool started = false;
+        for (auto const &point : s.points)
+        {
+            if ((logX && point.x() <= 0) || (logY && point.y() <= 0))
+                continue;
+            auto position = toScreen(point.x(), point.y());
+            if (started)
+                path.lineTo(position);
+            else
+                path.moveTo(position);
+            started = true;
+        }
+        painter.setPen(QPen(s.color, 2, s.dashed ? Qt::DashLine : Qt::SolidLine));
+        painter.setBrush(Qt::NoBrush);
+        if (!s.markers)
+            painter.drawPath(path);
+        else
+        {
+            painter.setBrush(s.color);
+            for (auto const &point : s.points)
+            {
+                if ((logX && point.x() <= 0) || (logY && point.y() <= 0))
+                    continue;
+                painter.drawEllipse(toScreen(point.x(), point.y()), 3, 3);
+            }
+        }
+
+        if (!s.name.isEmpty())
+        {
+            legendY += metrics.height();
+            painter.setPen(s.color);
+            painter.drawText(QPointF(area.left() + 8, legendY), s.name);
+        }
+    }
+}
+
+double LineChart::transformX(double x) const
+{
+    return logX ? std::log10(x) : x;
+}
+
+double LineChart::transformY(double y) const
+{
+    return logY ? std::log10(y) : y;
+}
+
+QString LineChart::formatValue(double value)
+{
+    double absolute = std::abs(value);
+    if (absolute >= 1e9)
+        return QString::number(value / 1e9, 'g', 3) + "G";
+    if (absolute >= 1e6)
+        return QString::number(value / 1e6, 'g', 3) + "M";
+    if (absolute >= 1e4)
+        return QString::number(value / 1e3, 'g', 3) + "k";
+    return QString::number(value, 'g', 3);
+}
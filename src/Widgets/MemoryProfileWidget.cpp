@@ -0,0 +1,265 @@
+/*
+ * Copyright (C) 2019-2020 Ashar Khan <ashar786khan@gmail.com>
+ *
+ * This file is part of CPEditor.
+ *
+ * CPEditor is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * I will not be responsible if CPEditor behaves in unexpected way and
+ * causes your ratings to go down and or loose any important contest.
+ *
+ * Believe Software is "Software" and it isn't immune to bugs.
+ *
+ */
+
+#include "Widgets/MemoryProfileWidget.hpp"
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QMessageBox>
+#include <QVBoxLayout>
+
+namespace
+{
+// sorted by the number in Qt::UserRole instead of the displayed text
+class NumberItem : public QTableWidgetItem
+{
+  public:
+    NumberItem(const QString &text, double value) : QTableWidgetItem(text)
+    {
+        setData(Qt::UserRole, value);
+    }
+
+    bool operator<(const QTableWidgetItem &other) const override
+    {
+        return data(Qt::UserRole).toDouble() < other.data(Qt::UserRole).toDouble();
+    }
+};
+} // namespace
+
+MemoryProfileWidget::MemoryProfileWidget(QWidget *parent) : QWidget(parent)
+{
+    auto mainLayout = new QVBoxLayout(this);
+    auto controlsLayout = new QHBoxLayout();
+
+    profiler = new Core::MemoryProfiler(this);
+    testCombo = new QComboBox();
+    intervalSpin = new QSpinBox();
+    intervalSpin->setRange(1, 1000);
+    intervalSpin->setValue(10);
+    intervalSpin->setPrefix("Every ");
+    intervalSpin->setSuffix("ms");
+    intervalSpin->setToolTip("The interval of the samples of the resident memory");
+    allocationsCheck = new QCheckBox("Track allocations");
+    startButton = new QPushButton("Start");
+    closeButton = new QPushButton("Close");
+    chart = new LineChart();
+    chart->setAxisTitles("Time (ms)", "Resident memory (MB)");
+    verdictLabel = new QLabel();
+    verdictLabel->setWordWrap(true);
+    verdictLabel->setTextFormat(Qt::RichText);
+    verdictLabel->setTextInteractionFlags(Qt::TextSelectableByMouse);
+
+    allocatorsTable = new QTableWidget(0, 5);
+    allocatorsTable->setHorizontalHeaderLabels({"Function", "Location", "Allocations", "Allocated", "Peak Live"});
+    allocatorsTable->horizontalHeader()->setSectionResizeMode(0, QHeaderView::Stretch);
+    allocatorsTable->verticalHeader()->hide();
+    allocatorsTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    allocatorsTable->setSelectionBehavior(QAbstractItemView::SelectRows);
+    allocatorsTable->hide();
+
+    if (Core::MemoryProfiler::shimPath().isEmpty())
+    {
+        allocationsCheck->setEnabled(false);
+        allocationsCheck->setToolTip("The memory shim is not built with the editor");
+    }
+    else
+        allocationsCheck->setToolTip("Count the allocations of each call site with a preloaded library, C++ only");
+
+    controlsLayout->addWidget(testCombo);
+    controlsLayout->addWidget(intervalSpin);
+    controlsLayout->addWidget(allocationsCheck);
+    controlsLayout->addStretch();
+    controlsLayout->addWidget(startButton);
+    controlsLayout->addWidget(closeButton);
+    mainLayout->addLayout(controlsLayout);
+    mainLayout->addWidget(chart, 1);
+    mainLayout->addWidget(verdictLabel);
+    mainLayout->addWidget(allocatorsTable, 1);
+
+    connect(startButton, SIGNAL(clicked()), this, SLOT(on_startButton_clicked()));
+    connect(closeButton, SIGNAL(clicked()), this, SLOT(on_closeButton_clicked()));
+    connect(profiler, SIGNAL(sampleTaken(int, qint64)), this, SLOT(onSampleTaken(int, qint64)));
+    connect(profiler, SIGNAL(profilingFinished()), this, SLOT(onProfilingFinished()));
+    connect(profiler, SIGNAL(errorOccured(const QString &)), this, SLOT(onErrorOccured(const QString &)));
+}
+
+void MemoryProfileWidget::setTarget(const QString &filePath, const QString &lang, const QString &runCommand,
+                                    const QString &args, int timeLimit, int memoryLimit, const QStringList &inputs)
+{
+    profiler->stop();
+    this->filePath = filePath;
+    this->lang = lang;
+    this->runCommand = runCommand;
+    this->args = args;
+    this->timeLimit = timeLimit;
+    this->memoryLimit = memoryLimit;
+    this->inputs = inputs;
+
+    testCombo->clear();
+    for (int i = 0; i < inputs.size(); ++i)
+    {
+        if (!inputs[i].trimmed().isEmpty())
+            testCombo->addItem("Test " + QString::number(i + 1), i);
+    }
+    if (testCombo->count() == 0)
+        testCombo->addItem("Empty input", -1);
+
+    startButton->setText("Start");
+    chart->clear();
+    allocatorsTable->setRowCount(0);
+    allocatorsTable->hide();
+    verdictLabel->setText(memoryLimit > 0 ? "Memory limit: " + QString::number(memoryLimit) + "MB"
+                                          : "The memory limit of the problem is unknown");
+}
+
+void MemoryProfileWidget::setFileIO(const QString &inputFileName, const QString &outputFileName)
+{
+    profiler->setFileIO(inputFileName, outputFileName);
+}
+
+void MemoryProfileWidget::on_startButton_clicked()
+{
+    if (profiler->isRunning())
+    {
+        profiler->stop();
+        onProfilingFinished();
+        return;
+    }
+
+    int index = testCombo->currentData().toInt();
+    startButton->setText("Stop");
+    chart->clear();
+    allocatorsTable->setRowCount(0);
+    allocatorsTable->setVisible(allocationsCheck->isChecked());
+    verdictLabel->setText("Running...");
+    // the run is only stopped well after the time limit, so that the memory of a slow solution is still shown
+    profiler->start(filePath, lang, runCommand, args, index >= 0 ? inputs[index] : QString(),
+                    qMax(timeLimit * 5, 10000), intervalSpin->value(), allocationsCheck->isChecked());
+}
+
+void MemoryProfileWidget::on_closeButton_clicked()
+{
+    profiler->stop();
+    startButton->setText("Start");
+    hide();
+}
+
+void MemoryProfileWidget::onSampleTaken(int time, qint64 rss)
+{
+    updateChart();
+    verdictLabel->setText(QString::number(time) + "ms: " + formatBytes(rss));
+}
+
+void MemoryProfileWidget::onProfilingFinished()
+{
+    startButton->setText("Start");
+    updateChart();
+    verdictLabel->setText(verdict());
+
+    auto profile = profiler->profile();
+    allocatorsTable->setSortingEnabled(false);
+    allocatorsTable->setRowCount(profile.allocators.size());
+    for (int i = 0; i < profile.allocators.size(); ++i)
+    {
+        auto const &allocator = profile.allocators[i];
+        auto functionItem = new QTableWidgetItem(allocator.function);
+        functionItem->setToolTip(allocator.function);
+        allocatorsTable->setItem(i, 0, functionItem);
+        allocatorsTable->setItem(i, 1, new QTableWidgetItem(allocator.location));
+        allocatorsTable->setItem(i, 2, new NumberItem(QString::number(allocator.count), allocator.count));
+        allocatorsTable->setItem(i, 3, new NumberItem(formatBytes(allocator.totalBytes), allocator.totalBytes));
+        allocatorsTable->setItem(i, 4, new NumberItem(formatBytes(allocator.peakLive), allocator.peakLive));
+    }
+    allocatorsTable->setSortingEnabled(true);
+    allocatorsTable->sortByColumn(4, Qt::DescendingOrder);
+}
+
+void MemoryProfileWidget::onErrorOccured(const QString &error)
+{
+    startButton->setText("Start");
+    verdictLabel->setText(error.toHtmlEscaped());
+    QMessageBox::warning(this, "Memory Profile", error);
+}
+
+void MemoryProfileWidget::updateChart()
+{
+    const double megabyte = 1024.0 * 1024.0;
+    LineChart::Series rss;
+    rss.name = "Resident memory";
+    rss.color = QColor(0, 120, 215);
+    for (auto const &sample : profiler->profile().samples)
+        rss.points.push_back(QPointF(sample.time, sample.rss / megabyte));
+    chart->setSeries({rss});
+
+    if (memoryLimit > 0)
+    {
+        LineChart::Marker limit;
+        limit.value = memoryLimit;
+        limit.label = "Memory limit";
+        chart->setMarkers({limit});
+    }
+}
+
+QString MemoryProfileWidget::verdict() const
+{
+    auto profile = profiler->profile();
+    if (profile.samples.isEmpty() && profile.peakMemory == 0)
+        return "The program finished before its memory could be sampled";
+
+    QString result = "Peak resident memory: ";
+    qint64 limit = memoryLimit * 1024LL * 1024LL;
+    if (memoryLimit <= 0)
+        result += "<b>" + formatBytes(profile.peakMemory) + "</b>";
+    else
+    {
+        QString color = "green", conclusion = "should pass";
+        if (profile.peakMemory > limit)
+        {
+            color = "red";
+            conclusion = "exceeds the memory limit";
+        }
+        else if (profile.peakMemory * 10 > limit * 8)
+        {
+            color = "orange";
+            conclusion = "is close to the memory limit";
+        }
+        result += "<span style=\"color:" + color + "\"><b>" + formatBytes(profile.peakMemory) + "</b></span> of " +
+                  QString::number(memoryLimit) + "MB, it " + conclusion;
+    }
+    result += " (" + QString::number(profile.samples.size()) + " samples in " + QString::number(profile.timeUsed) +
+              "ms)";
+
+    if (profile.timedOut)
+        result += "<br>The run was stopped after " + QString::number(profile.timeUsed) + "ms";
+    else if (profile.exitCode != 0)
+        result += "<br>The program exited with code " + QString::number(profile.exitCode);
+    if (profile.peakHeap >= 0)
+        result += "<br>Peak of the live allocations: " + formatBytes(profile.peakHeap);
+    if (profile.shimMemory > 0)
+        result += "<br>The " + formatBytes(profile.shimMemory) + " of the allocation tracking are not counted";
+    if (!profile.allocationError.isEmpty())
+        result += "<br>" + profile.allocationError.toHtmlEscaped();
+    return result;
+}
+
+QString MemoryProfileWidget::formatBytes(qint64 bytes)
+{
+    if (bytes >= 1024 * 1024)
+        return QString::number(bytes / (1024.0 * 1024.0), 'f', 1) + "MB";
+    if (bytes >= 1024)
+        return QString::number(bytes / 1024.0, 'f', 1) + "KB";
+    return QString::number(bytes) + "B";
+}
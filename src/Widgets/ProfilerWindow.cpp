@@ -0,0 +1,155 @@
+/*
+ * Copyright (C) 2019-2020 Ashar Khan <ashar786khan@gmail.com>
+ *
+ * This file is part of CPEditor.
+ *
+ * CPEditor is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * I will not be responsible if CPEditor behaves in unexpected way and
+ * causes your ratings to go down and or loose any important contest.
+ *
+ * Believe Software is "Software" and it isn't immune to bugs.
+ *
+ */
+
+#include "Widgets/ProfilerWindow.hpp"
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QVBoxLayout>
+
+namespace
+{
+// sorted by the number in Qt::UserRole instead of the displayed text
+class NumberItem : public QTableWidgetItem
+{
+  public:
+    NumberItem(const QString &text, double value) : QTableWidgetItem(text)
+    {
+        setData(Qt::UserRole, value);
+    }
+
+    bool operator<(const QTableWidgetItem &other) const override
+    {
+        return data(Qt::UserRole).toDouble() < other.data(Qt::UserRole).toDouble();
+    }
+};
+} // namespace
+
+ProfilerWindow::ProfilerWindow(QWidget *parent) : QMainWindow(parent)
+{
+    auto widget = new QWidget(this);
+    auto mainLayout = new QVBoxLayout(widget);
+    auto statusLayout = new QHBoxLayout();
+
+    profiler = new Core::SamplingProfiler(this);
+    statusLabel = new QLabel();
+    statusLabel->setWordWrap(true);
+    restartButton = new QPushButton("Profile Again");
+
+    functionsTable = new QTableWidget(0, 4);
+    functionsTable->setHorizontalHeaderLabels({"Function", "Self", "Total", "Location"});
+    functionsTable->horizontalHeader()->setSectionResizeMode(0, QHeaderView::Stretch);
+    functionsTable->verticalHeader()->hide();
+    functionsTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    functionsTable->setSelectionBehavior(QAbstractItemView::SelectRows);
+    functionsTable->setToolTip("Double click a function to go to its hottest line");
+
+    statusLayout->addWidget(statusLabel, 1);
+    statusLayout->addWidget(restartButton);
+    mainLayout->addLayout(statusLayout);
+    mainLayout->addWidget(functionsTable);
+
+    setCentralWidget(widget);
+    setWindowTitle("Profiler");
+    resize(700, 450);
+
+    connect(restartButton, SIGNAL(clicked()), this, SLOT(on_restartButton_clicked()));
+    connect(profiler, SIGNAL(statusChanged(const QString &)), this, SLOT(onStatusChanged(const QString &)));
+    connect(profiler, SIGNAL(profilingFinished()), this, SLOT(onProfilingFinished()));
+    connect(profiler, SIGNAL(errorOccured(const QString &)), this, SLOT(onErrorOccured(const QString &)));
+    connect(functionsTable, SIGNAL(cellDoubleClicked(int, int)), this, SLOT(onCellDoubleClicked(int, int)));
+}
+
+void ProfilerWindow::start(const QString &binaryPath, const QString &sourcePath, const QString &input, int timeLimit)
+{
+    this->binaryPath = binaryPath;
+    this->sourcePath = sourcePath;
+    this->input = input;
+    this->timeLimit = timeLimit;
+    functionsTable->setSortingEnabled(false);
+    functionsTable->setRowCount(0);
+    restartButton->setEnabled(false);
+    emit heatChanged(QVector<double>());
+    profiler->start(binaryPath, sourcePath, input, timeLimit);
+}
+
+void ProfilerWindow::setFileIO(const QString &inputFileName, const QString &outputFileName)
+{
+    profiler->setFileIO(inputFileName, outputFileName);
+}
+
+void ProfilerWindow::on_restartButton_clicked()
+{
+    start(binaryPath, sourcePath, input, timeLimit);
+}
+
+void ProfilerWindow::onStatusChanged(const QString &status)
+{
+    statusLabel->setText(status);
+}
+
+void ProfilerWindow::onProfilingFinished()
+{
+    restartButton->setEnabled(true);
+    auto profile = profiler->profile();
+    double samples = qMax(1, profile.samples);
+
+    QString status = QString::number(profile.samples) + " samples in " + QString::number(profile.timeUsed) + "ms";
+    if (profile.timedOut)
+        status += ", the run was stopped at the time limit";
+    if (profile.lost > 0)
+        status += ", " + QString::number(profile.lost) + " samples were lost";
+    statusLabel->setText(status);
+
+    functionsTable->setRowCount(profile.functions.size());
+    for (int i = 0; i < profile.functions.size(); ++i)
+    {
+        auto const &function = profile.functions[i];
+        auto nameItem = new QTableWidgetItem(function.name);
+        nameItem->setData(Qt::UserRole, function.line);
+        nameItem->setToolTip(function.name);
+        functionsTable->setItem(i, 0, nameItem);
+        functionsTable->setItem(
+            i, 1, new NumberItem(QString::number(function.self * 100 / samples, 'f', 1) + "%", function.self));
+        functionsTable->setItem(
+            i, 2, new NumberItem(QString::number(function.total * 100 / samples, 'f', 1) + "%", function.total));
+        functionsTable->setItem(i, 3, new QTableWidgetItem(function.location));
+    }
+    functionsTable->setSortingEnabled(true);
+    functionsTable->sortByColumn(1, Qt::DescendingOrder);
+
+    QVector<double> heat;
+    for (auto it = profile.lines.constBegin(); it != profile.lines.constEnd(); ++it)
+    {
+        if (it.key() >= heat.size())
+            heat.resize(it.key() + 1);
+        heat[it.key()] = it.value() / samples;
+    }
+    emit heatChanged(heat);
+}
+
+void ProfilerWindow::onErrorOccured(const QString &error)
+{
+    restartButton->setEnabled(true);
+    statusLabel->setText("<span style=\"color:red\">" + error.toHtmlEscaped() + "</span>");
+}
+
+void ProfilerWindow::onCellDoubleClicked(int row, int column)
+{
+    auto item = functionsTable->item(row, 0);
+    if (item != nullptr && item->data(Qt::UserRole).toInt() >= 0)
+        emit lineRequested(item->data(Qt::UserRole).toInt());
+}
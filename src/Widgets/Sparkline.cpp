@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2019-2020 Ashar Khan <ashar786khan@gmail.com>
+ *
+ * This file is part of CPEditor.
+ *
+ * CPEditor is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * I will not be responsible if CPEditor behaves in unexpected way and
+ * causes your ratings to go down and or loose any important contest.
+ *
+ * Believe Software is "Software" and it isn't immune to bugs.
+ *
+ */
+
+#include "Widgets/Sparkline.hpp"
+#include <QPainter>
+#include <QPainterPath>
+
+Sparkline::Sparkline(QWidget *parent) : QWidget(parent)
+{
+    setSizePolicy(QSizePolicy::Fixed, QSizePolicy::Fixed);
+    hide();
+}
+
+void Sparkline::setValues(const QVector<int> &values, const QString &unit)
+{
+    this->values = values;
+    QStringList texts;
+    for (auto value : values)
+        texts.push_back(QString::number(value) + unit);
+    setToolTip("The last " + QString::number(values.size()) + " revisions: " + texts.join(", "));
+    setVisible(values.size() >= 2);
+    update();
+}
+
+QSize Sparkline::sizeHint() const
+{
+    return QSize(60, fontMetrics().height());
+}
+
+void Sparkline::paintEvent(QPaintEvent *event)
+{
+    if (values.size() < 2)
+        return;
+
+    QPainter painter(this);
+    painter.setRenderHint(QPainter::Antialiasing);
+    int low = values.front(), high = values.front();
+    for (auto value : values)
+    {
+        low = qMin(low, value);
+        high = qMax(high, value);
+    }
+    // a flat line stays in the middle instead of jumping to an edge
+    if (high == low)
+    {
+        low -= 1;
+        high += 1;
+    }
+
+    QRectF area = QRectF(rect()).adjusted(2, 2, -2, -2);
+    auto pointOf = [&](int i) {
+        return QPointF(area.left() + area.width() * i / (values.size() - 1),
+                       area.bottom() - area.height() * (values[i] - low) / (high - low));
+    };
+    QPainterPath path(pointOf(0));
+    for (int i = 1; i < values.size(); ++i)
+        path.lineTo(pointOf(i));
+    painter.setPen(QPen(palette().color(QPalette::Text), 1));
+    painter.drawPath(path);
+
+    // the last run is red if it's slower than the one before
+    bool slower = values.back() > values[values.size() - 2];
+    painter.setPen(Qt::NoPen);
+    painter.setBrush(slower ? QColor(220, 40, 20) : QColor(20, 150, 40));
+    painter.drawEllipse(pointOf(values.size() - 1), 2, 2);
+}
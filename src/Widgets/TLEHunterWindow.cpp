@@ -0,0 +1,218 @@
+/*
+ * Copyright (C) 2019-2020 Ashar Khan <ashar786khan@gmail.com>
+ *
+ * This file is part of CPEditor.
+ *
+ * CPEditor is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * I will not be responsible if CPEditor behaves in unexpected way and
+ * causes your ratings to go down and or loose any important contest.
+ *
+ * Believe Software is "Software" and it isn't immune to bugs.
+ *
+ */
+
+#include "Widgets/TLEHunterWindow.hpp"
+#include <QFormLayout>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QMessageBox>
+#include <QSet>
+#include <QThread>
+#include <QVBoxLayout>
+
+TLEHunterWindow::TLEHunterWindow(const QString &generatorCommand, QWidget *parent) : QMainWindow(parent)
+{
+    auto widget = new QWidget(this);
+    auto mainLayout = new QVBoxLayout(widget);
+    auto formLayout = new QFormLayout();
+    auto nLayout = new QHBoxLayout();
+    auto valueLayout = new QHBoxLayout();
+    auto budgetLayout = new QHBoxLayout();
+    auto buttonsLayout = new QHBoxLayout();
+
+    generatorEdit = new QLineEdit(generatorCommand);
+    generatorEdit->setPlaceholderText("./gen {n} {min} {max} {seed}");
+    generatorEdit->setToolTip("The generator should print a test to stdout. {n}, {min}, {max} and {seed} are replaced "
+                              "by the parameters of each test.");
+    minNEdit = new QLineEdit("1");
+    maxNEdit = new QLineEdit("200000");
+    minValueEdit = new QLineEdit("1");
+    maxValueEdit = new QLineEdit("1000000000");
+    iterationsSpin = new QSpinBox();
+    iterationsSpin->setRange(1, 100000);
+    iterationsSpin->setValue(60);
+    parallelSpin = new QSpinBox();
+    parallelSpin->setRange(1, 256);
+    parallelSpin->setValue(qMax(1, QThread::idealThreadCount() / 2));
+    startButton = new QPushButton("Start");
+    addButton = new QPushButton("Add to Tests");
+    addButton->setToolTip("Add the selected inputs, or all of them if none is selected, to the test cases");
+    progressBar = new QProgressBar();
+    summaryLabel = new QLabel();
+    summaryLabel->setTextFormat(Qt::RichText);
+
+    resultsTable = new QTableWidget(0, 5);
+    resultsTable->setHorizontalHeaderLabels({"Parameters", "CPU Time", "Memory", "Exit Code", "Verdict"});
+    resultsTable->horizontalHeader()->setSectionResizeMode(0, QHeaderView::Stretch);
+    resultsTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    resultsTable->setSelectionBehavior(QAbstractItemView::SelectRows);
+
+    nLayout->addWidget(minNEdit);
+    nLayout->addWidget(new QLabel("to"));
+    nLayout->addWidget(maxNEdit);
+    valueLayout->addWidget(minValueEdit);
+    valueLayout->addWidget(new QLabel("to"));
+    valueLayout->addWidget(maxValueEdit);
+    budgetLayout->addWidget(iterationsSpin);
+    budgetLayout->addWidget(new QLabel("runs, parallel jobs:"));
+    budgetLayout->addWidget(parallelSpin);
+    formLayout->addRow("Generator", generatorEdit);
+    formLayout->addRow("n", nLayout);
+    formLayout->addRow("Values", valueLayout);
+    formLayout->addRow("Budget", budgetLayout);
+    buttonsLayout->addWidget(progressBar);
+    buttonsLayout->addWidget(startButton);
+    buttonsLayout->addWidget(addButton);
+    mainLayout->addLayout(formLayout);
+    mainLayout->addLayout(buttonsLayout);
+    mainLayout->addWidget(summaryLabel);
+    mainLayout->addWidget(resultsTable);
+
+    setCentralWidget(widget);
+    setWindowTitle("TLE Hunter");
+    resize(800, 600);
+
+    connect(startButton, SIGNAL(clicked()), this, SLOT(on_startButton_clicked()));
+    connect(addButton, SIGNAL(clicked()), this, SLOT(on_addButton_clicked()));
+}
+
+void TLEHunterWindow::setTarget(const QString &filePath, const QString &lang, const QString &runCommand,
+                                const QString &args, int timeLimit)
+{
+    if (hunter != nullptr)
+        delete hunter;
+    this->timeLimit = timeLimit;
+    hunter = new Core::TLEHunter(filePath, lang, runCommand, args, timeLimit, this);
+    connect(hunter, SIGNAL(progress(int, int)), this, SLOT(onProgress(int, int)));
+    connect(hunter, SIGNAL(worstResultsChanged()), this, SLOT(onWorstResultsChanged()));
+    connect(hunter, SIGNAL(huntFinished()), this, SLOT(onHuntFinished()));
+    connect(hunter, SIGNAL(errorOccured(const QString &)), this, SLOT(onErrorOccured(const QString &)));
+    startButton->setText("Start");
+    summaryLabel->setText("Time limit: " + QString::number(timeLimit) + "ms");
+}
+
+void TLEHunterWindow::setFileIO(const QString &inputFileName, const QString &outputFileName)
+{
+    if (hunter != nullptr)
+        hunter->setFileIO(inputFileName, outputFileName);
+}
+
+void TLEHunterWindow::on_startButton_clicked()
+{
+    if (hunter == nullptr)
+        return;
+
+    if (hunter->isRunning())
+    {
+        hunter->stop();
+        onHuntFinished();
+        return;
+    }
+
+    Core::TLEHunter::Parameters lowerBound, upperBound;
+    bool ok[4];
+    lowerBound.n = minNEdit->text().toLongLong(&ok[0]);
+    upperBound.n = maxNEdit->text().toLongLong(&ok[1]);
+    lowerBound.minValue = upperBound.minValue = minValueEdit->text().toLongLong(&ok[2]);
+    lowerBound.maxValue = upperBound.maxValue = maxValueEdit->text().toLongLong(&ok[3]);
+    if (!ok[0] || !ok[1] || !ok[2] || !ok[3] || lowerBound.n > upperBound.n ||
+        lowerBound.minValue > lowerBound.maxValue)
+    {
+        QMessageBox::warning(this, "TLE Hunter", "The bounds of n and of the values should be valid integer ranges.");
+        return;
+    }
+    if (generatorEdit->text().trimmed().isEmpty())
+    {
+        QMessageBox::warning(this, "TLE Hunter", "Please set the generator command.");
+        return;
+    }
+
+    emit generatorCommandChanged(generatorEdit->text());
+    startButton->setText("Stop");
+    hunter->start(generatorEdit->text(), lowerBound, upperBound, iterationsSpin->value(), parallelSpin->value());
+}
+
+void TLEHunterWindow::on_addButton_clicked()
+{
+    if (hunter == nullptr)
+        return;
+    auto results = hunter->worstResults();
+    QSet<int> rows;
+    for (auto item : resultsTable->selectedItems())
+        rows.insert(item->row());
+    for (int i = 0; i < results.size(); ++i)
+    {
+        if (rows.isEmpty() || rows.contains(i))
+            emit addTestCaseRequested(results[i].input);
+    }
+}
+
+void TLEHunterWindow::onProgress(int finished, int total)
+{
+    progressBar->setMaximum(total);
+    progressBar->setValue(finished);
+}
+
+void TLEHunterWindow::onWorstResultsChanged()
+{
+    auto results = hunter->worstResults();
+    resultsTable->setRowCount(results.size());
+    for (int i = 0; i < results.size(); ++i)
+    {
+        auto &result = results[i];
+        QString verdict;
+        if (result.timedOut || result.stats.cpuTime > timeLimit)
+            verdict = "TLE";
+        else if (result.exitCode != 0)
+            verdict = "RE";
+        else if (result.stats.cpuTime * 2 > timeLimit)
+            verdict = "Risky";
+        else
+            verdict = "OK";
+        QString memory = "?";
+        if (result.stats.peakMemory >= 0)
+            memory = QString::number(result.stats.peakMemory / 1024.0 / 1024.0, 'f', 1) + "MB";
+        resultsTable->setItem(i, 0, new QTableWidgetItem(result.parameters.toString()));
+        resultsTable->setItem(i, 1, new QTableWidgetItem(QString::number(result.stats.cpuTime) + "ms"));
+        resultsTable->setItem(i, 2, new QTableWidgetItem(memory));
+        resultsTable->setItem(i, 3, new QTableWidgetItem(QString::number(result.exitCode)));
+        resultsTable->setItem(i, 4, new QTableWidgetItem(verdict));
+    }
+
+    if (!results.isEmpty())
+    {
+        auto worst = results.front();
+        QString color = "green";
+        if (worst.stats.cpuTime > timeLimit)
+            color = "red";
+        else if (worst.stats.cpuTime * 2 > timeLimit)
+            color = "orange";
+        summaryLabel->setText("Worst input: <span style=\"color:" + color + "\">" +
+                              QString::number(worst.stats.cpuTime) + "ms</span> of the time limit " +
+                              QString::number(timeLimit) + "ms (" + worst.parameters.toString().toHtmlEscaped() + ")");
+    }
+}
+
+void TLEHunterWindow::onHuntFinished()
+{
+    startButton->setText("Start");
+}
+
+void TLEHunterWindow::onErrorOccured(const QString &error)
+{
+    QMessageBox::warning(this, "TLE Hunter", error);
+}
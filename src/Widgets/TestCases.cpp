@@ -16,6 +16,7 @@
  */
 
 #include "Widgets/TestCases.hpp"
+#include "Core/Checker.hpp"
 #include "diff_match_patch.h"
 #include <QFileDialog>
 #include <QMainWindow>
@@ -102,6 +103,9 @@ TestCase::TestCase(int index, MessageLogger *logger, QWidget *parent, const QStr
     inputLabel = new QLabel("Input");
     outputLabel = new QLabel("Output");
     expectedLabel = new QLabel("Expected");
+    statsLabel = new QLabel();
+    sanitizerLabel = new QLabel();
+    historySparkline = new Sparkline();
     deleteButton = new QPushButton("Del");
     loadInputButton = new QPushButton("Load");
     diffButton = new QPushButton("**");
@@ -125,6 +129,9 @@ TestCase::TestCase(int index, MessageLogger *logger, QWidget *parent, const QStr
     inputUpLayout->addWidget(inputLabel);
     inputUpLayout->addWidget(loadInputButton);
     outputUpLayout->addWidget(outputLabel);
+    outputUpLayout->addWidget(statsLabel);
+    outputUpLayout->addWidget(historySparkline);
+    outputUpLayout->addWidget(sanitizerLabel);
     outputUpLayout->addWidget(diffButton);
     expectedUpLayout->addWidget(expectedLabel);
     expectedUpLayout->addWidget(loadExpectedButton);
@@ -151,28 +158,32 @@ void TestCase::setInput(const QString &text)
     inputEdit->modifyText(text);
 }
 
-void TestCase::setOutput(const QString &text)
+void TestCase::setOutput(const QByteArray &output)
 {
-    outputEdit->modifyText(text);
+    outputData = output;
+    streamedOutput.clear();
+    outputEdit->modifyText(QString::fromUtf8(output));
     outputEdit->startAnimation();
 
-    currentVerdict = output().isEmpty() || expected().isEmpty() ? UNKNOWN : (isPass() ? AC : WA);
+    if (customChecker)
+        setVerdict(UNKNOWN);
+    else
+        setVerdict(output().isEmpty() || expected().isEmpty() ? UNKNOWN : (isPass() ? AC : WA));
+}
 
-    switch (currentVerdict)
-    {
-    case UNKNOWN:
-        diffButton->setStyleSheet("");
-        diffButton->setText("**");
-        break;
-    case AC:
-        diffButton->setStyleSheet("background: #0b0");
-        diffButton->setText("AC");
-        break;
-    case WA:
-        diffButton->setStyleSheet("background: #d00");
-        diffButton->setText("WA");
-        break;
-    }
+void TestCase::appendOutput(const QByteArray &chunk, qint64 total)
+{
+    streamedOutput += chunk;
+    if (streamedOutput.size() > Core::Runner::STREAM_TAIL)
+        streamedOutput.remove(0, streamedOutput.size() - Core::Runner::STREAM_TAIL);
+
+    // the text is decoded from the bytes each time, so a character split between two chunks is shown correctly
+    QString text = QString::fromUtf8(streamedOutput);
+    if (total > streamedOutput.size())
+        text = "[" + QString::number(total - streamedOutput.size()) + " bytes before]\n" + text;
+    outputEdit->modifyText(text);
+    outputEdit->startAnimation();
+    outputEdit->verticalScrollBar()->setValue(outputEdit->verticalScrollBar()->maximum());
 }
 
 void TestCase::setExpected(const QString &text)
@@ -182,10 +193,14 @@ void TestCase::setExpected(const QString &text)
 
 void TestCase::clearOutput()
 {
+    outputData.clear();
+    streamedOutput.clear();
     outputEdit->modifyText(QString());
-    currentVerdict = UNKNOWN;
-    diffButton->setStyleSheet("");
-    diffButton->setText("**");
+    setVerdict(UNKNOWN);
+    statsLabel->clear();
+    statsLabel->setToolTip(QString());
+    sanitizerLabel->clear();
+    sanitizerLabel->setToolTip(QString());
 }
 
 QString TestCase::input() const
@@ -193,9 +208,9 @@ QString TestCase::input() const
     return inputEdit->toPlainText();
 }
 
-QString TestCase::output() const
+QByteArray TestCase::output() const
 {
-    return outputEdit->toPlainText();
+    return outputData;
 }
 
 QString TestCase::expected() const
@@ -251,11 +266,84 @@ void TestCase::setID(int index)
     expectedLabel->setText("Expected #" + QString::number(id + 1));
 }
 
+void TestCase::setRunStats(int timeUsed, int judgeTime, const Core::ProcessStats &stats)
+{
+    QString text = QString::number(judgeTime) + "ms";
+    if (stats.ipc() > 0)
+        text += ", IPC " + QString::number(stats.ipc(), 'f', 2);
+    if (stats.isIOBound())
+        text += ", <span style=\"color:orange\">I/O bound</span>";
+    statsLabel->setText(text);
+
+    QString tooltip = stats.ioSummary();
+    if (judgeTime != timeUsed)
+    {
+        tooltip = "Judge-equivalent time, " + QString::number(timeUsed) + "ms on this machine" +
+                  (tooltip.isEmpty() ? "" : "\n") + tooltip;
+    }
+    if (!stats.countersSummary().isEmpty())
+        tooltip += (tooltip.isEmpty() ? "" : "\n") + stats.countersSummary();
+    if (stats.isIOBound())
+    {
+        tooltip += "\nMost of the syscalls move only a few bytes. Use buffered I/O, e.g. "
+                   "ios::sync_with_stdio(false) and '\\n' instead of endl.";
+    }
+    statsLabel->setToolTip(tooltip);
+}
+
+void TestCase::setSanitizerReport(const Core::SanitizerReport &report)
+{
+    if (report.isEmpty())
+    {
+        sanitizerLabel->setText("<span style=\"color:green\">Sanitizers OK</span>");
+        sanitizerLabel->setToolTip("No error is reported by the sanitizer build on this input");
+        return;
+    }
+    QString summary = report.summary;
+    if (summary.size() > 40)
+        summary = summary.left(37) + "...";
+    sanitizerLabel->setText("<span style=\"color:red\">" + summary.toHtmlEscaped() + "</span>");
+    sanitizerLabel->setToolTip(QString::number(report.errors) + " error(s) reported by the sanitizer build:\n\n" +
+                               report.details);
+}
+
+void TestCase::setRunHistory(const QVector<int> &times)
+{
+    historySparkline->setValues(times, "ms");
+}
+
 TestCase::Verdict TestCase::verdict() const
 {
     return currentVerdict;
 }
 
+void TestCase::setVerdict(Verdict verdict, const QString &message)
+{
+    currentVerdict = verdict;
+    diffButton->setToolTip(message);
+
+    switch (currentVerdict)
+    {
+    case UNKNOWN:
+        diffButton->setStyleSheet("");
+        diffButton->setText("**");
+        break;
+    case AC:
+        diffButton->setStyleSheet("background: #0b0");
+        diffButton->setText("AC");
+        break;
+    case WA:
+        diffButton->setStyleSheet("background: #d00");
+        diffButton->setText("WA");
+        break;
+    }
+}
+
+void TestCase::setCustomChecker(bool enabled)
+{
+    customChecker = enabled;
+}
+
 void TestCase::on_deleteButton_clicked()
 {
     if (input().isEmpty() && expected().isEmpty())
@@ -281,6 +369,11 @@ void TestCase::on_loadInputButton_clicked()
 }
 
 void TestCase::on_diffButton_clicked()
+{
+    showDiff();
+}
+
+void TestCase::showDiff()
 {
     auto window = new QMainWindow(this);
     auto widget = new QWidget(window);
@@ -309,11 +402,12 @@ void TestCase::on_diffButton_clicked()
     rightLayout->addWidget(outputEdit);
     layout->addLayout(rightLayout);
 
-    if (output().length() <= 100000 && expected().length() <= 100000)
+    auto outputText = QString::fromUtf8(outputData);
+    if (outputText.length() <= 100000 && expected().length() <= 100000)
     {
         diff_match_patch differ;
         differ.Diff_EditCost = 10;
-        auto diffs = differ.diff_main(expected(), output());
+        auto diffs = differ.diff_main(expected(), outputText);
         differ.diff_cleanupEfficiency(diffs);
 
         QString expectedHTML, outputHTML;
@@ -346,7 +440,7 @@ void TestCase::on_diffButton_clicked()
     {
         QMessageBox::warning(this, "Diff Viewer", "The output/expected is too large, use plain diff.");
         expectedEdit->setPlainText(expected());
-        outputEdit->setPlainText(output());
+        outputEdit->setPlainText(outputText);
         rightLayout->addWidget(outputEdit);
         layout->addLayout(rightLayout);
     }
@@ -375,49 +469,7 @@ void TestCase::on_loadExpectedButton_clicked()
 
 bool TestCase::isPass() const
 {
-    auto out = output().remove('\r');
-    auto ans = expected().remove('\r');
-    auto a_lines = out.split('\n');
-    auto b_lines = ans.split('\n');
-    for (int i = 0; i < a_lines.size() || i < b_lines.size(); ++i)
-    {
-        if (i >= a_lines.size())
-        {
-            if (b_lines[i].trimmed().isEmpty())
-                continue;
-            else
-                return false;
-        }
-        if (i >= b_lines.size())
-        {
-            if (a_lines[i].trimmed().isEmpty())
-                continue;
-            else
-                return false;
-        }
-        auto a_words = a_lines[i].split(' ');
-        auto b_words = b_lines[i].split(' ');
-        for (int j = 0; j < a_words.size() || j < b_words.size(); ++j)
-        {
-            if (j >= a_words.size())
-            {
-                if (b_words[j].trimmed().isEmpty())
-                    continue;
-                else
-                    return false;
-            }
-            if (j >= b_words.size())
-            {
-                if (a_words[j].trimmed().isEmpty())
-                    continue;
-                else
-                    return false;
-            }
-            if (a_words[j] != b_words[j])
-                return false;
-        }
-    }
-    return true;
+    return Core::Checker::isSameOutput(outputData, expected().toUtf8());
 }
 
 const int TestCases::MAX_NUMBER_OF_TESTCASES;
@@ -454,17 +506,60 @@ void TestCases::setInput(int index, const QString &input)
     testcases[index]->setInput(input);
 }
 
-void TestCases::setOutput(int index, const QString &output)
+void TestCases::setOutput(int index, const QByteArray &output)
 {
     testcases[index]->setOutput(output);
     updateVerdicts();
 }
 
+void TestCases::appendOutput(int index, const QByteArray &chunk, qint64 total)
+{
+    testcases[index]->appendOutput(chunk, total);
+}
+
 void TestCases::setExpected(int index, const QString &expected)
 {
     testcases[index]->setExpected(expected);
 }
 
+void TestCases::setVerdict(int index, TestCase::Verdict verdict, const QString &message)
+{
+    testcases[index]->setVerdict(verdict, message);
+    updateVerdicts();
+}
+
+TestCase::Verdict TestCases::verdict(int index) const
+{
+    return testcases[index]->verdict();
+}
+
+void TestCases::showDiff(int index)
+{
+    testcases[index]->showDiff();
+}
+
+void TestCases::setRunStats(int index, int timeUsed, int judgeTime, const Core::ProcessStats &stats)
+{
+    testcases[index]->setRunStats(timeUsed, judgeTime, stats);
+}
+
+void TestCases::setSanitizerReport(int index, const Core::SanitizerReport &report)
+{
+    testcases[index]->setSanitizerReport(report);
+}
+
+void TestCases::setRunHistory(int index, const QVector<int> &times)
+{
+    testcases[index]->setRunHistory(times);
+}
+
+void TestCases::setCustomChecker(bool enabled)
+{
+    customChecker = enabled;
+    for (auto testcase : testcases)
+        testcase->setCustomChecker(enabled);
+}
+
 void TestCases::addTestCase(const QString &input, const QString &expected)
 {
     if (count() >= MAX_NUMBER_OF_TESTCASES)
@@ -475,6 +570,7 @@ void TestCases::addTestCase(const QString &input, const QString &expected)
     else
     {
         auto testcase = new TestCase(count(), log, this, input, expected);
+        testcase->setCustomChecker(customChecker);
         connect(testcase, SIGNAL(deleted(TestCase *)), this, SLOT(onChildDeleted(TestCase *)));
         testcases.push_back(testcase);
         scrollAreaLayout->addWidget(testcase);
@@ -500,7 +596,7 @@ QString TestCases::input(int index) const
     return testcases[index]->input();
 }
 
-QString TestCases::output(int index) const
+QByteArray TestCases::output(int index) const
 {
     return testcases[index]->output();
 }
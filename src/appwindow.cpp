@@ -17,6 +17,7 @@
 
 #include "appwindow.hpp"
 #include "../ui/ui_appwindow.h"
+#include "Core/ExecutorClient.hpp"
 #include "Extensions/EditorTheme.hpp"
 #include <QClipboard>
 #include <QDesktopServices>
@@ -28,6 +29,7 @@
 #include <QMetaMethod>
 #include <QMimeData>
 #include <QProgressDialog>
+#include <QStatusBar>
 #include <QTimer>
 #include <QUrl>
 
@@ -109,6 +111,8 @@ AppWindow::AppWindow(bool cpp, bool java, bool python, bool noHotExit, int numbe
 
 AppWindow::~AppWindow()
 {
+    // the tabs are destroyed after this, and their jobs update the scheduler
+    disconnect(scheduler, nullptr, this, nullptr);
     saveSettings();
     Themes::EditorTheme::release();
     delete settingManager;
@@ -157,6 +161,9 @@ void AppWindow::setConnections()
     connect(timer, SIGNAL(timeout()), this, SLOT(onSaveTimerElapsed()));
 
     connect(preferenceWindow, SIGNAL(settingsApplied()), this, SLOT(onSettingsApplied()));
+    connect(scheduler, SIGNAL(statusChanged()), this, SLOT(onSchedulerStatusChanged()));
+    connect(Core::ExecutorClient::instance(), SIGNAL(jobFinishedWhileAway(const Core::ExecutorMessage &)), this,
+            SLOT(onExecutorJobFinishedWhileAway(const Core::ExecutorMessage &)));
 
     if (settingManager->isCompetitiveCompanionActive())
         companionEditorConnection =
@@ -170,6 +177,11 @@ void AppWindow::allocate()
     updater = new Telemetry::UpdateNotifier(settingManager->isBeta());
     preferenceWindow = new PreferenceWindow(settingManager, this);
     server = new Network::CompanionServer(settingManager->getConnectionPort());
+    scheduler = new Core::Scheduler(this);
+    schedulerLabel = new QLabel();
+    schedulerLabel->setToolTip("The compile and run jobs of all the tabs: running / the CPU budget, queued, and the "
+                               "memory reserved by the running jobs / the memory budget");
+    statusBar()->addPermanentWidget(schedulerLabel);
 
     timer->setInterval(3000);
     timer->setSingleShot(false);
@@ -439,6 +451,9 @@ void AppWindow::openContest(const QString &path, const QString &lang, int number
 
 bool AppWindow::quit()
 {
+    // the long runs in the executor daemon continue after the editor quits
+    if (Core::ExecutorClient::isEnabled())
+        Core::ExecutorClient::instance()->setDetaching(true);
     settingManager->clearEditorStatus();
     if (settingManager->isUseHotExit())
     {
@@ -461,7 +476,11 @@ bool AppWindow::quit()
     else
     {
         on_actionClose_All_triggered();
-        return ui->tabWidget->count() == 0;
+        if (ui->tabWidget->count() == 0)
+            return true;
+        if (Core::ExecutorClient::isEnabled())
+            Core::ExecutorClient::instance()->setDetaching(false);
+        return false;
     }
 }
 
@@ -654,6 +673,7 @@ void AppWindow::onTabChanged(int index)
 {
     if (index == -1)
     {
+        scheduler->setFocusedOwner(nullptr);
         activeLogger = nullptr;
         server->setMessageLogger(nullptr);
         setWindowTitle("CP Editor: An editor specially designed for competitive programming");
@@ -664,6 +684,7 @@ void AppWindow::onTabChanged(int index)
     disconnect(activeRightSplitterMoveConnection);
 
     auto tmp = windowIndex(index);
+    scheduler->setFocusedOwner(tmp);
 
     setWindowTitle(tmp->getTabTitle(true, false) + " - CP Editor");
 
@@ -734,6 +755,14 @@ void AppWindow::onSettingsApplied()
     disconnect(companionEditorConnection);
 
     server->updatePort(settingManager->getConnectionPort());
+    scheduler->setBudget(settingManager->getParallelJobs(),
+                         qint64(settingManager->getMemoryBudget()) * 1024 * 1024);
+    if (settingManager->isUseExecutor())
+    {
+        // collect the results of the runs which finished while the editor was closed
+        Core::ExecutorClient::instance()->setSession(settingManager->getExecutorSession());
+        Core::ExecutorClient::instance()->attach();
+    }
 
     if (settingManager->isCompetitiveCompanionActive())
         companionEditorConnection =
@@ -807,6 +836,16 @@ void AppWindow::on_actionCompile_Run_triggered()
     }
 }
 
+void AppWindow::on_actionRun_With_Sanitizers_triggered()
+{
+    if (currentWindow() != nullptr)
+    {
+        if (ui->actionEditor_Mode->isChecked())
+            on_actionSplit_Mode_triggered();
+        currentWindow()->runWithSanitizers();
+    }
+}
+
 void AppWindow::on_actionRun_triggered()
 {
     if (currentWindow() != nullptr)
@@ -835,6 +874,96 @@ void AppWindow::on_actionKill_Processes_triggered()
         currentWindow()->killProcesses();
 }
 
+void AppWindow::on_actionTLE_Hunter_triggered()
+{
+    if (currentWindow() != nullptr)
+        currentWindow()->huntTLE();
+}
+
+void AppWindow::on_actionEstimate_Complexity_triggered()
+{
+    if (currentWindow() != nullptr)
+        currentWindow()->estimateComplexity();
+}
+
+void AppWindow::on_actionBenchmark_triggered()
+{
+    if (currentWindow() != nullptr)
+        currentWindow()->runBenchmark();
+}
+
+void AppWindow::on_actionCompare_Performance_triggered()
+{
+    if (currentWindow() == nullptr)
+        return;
+    QVector<MainWindow *> tabs;
+    for (int i = 0; i < ui->tabWidget->count(); ++i)
+        tabs.push_back(windowIndex(i));
+    currentWindow()->comparePerformance(tabs);
+}
+
+void AppWindow::on_actionProfile_Run_triggered()
+{
+    if (currentWindow() != nullptr)
+        currentWindow()->profileRun();
+}
+
+void AppWindow::on_actionProfile_Memory_triggered()
+{
+    if (currentWindow() != nullptr)
+        currentWindow()->profileMemory();
+}
+
+void AppWindow::on_actionCount_Line_Executions_triggered()
+{
+    if (currentWindow() != nullptr)
+        currentWindow()->countLineExecutions();
+}
+
+void AppWindow::on_actionJudge_All_Tabs_triggered()
+{
+    if (ui->tabWidget->count() == 0)
+        return;
+
+    if (contestJudge == nullptr)
+    {
+        contestJudge = new ContestJudgeWindow(this);
+        contestJudge->setAttribute(Qt::WA_DeleteOnClose);
+        connect(contestJudge, SIGNAL(tabRequested(MainWindow *)), this, SLOT(onJudgeTabRequested(MainWindow *)));
+    }
+
+    QVector<MainWindow *> tabs;
+    for (int i = 0; i < ui->tabWidget->count(); ++i)
+        tabs.push_back(windowIndex(i));
+    contestJudge->judge(tabs);
+    contestJudge->show();
+    contestJudge->raise();
+}
+
+void AppWindow::onJudgeTabRequested(MainWindow *window)
+{
+    if (ui->tabWidget->indexOf(window) != -1)
+        ui->tabWidget->setCurrentWidget(window);
+}
+
+void AppWindow::on_actionChoose_Checker_triggered()
+{
+    if (currentWindow() != nullptr)
+        currentWindow()->chooseChecker();
+}
+
+void AppWindow::on_actionChoose_Interactor_triggered()
+{
+    if (currentWindow() != nullptr)
+        currentWindow()->chooseInteractor();
+}
+
+void AppWindow::on_actionChoose_File_IO_triggered()
+{
+    if (currentWindow() != nullptr)
+        currentWindow()->chooseFileIO();
+}
+
 void AppWindow::on_actionUse_Snippets_triggered()
 {
     auto current = currentWindow();
@@ -954,6 +1083,40 @@ void AppWindow::on_confirmTriggered(MainWindow *widget)
         ui->tabWidget->setCurrentIndex(index);
 }
 
+void AppWindow::onSchedulerStatusChanged()
+{
+    QString text = "Jobs " + QString::number(scheduler->runningJobs()) + "/" + QString::number(scheduler->cpuBudget());
+    if (scheduler->queuedJobs() > 0)
+        text += ", " + QString::number(scheduler->queuedJobs()) + " queued";
+    if (scheduler->memoryBudget() > 0)
+    {
+        const double GB = 1024.0 * 1024 * 1024;
+        text += ", memory " + QString::number(scheduler->memoryInUse() / GB, 'f', 1) + "/" +
+                QString::number(scheduler->memoryBudget() / GB, 'f', 1) + " GB";
+    }
+    schedulerLabel->setText(text);
+}
+
+void AppWindow::onExecutorJobFinishedWhileAway(const Core::ExecutorMessage &result)
+{
+    if (activeLogger == nullptr)
+        return;
+    if (result.type == Core::ExecutorMessage::Failed)
+    {
+        activeLogger->warn("Executor", "A job submitted before a restart failed: " + result.text);
+        return;
+    }
+    QString text = "[" + result.text + "] finished while the editor was away";
+    if (result.timedOut)
+        text += ", time limit exceeded after " + QString::number(result.timeUsed) + "ms";
+    else if (result.crashed)
+        text += ", crashed after " + QString::number(result.timeUsed) + "ms";
+    else
+        text += " with exit code " + QString::number(result.exitCode) + " in " + QString::number(result.timeUsed) +
+                "ms";
+    activeLogger->info("Executor", text);
+}
+
 void AppWindow::onTabContextMenuRequested(const QPoint &pos)
 {
     int index = ui->tabWidget->tabBar()->tabAt(pos);
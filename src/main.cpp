@@ -23,13 +23,105 @@
 #include <QTextStream>
 #include <singleapplication.h>
 
+#include "Core/ExecutorDaemon.hpp"
+#include "Core/HeadlessJudge.hpp"
+#include "Core/Launcher.hpp"
 #include "appwindow.hpp"
 #include "mainwindow.hpp"
 
 #define TOJSON(x) json[#x] = x
 
+// the --judge mode, it has no GUI so that it can be used by scripts and on servers without a display
+static int judge(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("CP Editor");
+    QCoreApplication::setApplicationVersion(APP_VERSION_MAJOR "." APP_VERSION_MINOR "." APP_VERSION_PATCH);
+
+    QTextStream cout(stdout, QIODevice::WriteOnly), cerr(stderr, QIODevice::WriteOnly);
+
+    QCommandLineParser parser;
+    parser.addVersionOption();
+    parser.addHelpOption();
+    parser.setApplicationDescription(
+        QString(argv[0]) + " --judge [options] <source1> [<source2> [...]]\n\nJudge the solutions on their tests "
+                           "<name>_<N>.in and <name>_<N>.ans saved by the editor, and print the results as JSON. "
+                           "The exit code is 0 if all the solutions pass all the tests, 1 if any of them fails, "
+                           "and 3 if a solution has no tests.");
+    parser.addOptions(
+        {{"judge", "Judge the solutions without a GUI."},
+         {{"t", "tests"}, "Judge all the solutions on the tests of <source> instead of their own tests.", "source"},
+         {"checker", "A testlib-style checker. The outputs are compared ignoring trailing spaces if not specified.",
+          "path"},
+         {"time-limit", "The time limit in milliseconds. The one in the preferences if not specified.", "ms", "0"},
+         {"input-file", "The input is written to this file instead of stdin, for the problems with file I/O.", "name"},
+         {"output-file", "The output is read from this file instead of stdout, for the problems with file I/O.",
+          "name"},
+         {{"j", "jobs"}, "The number of parallel runs. All the CPU cores but one if not specified.", "jobs", "0"}});
+    parser.process(app);
+
+    Core::HeadlessJudge::Options options;
+    options.sources = parser.positionalArguments();
+    options.testsFrom = parser.value("tests");
+    options.checkerPath = parser.value("checker");
+    options.inputFileName = parser.value("input-file");
+    options.outputFileName = parser.value("output-file");
+    bool timeLimitOk = false, jobsOk = false;
+    options.timeLimit = parser.value("time-limit").toInt(&timeLimitOk);
+    options.jobs = parser.value("jobs").toInt(&jobsOk);
+
+    bool fileNamesOk = Core::Runner::isValidFileIOName(options.inputFileName) &&
+                       Core::Runner::isValidFileIOName(options.outputFileName);
+    if (options.sources.isEmpty() || !timeLimitOk || !jobsOk || !fileNamesOk || options.timeLimit < 0 ||
+        options.jobs < 0)
+    {
+        cerr << "Invalid Arguments\n\n"
+             << "See " + QString(argv[0]) + " --judge --help for more infomation.\n\n";
+        return 2;
+    }
+    for (auto const &source : options.sources)
+    {
+        if (!QFileInfo(source).isFile() || Core::HeadlessJudge::languageOf(source).isEmpty())
+        {
+            cerr << "[" + source + "] is not a C++, Java or Python source file.\n";
+            return 2;
+        }
+    }
+
+    Settings::SettingManager settings;
+    Core::HeadlessJudge judge(options, settings.toData());
+    // finished() may be emitted before the event loop starts
+    QObject::connect(&judge, &Core::HeadlessJudge::finished, &app, &QCoreApplication::quit, Qt::QueuedConnection);
+    judge.start();
+    app.exec();
+
+    cout << QJsonDocument(judge.report()).toJson();
+    if (judge.hasSolutionWithoutTests())
+        return 3;
+    return judge.isSuccessful() ? 0 : 1;
+}
+
 int main(int argc, char *argv[])
 {
+    // the executor daemon is started by the editor, it has no GUI and doesn't take part in the single application
+    if (argc == 2 && QString(argv[1]) == "--executor")
+    {
+        QCoreApplication app(argc, argv);
+        Core::ExecutorDaemon daemon;
+        if (!daemon.listen())
+            return 0;
+        return app.exec();
+    }
+
+    // fork the launcher while the process is still small and has no thread
+    Core::Launcher::startZygote();
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (QString(argv[i]) == "--judge")
+            return judge(argc, argv);
+    }
+
     SingleApplication app(argc, argv, true);
     SingleApplication::setApplicationName("CP Editor");
     SingleApplication::setApplicationVersion(APP_VERSION_MAJOR "." APP_VERSION_MINOR "." APP_VERSION_PATCH);
@@ -43,7 +135,8 @@ int main(int argc, char *argv[])
     parser.addHelpOption();
     parser.setApplicationDescription(programName + " [-d/--depth <depth>] [options] [<path1> [<path2> [...]]]\n" +
                                      programName +
-                                     " [-c/--contest] [options] <number of problems> <contest directory>");
+                                     " [-c/--contest] [options] <number of problems> <contest directory>\n" +
+                                     programName + " --judge [options] <source1> [<source2> [...]]");
     parser.addOptions(
         {{{"d", "depth"}, "Maximum depth when opening files in directories. No limit if not specified.", "depth", "-1"},
          {{"c", "contest"}, "Open a contest. i.e. Open files named A, B, ..., Z in a given directory."},
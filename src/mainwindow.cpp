@@ -18,9 +18,14 @@
 #include "mainwindow.hpp"
 
 #include "Core/Compiler.hpp"
+#include "Core/ExecutorClient.hpp"
+#include "Core/HeadlessJudge.hpp"
+#include "Core/PerfCounters.hpp"
+#include "Core/Toolchain.hpp"
 #include "Extensions/EditorTheme.hpp"
 #include "Core/MessageLogger.hpp"
 #include <QCXXHighlighter>
+#include <QDateTime>
 #include <QFileDialog>
 #include <QFont>
 #include <QFontDialog>
@@ -65,6 +70,15 @@ MainWindow::~MainWindow()
         delete cftools;
     if (tmpDir != nullptr)
         delete tmpDir;
+    if (baselineDir != nullptr)
+        delete baselineDir;
+    if (profileDir != nullptr)
+        delete profileDir;
+    if (coverageDir != nullptr)
+        delete coverageDir;
+    stopSanitizeRun();
+    if (sanitizeDir != nullptr)
+        delete sanitizeDir;
 
     delete ui;
     delete editor;
@@ -87,7 +101,12 @@ void MainWindow::setEditor()
     editor->setSizePolicy(QSizePolicy::Policy::Expanding, QSizePolicy::Policy::Expanding);
     editor->setAcceptDrops(false);
 
-    ui->verticalLayout_8->addWidget(editor);
+    heatGutter = new HeatGutter(editor);
+    auto editorLayout = new QHBoxLayout();
+    editorLayout->setSpacing(0);
+    editorLayout->addWidget(heatGutter);
+    editorLayout->addWidget(editor);
+    ui->verticalLayout_8->addLayout(editorLayout);
 
     connect(editor, SIGNAL(textChanged()), this, SIGNAL(editorChanged()));
     connect(editor, SIGNAL(cursorPositionChanged()), this, SLOT(updateCursorInfo()));
@@ -100,6 +119,11 @@ void MainWindow::setupCore()
 {
     using namespace Core;
     formatter = new Formatter(data.clangFormatBinary, data.clangFormatStyle, &log);
+    checker = new Checker(this);
+    checker->setScheduling(this, Core::Scheduler::Interactive);
+    connect(checker, &Checker::checkFinished, this, &MainWindow::onCheckFinished);
+    connect(Toolchain::instance(), SIGNAL(probeFinished(int, const QString &, const QString &, bool)), this,
+            SLOT(onToolProbeFinished(int, const QString &, const QString &, bool)));
     log.setContainer(ui->compiler_edit);
 }
 
@@ -107,11 +131,13 @@ void MainWindow::compile()
 {
     killProcesses();
     compiler = new Core::Compiler();
+    compiler->setScheduling(this, Core::Scheduler::Interactive);
     if (saveTemp("Compiler"))
     {
+        compilingKey = compileKey();
         QString command;
         if (language == "C++")
-            command = data.compileCommandCpp;
+            command = Settings::compileCommandCpp(data);
         else if (language == "Java")
             command = data.compileCommandJava;
         else if (language == "Python")
@@ -122,6 +148,7 @@ void MainWindow::compile()
         else
         {
             log.warn("Compiler", "Please set the language");
+            stopJudging("FAIL");
             return;
         }
         connect(compiler, SIGNAL(compilationStarted()), this, SLOT(onCompilationStarted()));
@@ -131,36 +158,43 @@ void MainWindow::compile()
                 SLOT(onCompilationErrorOccured(const QString &)));
         compiler->start(tmpPath(), command, language);
     }
+    else
+    {
+        stopJudging("FAIL");
+    }
 }
 
 void MainWindow::run()
 {
-    killProcesses();
+    // the sanitizer build of the same code, started with this run by runWithSanitizers(), may still be running
+    killProcesses(editor->toPlainText() == sanitizedText);
     testcases->clearOutput();
-
-    QString command, args;
-    if (language == "C++")
-    {
-        args = data.runtimeArgumentsCpp;
-    }
-    else if (language == "Java")
+    if (editor->toPlainText() == sanitizedText)
     {
-        command = data.runCommandJava;
-        args = data.runtimeArgumentsJava;
+        for (auto it = sanitizerReports.constBegin(); it != sanitizerReports.constEnd(); ++it)
+            testcases->setSanitizerReport(it.key(), it.value());
     }
-    else if (language == "Python")
+
+    QString command, args;
+    if (!getRunCommand(command, args))
     {
-        command = data.runCommandPython;
-        args = data.runtimeArgumentsPython;
+        stopJudging("FAIL");
+        return;
     }
-    else
+
+    if (!interactorPath.isEmpty())
     {
-        log.warn("Runner", "Wrong language, please set the language");
+        runInteractive(command, args);
         return;
     }
 
     bool isRun = false;
     runner.resize(testcases->count());
+    earlyWrongAnswers.clear();
+    pendingHistory.clear();
+    judgeTimeouts.clear();
+    // the binary may be older than the code in the editor, its key is only known if it's compiled in this session
+    runKey = compiledKey;
 
     for (int i = 0; i < testcases->count(); ++i)
     {
@@ -168,14 +202,30 @@ void MainWindow::run()
         {
             isRun = true;
             runner[i] = new Core::Runner(i);
+            runner[i]->setScheduling(this, Core::Scheduler::Interactive);
             connect(runner[i], SIGNAL(runStarted(int)), this, SLOT(onRunStarted(int)));
-            connect(runner[i], SIGNAL(runFinished(int, const QString &, const QString &, int, int)), this,
-                    SLOT(onRunFinished(int, const QString &, const QString &, int, int)));
+            connect(runner[i], SIGNAL(runFinished(int, const QByteArray &, const QByteArray &, int, int)), this,
+                    SLOT(onRunFinished(int, const QByteArray &, const QByteArray &, int, int)));
             connect(runner[i], SIGNAL(runErrorOccured(int, const QString &)), this,
                     SLOT(onRunErrorOccured(int, const QString &)));
             connect(runner[i], SIGNAL(runTimeout(int)), this, SLOT(onRunTimeout(int)));
             connect(runner[i], SIGNAL(runKilled(int)), this, SLOT(onRunKilled(int)));
-            runner[i]->run(tmpPath(), language, command, args, testcases->input(i), data.timeLimit);
+            connect(runner[i], SIGNAL(runOutputStreamed(int, const QByteArray &, qint64)), this,
+                    SLOT(onRunOutputStreamed(int, const QByteArray &, qint64)));
+            connect(runner[i], SIGNAL(runLeakedProcesses(int, const QStringList &)), this,
+                    SLOT(onRunLeakedProcesses(int, const QStringList &)));
+            runner[i]->setOutputStreaming(true);
+            runner[i]->setFileIO(problemInputFile, problemOutputFile);
+            runner[i]->setMemoryLimit(problemMemoryLimit * 1024LL * 1024LL);
+            // the output file is only read after the run, so it can't be compared while running
+            if (data.isStopAtFirstWrongAnswer && checker->checkerPath().isEmpty() && problemOutputFile.isEmpty() &&
+                !testcases->expected(i).trimmed().isEmpty())
+            {
+                connect(runner[i], SIGNAL(runWrongAnswer(int, const QString &)), this,
+                        SLOT(onRunWrongAnswer(int, const QString &)));
+                runner[i]->setExpectedOutput(testcases->expected(i));
+            }
+            runner[i]->run(tmpPath(), language, command, args, testcases->input(i), getTimeLimit());
         }
     }
 
@@ -216,12 +266,9 @@ void MainWindow::setCFToolsUI()
             }
         });
     }
-    if (!Network::CFTools::check(cftoolPath))
-    {
+    // the button is enabled when the probe finds CF Tools
+    if (probeTool(Core::Toolchain::CFTools, cftoolPath) != Core::Toolchain::Available)
         submitToCodeforces->setEnabled(false);
-        log.error("CFTools", "You will not be able to submit code to Codeforces because CFTools is not installed or is "
-                             "not on SYSTEM PATH. You can set it manually in settings.");
-    }
 }
 
 int MainWindow::getUntitledIndex() const
@@ -294,6 +341,13 @@ MainWindow::EditorStatus::EditorStatus(const QMap<QString, QVariant> &status)
     FROMSTATUS(horizontalScrollBarValue).toInt();
     FROMSTATUS(verticalScrollbarValue).toInt();
     FROMSTATUS(untitledIndex).toInt();
+    FROMSTATUS(problemTimeLimit).toInt();
+    FROMSTATUS(problemMemoryLimit).toInt();
+    FROMSTATUS(problemInputFile).toString();
+    FROMSTATUS(problemOutputFile).toString();
+    FROMSTATUS(generatorCommand).toString();
+    FROMSTATUS(checkerPath).toString();
+    FROMSTATUS(interactorPath).toString();
     FROMSTATUS(input).toStringList();
     FROMSTATUS(expected).toStringList();
 }
@@ -314,6 +368,13 @@ QMap<QString, QVariant> MainWindow::EditorStatus::toMap() const
     TOSTATUS(horizontalScrollBarValue);
     TOSTATUS(verticalScrollbarValue);
     TOSTATUS(untitledIndex);
+    TOSTATUS(problemTimeLimit);
+    TOSTATUS(problemMemoryLimit);
+    TOSTATUS(problemInputFile);
+    TOSTATUS(problemOutputFile);
+    TOSTATUS(generatorCommand);
+    TOSTATUS(checkerPath);
+    TOSTATUS(interactorPath);
     TOSTATUS(input);
     TOSTATUS(expected);
     return status;
@@ -335,6 +396,13 @@ MainWindow::EditorStatus MainWindow::toStatus() const
     status.horizontalScrollBarValue = editor->horizontalScrollBar()->value();
     status.verticalScrollbarValue = editor->verticalScrollBar()->value();
     status.untitledIndex = untitledIndex;
+    status.problemTimeLimit = problemTimeLimit;
+    status.problemMemoryLimit = problemMemoryLimit;
+    status.problemInputFile = problemInputFile;
+    status.problemOutputFile = problemOutputFile;
+    status.generatorCommand = generatorCommand;
+    status.checkerPath = checker->checkerPath();
+    status.interactorPath = interactorPath;
     status.input = testcases->inputs();
     status.expected = testcases->expecteds();
 
@@ -357,6 +425,13 @@ void MainWindow::loadStatus(const EditorStatus &status)
     editor->horizontalScrollBar()->setValue(status.horizontalScrollBarValue);
     editor->verticalScrollBar()->setValue(status.verticalScrollbarValue);
     untitledIndex = status.untitledIndex;
+    problemTimeLimit = status.problemTimeLimit;
+    problemMemoryLimit = status.problemMemoryLimit;
+    problemInputFile = status.problemInputFile;
+    problemOutputFile = status.problemOutputFile;
+    generatorCommand = status.generatorCommand;
+    setChecker(status.checkerPath);
+    interactorPath = status.interactorPath;
     testcases->loadStatus(status.input, status.expected);
 }
 
@@ -378,9 +453,19 @@ void MainWindow::applyCompanion(Network::CompanionData data)
 
     testcases->clear();
 
+    problemTimeLimit = data.timeLimit;
+    problemMemoryLimit = data.memoryLimit;
+    problemInputFile = Core::Runner::isValidFileIOName(data.inputFileName) ? data.inputFileName : QString();
+    problemOutputFile = Core::Runner::isValidFileIOName(data.outputFileName) ? data.outputFileName : QString();
+    if (!problemInputFile.isEmpty() || !problemOutputFile.isEmpty())
+        log.info("Companion", "This problem uses file I/O: " + describeFileIO());
+
     for (int i = 0; i < data.testcases.size(); ++i)
         testcases->addTestCase(data.testcases[i].input, data.testcases[i].output);
 
+    if (data.interactive && interactorPath.isEmpty())
+        log.warn("Companion", "This is an interactive problem, please choose an interactor to run the tests");
+
     setProblemURL(data.url);
 }
 
@@ -392,12 +477,15 @@ void MainWindow::setSettingsData(const Settings::SettingsData &data, bool should
 
     cftoolPath = data.cfPath;
 
-    if (cftools != nullptr && Network::CFTools::check(cftoolPath))
-    {
-        cftools->updatePath(cftoolPath);
-        if (submitToCodeforces != nullptr)
-            submitToCodeforces->setEnabled(true);
-    }
+    Core::ExecutorClient::setEnabled(data.isUseExecutor);
+    Core::PerfCounters::setEnabled(data.isHardwareCounters);
+    if (data.isHardwareCounters && shouldPerformDigonistic && !Core::PerfCounters::isAvailable())
+        log.warn("Hardware Counters", Core::PerfCounters::unavailableReason());
+    if (data.isUseExecutor)
+        Core::ExecutorClient::instance()->setSession(data.executorSession);
+
+    if (cftools != nullptr)
+        probeTool(Core::Toolchain::CFTools, cftoolPath);
 
     editor->setTabReplace(data.isTabsReplaced);
     editor->setTabReplaceSize(data.tabStop);
@@ -499,11 +587,387 @@ void MainWindow::compileAndRun()
     compile();
 }
 
+void MainWindow::runWithSanitizers()
+{
+    if (language != "C++")
+    {
+        log.warn("Sanitizers", "The sanitizer build is only supported for C++");
+        return;
+    }
+
+    stopSanitizeRun();
+    sanitizerReports.clear();
+    compileAndRun();
+    if (data.buildProfile != "Fast")
+        log.info("Sanitizers", "The timing is measured with the " + data.buildProfile + " build");
+
+    sanitizedText = editor->toPlainText();
+    sanitizeCompilingKey = Settings::compileCommandCpp(data, "Sanitize") + '\n' + sanitizedText;
+    if (sanitizeDir == nullptr)
+        sanitizeDir = new QTemporaryDir();
+    if (sanitizeCompilingKey == sanitizeCompiledKey && QFile::exists(sanitizeDir->filePath("sol")))
+    {
+        runSanitizeBuild();
+        return;
+    }
+
+    // the sanitizer build is cached in its own directory, so that it doesn't replace the binary of the tab
+    QFile file(sanitizeDir->filePath("sol.cpp"));
+    if (!sanitizeDir->isValid() || !file.open(QIODevice::WriteOnly | QIODevice::Text))
+    {
+        log.error("Sanitizers", "Failed to save the source to a temporary file");
+        return;
+    }
+    file.write(sanitizedText.toUtf8());
+    file.close();
+
+    if (sanitizeCompiler != nullptr)
+        delete sanitizeCompiler;
+    sanitizeCompiler = new Core::Compiler();
+    sanitizeCompiler->setScheduling(this, Core::Scheduler::Background);
+    connect(sanitizeCompiler, SIGNAL(compilationFinished(const QString &)), this,
+            SLOT(onSanitizeCompilationFinished(const QString &)));
+    connect(sanitizeCompiler, SIGNAL(compilationErrorOccured(const QString &)), this,
+            SLOT(onSanitizeCompilationErrorOccured(const QString &)));
+    sanitizeCompiledKey.clear();
+    sanitizeCompiler->start(sanitizeDir->filePath("sol.cpp"), Settings::compileCommandCpp(data, "Sanitize"), "C++");
+}
+
+void MainWindow::judge()
+{
+    judging = true;
+    judgeResult = QVector<JudgeResult>(testcases->count());
+    for (int i = 0; i < testcases->count(); ++i)
+    {
+        if (testcases->input(i).trimmed().isEmpty())
+            judgeResult[i].verdict = "SKIP";
+    }
+    stopJudging(QString()); // all the inputs may be empty
+    if (!judging)
+        return;
+
+    emit judgeUpdated(this);
+    log.clear();
+    if (!compiledKey.isEmpty() && compiledKey == compileKey() && QFile::exists(tmpPath()))
+    {
+        log.info("Compiler", "The code is not changed since the last compilation, reusing the binary");
+        run();
+    }
+    else
+    {
+        afterCompile = Run;
+        compile();
+    }
+}
+
+bool MainWindow::isJudging() const
+{
+    return judging;
+}
+
+QVector<MainWindow::JudgeResult> MainWindow::judgeResults() const
+{
+    return judgeResult;
+}
+
+void MainWindow::showDiff(int index)
+{
+    if (index >= 0 && index < testcases->count())
+        testcases->showDiff(index);
+}
+
 void MainWindow::formatSource()
 {
     formatter->format(editor, filePath, language, true);
 }
 
+void MainWindow::huntTLE()
+{
+    afterCompile = HuntTLE;
+    log.clear();
+    compile();
+}
+
+void MainWindow::estimateComplexity()
+{
+    afterCompile = EstimateComplexity;
+    log.clear();
+    compile();
+}
+
+void MainWindow::profileMemory()
+{
+    afterCompile = ProfileMemory;
+    log.clear();
+    compile();
+}
+
+void MainWindow::runBenchmark()
+{
+    afterCompile = RunBenchmark;
+    log.clear();
+    compile();
+}
+
+void MainWindow::comparePerformance(const QVector<MainWindow *> &tabs)
+{
+    const QString saved = "The saved version of " + getFileName(), file = "Another file...";
+    QStringList items;
+    if (!isUntitled())
+        items.push_back(saved);
+    items.push_back(file);
+    QVector<MainWindow *> others;
+    for (auto tab : tabs)
+    {
+        if (tab != this)
+        {
+            others.push_back(tab);
+            items.push_back("Tab " + QString::number(others.size()) + ": " + tab->getTabTitle(false, false));
+        }
+    }
+
+    bool ok = false;
+    auto item = QInputDialog::getItem(this, "Compare Performance", "Compare with the baseline:", items, 0, false, &ok);
+    if (!ok)
+        return;
+
+    if (item == saved)
+    {
+        baselineText = savedText;
+        baselineLanguage = language;
+        baselineName = "the saved version of " + getFileName();
+    }
+    else if (item == file)
+    {
+        auto path = QFileDialog::getOpenFileName(this, "Choose Baseline", QFileInfo(filePath).path(),
+                                                 "Source Files (*.cpp *.cc *.cxx *.java *.py *.py3);;All Files (*)");
+        QFile baseline(path);
+        if (path.isEmpty() || !baseline.open(QIODevice::ReadOnly | QIODevice::Text))
+            return;
+        baselineText = baseline.readAll();
+        baselineLanguage = Core::HeadlessJudge::languageOf(path);
+        if (baselineLanguage.isEmpty())
+            baselineLanguage = language;
+        baselineName = path;
+    }
+    else
+    {
+        auto tab = others[items.indexOf(item) - (items.size() - others.size())];
+        baselineText = tab->getEditor()->toPlainText();
+        baselineLanguage = tab->getLanguage();
+        baselineName = "the tab " + tab->getTabTitle(false, false);
+    }
+
+    afterCompile = ComparePerformance;
+    log.clear();
+    compile();
+}
+
+void MainWindow::profileRun()
+{
+    if (language != "C++")
+    {
+        log.warn("Profiler", "Profiling is only supported for C++");
+        return;
+    }
+    if (!Core::SamplingProfiler::isSupported())
+    {
+        log.warn("Profiler", "Profiling is only supported on Linux");
+        return;
+    }
+
+    QStringList items;
+    QVector<int> tests;
+    for (int i = 0; i < testcases->count(); ++i)
+    {
+        if (!testcases->input(i).trimmed().isEmpty())
+        {
+            tests.push_back(i);
+            items.push_back("Test #" + QString::number(i + 1));
+        }
+    }
+    if (tests.isEmpty())
+    {
+        log.warn("Profiler", "Please add a test with a non-empty input to profile");
+        return;
+    }
+    int chosen = 0;
+    if (tests.size() > 1)
+    {
+        bool ok = false;
+        auto item = QInputDialog::getItem(this, "Profile Run", "Profile the run on:", items, 0, false, &ok);
+        if (!ok)
+            return;
+        chosen = items.indexOf(item);
+    }
+    profileInput = testcases->input(tests[chosen]);
+    profiledText = editor->toPlainText();
+
+    // the profiled binary is built in its own directory, so that it doesn't replace the one of the tab
+    if (profileDir == nullptr)
+        profileDir = new QTemporaryDir();
+    QFile file(profileDir->filePath("sol.cpp"));
+    if (!profileDir->isValid() || !file.open(QIODevice::WriteOnly | QIODevice::Text))
+    {
+        log.error("Profiler", "Failed to save the source to a temporary file");
+        return;
+    }
+    file.write(profiledText.toUtf8());
+    file.close();
+
+    if (profileCompiler != nullptr)
+        delete profileCompiler;
+    profileCompiler = new Core::Compiler();
+    profileCompiler->setScheduling(this, Core::Scheduler::Interactive);
+    connect(profileCompiler, SIGNAL(compilationFinished(const QString &)), this,
+            SLOT(onProfileCompilationFinished(const QString &)));
+    connect(profileCompiler, SIGNAL(compilationErrorOccured(const QString &)), this,
+            SLOT(onProfileCompilationErrorOccured(const QString &)));
+    log.clear();
+    log.info("Profiler", "Compiling with debug information for test #" + QString::number(tests[chosen] + 1));
+    // the later options override the ones of the Fast profile, the frame pointers are needed for the call stacks
+    profileCompiler->start(profileDir->filePath("sol.cpp"),
+                           Settings::compileCommandCpp(data, "Fast") + " -g -O2 -fno-omit-frame-pointer", "C++");
+}
+
+void MainWindow::countLineExecutions()
+{
+    if (language != "C++")
+    {
+        log.warn("Line Counts", "Counting the line executions is only supported for C++");
+        return;
+    }
+
+    QStringList items;
+    QVector<int> tests;
+    for (int i = 0; i < testcases->count(); ++i)
+    {
+        if (!testcases->input(i).trimmed().isEmpty())
+        {
+            tests.push_back(i);
+            items.push_back("Test #" + QString::number(i + 1));
+        }
+    }
+    if (tests.isEmpty())
+    {
+        log.warn("Line Counts", "Please add a test with a non-empty input to run");
+        return;
+    }
+    coveredTests = tests;
+    if (tests.size() > 1)
+    {
+        const QString all = "All tests";
+        items.push_front(all);
+        bool ok = false;
+        auto item = QInputDialog::getItem(this, "Count Line Executions", "Count the executions on:", items, 0, false,
+                                          &ok);
+        if (!ok)
+            return;
+        if (item != all)
+            coveredTests = {tests[items.indexOf(item) - 1]};
+    }
+    coveredText = editor->toPlainText();
+
+    // the instrumented binary is built in its own directory, so that it doesn't replace the one of the tab
+    if (coverageDir == nullptr)
+        coverageDir = new QTemporaryDir();
+    QFile file(coverageDir->filePath("sol.cpp"));
+    if (!coverageDir->isValid() || !file.open(QIODevice::WriteOnly | QIODevice::Text))
+    {
+        log.error("Line Counts", "Failed to save the source to a temporary file");
+        return;
+    }
+    file.write(coveredText.toUtf8());
+    file.close();
+
+    if (coverageCompiler != nullptr)
+        delete coverageCompiler;
+    coverageCompiler = new Core::Compiler();
+    coverageCompiler->setScheduling(this, Core::Scheduler::Interactive);
+    connect(coverageCompiler, SIGNAL(compilationFinished(const QString &)), this,
+            SLOT(onCoverageCompilationFinished(const QString &)));
+    connect(coverageCompiler, SIGNAL(compilationErrorOccured(const QString &)), this,
+            SLOT(onCoverageCompilationErrorOccured(const QString &)));
+    log.clear();
+    log.info("Line Counts", "Compiling with the coverage counters");
+    // without optimizations, the counts belong to the lines as they are written, -O0 overrides the one of the profile
+    coverageCompiler->start(coverageDir->filePath("sol.cpp"),
+                            Settings::compileCommandCpp(data, "Fast") + " -O0 --coverage", "C++");
+}
+
+void MainWindow::chooseChecker()
+{
+    const QString builtin = "Built-in (ignore trailing spaces)", custom = "Custom checker...";
+    bool ok = false;
+    auto item = QInputDialog::getItem(this, "Checker", "Judge the outputs with:", {builtin, custom},
+                                      checker->checkerPath().isEmpty() ? 0 : 1, false, &ok);
+    if (!ok)
+        return;
+    if (item == builtin)
+    {
+        setChecker(QString());
+        return;
+    }
+    auto path = QFileDialog::getOpenFileName(this, "Choose Checker", checker->checkerPath(),
+                                             "testlib checker (*.cpp *.cc *.cxx);;Executable (*)");
+    if (!path.isEmpty())
+        setChecker(path);
+}
+
+void MainWindow::chooseInteractor()
+{
+    if (!interactorPath.isEmpty())
+    {
+        auto response = QMessageBox::question(this, "Interactor",
+                                              "The tests are run with the interactor [" + interactorPath +
+                                                  "].\n\nChoose another one? Reset to run without interactor.",
+                                              QMessageBox::Yes | QMessageBox::No | QMessageBox::Reset);
+        if (response == QMessageBox::Reset)
+        {
+            interactorPath.clear();
+            log.info("Interactor", "The tests are run without interactor");
+        }
+        if (response != QMessageBox::Yes)
+            return;
+    }
+    auto path = QFileDialog::getOpenFileName(this, "Choose Interactor", interactorPath,
+                                             "testlib interactor (*.cpp *.cc *.cxx);;Executable (*)");
+    if (!path.isEmpty())
+    {
+        interactorPath = path;
+        log.info("Interactor", "The tests are run with the interactor [" + path + "]");
+    }
+}
+
+void MainWindow::chooseFileIO()
+{
+    bool ok = false;
+    auto input = QInputDialog::getText(this, "File I/O", "Input file name (leave it empty to read from stdin):",
+                                       QLineEdit::Normal, problemInputFile, &ok)
+                     .trimmed();
+    if (!ok)
+        return;
+    auto output = QInputDialog::getText(this, "File I/O", "Output file name (leave it empty to write to stdout):",
+                                        QLineEdit::Normal, problemOutputFile, &ok)
+                      .trimmed();
+    if (!ok)
+        return;
+    if (!Core::Runner::isValidFileIOName(input) || !Core::Runner::isValidFileIOName(output))
+    {
+        QMessageBox::warning(this, "File I/O", "The file names should be plain names without directories.");
+        return;
+    }
+    problemInputFile = input;
+    problemOutputFile = output;
+    log.info("File I/O", describeFileIO());
+}
+
+QString MainWindow::describeFileIO() const
+{
+    return "the input is read from " + (problemInputFile.isEmpty() ? "stdin" : "[" + problemInputFile + "]") +
+           ", the output is written to " + (problemOutputFile.isEmpty() ? "stdout" : "[" + problemOutputFile + "]");
+}
+
 void MainWindow::setLanguage(QString lang)
 {
     log.clear();
@@ -579,7 +1043,7 @@ void MainWindow::detachedExecution()
     compile();
 }
 
-void MainWindow::killProcesses()
+void MainWindow::killProcesses(bool keepSanitizeRun)
 {
     if (compiler != nullptr)
     {
@@ -587,6 +1051,27 @@ void MainWindow::killProcesses()
         compiler = nullptr;
     }
 
+    if (baselineCompiler != nullptr)
+    {
+        delete baselineCompiler;
+        baselineCompiler = nullptr;
+    }
+
+    if (profileCompiler != nullptr)
+    {
+        delete profileCompiler;
+        profileCompiler = nullptr;
+    }
+
+    if (coverageCompiler != nullptr)
+    {
+        delete coverageCompiler;
+        coverageCompiler = nullptr;
+    }
+
+    if (coverageProfiler != nullptr)
+        coverageProfiler->stop();
+
     for (auto &t : runner)
     {
         if (t != nullptr)
@@ -596,6 +1081,17 @@ void MainWindow::killProcesses()
     }
     runner.clear();
 
+    for (auto t : interactiveRunner)
+    {
+        if (t != nullptr)
+            delete t;
+    }
+    interactiveRunner.clear();
+
+    checker->cancel();
+    if (!keepSanitizeRun)
+        stopSanitizeRun();
+
     if (detachedRunner != nullptr)
     {
         delete detachedRunner;
@@ -951,30 +1447,61 @@ QSplitter *MainWindow::getRightSplitter()
 void MainWindow::performCoreDiagonistics()
 {
     log.clear();
-    bool formatResult = Core::Formatter::check(data.clangFormatBinary, data.clangFormatStyle);
-    bool compilerResult = true;
-    bool runResults = true;
+    probeTool(Core::Toolchain::Formatter, data.clangFormatBinary, data.clangFormatStyle);
 
     if (language == "C++")
-        compilerResult = Core::Compiler::check(data.compileCommandCpp);
+        probeTool(Core::Toolchain::Compiler, data.compileCommandCpp);
 
     if (language == "Java")
     {
-        compilerResult = Core::Compiler::check(data.compileCommandJava);
-        runResults = Core::Compiler::check(data.runCommandJava);
+        probeTool(Core::Toolchain::Compiler, data.compileCommandJava);
+        probeTool(Core::Toolchain::Compiler, data.runCommandJava);
     }
 
     if (language == "Python")
-        compilerResult = Core::Compiler::check(data.runCommandPython);
+        probeTool(Core::Toolchain::Compiler, data.runCommandPython);
+}
+
+Core::Toolchain::Status MainWindow::probeTool(int tool, const QString &command, const QString &options)
+{
+    auto status = Core::Toolchain::instance()->probe(static_cast<Core::Toolchain::Tool>(tool), command, options);
+    if (status == Core::Toolchain::Unknown)
+        pendingProbes.insert(QString::number(tool) + '\n' + command + '\n' + options);
+    else
+        reportToolStatus(tool, command, status == Core::Toolchain::Available);
+    return status;
+}
 
-    if (!formatResult)
-        log.warn("Formatter", "Code formatting failed to work. Please check whether the clang-format binary is in the "
-                              "PATH and the style is valid.");
-    if (!compilerResult)
-        log.error("Compiler", "Compiler command for " + language + " is invalid. Is compiler on PATH?");
-    if (!runResults)
-        log.error("Runner",
-                  "Binary or Script won't be executed because its corresponding program or VM could not be loaded");
+void MainWindow::reportToolStatus(int tool, const QString &command, bool available)
+{
+    switch (tool)
+    {
+    case Core::Toolchain::Formatter:
+        if (!available)
+            log.warn("Formatter", "Code formatting failed to work. Please check whether the clang-format binary is in "
+                                  "the PATH and the style is valid.");
+        break;
+    case Core::Toolchain::Compiler:
+        if (available)
+            break;
+        if (language == "Java" && command == data.runCommandJava && command != data.compileCommandJava)
+            log.error("Runner",
+                      "Binary or Script won't be executed because its corresponding program or VM could not be loaded");
+        else
+            log.error("Compiler", "Compiler command for " + language + " is invalid. Is compiler on PATH?");
+        break;
+    case Core::Toolchain::CFTools:
+        if (cftools == nullptr)
+            break;
+        if (available)
+            cftools->updatePath(cftoolPath);
+        else
+            log.error("CFTools", "You will not be able to submit code to Codeforces because CFTools is not installed "
+                                 "or is not on SYSTEM PATH. You can set it manually in settings.");
+        if (submitToCodeforces != nullptr)
+            submitToCodeforces->setEnabled(available);
+        break;
+    }
 }
 
 // -------------------- COMPILER SLOTS ---------------------------
@@ -986,6 +1513,7 @@ void MainWindow::onCompilationStarted()
 
 void MainWindow::onCompilationFinished(const QString &warning)
 {
+    compiledKey = compilingKey;
     if (language != "Python")
     {
         log.info("Compiler", "Compilation has finished");
@@ -1004,25 +1532,8 @@ void MainWindow::onCompilationFinished(const QString &warning)
         killProcesses();
 
         QString command, args;
-        if (language == "C++")
-        {
-            args = data.runtimeArgumentsCpp;
-        }
-        else if (language == "Java")
-        {
-            command = data.runCommandJava;
-            args = data.runtimeArgumentsJava;
-        }
-        else if (language == "Python")
-        {
-            command = data.runCommandPython;
-            args = data.runtimeArgumentsPython;
-        }
-        else
-        {
-            log.warn("Runner", "Wrong language, please set the language");
+        if (!getRunCommand(command, args))
             return;
-        }
 
         detachedRunner = new Core::Runner(-1);
         connect(detachedRunner, SIGNAL(runStarted(int)), this, SLOT(onRunStarted(int)));
@@ -1031,13 +1542,35 @@ void MainWindow::onCompilationFinished(const QString &warning)
         connect(detachedRunner, SIGNAL(runKilled(int)), this, SLOT(onRunKilled(int)));
         detachedRunner->runDetached(tmpPath(), language, command, args);
     }
+    else if (afterCompile == HuntTLE)
+    {
+        openTLEHunter();
+    }
+    else if (afterCompile == EstimateComplexity)
+    {
+        openComplexityWidget();
+    }
+    else if (afterCompile == RunBenchmark)
+    {
+        openBenchmark();
+    }
+    else if (afterCompile == ComparePerformance)
+    {
+        compileBaseline();
+    }
+    else if (afterCompile == ProfileMemory)
+    {
+        openMemoryProfile();
+    }
 }
 
 void MainWindow::onCompilationErrorOccured(const QString &error)
 {
+    compiledKey.clear();
     log.error("Complier", "Error occured while compiling");
     if (!error.trimmed().isEmpty())
         log.error("Compile Errors", error);
+    stopJudging("CE");
 }
 
 // --------------------- RUNNER SLOTS ----------------------------
@@ -1049,40 +1582,571 @@ QString MainWindow::getRunnerHead(int index)
     return "Runner[" + QString::number(index + 1) + "]";
 }
 
+bool MainWindow::getRunCommand(QString &command, QString &args)
+{
+    return getRunCommand(language, command, args);
+}
+
+bool MainWindow::getRunCommand(const QString &lang, QString &command, QString &args)
+{
+    if (lang == "C++")
+    {
+        args = data.runtimeArgumentsCpp;
+    }
+    else if (lang == "Java")
+    {
+        command = data.runCommandJava;
+        args = data.runtimeArgumentsJava;
+    }
+    else if (lang == "Python")
+    {
+        command = data.runCommandPython;
+        args = data.runtimeArgumentsPython;
+    }
+    else
+    {
+        log.warn("Runner", "Wrong language, please set the language");
+        return false;
+    }
+    return true;
+}
+
+int MainWindow::getTimeLimit() const
+{
+    // the time limit of the problem if it's parsed by Competitive Companion, otherwise the one in the preferences,
+    // both are the limits on the judge and they are scaled to the speed of this machine
+    return Settings::localTimeLimit(data, problemTimeLimit > 0 ? problemTimeLimit : data.timeLimit);
+}
+
+QString MainWindow::formatTime(int time) const
+{
+    int judgeTime = Settings::judgeTime(data, time);
+    if (judgeTime == time)
+        return QString::number(time) + "ms";
+    return QString::number(judgeTime) + " judge-equivalent ms (" + QString::number(time) + "ms here)";
+}
+
+void MainWindow::openTLEHunter()
+{
+    QString command, args;
+    if (!getRunCommand(command, args))
+        return;
+
+    if (tleHunter == nullptr)
+    {
+        tleHunter = new TLEHunterWindow(generatorCommand, this);
+        tleHunter->setAttribute(Qt::WA_DeleteOnClose);
+        connect(tleHunter, &TLEHunterWindow::generatorCommandChanged, this,
+                [this](const QString &newCommand) { generatorCommand = newCommand; });
+        connect(tleHunter, &TLEHunterWindow::addTestCaseRequested, this,
+                [this](const QString &input) { testcases->addTestCase(input); });
+    }
+    tleHunter->setWindowTitle("TLE Hunter - " + getFileName());
+    tleHunter->setTarget(tmpPath(), language, command, args, getTimeLimit());
+    tleHunter->setFileIO(problemInputFile, problemOutputFile);
+    tleHunter->show();
+    tleHunter->raise();
+}
+
+void MainWindow::openComplexityWidget()
+{
+    QString command, args;
+    if (!getRunCommand(command, args))
+        return;
+
+    if (complexityWidget == nullptr)
+    {
+        complexityWidget = new ComplexityWidget(this);
+        connect(complexityWidget, &ComplexityWidget::generatorCommandChanged, this,
+                [this](const QString &newCommand) { generatorCommand = newCommand; });
+        ui->right_splitter->addWidget(complexityWidget);
+    }
+    complexityWidget->setGeneratorCommand(generatorCommand);
+    complexityWidget->setTarget(tmpPath(), language, command, args, getTimeLimit());
+    complexityWidget->setFileIO(problemInputFile, problemOutputFile);
+    complexityWidget->show();
+}
+
+void MainWindow::openMemoryProfile()
+{
+    QString command, args;
+    if (!getRunCommand(command, args))
+        return;
+
+    if (memoryProfileWidget == nullptr)
+    {
+        memoryProfileWidget = new MemoryProfileWidget(this);
+        ui->right_splitter->addWidget(memoryProfileWidget);
+    }
+    memoryProfileWidget->setTarget(tmpPath(), language, command, args, getTimeLimit(), problemMemoryLimit,
+                                   testcases->inputs());
+    memoryProfileWidget->setFileIO(problemInputFile, problemOutputFile);
+    memoryProfileWidget->show();
+}
+
+void MainWindow::openBenchmark()
+{
+    QString command, args;
+    if (!getRunCommand(command, args))
+        return;
+
+    if (benchmarkWindow == nullptr)
+    {
+        benchmarkWindow = new BenchmarkWindow(this);
+        benchmarkWindow->setAttribute(Qt::WA_DeleteOnClose);
+    }
+    benchmarkWindow->setWindowTitle("Benchmark - " + getFileName());
+    benchmarkWindow->setTarget(tmpPath(), language, command, args, getTimeLimit(), testcases->inputs());
+    benchmarkWindow->setFileIO(problemInputFile, problemOutputFile);
+    benchmarkWindow->show();
+    benchmarkWindow->raise();
+}
+
+void MainWindow::compileBaseline()
+{
+    if (baselineDir == nullptr)
+        baselineDir = new QTemporaryDir();
+    QFile file(baselinePath());
+    if (!baselineDir->isValid() || baselinePath().isEmpty() || !file.open(QIODevice::WriteOnly | QIODevice::Text))
+    {
+        log.error("Compare", "Failed to save the baseline to a temporary file");
+        return;
+    }
+    file.write(baselineText.toUtf8());
+    file.close();
+
+    QString command;
+    if (baselineLanguage == "C++")
+        command = Settings::compileCommandCpp(data);
+    else if (baselineLanguage == "Java")
+        command = data.compileCommandJava;
+
+    if (baselineCompiler != nullptr)
+        delete baselineCompiler;
+    baselineCompiler = new Core::Compiler();
+    baselineCompiler->setScheduling(this, Core::Scheduler::Interactive);
+    connect(baselineCompiler, SIGNAL(compilationFinished(const QString &)), this,
+            SLOT(onBaselineCompilationFinished(const QString &)));
+    connect(baselineCompiler, SIGNAL(compilationErrorOccured(const QString &)), this,
+            SLOT(onBaselineCompilationErrorOccured(const QString &)));
+    baselineCompiler->start(baselinePath(), command, baselineLanguage);
+}
+
+QString MainWindow::baselinePath() const
+{
+    // the baseline is compiled in its own directory, so that its binary doesn't replace the one of the tab
+    if (baselineLanguage == "C++")
+        return baselineDir->filePath("sol.cpp");
+    if (baselineLanguage == "Java")
+        return baselineDir->filePath("sol.java");
+    if (baselineLanguage == "Python")
+        return baselineDir->filePath("sol.py");
+    return QString();
+}
+
+void MainWindow::onBaselineCompilationFinished(const QString &warning)
+{
+    log.info("Compare", "The baseline has been compiled");
+    openComparison();
+}
+
+void MainWindow::onBaselineCompilationErrorOccured(const QString &error)
+{
+    log.error("Compare", "Error occured while compiling the baseline");
+    if (!error.trimmed().isEmpty())
+        log.error("Compile Errors", error);
+}
+
+void MainWindow::onProfileCompilationFinished(const QString &warning)
+{
+    log.info("Profiler", "Compiled, profiling the run");
+    if (profilerWindow == nullptr)
+    {
+        profilerWindow = new ProfilerWindow(this);
+        profilerWindow->setAttribute(Qt::WA_DeleteOnClose);
+        connect(profilerWindow, SIGNAL(heatChanged(const QVector<double> &)), this,
+                SLOT(onProfileHeatChanged(const QVector<double> &)));
+        connect(profilerWindow, SIGNAL(lineRequested(int)), this, SLOT(onProfileLineRequested(int)));
+    }
+    profilerWindow->setWindowTitle("Profiler - " + getFileName());
+    profilerWindow->show();
+    profilerWindow->raise();
+    profilerWindow->setFileIO(problemInputFile, problemOutputFile);
+    // a slow solution is profiled until well after its time limit, its samples are still shown
+    profilerWindow->start(profileDir->filePath("sol"), profileDir->filePath("sol.cpp"), profileInput,
+                          qMax(getTimeLimit() * 5, 10000));
+}
+
+void MainWindow::onProfileCompilationErrorOccured(const QString &error)
+{
+    log.error("Profiler", "Error occured while compiling for profiling");
+    if (!error.trimmed().isEmpty())
+        log.error("Compile Errors", error);
+}
+
+void MainWindow::onProfileHeatChanged(const QVector<double> &heat)
+{
+    if (!heat.isEmpty() && editor->toPlainText() != profiledText)
+    {
+        log.warn("Profiler", "The code has been changed since it was profiled, the hot lines are not shown");
+        heatGutter->clear();
+        return;
+    }
+    heatGutter->setHeat(heat);
+}
+
+void MainWindow::onProfileLineRequested(int line)
+{
+    auto block = editor->document()->findBlockByNumber(line);
+    if (!block.isValid())
+        return;
+    QTextCursor cursor(block);
+    editor->setTextCursor(cursor);
+    editor->ensureCursorVisible();
+    activateWindow();
+    editor->setFocus();
+}
+
+void MainWindow::onCoverageCompilationFinished(const QString &warning)
+{
+    QStringList inputs;
+    for (auto index : coveredTests)
+        inputs.push_back(testcases->input(index));
+    log.info("Line Counts", "Compiled, running " + QString::number(inputs.size()) + " test(s)");
+
+    if (coverageProfiler == nullptr)
+    {
+        coverageProfiler = new Core::CoverageProfiler(this);
+        coverageProfiler->setScheduling(this, Core::Scheduler::Interactive);
+        connect(coverageProfiler, SIGNAL(profilingFinished()), this, SLOT(onCoverageFinished()));
+        connect(coverageProfiler, SIGNAL(errorOccured(const QString &)), this,
+                SLOT(onCoverageErrorOccured(const QString &)));
+    }
+    coverageProfiler->setFileIO(problemInputFile, problemOutputFile);
+    // the instrumented binary is much slower, so it's stopped well after the time limit
+    coverageProfiler->start(coverageDir->filePath("sol"), coverageDir->filePath("sol.cpp"), inputs,
+                            qMax(getTimeLimit() * 5, 10000), qMax(1, QThread::idealThreadCount() - 1));
+}
+
+void MainWindow::onCoverageCompilationErrorOccured(const QString &error)
+{
+    log.error("Line Counts", "Error occured while compiling with the coverage counters");
+    if (!error.trimmed().isEmpty())
+        log.error("Compile Errors", error);
+}
+
+void MainWindow::onCoverageFinished()
+{
+    auto result = coverageProfiler->result();
+    for (auto index : result.killed)
+    {
+        log.warn("Line Counts", "Test #" + QString::number(coveredTests.value(index) + 1) +
+                                    " didn't finish normally, its executions are not counted");
+    }
+
+    if (editor->toPlainText() != coveredText)
+    {
+        log.warn("Line Counts", "The code has been changed since it was run, the counts are not shown");
+        return;
+    }
+
+    int hottest = -1;
+    for (int i = 0; i < result.lines.size(); ++i)
+    {
+        if (hottest == -1 || result.lines[i] > result.lines[hottest])
+            hottest = i;
+    }
+    heatGutter->setCounts(result.lines);
+    if (hottest >= 0)
+    {
+        log.info("Line Counts", "Counted the executions of " + QString::number(result.runs) + " run(s), line " +
+                                    QString::number(hottest + 1) + " is executed the most, " +
+                                    QString::number(result.lines[hottest]) + " times");
+    }
+}
+
+void MainWindow::onCoverageErrorOccured(const QString &error)
+{
+    log.error("Line Counts", error);
+}
+
+void MainWindow::onSanitizeCompilationFinished(const QString &warning)
+{
+    sanitizeCompiledKey = sanitizeCompilingKey;
+    runSanitizeBuild();
+}
+
+void MainWindow::onSanitizeCompilationErrorOccured(const QString &error)
+{
+    log.error("Sanitizers", "Error occured while compiling the sanitizer build");
+    if (!error.trimmed().isEmpty())
+        log.error("Compile Errors", error);
+}
+
+void MainWindow::onSanitizeRunFinished(int index, const QByteArray &out, const QByteArray &err, int exitCode,
+                                       int timeUsed)
+{
+    auto errorText = QString::fromUtf8(err);
+    auto report = Core::SanitizerReport::parse(errorText);
+    if (report.isEmpty() && exitCode != 0)
+    {
+        report.errors = 1;
+        report.summary = "exited with code " + QString::number(exitCode);
+        report.details = errorText.left(Core::SanitizerReport::MAX_DETAILS);
+    }
+    sanitizerReports[index] = report;
+    if (index < testcases->count())
+        testcases->setSanitizerReport(index, report);
+    if (!report.isEmpty())
+        log.error("Sanitizers", "Test #" + QString::number(index + 1) + ": " + report.summary);
+}
+
+void MainWindow::onSanitizeRunErrorOccured(int index, const QString &error)
+{
+    log.error("Sanitizers", "Test #" + QString::number(index + 1) + ": " + error);
+}
+
+void MainWindow::onSanitizeRunTimeout(int index)
+{
+    log.warn("Sanitizers", "Test #" + QString::number(index + 1) + " is too slow with the sanitizers, it's stopped");
+}
+
+void MainWindow::runSanitizeBuild()
+{
+    QString command, args;
+    if (!getRunCommand(command, args))
+        return;
+
+    for (auto runner : sanitizeRunners)
+        delete runner;
+    sanitizeRunners = QVector<Core::Runner *>(testcases->count(), nullptr);
+    for (int i = 0; i < testcases->count(); ++i)
+    {
+        if (testcases->input(i).trimmed().isEmpty())
+            continue;
+        // the timing runs go first, the sanitizer build is several times slower, so it gets a longer time limit
+        sanitizeRunners[i] = new Core::Runner(i);
+        sanitizeRunners[i]->setScheduling(this, Core::Scheduler::Background);
+        sanitizeRunners[i]->setFileIO(problemInputFile, problemOutputFile);
+        connect(sanitizeRunners[i], SIGNAL(runFinished(int, const QByteArray &, const QByteArray &, int, int)), this,
+                SLOT(onSanitizeRunFinished(int, const QByteArray &, const QByteArray &, int, int)));
+        connect(sanitizeRunners[i], SIGNAL(runErrorOccured(int, const QString &)), this,
+                SLOT(onSanitizeRunErrorOccured(int, const QString &)));
+        connect(sanitizeRunners[i], SIGNAL(runTimeout(int)), this, SLOT(onSanitizeRunTimeout(int)));
+        sanitizeRunners[i]->run(sanitizeDir->filePath("sol.cpp"), "C++", command, args, testcases->input(i),
+                                getTimeLimit() * 5);
+    }
+}
+
+void MainWindow::stopSanitizeRun()
+{
+    if (sanitizeCompiler != nullptr)
+    {
+        delete sanitizeCompiler;
+        sanitizeCompiler = nullptr;
+    }
+    for (auto runner : sanitizeRunners)
+        delete runner;
+    sanitizeRunners.clear();
+}
+
+void MainWindow::openComparison()
+{
+    Core::PerformanceComparison::Target baseline, current;
+    if (!getRunCommand(language, current.runCommand, current.args) ||
+        !getRunCommand(baselineLanguage, baseline.runCommand, baseline.args))
+        return;
+    current.filePath = tmpPath();
+    current.lang = language;
+    baseline.filePath = baselinePath();
+    baseline.lang = baselineLanguage;
+    current.inputFileName = baseline.inputFileName = problemInputFile;
+    current.outputFileName = baseline.outputFileName = problemOutputFile;
+
+    if (comparisonWindow == nullptr)
+    {
+        comparisonWindow = new ComparisonWindow(this);
+        comparisonWindow->setAttribute(Qt::WA_DeleteOnClose);
+    }
+    comparisonWindow->setWindowTitle("Compare Performance - " + getFileName());
+    comparisonWindow->setTargets(baseline, baselineName, current, getTimeLimit(), testcases->inputs(),
+                                 testcases->expecteds());
+    comparisonWindow->show();
+    comparisonWindow->raise();
+}
+
+void MainWindow::setChecker(const QString &path)
+{
+    checker->setChecker(path, data.compileCommandCpp);
+    testcases->setCustomChecker(!path.isEmpty());
+    if (!path.isEmpty())
+        log.info("Checker", "The outputs are judged by [" + path + "]");
+}
+
+void MainWindow::runInteractive(const QString &command, const QString &args)
+{
+    bool isRun = false;
+    interactiveRunner.resize(testcases->count());
+
+    for (int i = 0; i < testcases->count(); ++i)
+    {
+        if (!testcases->input(i).trimmed().isEmpty())
+        {
+            isRun = true;
+            interactiveRunner[i] = new Core::InteractiveRunner(i);
+            interactiveRunner[i]->setScheduling(this, Core::Scheduler::Interactive);
+            connect(interactiveRunner[i], &Core::InteractiveRunner::interactionFinished, this,
+                    &MainWindow::onInteractionFinished);
+            interactiveRunner[i]->run(tmpPath(), language, command, args, interactorPath, data.compileCommandCpp,
+                                      testcases->input(i), testcases->expected(i), getTimeLimit(),
+                                      problemMemoryLimit);
+        }
+    }
+
+    if (!isRun)
+        log.warn("Interactor", "All inputs are empty, nothing to run");
+}
+
+QString MainWindow::compileKey() const
+{
+    // the compiled binary can be reused if neither the code nor the way it's compiled has changed
+    QString command;
+    if (language == "C++")
+        command = Settings::compileCommandCpp(data);
+    else if (language == "Java")
+        command = data.compileCommandJava;
+    return language + '\n' + command + '\n' + editor->toPlainText();
+}
+
+void MainWindow::setJudgeResult(int index, const QString &verdict, int timeUsed, qint64 peakMemory)
+{
+    if (!judging || index < 0 || index >= judgeResult.size() || !judgeResult[index].verdict.isEmpty())
+        return;
+
+    if (index < runner.size() && runner[index] != nullptr)
+    {
+        auto stats = runner[index]->stats();
+        timeUsed = stats.cpuTime;
+        peakMemory = stats.peakMemory;
+    }
+    judgeResult[index].verdict = verdict;
+    judgeResult[index].timeUsed = timeUsed >= 0 ? Settings::judgeTime(data, timeUsed) : timeUsed;
+    judgeResult[index].peakMemory = peakMemory;
+    stopJudging(QString()); // stop if this was the last one
+    emit judgeUpdated(this);
+}
+
+void MainWindow::stopJudging(const QString &verdict)
+{
+    // set the verdict of the pending tests, an empty verdict only checks whether all the tests are judged
+    if (!judging)
+        return;
+    bool pending = false;
+    for (auto &result : judgeResult)
+    {
+        if (result.verdict.isEmpty() && !verdict.isEmpty())
+            result.verdict = verdict;
+        pending |= result.verdict.isEmpty();
+    }
+    if (pending)
+        return;
+    judging = false;
+    emit judgeUpdated(this);
+}
+
 void MainWindow::onRunStarted(int index)
 {
     log.info(getRunnerHead(index), "Execution has started");
 }
 
-void MainWindow::onRunFinished(int index, const QString &out, const QString &err, int exitCode, int timeUsed)
+void MainWindow::onRunFinished(int index, const QByteArray &out, const QByteArray &err, int exitCode, int timeUsed)
 {
     auto head = getRunnerHead(index);
 
-    if (exitCode == 0)
+    QString startInfo;
+    if (index >= 0 && index < runner.size() && runner[index] != nullptr && runner[index]->stats().startLatency >= 0)
+        startInfo = " (started in " + QString::number(runner[index]->stats().startLatency / 1000.0, 'f', 2) + "ms)";
+
+    if (earlyWrongAnswers.contains(index))
+    {
+        log.warn(head, "Execution for test case #" + QString::number(index + 1) + " has been stopped after " +
+                           formatTime(timeUsed) + " at the first wrong answer" + startInfo);
+    }
+
+    else if (exitCode == 0)
     {
         log.info(head, "Execution for test case #" + QString::number(index + 1) + " has finished in " +
-                           QString::number(timeUsed) + "ms");
+                           formatTime(timeUsed) + startInfo);
     }
 
     else
     {
         log.error(head, "Execution for test case #" + QString::number(index + 1) +
                             " has finished with non-zero exitcode " + QString::number(exitCode) + " in " +
-                            QString::number(timeUsed) + "ms");
+                            formatTime(timeUsed) + startInfo);
     }
 
     if (!err.trimmed().isEmpty())
-        log.error(head + "/stderr", err);
+        log.error(head + "/stderr", QString::fromUtf8(err));
     testcases->setOutput(index, out);
+    if (index >= 0 && index < runner.size() && runner[index] != nullptr)
+    {
+        auto stats = runner[index]->stats();
+        testcases->setRunStats(index, timeUsed, Settings::judgeTime(data, timeUsed), stats);
+        if (stats.isIOBound())
+        {
+            log.warn(head, "Test case #" + QString::number(index + 1) + " looks I/O bound: " + stats.ioSummary() +
+                               ". Consider buffered input and output.");
+        }
+    }
+    if (earlyWrongAnswers.contains(index))
+        testcases->setVerdict(index, TestCase::WA, earlyWrongAnswers[index]);
+    else if (!checker->checkerPath().isEmpty())
+        checker->check(index, testcases->input(index), out, testcases->expected(index));
+
+    QString verdict;
+    if (earlyWrongAnswers.contains(index))
+        verdict = "WA";
+    else if (judgeTimeouts.contains(index))
+        verdict = "TLE";
+    else if (exitCode != 0)
+        verdict = "RE";
+    else if (checker->checkerPath().isEmpty())
+    {
+        auto testVerdict = testcases->verdict(index);
+        verdict = testVerdict == TestCase::AC ? "AC" : (testVerdict == TestCase::WA ? "WA" : "OK");
+    }
+    if (!verdict.isEmpty())
+        setJudgeResult(index, verdict);
+
+    // a run of an unknown version of the code can't be compared with the other revisions
+    if (index >= 0 && index < runner.size() && runner[index] != nullptr && !runKey.isEmpty())
+    {
+        Core::RunHistory::Record record;
+        record.timestamp = QDateTime::currentMSecsSinceEpoch();
+        record.sourceHash = Core::RunHistory::hash(runKey);
+        record.testHash = Core::RunHistory::hash(testcases->input(index));
+        record.profile = language == "C++" ? data.buildProfile : QString();
+        record.verdict = verdict;
+        record.cpuTime = runner[index]->stats().cpuTime;
+        record.peakMemory = runner[index]->stats().peakMemory;
+        // the verdict of a custom checker comes later
+        if (verdict.isEmpty())
+            pendingHistory[index] = record;
+        else
+            recordRun(index, record);
+    }
 }
 
 void MainWindow::onRunErrorOccured(int index, const QString &error)
 {
     log.error(getRunnerHead(index), error);
+    setJudgeResult(index, "FAIL");
 }
 
 void MainWindow::onRunTimeout(int index)
 {
+    judgeTimeouts.insert(index);
     log.warn(getRunnerHead(index), "Time Limit Exceeded");
 }
 
@@ -1092,3 +2156,145 @@ void MainWindow::onRunKilled(int index)
              (index == -1 ? "Detached runner" : "Runner for test case #" + QString::number(index + 1)) +
                  " has been killed");
 }
+
+void MainWindow::onRunWrongAnswer(int index, const QString &message)
+{
+    earlyWrongAnswers[index] = message;
+    log.error(getRunnerHead(index), message);
+}
+
+void MainWindow::onRunOutputStreamed(int index, const QByteArray &chunk, qint64 total)
+{
+    if (index >= 0 && index < testcases->count())
+        testcases->appendOutput(index, chunk, total);
+}
+
+void MainWindow::onRunLeakedProcesses(int index, const QStringList &processes)
+{
+    auto shown = processes.mid(0, 5).join(", ") + (processes.size() > 5 ? ", ..." : "");
+    log.warn(getRunnerHead(index), "Test case #" + QString::number(index + 1) + " left " +
+                                       QString::number(processes.size()) +
+                                       " process(es) running after it exited, they have been killed: " + shown);
+}
+
+void MainWindow::onInteractionFinished(int index, const Core::InteractiveRunner::Result &result)
+{
+    if (index < 0 || index >= testcases->count())
+        return;
+
+    auto head = "Interactor[" + QString::number(index + 1) + "]";
+    auto verdict = Core::InteractiveRunner::verdictName(result.verdict);
+    if (!result.message.isEmpty())
+        verdict += ": " + result.message;
+
+    testcases->setOutput(index, result.transcript.toUtf8());
+    switch (result.verdict)
+    {
+    case Core::InteractiveRunner::Accepted:
+        testcases->setVerdict(index, TestCase::AC, verdict);
+        log.info(head, verdict + " in " + QString::number(result.stats.cpuTime) + "ms");
+        setJudgeResult(index, "AC", result.stats.cpuTime, result.stats.peakMemory);
+        break;
+    case Core::InteractiveRunner::Failed:
+        testcases->setVerdict(index, TestCase::UNKNOWN, verdict);
+        log.error(head, verdict);
+        setJudgeResult(index, "FAIL", result.stats.cpuTime, result.stats.peakMemory);
+        break;
+    default: {
+        testcases->setVerdict(index, TestCase::WA, verdict);
+        log.warn(head, verdict);
+        QString judgeVerdict = "WA";
+        if (result.verdict == Core::InteractiveRunner::TimeLimitExceeded)
+            judgeVerdict = "TLE";
+        else if (result.verdict == Core::InteractiveRunner::MemoryLimitExceeded)
+            judgeVerdict = "MLE";
+        else if (result.verdict == Core::InteractiveRunner::RuntimeError)
+            judgeVerdict = "RE";
+        setJudgeResult(index, judgeVerdict, result.stats.cpuTime, result.stats.peakMemory);
+        break;
+    }
+    }
+}
+
+void MainWindow::onCheckFinished(int index, Core::Checker::Verdict verdict, const QString &message)
+{
+    if (index < 0 || index >= testcases->count())
+        return;
+
+    switch (verdict)
+    {
+    case Core::Checker::Accepted:
+        testcases->setVerdict(index, TestCase::AC, message);
+        setJudgeResult(index, "AC");
+        break;
+    case Core::Checker::WrongAnswer:
+        testcases->setVerdict(index, TestCase::WA, message);
+        if (!message.isEmpty())
+            log.warn("Checker[" + QString::number(index + 1) + "]", message);
+        setJudgeResult(index, "WA");
+        break;
+    case Core::Checker::Failed:
+        testcases->setVerdict(index, TestCase::UNKNOWN, message);
+        log.error("Checker[" + QString::number(index + 1) + "]", message);
+        setJudgeResult(index, "FAIL");
+        break;
+    }
+
+    if (pendingHistory.contains(index))
+    {
+        auto record = pendingHistory.take(index);
+        record.verdict = verdict == Core::Checker::Accepted ? "AC"
+                         : verdict == Core::Checker::WrongAnswer ? "WA" : "FAIL";
+        recordRun(index, record);
+    }
+}
+
+void MainWindow::recordRun(int index, Core::RunHistory::Record record)
+{
+    auto history = Core::RunHistory::instance();
+    auto records = history->records(record.testHash);
+    history->append(record);
+    records.push_back(record);
+
+    const int revisions = 20;
+    auto times = Core::RunHistory::timesPerRevision(records, record.profile, revisions);
+    testcases->setRunHistory(index, times);
+
+    // the last time of the previous revision is compared, the small differences are noise
+    if (data.regressionThreshold <= 0 || times.size() < 2 || record.verdict == "TLE" || record.verdict == "RE")
+        return;
+    int before = times[times.size() - 2], after = times.back();
+    if (after - before >= 10 && after * 100 > before * (100 + data.regressionThreshold))
+    {
+        log.warn("History", "Test case #" + QString::number(index + 1) + " is " +
+                                QString::number((after - before) * 100 / qMax(1, before)) +
+                                "% slower than on the previous revision (" + QString::number(before) + "ms -> " +
+                                QString::number(after) + "ms)");
+    }
+}
+
+void MainWindow::onToolProbeFinished(int tool, const QString &command, const QString &options, bool available)
+{
+    // only the probes requested by this tab are reported, and only if they still match the settings and the language
+    if (!pendingProbes.remove(QString::number(tool) + '\n' + command + '\n' + options))
+        return;
+
+    bool inUse = false;
+    switch (tool)
+    {
+    case Core::Toolchain::Formatter:
+        inUse = command == data.clangFormatBinary && options == data.clangFormatStyle;
+        break;
+    case Core::Toolchain::Compiler:
+        inUse = (language == "C++" && command == data.compileCommandCpp) ||
+                (language == "Java" && (command == data.compileCommandJava || command == data.runCommandJava)) ||
+                (language == "Python" && command == data.runCommandPython);
+        break;
+    case Core::Toolchain::CFTools:
+        inUse = command == cftoolPath;
+        break;
+    }
+
+    if (inUse)
+        reportToolStatus(tool, command, available);
+}
@@ -19,6 +19,7 @@
 #include "../ui/ui_preferencewindow.h"
 
 #include "Extensions/EditorTheme.hpp"
+#include "Widgets/CalibrationDialog.hpp"
 #include <QAction>
 #include <QCXXHighlighter>
 #include <QDesktopWidget>
@@ -58,6 +59,8 @@ void PreferenceWindow::setConstraints()
 
     ui->time_limit->setMinimum(1);
     ui->time_limit->setMaximum(3600000);
+    ui->parallel_jobs->setMaximum(256);
+    ui->memory_budget->setMaximum(1024 * 1024);
 
     ui->companion_port->setMinimum(10000);
     ui->companion_port->setMaximum(65535);
@@ -105,6 +108,10 @@ void PreferenceWindow::applySettingsToui()
 
     ui->cpp_compiler_cmd->setText(manager->getCompileCommandCpp());
     ui->cpp_args_cmd->setText(manager->getRuntimeArgumentsCpp());
+    ui->cpp_build_profile->setCurrentText(manager->getBuildProfile());
+    ui->cpp_fast_flags->setText(manager->getBuildFlags("Fast"));
+    ui->cpp_debug_flags->setText(manager->getBuildFlags("Debug"));
+    ui->cpp_sanitize_flags->setText(manager->getBuildFlags("Sanitize"));
 
     ui->java_compiler_cmd->setText(manager->getCompileCommandJava());
     ui->java_args_cmd->setText(manager->getRuntimeArgumentsJava());
@@ -128,6 +135,13 @@ void PreferenceWindow::applySettingsToui()
     ui->beta_update->setChecked(manager->isBeta());
 
     ui->time_limit->setValue(manager->getTimeLimit());
+    ui->stop_at_first_wa->setChecked(manager->isStopAtFirstWrongAnswer());
+    ui->use_executor->setChecked(manager->isUseExecutor());
+    ui->hardware_counters->setChecked(manager->isHardwareCounters());
+    ui->parallel_jobs->setValue(manager->getParallelJobs());
+    ui->memory_budget->setValue(manager->getMemoryBudget());
+    ui->regression_threshold->setValue(manager->getRegressionThreshold());
+    ui->judge_speed_factor->setValue(manager->getJudgeSpeedFactor());
 
     ui->cpp_template->setText(cppTemplatePath.isEmpty() ? "<Not selected>" : "..." + cppTemplatePath.right(30));
     ui->py_template->setText(pythonTemplatePath.isEmpty() ? "<Not selected>" : "..." + pythonTemplatePath.right(30));
@@ -173,6 +187,10 @@ void PreferenceWindow::extractSettingsFromUi()
 
     manager->setCompileCommandsCpp(ui->cpp_compiler_cmd->text());
     manager->setRuntimeArgumentsCpp(ui->cpp_args_cmd->text());
+    manager->setBuildProfile(ui->cpp_build_profile->currentText());
+    manager->setBuildFlags("Fast", ui->cpp_fast_flags->text());
+    manager->setBuildFlags("Debug", ui->cpp_debug_flags->text());
+    manager->setBuildFlags("Sanitize", ui->cpp_sanitize_flags->text());
 
     manager->setCompileCommandsJava(ui->java_compiler_cmd->text());
     manager->setRuntimeArgumentsJava(ui->java_args_cmd->text());
@@ -192,6 +210,13 @@ void PreferenceWindow::extractSettingsFromUi()
     manager->checkUpdateOnStartup(ui->update_startup->isChecked());
 
     manager->setTimeLimit(ui->time_limit->value());
+    manager->setStopAtFirstWrongAnswer(ui->stop_at_first_wa->isChecked());
+    manager->setUseExecutor(ui->use_executor->isChecked());
+    manager->setHardwareCounters(ui->hardware_counters->isChecked());
+    manager->setParallelJobs(ui->parallel_jobs->value());
+    manager->setMemoryBudget(ui->memory_budget->value());
+    manager->setRegressionThreshold(ui->regression_threshold->value());
+    manager->setJudgeSpeedFactor(ui->judge_speed_factor->value());
 
     manager->setTemplatePathCpp(cppTemplatePath);
     manager->setTemplatePathJava(javaTemplatePath);
@@ -506,6 +531,15 @@ void PreferenceWindow::on_transparency_slider_valueChanged(int value)
     parentWidget()->setWindowOpacity(value / 100.0);
 }
 
+void PreferenceWindow::on_calibrate_clicked()
+{
+    // the judges compile with optimizations, so the programs are compiled with the flags of the Fast profile
+    QString command = ui->cpp_compiler_cmd->text().trimmed() + " " + ui->cpp_fast_flags->text().trimmed();
+    CalibrationDialog dialog(manager, command.trimmed(), this);
+    if (dialog.exec() == QDialog::Accepted && dialog.speedFactor() > 0)
+        ui->judge_speed_factor->setValue(dialog.speedFactor());
+}
+
 QString PreferenceWindow::getNewSnippetName(const QString &lang, const QString &old)
 {
     QString label = "New name:";